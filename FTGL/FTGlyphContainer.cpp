@@ -56,6 +56,9 @@ bool FTGlyphContainer::CharMap(FT_Encoding encoding)
 {
     bool result = charMap->CharMap(encoding);
     err = charMap->Error();
+
+    // The cached pairs are character codes of the previous encoding
+    kerningCache.clear();
     return result;
 }
 
@@ -81,25 +84,47 @@ FTBBox FTGlyphContainer::BBox(const unsigned int charCode) const
     return Glyph(charCode)->BBox();
 }
 
-float FTGlyphContainer::Advance(const unsigned int charCode,
-                                const unsigned int nextCharCode)
+bool FTGlyphContainer::KernAdvance(const unsigned int charCode,
+                                   const unsigned int nextCharCode,
+                                   FTPoint& kern)
 {
+    float x, y;
+
+    if (kerningCache.find(charCode, nextCharCode, x, y))
+    {
+        kern = FTPoint(x, y);
+        return true;
+    }
+
     unsigned int left = charMap->FontIndex(charCode);
     unsigned int right = charMap->FontIndex(nextCharCode);
 
-    return face->KernAdvance(left, right).Xf() + Glyph(charCode)->Advance();
+    kern = face->KernAdvance(left, right);
+    if (face->Error())
+    {
+        return false;
+    }
+
+    kerningCache.insert(charCode, nextCharCode, kern.Xf(), kern.Yf());
+    return true;
+}
+
+float FTGlyphContainer::Advance(const unsigned int charCode,
+                                const unsigned int nextCharCode)
+{
+    FTPoint kernAdvance;
+    KernAdvance(charCode, nextCharCode, kernAdvance);
+
+    return kernAdvance.Xf() + Glyph(charCode)->Advance();
 }
 
 FTPoint FTGlyphContainer::Render(const unsigned int charCode,
                                  const unsigned int nextCharCode,
                                  FTPoint penPosition, int renderMode)
 {
-    unsigned int left = charMap->FontIndex(charCode);
-    unsigned int right = charMap->FontIndex(nextCharCode);
-
-    FTPoint kernAdvance = face->KernAdvance(left, right);
+    FTPoint kernAdvance;
 
-    if (!face->Error())
+    if (KernAdvance(charCode, nextCharCode, kernAdvance))
     {
         unsigned int index = charMap->GlyphListIndex(charCode);
         kernAdvance += glyphs[index]->Render(penPosition, renderMode);
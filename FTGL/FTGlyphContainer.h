@@ -33,6 +33,7 @@
 #include "FTGL/ftgl.h"
 
 #include "FTVector.h"
+#include "FTKerningCache.h"
 
 class FTFace;
 class FTGlyph;
@@ -132,6 +133,15 @@ public:
     FT_Error Error() const { return err; }
 
 private:
+    /**
+     * Get the kerning vector of a character pair, from the cache or from
+     * the face.
+     *
+     * @return  <code>false</code> if the face failed to provide it
+     */
+    bool KernAdvance(const unsigned int characterCode,
+                     const unsigned int nextCharacterCode, FTPoint& kern);
+
     /**
      * The FTGL face
      */
@@ -147,6 +157,12 @@ private:
      */
     GlyphVector glyphs;
 
+    /**
+     * The kerning vectors of the character pairs laid out so far. The
+     * container is rebuilt for each face size, so is the cache.
+     */
+    FTKerningCache kerningCache;
+
     /**
      * Current error code. Zero means no error.
      */
@@ -0,0 +1,253 @@
+/*
+ * FTGL - OpenGL font library
+ *
+ * Copyright (c) 2001-2004 Henry Maddocks <ftgl@opengl.geek.nz>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __FTKerningCache__
+#define __FTKerningCache__
+
+/**
+ * Caches the kerning vectors of character code pairs for
+ * FTGlyphContainer, so that laying out pairs which have already been seen
+ * does not go through the charmap and FT_Get_Kerning again.
+ *
+ * Implementation:
+ *   - The pairs of two Latin-1 characters are stored in a dense table of
+ *     DenseSize rows. The row of the left character is allocated the first
+ *     time it is used; a bit mask tells which of its entries are set.
+ *   - The other pairs are stored in an open addressing hash table with
+ *     linear probing, which is doubled when it is half full. When it
+ *     reaches MaxHashSize entries, it is cleared instead, so that the text
+ *     of large scripts cannot make it grow without bounds.
+ */
+class FTKerningCache
+{
+public:
+    typedef unsigned int CharacterCode;
+
+    enum
+    {
+        DenseSize = 256,
+        MinHashSize = 64,
+        MaxHashSize = 65536
+    };
+
+    FTKerningCache()
+        : Rows(0)
+        , Table(0)
+        , TableSize(0)
+        , TableCount(0)
+    {
+    }
+
+    ~FTKerningCache()
+    {
+        this->clear();
+        delete[] this->Rows;
+        this->Rows = 0;
+    }
+
+    void clear()
+    {
+        if (this->Rows)
+        {
+            for (int i = 0; i < FTKerningCache::DenseSize; i++)
+            {
+                delete this->Rows[i];
+                this->Rows[i] = 0;
+            }
+        }
+
+        delete[] this->Table;
+        this->Table = 0;
+        this->TableSize = 0;
+        this->TableCount = 0;
+    }
+
+    /**
+     * Looks up the kerning vector of a pair.
+     *
+     * @return <code>true</code> and the vector in x and y if the pair is
+     *         in the cache.
+     */
+    bool find(CharacterCode left, CharacterCode right, float& x,
+              float& y) const
+    {
+        if (left < FTKerningCache::DenseSize
+            && right < FTKerningCache::DenseSize)
+        {
+            const Row* row = this->Rows ? this->Rows[left] : 0;
+            if (!row || !(row->Known[right >> 5] & (1u << (right & 31))))
+            {
+                return false;
+            }
+
+            x = row->Kern[right][0];
+            y = row->Kern[right][1];
+            return true;
+        }
+
+        if (!this->Table)
+        {
+            return false;
+        }
+
+        for (unsigned int i = Hash(left, right);; i++)
+        {
+            const Entry* e = &this->Table[i & (this->TableSize - 1)];
+            if (!e->Used)
+            {
+                return false;
+            }
+
+            if (e->Left == left && e->Right == right)
+            {
+                x = e->X;
+                y = e->Y;
+                return true;
+            }
+        }
+    }
+
+    void insert(CharacterCode left, CharacterCode right, float x, float y)
+    {
+        if (left < FTKerningCache::DenseSize
+            && right < FTKerningCache::DenseSize)
+        {
+            if (!this->Rows)
+            {
+                this->Rows = new Row*[FTKerningCache::DenseSize];
+                for (int i = 0; i < FTKerningCache::DenseSize; i++)
+                {
+                    this->Rows[i] = 0;
+                }
+            }
+
+            Row* row = this->Rows[left];
+            if (!row)
+            {
+                row = this->Rows[left] = new Row;
+                for (int i = 0; i < FTKerningCache::DenseSize / 32; i++)
+                {
+                    row->Known[i] = 0;
+                }
+            }
+
+            row->Kern[right][0] = x;
+            row->Kern[right][1] = y;
+            row->Known[right >> 5] |= 1u << (right & 31);
+            return;
+        }
+
+        if (2 * (this->TableCount + 1) > this->TableSize)
+        {
+            if (this->TableSize >= FTKerningCache::MaxHashSize)
+            {
+                delete[] this->Table;
+                this->Table = 0;
+                this->TableSize = 0;
+                this->TableCount = 0;
+            }
+
+            Resize(this->TableSize ? 2 * this->TableSize
+                                   : FTKerningCache::MinHashSize);
+        }
+
+        Entry* e = Slot(left, right);
+        if (!e->Used)
+        {
+            e->Used = true;
+            e->Left = left;
+            e->Right = right;
+            this->TableCount++;
+        }
+
+        e->X = x;
+        e->Y = y;
+    }
+
+private:
+    struct Row
+    {
+        unsigned int Known[FTKerningCache::DenseSize / 32];
+        float Kern[FTKerningCache::DenseSize][2];
+    };
+
+    struct Entry
+    {
+        CharacterCode Left;
+        CharacterCode Right;
+        float X;
+        float Y;
+        bool Used;
+    };
+
+    static unsigned int Hash(CharacterCode left, CharacterCode right)
+    {
+        unsigned int h = left * 0x9E3779B1u ^ right * 0x85EBCA77u;
+        return h ^ (h >> 16);
+    }
+
+    /** The entry of the pair, or the empty one where it goes. */
+    Entry* Slot(CharacterCode left, CharacterCode right)
+    {
+        for (unsigned int i = Hash(left, right);; i++)
+        {
+            Entry* e = &this->Table[i & (this->TableSize - 1)];
+            if (!e->Used || (e->Left == left && e->Right == right))
+            {
+                return e;
+            }
+        }
+    }
+
+    void Resize(unsigned int size)
+    {
+        Entry* old = this->Table;
+        unsigned int oldSize = this->TableSize;
+
+        this->Table = new Entry[size];
+        this->TableSize = size;
+        for (unsigned int i = 0; i < size; i++)
+        {
+            this->Table[i].Used = false;
+        }
+
+        for (unsigned int i = 0; i < oldSize; i++)
+        {
+            if (old[i].Used)
+            {
+                *Slot(old[i].Left, old[i].Right) = old[i];
+            }
+        }
+
+        delete[] old;
+    }
+
+    Row** Rows;
+    Entry* Table;
+    unsigned int TableSize;
+    unsigned int TableCount;
+};
+
+#endif //  __FTKerningCache__
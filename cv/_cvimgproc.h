@@ -97,6 +97,7 @@ CvStatus CV_STDCALL icvCopyReplicateBorder_8u(const uchar* src, int srcstep,
                                               int left, int right, int cn,
                                               const uchar* value = 0);
 
+/* the stripe buffer is allocated from the scratch arena (cvScratchFree) */
 CvMat* icvIPPFilterInit(const CvMat* src, int stripe_size, CvSize ksize);
 
 int icvIPPFilterNextStripe(const CvMat* src, CvMat* temp, int y, CvSize ksize,
@@ -117,6 +118,16 @@ extern float icvCubicCoeffs[(ICV_CUBIC_TAB_SIZE + 1) * 2];
 
 void icvInitCubicCoeffTab();
 
+/* fixed-point remap maps (see cvConvertMaps) keep the integer source
+   coordinates in a 16sC2 array and the fractional ones, quantized to
+   ICV_REMAP_FIX_SHIFT bits each, in a 16uC1 array */
+#define ICV_REMAP_FIX_SHIFT 5
+#define ICV_REMAP_FIX_MASK ((1 << ICV_REMAP_FIX_SHIFT) - 1)
+#define ICV_REMAP_FIX_TAB_SIZE (1 << ICV_REMAP_FIX_SHIFT * 2)
+
+void icvConvertMapRow(const float* mapx, const float* mapy, short* mapxy,
+                      ushort* mapa, int width);
+
 CvStatus CV_STDCALL icvGetRectSubPix_8u_C1R(const uchar* src, int src_step,
                                             CvSize src_size, uchar* dst,
                                             int dst_step, CvSize win_size,
@@ -86,7 +86,11 @@ extern "C"
 #define CV_MEDIAN 3
 #define CV_BILATERAL 4
 
-    /* Smoothes array (removes noise) */
+    /* Smoothes array (removes noise). The Gaussian smoothing of 16u and 32f
+       arrays with large sigmas (param3, param4 >= 12) and the kernel size
+       derived from them (param1 = param2 = 0) uses a recursive approximation
+       of the filter, which cost does not depend on sigma (unless the
+       optimized code is off, see cvUseOptimized) */
     CVAPI(void)
     cvSmooth(const CvArr* src, CvArr* dst,
              int smoothtype CV_DEFAULT(CV_GAUSSIAN), int param1 CV_DEFAULT(3),
@@ -275,17 +279,34 @@ extern "C"
 #define CV_WARP_FILL_OUTLIERS 8
 #define CV_WARP_INVERSE_MAP 16
 
+/* 16-bit unsigned (CV_16U) arrays hold IEEE 754 half-precision floats */
+#define CV_WARP_16F 32
+
     /* Resizes image (input array is resized to fit the destination array) */
     CVAPI(void)
     cvResize(const CvArr* src, CvArr* dst,
              int interpolation CV_DEFAULT(CV_INTER_LINEAR));
 
+    /* Resizes each of count single-channel planes src[i] into dst[i] */
+    CVAPI(void)
+    cvResizePlanes(const CvArr** src, CvArr** dst, int count,
+                   int interpolation CV_DEFAULT(CV_INTER_LINEAR));
+
     /* Warps image with affine transform */
     CVAPI(void)
     cvWarpAffine(const CvArr* src, CvArr* dst, const CvMat* map_matrix,
                  int flags CV_DEFAULT(CV_INTER_LINEAR + CV_WARP_FILL_OUTLIERS),
                  CvScalar fillval CV_DEFAULT(cvScalarAll(0)));
 
+    /* Warps each of count single-channel planes; plane i is filled with
+       fillval.val[MIN(i,3)] */
+    CVAPI(void)
+    cvWarpAffinePlanes(const CvArr** src, CvArr** dst, int count,
+                       const CvMat* map_matrix,
+                       int flags CV_DEFAULT(CV_INTER_LINEAR
+                                            + CV_WARP_FILL_OUTLIERS),
+                       CvScalar fillval CV_DEFAULT(cvScalarAll(0)));
+
     /* Computes affine transform matrix for mapping src[i] to dst[i] (i=0,1,2)
      */
     CVAPI(CvMat*)
@@ -304,6 +325,15 @@ extern "C"
                                            + CV_WARP_FILL_OUTLIERS),
                       CvScalar fillval CV_DEFAULT(cvScalarAll(0)));
 
+    /* Warps each of count single-channel planes; plane i is filled with
+       fillval.val[MIN(i,3)] */
+    CVAPI(void)
+    cvWarpPerspectivePlanes(const CvArr** src, CvArr** dst, int count,
+                            const CvMat* map_matrix,
+                            int flags CV_DEFAULT(CV_INTER_LINEAR
+                                                 + CV_WARP_FILL_OUTLIERS),
+                            CvScalar fillval CV_DEFAULT(cvScalarAll(0)));
+
     /* Computes perspective transform matrix for mapping src[i] to dst[i]
      * (i=0,1,2,3) */
     CVAPI(CvMat*)
@@ -311,12 +341,30 @@ extern "C"
                               CvMat* map_matrix);
 
     /* Performs generic geometric transformation using the specified coordinate
-     * maps */
+     * maps: either two 32fC1 arrays or the fixed-point maps made by
+     * cvConvertMaps */
     CVAPI(void)
     cvRemap(const CvArr* src, CvArr* dst, const CvArr* mapx, const CvArr* mapy,
             int flags CV_DEFAULT(CV_INTER_LINEAR + CV_WARP_FILL_OUTLIERS),
             CvScalar fillval CV_DEFAULT(cvScalarAll(0)));
 
+    /* Remaps each of count single-channel planes using the same maps; plane i
+       is filled with fillval.val[MIN(i,3)] */
+    CVAPI(void)
+    cvRemapPlanes(const CvArr** src, CvArr** dst, int count, const CvArr* mapx,
+                  const CvArr* mapy,
+                  int flags CV_DEFAULT(CV_INTER_LINEAR + CV_WARP_FILL_OUTLIERS),
+                  CvScalar fillval CV_DEFAULT(cvScalarAll(0)));
+
+    /* Converts 32fC1 coordinate maps to the compact fixed-point form used by
+       cvRemap: integer coordinates (16sC2) and 1/32 pixel fractions (16uC1).
+       Without mapalpha the coordinates are rounded for nearest-neighbor
+       remapping. The maps can be stored with cvSave and reloaded with cvLoad
+     */
+    CVAPI(void)
+    cvConvertMaps(const CvArr* mapx, const CvArr* mapy, CvArr* mapxy,
+                  CvArr* mapalpha CV_DEFAULT(NULL));
+
     /* Performs forward or inverse log-polar image transform */
     CVAPI(void)
     cvLogPolar(const CvArr* src, CvArr* dst, CvPoint2D32f center, double M,
@@ -1154,7 +1202,8 @@ extern "C"
                  const CvMat* distortion_coeffs);
 
     /* computes transformation map from intrinsic camera parameters
-       that can used by cvRemap */
+       that can used by cvRemap; the map is either a pair of 32fC1 arrays or
+       the fixed-point maps of cvConvertMaps (16sC2 and 16uC1 or NULL) */
     CVAPI(void)
     cvInitUndistortMap(const CvMat* intrinsic_matrix,
                        const CvMat* distortion_coeffs, CvArr* mapx,
@@ -85,7 +85,10 @@ public:
        the anchor is at the center. to get interpolate pixel values outside the
        image _border_mode=IPL_BORDER_*** is used, _border_value specify the
        pixel value in case of IPL_BORDER_CONSTANT border mode. before
-       initialization clear() is called if necessary.
+       initialization clear() is called if necessary: the buffers are kept
+       if only the border (or the kernel values, but not the kernel size)
+       change and _max_width does not grow, so the object can be
+       re-initialized for every frame of a sequence without reallocations.
     */
     virtual void init(int _max_width, int _src_type, int _dst_type,
                       bool _is_separable, CvSize _ksize,
@@ -297,10 +297,11 @@ static void icvCornerEigenValsVecs(const CvMat* src, CvMat* eigenv,
         max_dy = MAX(max_dy, aperture_size + block_size);
     }
 
-    CV_CALL(Dx = cvCreateMat(max_dy, aligned_width, d_depth));
-    CV_CALL(Dy = cvCreateMat(max_dy, aligned_width, d_depth));
-    CV_CALL(cov = cvCreateMat(max_dy + block_size + 1, size.width, CV_32FC3));
-    CV_CALL(sqrt_buf = cvCreateMat(2, size.width, CV_32F));
+    CV_CALL(Dx = cvCreateScratchMat(max_dy, aligned_width, d_depth));
+    CV_CALL(Dy = cvCreateScratchMat(max_dy, aligned_width, d_depth));
+    CV_CALL(cov = cvCreateScratchMat(max_dy + block_size + 1, size.width,
+                                     CV_32FC3));
+    CV_CALL(sqrt_buf = cvCreateScratchMat(2, size.width, CV_32F));
     Dx->cols = Dy->cols = size.width;
 
     if (!use_ipp)
@@ -422,11 +423,11 @@ static void icvCornerEigenValsVecs(const CvMat* src, CvMat* eigenv,
 
     __END__;
 
-    cvReleaseMat(&Dx);
-    cvReleaseMat(&Dy);
-    cvReleaseMat(&cov);
-    cvReleaseMat(&sqrt_buf);
-    cvReleaseMat(&tempsrc);
+    cvScratchFree(&Dx);
+    cvScratchFree(&Dy);
+    cvScratchFree(&cov);
+    cvScratchFree(&sqrt_buf);
+    cvScratchFree(&tempsrc);
 }
 
 CV_IMPL void cvCornerMinEigenVal(const void* srcarr, void* eigenvarr,
@@ -614,11 +615,11 @@ CV_IMPL void cvPreCornerDetect(const void* srcarr, void* dstarr,
         max_dy = MAX(max_dy, aperture_size);
     }
 
-    CV_CALL(Dx = cvCreateMat(max_dy, aligned_width, d_depth));
-    CV_CALL(Dy = cvCreateMat(max_dy, aligned_width, d_depth));
-    CV_CALL(D2x = cvCreateMat(max_dy, aligned_width, d_depth));
-    CV_CALL(D2y = cvCreateMat(max_dy, aligned_width, d_depth));
-    CV_CALL(Dxy = cvCreateMat(max_dy, aligned_width, d_depth));
+    CV_CALL(Dx = cvCreateScratchMat(max_dy, aligned_width, d_depth));
+    CV_CALL(Dy = cvCreateScratchMat(max_dy, aligned_width, d_depth));
+    CV_CALL(D2x = cvCreateScratchMat(max_dy, aligned_width, d_depth));
+    CV_CALL(D2y = cvCreateScratchMat(max_dy, aligned_width, d_depth));
+    CV_CALL(Dxy = cvCreateScratchMat(max_dy, aligned_width, d_depth));
     Dx->cols = Dy->cols = D2x->cols = D2y->cols = Dxy->cols = size.width;
 
     if (!use_ipp)
@@ -730,12 +731,12 @@ CV_IMPL void cvPreCornerDetect(const void* srcarr, void* dstarr,
 
     __END__;
 
-    cvReleaseMat(&Dx);
-    cvReleaseMat(&Dy);
-    cvReleaseMat(&D2x);
-    cvReleaseMat(&D2y);
-    cvReleaseMat(&Dxy);
-    cvReleaseMat(&tempsrc);
+    cvScratchFree(&Dx);
+    cvScratchFree(&Dy);
+    cvScratchFree(&D2x);
+    cvScratchFree(&D2y);
+    cvScratchFree(&Dxy);
+    cvScratchFree(&tempsrc);
 }
 
 /* End of file */
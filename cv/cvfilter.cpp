@@ -52,6 +52,11 @@ direct,
                                     Base Image Filter
 \****************************************************************************************/
 
+/* the ring buffer size (in bytes) of a tile of a separable filter, see
+   CvBaseImageFilter::process */
+#define ICV_FILTER_TILE_BUF_SIZE (1 << 18)
+#define ICV_FILTER_MIN_TILE_WIDTH 256
+
 static void default_x_filter_func(const uchar*, uchar*, void*) {}
 
 static void default_y_filter_func(uchar**, uchar*, int, int, void*) {}
@@ -128,10 +133,15 @@ void CvBaseImageFilter::init(int _max_width, int _src_type, int _dst_type,
     int total_buf_sz, src_pix_sz, row_tab_sz, bsz;
     uchar* ptr;
 
-    if (!(buffer && _max_width <= max_width && _src_type == src_type
-          && _dst_type == dst_type && _is_separable == is_separable
-          && _ksize.width == ksize.width && _ksize.height == ksize.height
-          && _anchor.x == anchor.x && _anchor.y == anchor.y))
+    // the buffer allocated for the same filter parameters and the same or
+    // larger width is reused, so that a filter object re-initialized for
+    // every frame of a video stream does not reallocate it
+    if (buffer && _max_width <= max_width && _src_type == src_type
+        && _dst_type == dst_type && _is_separable == is_separable
+        && _ksize.width == ksize.width && _ksize.height == ksize.height
+        && _anchor.x == anchor.x && _anchor.y == anchor.y)
+        _max_width = max_width;
+    else
         clear();
 
     is_separable = _is_separable != 0;
@@ -178,7 +188,9 @@ void CvBaseImageFilter::init(int _max_width, int _src_type, int _dst_type,
     row_tab_sz = cvAlign(max_rows * sizeof(uchar*), ALIGN);
     total_buf_sz = buf_size + row_tab_sz + bsz;
 
-    CV_CALL(ptr = buffer = (uchar*)cvAlloc(total_buf_sz));
+    if (!buffer)
+        CV_CALL(buffer = (uchar*)cvAlloc(total_buf_sz));
+    ptr = buffer;
 
     rows = (uchar**)ptr;
     ptr += row_tab_sz;
@@ -278,7 +290,14 @@ void CvBaseImageFilter::start_process(CvSlice x_range, int width)
         {
             for (j = 0; j < pix_sz; j++)
                 border_tab[i + j] = idx + ofs + j;
-            if (mode != IPL_BORDER_REPLICATE)
+            if (mode == IPL_BORDER_REPLICATE)
+            {
+                // outside of a non-isolated ROI the image pixels are used
+                // up to the image edge, which is then replicated
+                if (delta == di && idx != (k == 0 ? 0 : width))
+                    idx += delta;
+            }
+            else
             {
                 if (delta > 0 && idx == width || delta < 0 && idx == 0)
                 {
@@ -370,6 +389,17 @@ int CvBaseImageFilter::fill_cyclic_buffer(const uchar* src, int src_step,
 
         if (border_mode != IPL_BORDER_CONSTANT)
         {
+            // the border pixels that are inside the image (the ROI is not
+            // isolated) refer to themselves in border_tab; copy them to trow
+            // before the other border pixels are formed from them
+            if (bptr == trow)
+                for (i = 0; i < bsz; i++)
+                {
+                    int k = i < bsz1 ? i : i + width_n;
+                    if (border_tab[i] == k)
+                        bptr[k] = src[k - bsz1];
+                }
+
             for (i = 0; i < bsz1; i++)
             {
                 int j = border_tab[i];
@@ -493,6 +523,40 @@ int CvBaseImageFilter::process(const CvMat* src, CvMat* dst, CvRect src_roi,
         phase = CV_START | CV_END;
     phase &= CV_START | CV_END | CV_MIDDLE;
 
+    // a wide image is filtered by vertical tiles, so that the rows of the
+    // ring buffer read by the column filter stay in cache. The tiles take
+    // the border pixels from their neighbours, so the seams do not show.
+    // In-place (or otherwise overlapping) calls are not tiled, as those
+    // neighbours would already be overwritten by the previous tiles
+    if (phase == (CV_START | CV_END) && is_separable && !isolated_roi
+        && border_mode != IPL_BORDER_CONSTANT
+        && (dst->data.ptr >= src->data.ptr + src->rows * src->step
+            || src->data.ptr >= dst->data.ptr + dst->rows * dst->step))
+    {
+        int tile_width = ICV_FILTER_TILE_BUF_SIZE
+                         / ((max_ky * 2 + 3) * CV_ELEM_SIZE(work_type));
+        tile_width = MAX(tile_width, ICV_FILTER_MIN_TILE_WIDTH);
+        tile_width = MAX(tile_width, ksize.width * 4);
+
+        if (src_roi.width > tile_width)
+        {
+            int x, tile_count = (src_roi.width + tile_width - 1) / tile_width;
+            tile_width = (src_roi.width + tile_count - 1) / tile_count;
+
+            for (x = 0; x < src_roi.width; x += tile_width)
+            {
+                CvRect tile = cvRect(src_roi.x + x, src_roi.y,
+                                     MIN(tile_width, src_roi.width - x),
+                                     src_roi.height);
+                CV_CALL(rows_processed =
+                            process(src, dst, tile,
+                                    cvPoint(dst_origin.x + x, dst_origin.y),
+                                    flags));
+            }
+            EXIT;
+        }
+    }
+
     // initialize horizontal border relocation tab if it is not initialized yet
     if (phase & CV_START)
         start_process(cvSlice(src_roi.x, src_roi.x + src_roi.width), width);
@@ -694,13 +758,20 @@ void CvSepFilter::init(int _max_width, int _src_type, int _dst_type,
     CV_CALL(CvBaseImageFilter::init(_max_width, _src_type, _dst_type, 1, _ksize,
                                     _anchor, _border_mode, _border_value));
 
-    if (!(kx && CV_ARE_SIZES_EQ(kx, _kx)))
+    // the kernels of the previous init() may have been converted to 32s
+    if (kx && CV_ARE_SIZES_EQ(kx, _kx)
+        && CV_ELEM_SIZE(kx->type) == CV_ELEM_SIZE(filter_type))
+        kx->type = (kx->type & ~CV_MAT_DEPTH_MASK) | filter_type;
+    else
     {
         cvReleaseMat(&kx);
         CV_CALL(kx = cvCreateMat(_kx->rows, _kx->cols, filter_type));
     }
 
-    if (!(ky && CV_ARE_SIZES_EQ(ky, _ky)))
+    if (ky && CV_ARE_SIZES_EQ(ky, _ky)
+        && CV_ELEM_SIZE(ky->type) == CV_ELEM_SIZE(filter_type))
+        ky->type = (ky->type & ~CV_MAT_DEPTH_MASK) | filter_type;
+    else
     {
         cvReleaseMat(&ky);
         CV_CALL(ky = cvCreateMat(_ky->rows, _ky->cols, filter_type));
@@ -1106,7 +1177,209 @@ ICV_FILTER_ROW(16s32f, short, float, CV_NOP)
 ICV_FILTER_ROW(16u32f, ushort, float, CV_NOP)
 ICV_FILTER_ROW(32f, float, float, CV_NOP)
 
-#define ICV_FILTER_ROW_SYMM(flavor, srctype, dsttype, load_macro)             \
+/* SSE4.1/AVX2 versions of the symmetrical row and column filters for 16u and
+   32f data. They process the longest prefix of the row that fills whole
+   vectors and return its length, the rest is done by the generic code.
+   Unlike the generic code, they accumulate the sums in single precision,
+   so they are off after cvUseOptimized(0) */
+#if CV_SIMD_X86
+
+#include <smmintrin.h>
+#include <immintrin.h>
+
+static int icvFilterSimdLevel()
+{
+    static int level = -1;
+    if (level < 0)
+        level = cvCheckHardwareSupport(CV_CPU_AVX2)     ? 2
+                : cvCheckHardwareSupport(CV_CPU_SSE4_1) ? 1
+                                                        : 0;
+    return cvGetUseOptimized() ? level : 0;
+}
+
+#define ICV_LOAD_32F_SSE4(p) _mm_loadu_ps(p)
+#define ICV_LOAD_16U_SSE4(p) \
+    _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(p))))
+#define ICV_LOAD_32F_AVX2(p) _mm256_loadu_ps(p)
+#define ICV_LOAD_16U_AVX2(p) \
+    _mm256_cvtepi32_ps(      \
+        _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(p))))
+
+#define ICV_STORE_32F_SSE4(p, v) _mm_storeu_ps(p, v)
+#define ICV_STORE_16U_SSE4(p, v)                                 \
+    {                                                            \
+        __m128i t = _mm_cvtps_epi32(v);                          \
+        _mm_storel_epi64((__m128i*)(p), _mm_packus_epi32(t, t)); \
+    }
+#define ICV_STORE_32F_AVX2(p, v) _mm256_storeu_ps(p, v)
+#define ICV_STORE_16U_AVX2(p, v)                                            \
+    {                                                                       \
+        __m256i t = _mm256_cvtps_epi32(v);                                  \
+        _mm_storeu_si128((__m128i*)(p),                                     \
+                         _mm_packus_epi32(_mm256_castsi256_si128(t),        \
+                                          _mm256_extracti128_si256(t, 1))); \
+    }
+
+#define ICV_DEF_FILTER_ROW_SYMM_SIMD(flavor, srctype, load_sse4, load_avx2)   \
+    static CV_TARGET_SSE4_1 int icvFilterRowSymm_##flavor##_sse4(             \
+        const srctype* s, float* dst, const float* kx, int ksize2, int cn,    \
+        int width)                                                            \
+    {                                                                         \
+        int i = 0, j, k;                                                      \
+        for (; i <= width - 8; i += 8)                                        \
+        {                                                                     \
+            const srctype* sp = s + i;                                        \
+            __m128 f = _mm_set1_ps(kx[0]);                                    \
+            __m128 s0 = _mm_mul_ps(f, load_sse4(sp));                         \
+            __m128 s1 = _mm_mul_ps(f, load_sse4(sp + 4));                     \
+            for (k = 1, j = cn; k <= ksize2; k++, j += cn)                    \
+            {                                                                 \
+                __m128 t0 = _mm_add_ps(load_sse4(sp + j), load_sse4(sp - j)); \
+                __m128 t1 =                                                   \
+                    _mm_add_ps(load_sse4(sp + j + 4), load_sse4(sp - j + 4)); \
+                f = _mm_set1_ps(kx[k]);                                       \
+                s0 = _mm_add_ps(s0, _mm_mul_ps(f, t0));                       \
+                s1 = _mm_add_ps(s1, _mm_mul_ps(f, t1));                       \
+            }                                                                 \
+            _mm_storeu_ps(dst + i, s0);                                       \
+            _mm_storeu_ps(dst + i + 4, s1);                                   \
+        }                                                                     \
+        return i;                                                             \
+    }                                                                         \
+                                                                              \
+    static CV_TARGET_AVX2 int icvFilterRowSymm_##flavor##_avx2(               \
+        const srctype* s, float* dst, const float* kx, int ksize2, int cn,    \
+        int width)                                                            \
+    {                                                                         \
+        int i = 0, j, k;                                                      \
+        for (; i <= width - 16; i += 16)                                      \
+        {                                                                     \
+            const srctype* sp = s + i;                                        \
+            __m256 f = _mm256_set1_ps(kx[0]);                                 \
+            __m256 s0 = _mm256_mul_ps(f, load_avx2(sp));                      \
+            __m256 s1 = _mm256_mul_ps(f, load_avx2(sp + 8));                  \
+            for (k = 1, j = cn; k <= ksize2; k++, j += cn)                    \
+            {                                                                 \
+                __m256 t0 =                                                   \
+                    _mm256_add_ps(load_avx2(sp + j), load_avx2(sp - j));      \
+                __m256 t1 =                                                   \
+                    _mm256_add_ps(load_avx2(sp + j + 8),                      \
+                                  load_avx2(sp - j + 8));                     \
+                f = _mm256_set1_ps(kx[k]);                                    \
+                s0 = _mm256_add_ps(s0, _mm256_mul_ps(f, t0));                 \
+                s1 = _mm256_add_ps(s1, _mm256_mul_ps(f, t1));                 \
+            }                                                                 \
+            _mm256_storeu_ps(dst + i, s0);                                    \
+            _mm256_storeu_ps(dst + i + 8, s1);                                \
+        }                                                                     \
+        return i;                                                             \
+    }                                                                         \
+                                                                              \
+    static int icvFilterRowSymm_##flavor##_simd(const srctype* s, float* dst, \
+                                                const float* kx, int ksize2,  \
+                                                int cn, int width)            \
+    {                                                                         \
+        int level = icvFilterSimdLevel();                                     \
+        if (level == 2)                                                       \
+            return icvFilterRowSymm_##flavor##_avx2(s, dst, kx, ksize2, cn,   \
+                                                    width);                   \
+        if (level == 1)                                                       \
+            return icvFilterRowSymm_##flavor##_sse4(s, dst, kx, ksize2, cn,   \
+                                                    width);                   \
+        return 0;                                                             \
+    }
+
+#define ICV_DEF_FILTER_COL_SYMM_SIMD(flavor, dsttype, store_sse4, store_avx2) \
+    static CV_TARGET_SSE4_1 int icvFilterColSymm_##flavor##_sse4(             \
+        const float** src, dsttype* dst, const float* ky, int ksize2,         \
+        int width)                                                            \
+    {                                                                         \
+        int i = 0, k;                                                         \
+        for (; i <= width - 8; i += 8)                                        \
+        {                                                                     \
+            __m128 f = _mm_set1_ps(ky[0]);                                    \
+            __m128 s0 = _mm_mul_ps(f, _mm_loadu_ps(src[0] + i));              \
+            __m128 s1 = _mm_mul_ps(f, _mm_loadu_ps(src[0] + i + 4));          \
+            for (k = 1; k <= ksize2; k++)                                     \
+            {                                                                 \
+                const float *sptr = src[k] + i, *sptr2 = src[-k] + i;         \
+                __m128 t0 =                                                   \
+                    _mm_add_ps(_mm_loadu_ps(sptr), _mm_loadu_ps(sptr2));      \
+                __m128 t1 = _mm_add_ps(_mm_loadu_ps(sptr + 4),                \
+                                       _mm_loadu_ps(sptr2 + 4));              \
+                f = _mm_set1_ps(ky[k]);                                       \
+                s0 = _mm_add_ps(s0, _mm_mul_ps(f, t0));                       \
+                s1 = _mm_add_ps(s1, _mm_mul_ps(f, t1));                       \
+            }                                                                 \
+            store_sse4(dst + i, s0);                                          \
+            store_sse4(dst + i + 4, s1);                                      \
+        }                                                                     \
+        return i;                                                             \
+    }                                                                         \
+                                                                              \
+    static CV_TARGET_AVX2 int icvFilterColSymm_##flavor##_avx2(               \
+        const float** src, dsttype* dst, const float* ky, int ksize2,         \
+        int width)                                                            \
+    {                                                                         \
+        int i = 0, k;                                                         \
+        for (; i <= width - 16; i += 16)                                      \
+        {                                                                     \
+            __m256 f = _mm256_set1_ps(ky[0]);                                 \
+            __m256 s0 = _mm256_mul_ps(f, _mm256_loadu_ps(src[0] + i));        \
+            __m256 s1 = _mm256_mul_ps(f, _mm256_loadu_ps(src[0] + i + 8));    \
+            for (k = 1; k <= ksize2; k++)                                     \
+            {                                                                 \
+                const float *sptr = src[k] + i, *sptr2 = src[-k] + i;         \
+                __m256 t0 =                                                   \
+                    _mm256_add_ps(_mm256_loadu_ps(sptr),                      \
+                                  _mm256_loadu_ps(sptr2));                    \
+                __m256 t1 = _mm256_add_ps(_mm256_loadu_ps(sptr + 8),          \
+                                          _mm256_loadu_ps(sptr2 + 8));        \
+                f = _mm256_set1_ps(ky[k]);                                    \
+                s0 = _mm256_add_ps(s0, _mm256_mul_ps(f, t0));                 \
+                s1 = _mm256_add_ps(s1, _mm256_mul_ps(f, t1));                 \
+            }                                                                 \
+            store_avx2(dst + i, s0);                                          \
+            store_avx2(dst + i + 8, s1);                                      \
+        }                                                                     \
+        return i;                                                             \
+    }                                                                         \
+                                                                              \
+    static int icvFilterColSymm_##flavor##_simd(                              \
+        const float** src, dsttype* dst, const float* ky, int ksize2,         \
+        int width)                                                            \
+    {                                                                         \
+        int level = icvFilterSimdLevel();                                     \
+        if (level == 2)                                                       \
+            return icvFilterColSymm_##flavor##_avx2(src, dst, ky, ksize2,     \
+                                                    width);                   \
+        if (level == 1)                                                       \
+            return icvFilterColSymm_##flavor##_sse4(src, dst, ky, ksize2,     \
+                                                    width);                   \
+        return 0;                                                             \
+    }
+
+ICV_DEF_FILTER_ROW_SYMM_SIMD(16u32f, ushort, ICV_LOAD_16U_SSE4,
+                             ICV_LOAD_16U_AVX2)
+ICV_DEF_FILTER_ROW_SYMM_SIMD(32f, float, ICV_LOAD_32F_SSE4, ICV_LOAD_32F_AVX2)
+ICV_DEF_FILTER_COL_SYMM_SIMD(32f16u, ushort, ICV_STORE_16U_SSE4,
+                             ICV_STORE_16U_AVX2)
+ICV_DEF_FILTER_COL_SYMM_SIMD(32f, float, ICV_STORE_32F_SSE4,
+                             ICV_STORE_32F_AVX2)
+
+#else
+
+#define icvFilterRowSymm_16u32f_simd(s, dst, kx, ksize2, cn, width) 0
+#define icvFilterRowSymm_32f_simd(s, dst, kx, ksize2, cn, width) 0
+#define icvFilterColSymm_32f16u_simd(src, dst, ky, ksize2, width) 0
+#define icvFilterColSymm_32f_simd(src, dst, ky, ksize2, width) 0
+
+#endif /* CV_SIMD_X86 */
+
+#define icvFilterRowSymm_noSIMD(s, dst, kx, ksize2, cn, width) 0
+#define icvFilterColSymm_noSIMD(src, dst, ky, ksize2, width) 0
+
+#define ICV_FILTER_ROW_SYMM(flavor, srctype, dsttype, load_macro, simd_func) \
     static void icvFilterRowSymm_##flavor(const srctype* src, dsttype* dst,   \
                                           void* params)                       \
     {                                                                         \
@@ -1125,6 +1398,9 @@ ICV_FILTER_ROW(32f, float, float, CV_NOP)
                                                                               \
         if (is_symm)                                                          \
         {                                                                     \
+            i = simd_func(s, dst, kx, ksize2, cn, width);                     \
+            s += i;                                                           \
+                                                                              \
             for (; i <= width - 4; i += 4, s += 4)                            \
             {                                                                 \
                 double f = kx[0];                                             \
@@ -1183,9 +1459,10 @@ ICV_FILTER_ROW(32f, float, float, CV_NOP)
         }                                                                     \
     }
 
-ICV_FILTER_ROW_SYMM(8u32f, uchar, float, CV_8TO32F)
-ICV_FILTER_ROW_SYMM(16s32f, short, float, CV_NOP)
-ICV_FILTER_ROW_SYMM(16u32f, ushort, float, CV_NOP)
+ICV_FILTER_ROW_SYMM(8u32f, uchar, float, CV_8TO32F, icvFilterRowSymm_noSIMD)
+ICV_FILTER_ROW_SYMM(16s32f, short, float, CV_NOP, icvFilterRowSymm_noSIMD)
+ICV_FILTER_ROW_SYMM(16u32f, ushort, float, CV_NOP,
+                    icvFilterRowSymm_16u32f_simd)
 
 static void icvFilterRowSymm_32f(const float* src, float* dst, void* params)
 {
@@ -1223,6 +1500,10 @@ static void icvFilterRowSymm_32f(const float* src, float* dst, void* params)
                 dst[i + 1] = s1;
             }
         else
+        {
+            i = icvFilterRowSymm_32f_simd(s, dst, kx, ksize2, cn, width);
+            s += i;
+
             for (; i <= width - 4; i += 4, s += 4)
             {
                 double f = kx[0];
@@ -1242,6 +1523,7 @@ static void icvFilterRowSymm_32f(const float* src, float* dst, void* params)
                 dst[i + 2] = (float)s2;
                 dst[i + 3] = (float)s3;
             }
+        }
 
         for (; i < width; i++, s++)
         {
@@ -1571,7 +1853,7 @@ ICV_FILTER_COL(32f16s, float, short, int, cvRound, CV_CAST_16S)
 ICV_FILTER_COL(32f16u, float, ushort, int, cvRound, CV_CAST_16U)
 
 #define ICV_FILTER_COL_SYMM(flavor, srctype, dsttype, worktype, cast_macro1,  \
-                            cast_macro2)                                      \
+                            cast_macro2, simd_func)                           \
     static void icvFilterColSymm_##flavor(const srctype** src, dsttype* dst,  \
                                           int dst_step, int count,            \
                                           void* params)                       \
@@ -1593,7 +1875,8 @@ ICV_FILTER_COL(32f16u, float, ushort, int, cvRound, CV_CAST_16U)
         {                                                                     \
             for (; count--; dst += dst_step, src++)                           \
             {                                                                 \
-                for (i = 0; i <= width - 4; i += 4)                           \
+                for (i = simd_func(src, dst, ky, ksize2, width);              \
+                     i <= width - 4; i += 4)                                  \
                 {                                                             \
                     double f = ky[0];                                         \
                     const srctype *sptr = src[0] + i, *sptr2;                 \
@@ -1676,9 +1959,12 @@ ICV_FILTER_COL(32f16u, float, ushort, int, cvRound, CV_CAST_16U)
         }                                                                     \
     }
 
-ICV_FILTER_COL_SYMM(32f8u, float, uchar, int, cvRound, CV_CAST_8U)
-ICV_FILTER_COL_SYMM(32f16s, float, short, int, cvRound, CV_CAST_16S)
-ICV_FILTER_COL_SYMM(32f16u, float, ushort, int, cvRound, CV_CAST_16U)
+ICV_FILTER_COL_SYMM(32f8u, float, uchar, int, cvRound, CV_CAST_8U,
+                    icvFilterColSymm_noSIMD)
+ICV_FILTER_COL_SYMM(32f16s, float, short, int, cvRound, CV_CAST_16S,
+                    icvFilterColSymm_noSIMD)
+ICV_FILTER_COL_SYMM(32f16u, float, ushort, int, cvRound, CV_CAST_16U,
+                    icvFilterColSymm_32f16u_simd)
 
 static void icvFilterCol_32f(const float** src, float* dst, int dst_step,
                              int count, void* params)
@@ -1793,7 +2079,8 @@ static void icvFilterColSymm_32f(const float** src, float* dst, int dst_step,
                 }
             }
             else
-                for (i = 0; i <= width - 4; i += 4)
+                for (i = icvFilterColSymm_32f_simd(src, dst, ky, ksize2, width);
+                     i <= width - 4; i += 4)
                 {
                     double f = ky[0];
                     const float *sptr = src[0] + i, *sptr2;
@@ -2395,7 +2682,7 @@ CvMat* icvIPPFilterInit(const CvMat* src, int stripe_size, CvSize ksize)
     temp_size.height = MAX(temp_size.height, ksize.height);
     temp_size.height = MIN(temp_size.height, src->rows + ksize.height - 1);
 
-    return cvCreateMat(temp_size.height, temp_size.width, src->type);
+    return cvCreateScratchMat(temp_size.height, temp_size.width, src->type);
 }
 
 int icvIPPFilterNextStripe(const CvMat* src, CvMat* temp, int y, CvSize ksize,
@@ -2561,16 +2848,16 @@ int icvIPPSepFilter(const CvMat* src, CvMat* dst, const CvMat* kernelX,
 
     align = 8 / CV_ELEM_SIZE(depth);
 
-    CV_CALL(top_bottom = cvCreateMat(ksize.height * 2,
-                                     cvAlign(size.width, align), type));
+    CV_CALL(top_bottom = cvCreateScratchMat(ksize.height * 2,
+                                            cvAlign(size.width, align), type));
 
-    CV_CALL(vout_hin = cvCreateMat(max_dy + ksize.height,
-                                   cvAlign(size.width + ksize.width - 1, align),
-                                   type));
+    CV_CALL(vout_hin = cvCreateScratchMat(
+                max_dy + ksize.height,
+                cvAlign(size.width + ksize.width - 1, align), type));
 
     if (src->data.ptr == dst->data.ptr && size.height)
-        CV_CALL(dst_buf = cvCreateMat(max_dy + ksize.height,
-                                      cvAlign(size.width, align), type));
+        CV_CALL(dst_buf = cvCreateScratchMat(max_dy + ksize.height,
+                                             cvAlign(size.width, align), type));
 
     kx = (float*)cvStackAlloc(ksize.width * sizeof(kx[0]));
     ky = (float*)cvStackAlloc(ksize.height * sizeof(ky[0]));
@@ -2670,9 +2957,9 @@ int icvIPPSepFilter(const CvMat* src, CvMat* dst, const CvMat* kernelX,
 
     __END__;
 
-    cvReleaseMat(&vout_hin);
-    cvReleaseMat(&dst_buf);
-    cvReleaseMat(&top_bottom);
+    cvScratchFree(&dst_buf);
+    cvScratchFree(&vout_hin);
+    cvScratchFree(&top_bottom);
 
     return result;
 }
@@ -2780,8 +3067,8 @@ CV_IMPL void cvFilter2D(const CvArr* _src, CvArr* _dst, const CvMat* kernel,
             el_anchor = cvPoint(el_size.width - anchor.x - 1,
                                 el_size.height - anchor.y - 1);
 
-            CV_CALL(ipp_kernel =
-                        cvCreateMat(kernel->rows, kernel->cols, CV_32FC1));
+            CV_CALL(ipp_kernel = cvCreateScratchMat(kernel->rows, kernel->cols,
+                                                    CV_32FC1));
             CV_CALL(cvConvert(kernel, ipp_kernel));
 
             // mirror the kernel around the center
@@ -2826,8 +3113,8 @@ CV_IMPL void cvFilter2D(const CvArr* _src, CvArr* _dst, const CvMat* kernel,
 
     __END__;
 
-    cvReleaseMat(&temp);
-    cvReleaseMat(&ipp_kernel);
+    cvScratchFree(&temp);
+    cvScratchFree(&ipp_kernel);
 }
 
 /* End of file. */
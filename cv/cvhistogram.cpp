@@ -865,6 +865,233 @@ static CvStatus icvCalcHistLookupTables8u(const CvHistogram* hist, int dims,
     return CV_OK;
 }
 
+/* the pixels of the 16u and 32f images are processed in blocks: the bin
+   indices of a block are computed plane by plane, then the bins are
+   incremented */
+#define ICV_HIST_BLOCK_SIZE 256
+
+/* the histogram is computed on several stripes of the image concurrently
+   (see cvParallelFor) when each of them has at least that many pixels and
+   at least as many pixels as there are bins */
+#define ICV_HIST_MIN_STRIPE_SIZE (1 << 16)
+
+/* SSE4.1/AVX2 versions of the uniform bin index computation for 16u and
+   32f data. The indices are computed in double precision, like in the
+   generic code, so the results are the same. They process the longest
+   prefix of the block that fills whole vectors and return its length */
+#if CV_SIMD_X86
+
+#include <smmintrin.h>
+#include <immintrin.h>
+
+static int icvHistSimdLevel()
+{
+    static int level = -1;
+    if (level < 0)
+        level = cvCheckHardwareSupport(CV_CPU_AVX2)     ? 2
+                : cvCheckHardwareSupport(CV_CPU_SSE4_1) ? 1
+                                                        : 0;
+    return level;
+}
+
+#define ICV_HIST_LOAD_32F_SSE4(p, v0, v1)   \
+    {                                       \
+        __m128 t = _mm_loadu_ps(p);         \
+        v0 = _mm_cvtps_pd(t);               \
+        v1 = _mm_cvtps_pd(_mm_movehl_ps(t, t)); \
+    }
+#define ICV_HIST_LOAD_16U_SSE4(p, v0, v1)                                    \
+    {                                                                        \
+        __m128i t =                                                          \
+            _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(p)));        \
+        v0 = _mm_cvtepi32_pd(t);                                             \
+        v1 = _mm_cvtepi32_pd(_mm_srli_si128(t, 8));                          \
+    }
+#define ICV_HIST_LOAD_32F_AVX2(p, v0, v1)                   \
+    {                                                       \
+        __m256 t = _mm256_loadu_ps(p);                      \
+        v0 = _mm256_cvtps_pd(_mm256_castps256_ps128(t));    \
+        v1 = _mm256_cvtps_pd(_mm256_extractf128_ps(t, 1));  \
+    }
+#define ICV_HIST_LOAD_16U_AVX2(p, v0, v1)                                    \
+    {                                                                        \
+        __m256i t =                                                          \
+            _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(p)));     \
+        v0 = _mm256_cvtepi32_pd(_mm256_castsi256_si128(t));                  \
+        v1 = _mm256_cvtepi32_pd(_mm256_extracti128_si256(t, 1));             \
+    }
+
+/* idx[x] = bin index * step, or -1 if the value is out of range. When
+   accumulate is set, the index is added to the one computed for the
+   previous planes, unless any of them is -1 */
+#define ICV_DEF_HIST_BIN_IDX_SIMD(flavor, srctype, load_sse4, load_avx2)      \
+    static CV_TARGET_SSE4_1 int icvHistBinIdx_##flavor##_sse4(                \
+        const srctype* src, int* idx, int n, double a, double b, int sz,      \
+        int step, int accumulate)                                             \
+    {                                                                         \
+        __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b);                     \
+        __m128i vsz = _mm_set1_epi32(sz), vstep = _mm_set1_epi32(step);       \
+        __m128i vm1 = _mm_set1_epi32(-1);                                     \
+        int x = 0;                                                            \
+                                                                              \
+        for (; x <= n - 4; x += 4)                                            \
+        {                                                                     \
+            __m128d v0, v1;                                                   \
+            __m128i t, mask;                                                  \
+            load_sse4(src + x, v0, v1);                                       \
+            v0 = _mm_floor_pd(_mm_add_pd(_mm_mul_pd(v0, va), vb));            \
+            v1 = _mm_floor_pd(_mm_add_pd(_mm_mul_pd(v1, va), vb));            \
+            t = _mm_unpacklo_epi64(_mm_cvttpd_epi32(v0),                      \
+                                   _mm_cvttpd_epi32(v1));                     \
+            mask = _mm_and_si128(_mm_cmpgt_epi32(t, vm1),                     \
+                                 _mm_cmpgt_epi32(vsz, t));                    \
+            t = _mm_blendv_epi8(vm1, _mm_mullo_epi32(t, vstep), mask);        \
+            if (accumulate)                                                   \
+            {                                                                 \
+                __m128i p = _mm_loadu_si128((const __m128i*)(idx + x));       \
+                t = _mm_or_si128(_mm_add_epi32(t, p),                         \
+                                 _mm_srai_epi32(_mm_or_si128(t, p), 31));     \
+            }                                                                 \
+            _mm_storeu_si128((__m128i*)(idx + x), t);                         \
+        }                                                                     \
+        return x;                                                             \
+    }                                                                         \
+                                                                              \
+    static CV_TARGET_AVX2 int icvHistBinIdx_##flavor##_avx2(                  \
+        const srctype* src, int* idx, int n, double a, double b, int sz,      \
+        int step, int accumulate)                                             \
+    {                                                                         \
+        __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);               \
+        __m256i vsz = _mm256_set1_epi32(sz), vstep = _mm256_set1_epi32(step); \
+        __m256i vm1 = _mm256_set1_epi32(-1);                                  \
+        int x = 0;                                                            \
+                                                                              \
+        for (; x <= n - 8; x += 8)                                            \
+        {                                                                     \
+            __m256d v0, v1;                                                   \
+            __m256i t, mask;                                                  \
+            load_avx2(src + x, v0, v1);                                       \
+            v0 = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(v0, va), vb));   \
+            v1 = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(v1, va), vb));   \
+            t = _mm256_inserti128_si256(                                      \
+                _mm256_castsi128_si256(_mm256_cvttpd_epi32(v0)),              \
+                _mm256_cvttpd_epi32(v1), 1);                                  \
+            mask = _mm256_and_si256(_mm256_cmpgt_epi32(t, vm1),               \
+                                    _mm256_cmpgt_epi32(vsz, t));              \
+            t = _mm256_blendv_epi8(vm1, _mm256_mullo_epi32(t, vstep), mask);  \
+            if (accumulate)                                                   \
+            {                                                                 \
+                __m256i p = _mm256_loadu_si256((const __m256i*)(idx + x));    \
+                t = _mm256_or_si256(                                          \
+                    _mm256_add_epi32(t, p),                                   \
+                    _mm256_srai_epi32(_mm256_or_si256(t, p), 31));            \
+            }                                                                 \
+            _mm256_storeu_si256((__m256i*)(idx + x), t);                      \
+        }                                                                     \
+        return x;                                                             \
+    }                                                                         \
+                                                                              \
+    static int icvHistBinIdx_##flavor##_simd(const srctype* src, int* idx,   \
+                                             int n, double a, double b,       \
+                                             int sz, int step, int accumulate) \
+    {                                                                         \
+        int level = icvHistSimdLevel();                                       \
+        if (level == 2)                                                       \
+            return icvHistBinIdx_##flavor##_avx2(src, idx, n, a, b, sz, step, \
+                                                 accumulate);                 \
+        if (level == 1)                                                       \
+            return icvHistBinIdx_##flavor##_sse4(src, idx, n, a, b, sz, step, \
+                                                 accumulate);                 \
+        return 0;                                                             \
+    }
+
+ICV_DEF_HIST_BIN_IDX_SIMD(16u, ushort, ICV_HIST_LOAD_16U_SSE4,
+                          ICV_HIST_LOAD_16U_AVX2)
+ICV_DEF_HIST_BIN_IDX_SIMD(32f, float, ICV_HIST_LOAD_32F_SSE4,
+                          ICV_HIST_LOAD_32F_AVX2)
+
+#else
+
+#define icvHistBinIdx_16u_simd(src, idx, n, a, b, sz, step, accumulate) 0
+#define icvHistBinIdx_32f_simd(src, idx, n, a, b, sz, step, accumulate) 0
+
+#endif /* CV_SIMD_X86 */
+
+#define ICV_DEF_CALC_HIST_UNIFORM(flavor, srctype)                             \
+    static void icvHistBinIdx_##flavor(const srctype* src, int* idx, int n,    \
+                                       double a, double b, int sz, int step,   \
+                                       int accumulate)                         \
+    {                                                                          \
+        int x = icvHistBinIdx_##flavor##_simd(src, idx, n, a, b, sz, step,     \
+                                              accumulate);                     \
+        for (; x < n; x++)                                                     \
+        {                                                                      \
+            int v = cvFloor(src[x] * a + b);                                   \
+            v = (unsigned)v < (unsigned)sz ? v * step : -1;                    \
+            if (accumulate)                                                    \
+                v = (v | idx[x]) < 0 ? -1 : v + idx[x];                        \
+            idx[x] = v;                                                        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* computes a dense histogram with uniform bins, step is in elements */    \
+    static void icvCalcHistUniform_##flavor(                                   \
+        srctype** img, int step, uchar* mask, int maskStep, CvSize size,       \
+        int dims, const int* histsize, double uni_range[][2],                  \
+        const int* binstep, int* bins)                                         \
+    {                                                                          \
+        int idx[ICV_HIST_BLOCK_SIZE];                                          \
+        int i, x, x0;                                                          \
+                                                                               \
+        for (; size.height--;)                                                 \
+        {                                                                      \
+            for (x0 = 0; x0 < size.width; x0 += ICV_HIST_BLOCK_SIZE)           \
+            {                                                                  \
+                int n = MIN(size.width - x0, ICV_HIST_BLOCK_SIZE);             \
+                                                                               \
+                for (i = 0; i < dims; i++)                                     \
+                    icvHistBinIdx_##flavor(img[i] + x0, idx, n,                \
+                                           uni_range[i][0], uni_range[i][1],   \
+                                           histsize[i], binstep[i], i > 0);    \
+                                                                               \
+                if (mask)                                                      \
+                {                                                              \
+                    for (x = 0; x < n; x++)                                    \
+                        if (!mask[x0 + x])                                     \
+                            idx[x] = -1;                                       \
+                }                                                              \
+                                                                               \
+                for (x = 0; x < n; x++)                                        \
+                    if (idx[x] >= 0)                                           \
+                        bins[idx[x]]++;                                        \
+            }                                                                  \
+                                                                               \
+            for (i = 0; i < dims; i++)                                         \
+                img[i] += step;                                                \
+            if (mask)                                                          \
+                mask += maskStep;                                              \
+        }                                                                      \
+    }
+
+ICV_DEF_CALC_HIST_UNIFORM(16u, ushort)
+ICV_DEF_CALC_HIST_UNIFORM(32f, float)
+
+/* the scale and the shift mapping the values to the uniform bin indices */
+static void icvCalcHistUniformRanges(const CvHistogram* hist, int dims,
+                                     const int* histsize,
+                                     double uni_range[][2])
+{
+    int i;
+
+    for (i = 0; i < dims; i++)
+    {
+        double t =
+            histsize[i] / ((double)hist->thresh[i][1] - hist->thresh[i][0]);
+        uni_range[i][0] = t;
+        uni_range[i][1] = -t * hist->thresh[i][0];
+    }
+}
+
 /***************************** C A L C   H I S T O G R A M
  * *************************/
 
@@ -1136,15 +1363,7 @@ static CvStatus CV_STDCALL icvCalcHist_32f_C1R(float** img, int step,
     step /= sizeof(img[0][0]);
 
     if (uniform)
-    {
-        for (i = 0; i < dims; i++)
-        {
-            double t =
-                histsize[i] / ((double)hist->thresh[i][1] - hist->thresh[i][0]);
-            uni_range[i][0] = t;
-            uni_range[i][1] = -t * hist->thresh[i][0];
-        }
-    }
+        icvCalcHistUniformRanges(hist, dims, histsize, uni_range);
 
     if (!is_sparse)
     {
@@ -1153,154 +1372,13 @@ static CvStatus CV_STDCALL icvCalcHist_32f_C1R(float** img, int step,
 
         if (uniform)
         {
-            switch (dims)
-            {
-            case 1:
-            {
-                double a = uni_range[0][0], b = uni_range[0][1];
-                int sz = histsize[0];
-
-                for (; size.height--; img[0] += step)
-                {
-                    float* ptr = img[0];
-
-                    if (!mask)
-                    {
-                        for (x = 0; x <= size.width - 4; x += 4)
-                        {
-                            int v0 = cvFloor(ptr[x] * a + b);
-                            int v1 = cvFloor(ptr[x + 1] * a + b);
-
-                            if ((unsigned)v0 < (unsigned)sz)
-                                bins[v0]++;
-                            if ((unsigned)v1 < (unsigned)sz)
-                                bins[v1]++;
-
-                            v0 = cvFloor(ptr[x + 2] * a + b);
-                            v1 = cvFloor(ptr[x + 3] * a + b);
+            int binstep[CV_MAX_DIM];
 
-                            if ((unsigned)v0 < (unsigned)sz)
-                                bins[v0]++;
-                            if ((unsigned)v1 < (unsigned)sz)
-                                bins[v1]++;
-                        }
-
-                        for (; x < size.width; x++)
-                        {
-                            int v0 = cvFloor(ptr[x] * a + b);
-                            if ((unsigned)v0 < (unsigned)sz)
-                                bins[v0]++;
-                        }
-                    }
-                    else
-                    {
-                        for (x = 0; x < size.width; x++)
-                            if (mask[x])
-                            {
-                                int v0 = cvFloor(ptr[x] * a + b);
-                                if ((unsigned)v0 < (unsigned)sz)
-                                    bins[v0]++;
-                            }
-                        mask += maskStep;
-                    }
-                }
-            }
-            break;
-            case 2:
-            {
-                double a0 = uni_range[0][0], b0 = uni_range[0][1];
-                double a1 = uni_range[1][0], b1 = uni_range[1][1];
-                int sz0 = histsize[0], sz1 = histsize[1];
-                int step0 =
-                    ((CvMatND*)(hist->bins))->dim[0].step / sizeof(float);
-
-                for (; size.height--; img[0] += step, img[1] += step)
-                {
-                    float* ptr0 = img[0];
-                    float* ptr1 = img[1];
-
-                    if (!mask)
-                    {
-                        for (x = 0; x < size.width; x++)
-                        {
-                            int v0 = cvFloor(ptr0[x] * a0 + b0);
-                            int v1 = cvFloor(ptr1[x] * a1 + b1);
-
-                            if ((unsigned)v0 < (unsigned)sz0
-                                && (unsigned)v1 < (unsigned)sz1)
-                                bins[v0 * step0 + v1]++;
-                        }
-                    }
-                    else
-                    {
-                        for (x = 0; x < size.width; x++)
-                        {
-                            if (mask[x])
-                            {
-                                int v0 = cvFloor(ptr0[x] * a0 + b0);
-                                int v1 = cvFloor(ptr1[x] * a1 + b1);
-
-                                if ((unsigned)v0 < (unsigned)sz0
-                                    && (unsigned)v1 < (unsigned)sz1)
-                                    bins[v0 * step0 + v1]++;
-                            }
-                        }
-                        mask += maskStep;
-                    }
-                }
-            }
-            break;
-            default:
-                for (; size.height--;)
-                {
-                    if (!mask)
-                    {
-                        for (x = 0; x < size.width; x++)
-                        {
-                            int* binptr = bins;
-                            for (i = 0; i < dims; i++)
-                            {
-                                int idx =
-                                    cvFloor((double)img[i][x] * uni_range[i][0]
-                                            + uni_range[i][1]);
-                                if ((unsigned)idx >= (unsigned)histsize[i])
-                                    break;
-                                binptr +=
-                                    idx * (mat->dim[i].step / sizeof(float));
-                            }
-                            if (i == dims)
-                                binptr[0]++;
-                        }
-                    }
-                    else
-                    {
-                        for (x = 0; x < size.width; x++)
-                        {
-                            if (mask[x])
-                            {
-                                int* binptr = bins;
-                                for (i = 0; i < dims; i++)
-                                {
-                                    int idx = cvFloor((double)img[i][x]
-                                                          * uni_range[i][0]
-                                                      + uni_range[i][1]);
-                                    if ((unsigned)idx >= (unsigned)histsize[i])
-                                        break;
-                                    binptr +=
-                                        idx
-                                        * (mat->dim[i].step / sizeof(float));
-                                }
-                                if (i == dims)
-                                    binptr[0]++;
-                            }
-                        }
-                        mask += maskStep;
-                    }
+            for (i = 0; i < dims; i++)
+                binstep[i] = mat->dim[i].step / sizeof(float);
 
-                    for (i = 0; i < dims; i++)
-                        img[i] += step;
-                }
-            }
+            icvCalcHistUniform_32f(img, step, mask, maskStep, size, dims,
+                                   histsize, uni_range, binstep, bins);
         }
         else
         {
@@ -1406,9 +1484,157 @@ static CvStatus CV_STDCALL icvCalcHist_32f_C1R(float** img, int step,
     return CV_OK;
 }
 
+// Calculates histogram for one or more 16u arrays
+static CvStatus CV_STDCALL icvCalcHist_16u_C1R(ushort** img, int step,
+                                               uchar* mask, int maskStep,
+                                               CvSize size, CvHistogram* hist)
+{
+    int dims, histsize[CV_MAX_DIM];
+    float* buf;
+    float* ptr[CV_MAX_DIM];
+    int i, x;
+    CvStatus status = CV_OK;
+
+    dims = cvGetDims(hist->bins, histsize);
+    step /= sizeof(img[0][0]);
+
+    if (!CV_IS_SPARSE_HIST(hist) && CV_IS_UNIFORM_HIST(hist))
+    {
+        CvMatND* mat = (CvMatND*)(hist->bins);
+        double uni_range[CV_MAX_DIM][2];
+        int binstep[CV_MAX_DIM];
+
+        icvCalcHistUniformRanges(hist, dims, histsize, uni_range);
+        for (i = 0; i < dims; i++)
+            binstep[i] = mat->dim[i].step / sizeof(float);
+
+        icvCalcHistUniform_16u(img, step, mask, maskStep, size, dims, histsize,
+                               uni_range, binstep, mat->data.i);
+        return CV_OK;
+    }
+
+    // the rest of the histograms are computed from the rows converted to 32f
+    buf = (float*)cvScratchAlloc(dims * size.width * sizeof(buf[0]));
+    if (!buf)
+        return CV_OUTOFMEM_ERR;
+
+    for (; size.height--;)
+    {
+        for (i = 0; i < dims; i++)
+        {
+            ptr[i] = buf + i * size.width;
+            for (x = 0; x < size.width; x++)
+                ptr[i][x] = img[i][x];
+            img[i] += step;
+        }
+
+        status = icvCalcHist_32f_C1R(ptr, 0, mask, 0, cvSize(size.width, 1),
+                                     hist);
+        if (status < 0)
+            break;
+
+        if (mask)
+            mask += maskStep;
+    }
+
+    cvScratchFree(&buf);
+    return status;
+}
+
+static CvStatus icvCalcHistRows(uchar** img, int depth, int step, uchar* mask,
+                                int maskStep, CvSize size, CvHistogram* hist)
+{
+    union
+    {
+        uchar** ptr;
+        ushort** u16;
+        float** fl;
+    } v;
+
+    v.ptr = img;
+
+    if (depth == CV_8U)
+        return icvCalcHist_8u_C1R(v.ptr, step, mask, maskStep, size, hist);
+    if (depth == CV_16U)
+        return icvCalcHist_16u_C1R(v.u16, step, mask, maskStep, size, hist);
+    return icvCalcHist_32f_C1R(v.fl, step, mask, maskStep, size, hist);
+}
+
+/* arguments of the histogram computation on the image stripes. The first
+   stripe is accumulated in the histogram, the others in the partial ones
+   that are added to it afterwards. A single row (continuous arrays) is
+   split into the column stripes */
+typedef struct CvCalcHistJob
+{
+    CvHistogram* hist;
+    uchar** ptr;
+    int depth, step;
+    uchar* mask;
+    int maskstep;
+    CvSize size;
+    int stripes;
+    int* partial;
+    int total;
+} CvCalcHistJob;
+
+static int CV_CDECL icvCalcHistStripe(int start, int end, void* userdata)
+{
+    const CvCalcHistJob* job = (const CvCalcHistJob*)userdata;
+    int dims = cvGetDims(job->hist->bins);
+    int i, k;
+
+    for (k = start; k < end; k++)
+    {
+        CvHistogram hist = *job->hist;
+        CvMatND bins;
+        uchar* ptr[CV_MAX_DIM];
+        uchar* mask = job->mask;
+        CvSize size = job->size;
+        int len = size.height > 1 ? size.height : size.width;
+        int a = (int)((int64)len * k / job->stripes);
+        int b = (int)((int64)len * (k + 1) / job->stripes);
+        int ofs, mask_ofs;
+        CvStatus status;
+
+        if (k > 0)
+        {
+            bins = *(CvMatND*)job->hist->bins;
+            bins.data.i = job->partial + (k - 1) * job->total;
+            hist.bins = &bins;
+        }
+
+        if (size.height > 1)
+        {
+            ofs = a * job->step;
+            mask_ofs = a * job->maskstep;
+            size.height = b - a;
+        }
+        else
+        {
+            ofs = a * CV_ELEM_SIZE(job->depth);
+            mask_ofs = a;
+            size.width = b - a;
+        }
+
+        for (i = 0; i < dims; i++)
+            ptr[i] = job->ptr[i] + ofs;
+        if (mask)
+            mask += mask_ofs;
+
+        status = icvCalcHistRows(ptr, job->depth, job->step, mask,
+                                 job->maskstep, size, &hist);
+        if (status < 0)
+            return status;
+    }
+
+    return CV_OK;
+}
+
 CV_IMPL void cvCalcArrHist(CvArr** img, CvHistogram* hist, int do_not_clear,
                            const CvArr* mask)
 {
+    int* partial = 0;
+
     CV_FUNCNAME("cvCalcHist");
 
     __BEGIN__;
@@ -1416,11 +1642,12 @@ CV_IMPL void cvCalcArrHist(CvArr** img, CvHistogram* hist, int do_not_clear,
     uchar* ptr[CV_MAX_DIM];
     uchar* maskptr = 0;
     int maskstep = 0, step = 0;
-    int i, dims;
+    int i, k, dims, depth;
     int cont_flag = -1;
     CvMat stub0, *mat0 = 0;
     CvMatND dense;
     CvSize size;
+    CvCalcHistJob job;
 
     if (!CV_IS_HIST(hist))
         CV_ERROR(CV_StsBadArg, "Bad histogram pointer");
@@ -1515,31 +1742,53 @@ CV_IMPL void cvCalcArrHist(CvArr** img, CvHistogram* hist, int do_not_clear,
         }
     }
 
-    if (CV_MAT_DEPTH(mat0->type) > CV_8S && !CV_HIST_HAS_RANGES(hist))
+    depth = CV_MAT_DEPTH(mat0->type);
+    if (depth > CV_8S && !CV_HIST_HAS_RANGES(hist))
         CV_ERROR(CV_StsBadArg,
                  "histogram ranges must be set (via cvSetHistBinRanges) "
                  "before calling the function");
 
-    switch (CV_MAT_DEPTH(mat0->type))
-    {
-    case CV_8U:
-        IPPI_CALL(icvCalcHist_8u_C1R(ptr, step, maskptr, maskstep, size, hist));
-        break;
-    case CV_32F:
+    if (depth != CV_8U && depth != CV_16U && depth != CV_32F)
+        CV_ERROR(CV_StsUnsupportedFormat, "Unsupported array type");
+
+    job.hist = hist;
+    job.ptr = ptr;
+    job.depth = depth;
+    job.step = step;
+    job.mask = maskptr;
+    job.maskstep = maskstep;
+    job.size = size;
+    job.stripes = 1;
+    job.partial = 0;
+    job.total = 0;
+
+    if (!CV_IS_SPARSE_HIST(hist))
     {
-        union
-        {
-            uchar** ptr;
-            float** fl;
-        } v;
+        int64 pixels = (int64)size.width * size.height;
+        int64 stripes;
 
-        v.ptr = ptr;
-        IPPI_CALL(
-            icvCalcHist_32f_C1R(v.fl, step, maskptr, maskstep, size, hist));
+        job.total = dense.dim[0].size * dense.dim[0].step / sizeof(int);
+        stripes = pixels / MAX(job.total, ICV_HIST_MIN_STRIPE_SIZE);
+        stripes = MIN(stripes, cvGetParallelThreads());
+        job.stripes = (int)MAX(stripes, 1);
     }
-    break;
-    default:
-        CV_ERROR(CV_StsUnsupportedFormat, "Unsupported array type");
+
+    if (job.stripes > 1)
+    {
+        size_t partial_size =
+            (size_t)(job.stripes - 1) * job.total * sizeof(partial[0]);
+        CV_CALL(partial = (int*)cvScratchAlloc(partial_size));
+        memset(partial, 0, partial_size);
+        job.partial = partial;
+    }
+
+    IPPI_CALL((CvStatus)cvParallelFor(job.stripes, 1, icvCalcHistStripe, &job));
+
+    for (k = 1; k < job.stripes; k++)
+    {
+        const int* src = partial + (k - 1) * job.total;
+        for (i = 0; i < job.total; i++)
+            dense.data.i[i] += src[i];
     }
 
     if (!CV_IS_SPARSE_HIST(hist))
@@ -1561,6 +1810,8 @@ CV_IMPL void cvCalcArrHist(CvArr** img, CvHistogram* hist, int do_not_clear,
     }
 
     __END__;
+
+    cvScratchFree(&partial);
 }
 
 /***************************** B A C K   P R O J E C T
@@ -58,6 +58,24 @@ direct,
 
 #define ICV_WARP_MUL_ONE_8U(x) ((x) << ICV_WARP_SHIFT)
 #define ICV_WARP_DESCALE_8U(x) CV_DESCALE((x), ICV_WARP_SHIFT * 2)
+
+/* the destination is split into row bands of at least that many pixels
+   (see cvParallelFor) */
+#define ICV_WARP_MIN_BAND_SIZE (1 << 15)
+#define ICV_WARP_MIN_BAND(dsize) \
+    MAX(ICV_WARP_MIN_BAND_SIZE / MAX((dsize).width, 1), 1)
+
+/* the kernels for the half-float data (16u arrays processed with
+   CV_WARP_16F) are stored in the otherwise unused user type slot of the
+   function tables */
+#define ICV_DEPTH_16F CV_USRTYPE1
+
+static void icvScalarToHalf(const CvScalar* scalar, ushort* data, int cn)
+{
+    int k;
+    for (k = 0; k < cn; k++)
+        data[k] = cvFloatToHalf((float)scalar->val[k]);
+}
 #define ICV_WARP_CLIP_X(x)                       \
     ((unsigned)(x) < (unsigned)ssize.width ? (x) \
      : (x) < 0                             ? 0   \
@@ -131,7 +149,7 @@ void icvInitCubicCoeffTab()
 static CvStatus CV_STDCALL icvResize_NN_8u_C1R(const uchar* src, int srcstep,
                                                CvSize ssize, uchar* dst,
                                                int dststep, CvSize dsize,
-                                               int pix_size)
+                                               int pix_size, int y0, int y1)
 {
     int* x_ofs = (int*)cvStackAlloc(dsize.width * sizeof(x_ofs[0]));
     int pix_size4 = pix_size / sizeof(int);
@@ -145,7 +163,7 @@ static CvStatus CV_STDCALL icvResize_NN_8u_C1R(const uchar* src, int srcstep,
         x_ofs[x] = t * pix_size;
     }
 
-    for (y = 0; y < dsize.height; y++, dst += dststep)
+    for (y = y0, dst += y0 * dststep; y < y1; y++, dst += dststep)
     {
         const uchar* tsrc;
         t = (ssize.height * y * 2 + MIN(ssize.height, dsize.height) - 1)
@@ -216,12 +234,12 @@ typedef struct CvResizeAlpha
 } CvResizeAlpha;
 
 #define ICV_DEF_RESIZE_BILINEAR_FUNC(flavor, arrtype, worktype, alpha_field,   \
-                                     mul_one_macro, descale_macro)             \
+                                     load_macro, mul_one_macro, descale_macro) \
     static CvStatus CV_STDCALL icvResize_Bilinear_##flavor##_CnR(              \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,           \
         int dststep, CvSize dsize, int cn, int xmax,                           \
         const CvResizeAlpha* xofs, const CvResizeAlpha* yofs, worktype* buf0,  \
-        worktype* buf1)                                                        \
+        worktype* buf1, int y0, int y1)                                        \
     {                                                                          \
         int prev_sy0 = -1, prev_sy1 = -1;                                      \
         int k, dx, dy;                                                         \
@@ -231,7 +249,7 @@ typedef struct CvResizeAlpha
         dsize.width *= cn;                                                     \
         xmax *= cn;                                                            \
                                                                                \
-        for (dy = 0; dy < dsize.height; dy++, dst += dststep)                  \
+        for (dy = y0, dst += y0 * dststep; dy < y1; dy++, dst += dststep)      \
         {                                                                      \
             worktype fy = yofs[dy].alpha_field, *swap_t;                       \
             int sy0 = yofs[dy].idx,                                            \
@@ -263,12 +281,13 @@ typedef struct CvResizeAlpha
                 {                                                              \
                     int sx = xofs[dx].idx;                                     \
                     worktype fx = xofs[dx].alpha_field;                        \
-                    worktype t = _src[sx];                                     \
-                    _buf[dx] = mul_one_macro(t) + fx * (_src[sx + cn] - t);    \
+                    worktype t = load_macro(_src[sx]);                         \
+                    _buf[dx] = mul_one_macro(t)                                \
+                               + fx * (load_macro(_src[sx + cn]) - t);         \
                 }                                                              \
                                                                                \
                 for (; dx < dsize.width; dx++)                                 \
-                    _buf[dx] = mul_one_macro(_src[xofs[dx].idx]);              \
+                    _buf[dx] = mul_one_macro(load_macro(_src[xofs[dx].idx]));  \
             }                                                                  \
                                                                                \
             prev_sy0 = sy0;                                                    \
@@ -292,10 +311,12 @@ typedef struct CvDecimateAlpha
     float alpha;
 } CvDecimateAlpha;
 
-#define ICV_DEF_RESIZE_AREA_FAST_FUNC(flavor, arrtype, worktype, cast_macro)   \
+#define ICV_DEF_RESIZE_AREA_FAST_FUNC(flavor, arrtype, worktype, load_macro,   \
+                                      cast_macro)                              \
     static CvStatus CV_STDCALL icvResize_AreaFast_##flavor##_CnR(              \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,           \
-        int dststep, CvSize dsize, int cn, const int* ofs, const int* xofs)    \
+        int dststep, CvSize dsize, int cn, const int* ofs, const int* xofs,    \
+        int y0, int y1)                                                        \
     {                                                                          \
         int dy, dx, k = 0;                                                     \
         int scale_x = ssize.width / dsize.width;                               \
@@ -307,18 +328,20 @@ typedef struct CvDecimateAlpha
         dststep /= sizeof(dst[0]);                                             \
         dsize.width *= cn;                                                     \
                                                                                \
-        for (dy = 0; dy < dsize.height; dy++, dst += dststep)                  \
+        for (dy = y0, dst += y0 * dststep; dy < y1; dy++, dst += dststep)      \
             for (dx = 0; dx < dsize.width; dx++)                               \
             {                                                                  \
                 const arrtype* _src = src + dy * scale_y * srcstep + xofs[dx]; \
                 worktype sum = 0;                                              \
                                                                                \
                 for (k = 0; k <= area - 4; k += 4)                             \
-                    sum += _src[ofs[k]] + _src[ofs[k + 1]] + _src[ofs[k + 2]]  \
-                           + _src[ofs[k + 3]];                                 \
+                    sum += load_macro(_src[ofs[k]])                            \
+                           + load_macro(_src[ofs[k + 1]])                      \
+                           + load_macro(_src[ofs[k + 2]])                      \
+                           + load_macro(_src[ofs[k + 3]]);                     \
                                                                                \
                 for (; k < area; k++)                                          \
-                    sum += _src[ofs[k]];                                       \
+                    sum += load_macro(_src[ofs[k]]);                           \
                                                                                \
                 dst[dx] = (arrtype)cast_macro(sum * scale);                    \
             }                                                                  \
@@ -433,7 +456,7 @@ typedef struct CvDecimateAlpha
     static CvStatus CV_STDCALL icvResize_Bicubic_##flavor##_CnR(               \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,           \
         int dststep, CvSize dsize, int cn, int xmin, int xmax,                 \
-        const CvResizeAlpha* xofs, float** buf)                                \
+        const CvResizeAlpha* xofs, float** buf, int y0, int y1)                \
     {                                                                          \
         float scale_y = (float)ssize.height / dsize.height;                    \
         int dx, dy, sx, sy, sy2, ify;                                          \
@@ -446,7 +469,7 @@ typedef struct CvDecimateAlpha
         srcstep /= sizeof(src[0]);                                             \
         dststep /= sizeof(dst[0]);                                             \
                                                                                \
-        for (dy = 0; dy < dsize.height; dy++, dst += dststep)                  \
+        for (dy = y0, dst += y0 * dststep; dy < y1; dy++, dst += dststep)      \
         {                                                                      \
             float w0, w1, w2, w3;                                              \
             float fy, x, sum;                                                  \
@@ -506,11 +529,12 @@ typedef struct CvDecimateAlpha
                     int ifx = xofs[dx].ialpha;                                 \
                     int sx0 = xofs[dx].idx;                                    \
                     row[dx] =                                                  \
-                        _src[sx0 - cn] * icvCubicCoeffs[ifx * 2 + 1]           \
-                        + _src[sx0] * icvCubicCoeffs[ifx * 2]                  \
-                        + _src[sx0 + cn]                                       \
+                        load_macro(_src[sx0 - cn])                             \
+                              * icvCubicCoeffs[ifx * 2 + 1]                    \
+                        + load_macro(_src[sx0]) * icvCubicCoeffs[ifx * 2]      \
+                        + load_macro(_src[sx0 + cn])                           \
                               * icvCubicCoeffs[(ICV_CUBIC_TAB_SIZE - ifx) * 2] \
-                        + _src[sx0 + cn * 2]                                   \
+                        + load_macro(_src[sx0 + cn * 2])                       \
                               * icvCubicCoeffs[(ICV_CUBIC_TAB_SIZE - ifx) * 2  \
                                                + 1];                           \
                 }                                                              \
@@ -563,22 +587,28 @@ typedef struct CvDecimateAlpha
         return CV_OK;                                                          \
     }
 
-ICV_DEF_RESIZE_BILINEAR_FUNC(8u, uchar, int, ialpha, ICV_WARP_MUL_ONE_8U,
-                             ICV_WARP_DESCALE_8U)
-ICV_DEF_RESIZE_BILINEAR_FUNC(16u, ushort, float, alpha, CV_NOP, cvRound)
-ICV_DEF_RESIZE_BILINEAR_FUNC(32f, float, float, alpha, CV_NOP, CV_NOP)
+ICV_DEF_RESIZE_BILINEAR_FUNC(8u, uchar, int, ialpha, CV_NOP,
+                             ICV_WARP_MUL_ONE_8U, ICV_WARP_DESCALE_8U)
+ICV_DEF_RESIZE_BILINEAR_FUNC(16u, ushort, float, alpha, CV_NOP, CV_NOP, cvRound)
+ICV_DEF_RESIZE_BILINEAR_FUNC(32f, float, float, alpha, CV_NOP, CV_NOP, CV_NOP)
+ICV_DEF_RESIZE_BILINEAR_FUNC(16f, ushort, float, alpha, cvHalfToFloat, CV_NOP,
+                             cvFloatToHalf)
 
 ICV_DEF_RESIZE_BICUBIC_FUNC(8u, uchar, int, CV_8TO32F, cvRound, CV_CAST_8U)
 ICV_DEF_RESIZE_BICUBIC_FUNC(16u, ushort, int, CV_NOP, cvRound, CV_CAST_16U)
 ICV_DEF_RESIZE_BICUBIC_FUNC(32f, float, float, CV_NOP, CV_NOP, CV_NOP)
+ICV_DEF_RESIZE_BICUBIC_FUNC(16f, ushort, float, cvHalfToFloat, CV_NOP,
+                            cvFloatToHalf)
 
-ICV_DEF_RESIZE_AREA_FAST_FUNC(8u, uchar, int, cvRound)
-ICV_DEF_RESIZE_AREA_FAST_FUNC(16u, ushort, int, cvRound)
-ICV_DEF_RESIZE_AREA_FAST_FUNC(32f, float, float, CV_NOP)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(8u, uchar, int, CV_NOP, cvRound)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(16u, ushort, int, CV_NOP, cvRound)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(32f, float, float, CV_NOP, CV_NOP)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(16f, ushort, float, cvHalfToFloat, cvFloatToHalf)
 
 ICV_DEF_RESIZE_AREA_FUNC(8u, uchar, CV_8TO32F, cvRound)
 ICV_DEF_RESIZE_AREA_FUNC(16u, ushort, CV_NOP, cvRound)
 ICV_DEF_RESIZE_AREA_FUNC(32f, float, CV_NOP, CV_NOP)
+ICV_DEF_RESIZE_AREA_FUNC(16f, ushort, cvHalfToFloat, cvFloatToHalf)
 
 static void icvInitResizeTab(CvFuncTable* bilin_tab, CvFuncTable* bicube_tab,
                              CvFuncTable* areafast_tab, CvFuncTable* area_tab)
@@ -586,37 +616,42 @@ static void icvInitResizeTab(CvFuncTable* bilin_tab, CvFuncTable* bicube_tab,
     bilin_tab->fn_2d[CV_8U] = (void*)icvResize_Bilinear_8u_CnR;
     bilin_tab->fn_2d[CV_16U] = (void*)icvResize_Bilinear_16u_CnR;
     bilin_tab->fn_2d[CV_32F] = (void*)icvResize_Bilinear_32f_CnR;
+    bilin_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvResize_Bilinear_16f_CnR;
 
     bicube_tab->fn_2d[CV_8U] = (void*)icvResize_Bicubic_8u_CnR;
     bicube_tab->fn_2d[CV_16U] = (void*)icvResize_Bicubic_16u_CnR;
     bicube_tab->fn_2d[CV_32F] = (void*)icvResize_Bicubic_32f_CnR;
+    bicube_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvResize_Bicubic_16f_CnR;
 
     areafast_tab->fn_2d[CV_8U] = (void*)icvResize_AreaFast_8u_CnR;
     areafast_tab->fn_2d[CV_16U] = (void*)icvResize_AreaFast_16u_CnR;
     areafast_tab->fn_2d[CV_32F] = (void*)icvResize_AreaFast_32f_CnR;
+    areafast_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvResize_AreaFast_16f_CnR;
 
     area_tab->fn_2d[CV_8U] = (void*)icvResize_Area_8u_CnR;
     area_tab->fn_2d[CV_16U] = (void*)icvResize_Area_16u_CnR;
     area_tab->fn_2d[CV_32F] = (void*)icvResize_Area_32f_CnR;
+    area_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvResize_Area_16f_CnR;
 }
 
 typedef CvStatus(CV_STDCALL* CvResizeBilinearFunc)(
     const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
     CvSize dsize, int cn, int xmax, const CvResizeAlpha* xofs,
-    const CvResizeAlpha* yofs, float* buf0, float* buf1);
+    const CvResizeAlpha* yofs, float* buf0, float* buf1, int y0, int y1);
 
 typedef CvStatus(CV_STDCALL* CvResizeBicubicFunc)(const void* src, int srcstep,
                                                   CvSize ssize, void* dst,
                                                   int dststep, CvSize dsize,
                                                   int cn, int xmin, int xmax,
                                                   const CvResizeAlpha* xofs,
-                                                  float** buf);
+                                                  float** buf, int y0, int y1);
 
 typedef CvStatus(CV_STDCALL* CvResizeAreaFastFunc)(const void* src, int srcstep,
                                                    CvSize ssize, void* dst,
                                                    int dststep, CvSize dsize,
                                                    int cn, const int* ofs,
-                                                   const int* xofs);
+                                                   const int* xofs, int y0,
+                                                   int y1);
 
 typedef CvStatus(CV_STDCALL* CvResizeAreaFunc)(
     const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
@@ -643,6 +678,85 @@ typedef CvStatus(CV_STDCALL* CvResizeIPPFunc)(const void* src, CvSize srcsize,
                                               double yfactor,
                                               int interpolation);
 
+/* arguments of the resize functions processing the destination row bands */
+typedef struct CvResizeJob
+{
+    void* func;
+    const CvMat* src;
+    CvMat* dst;
+    CvSize ssize, dsize;
+    int cn, xmin, xmax;
+    const void* xofs;
+    const void* yofs;
+} CvResizeJob;
+
+static int CV_CDECL icvResizeNNBand(int y0, int y1, void* userdata)
+{
+    const CvResizeJob* job = (const CvResizeJob*)userdata;
+    return icvResize_NN_8u_C1R(job->src->data.ptr, job->src->step, job->ssize,
+                               job->dst->data.ptr, job->dst->step, job->dsize,
+                               CV_ELEM_SIZE(job->src->type), y0, y1);
+}
+
+static int CV_CDECL icvResizeAreaFastBand(int y0, int y1, void* userdata)
+{
+    const CvResizeJob* job = (const CvResizeJob*)userdata;
+    return ((CvResizeAreaFastFunc)job->func)(
+        job->src->data.ptr, job->src->step, job->ssize, job->dst->data.ptr,
+        job->dst->step, job->dsize, job->cn, (const int*)job->yofs,
+        (const int*)job->xofs, y0, y1);
+}
+
+static int CV_CDECL icvResizeBilinearBand(int y0, int y1, void* userdata)
+{
+    const CvResizeJob* job = (const CvResizeJob*)userdata;
+    int width = job->dsize.width * job->cn;
+    int buf_size = width * 2 * sizeof(float);
+    float* buf0;
+    void* temp_buf = 0;
+    CvStatus status;
+
+    if (buf_size < CV_MAX_LOCAL_SIZE)
+        buf0 = (float*)cvStackAlloc(buf_size);
+    else if (!(temp_buf = buf0 = (float*)cvScratchAlloc(buf_size)))
+        return CV_OUTOFMEM_ERR;
+
+    status = ((CvResizeBilinearFunc)job->func)(
+        job->src->data.ptr, job->src->step, job->ssize, job->dst->data.ptr,
+        job->dst->step, job->dsize, job->cn, job->xmax,
+        (const CvResizeAlpha*)job->xofs, (const CvResizeAlpha*)job->yofs, buf0,
+        buf0 + width, y0, y1);
+
+    cvScratchFree(&temp_buf);
+    return status;
+}
+
+static int CV_CDECL icvResizeBicubicBand(int y0, int y1, void* userdata)
+{
+    const CvResizeJob* job = (const CvResizeJob*)userdata;
+    int k, width = job->dsize.width * job->cn;
+    int buf_size = width * 4 * sizeof(float);
+    float* buf[4];
+    void* temp_buf = 0;
+    CvStatus status;
+
+    if (buf_size < CV_MAX_LOCAL_SIZE)
+        buf[0] = (float*)cvStackAlloc(buf_size);
+    else if (!(temp_buf = buf[0] = (float*)cvScratchAlloc(buf_size)))
+        return CV_OUTOFMEM_ERR;
+
+    for (k = 1; k < 4; k++)
+        buf[k] = buf[k - 1] + width;
+
+    status = ((CvResizeBicubicFunc)job->func)(
+        job->src->data.ptr, job->src->step, job->ssize, job->dst->data.ptr,
+        job->dst->step, job->dsize, job->cn, job->xmin, job->xmax,
+        (const CvResizeAlpha*)job->xofs, buf, y0, y1);
+
+    cvScratchFree(&temp_buf);
+    return status;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
@@ -658,9 +772,13 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
     CvMat srcstub, *src = (CvMat*)srcarr;
     CvMat dststub, *dst = (CvMat*)dstarr;
     CvSize ssize, dsize;
+    CvResizeJob job;
     float scale_x, scale_y;
     int k, sx, sy, dx, dy;
     int type, depth, cn;
+    int half = method & CV_WARP_16F;
+
+    method &= ~CV_WARP_16F;
 
     CV_CALL(src = cvGetMat(srcarr, &srcstub));
     CV_CALL(dst = cvGetMat(dstarr, &dststub));
@@ -685,12 +803,20 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
     scale_x = (float)ssize.width / dsize.width;
     scale_y = (float)ssize.height / dsize.height;
 
+    if (half)
+    {
+        if (depth != CV_16U)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Half-float data must be stored in 16u arrays");
+        depth = ICV_DEPTH_16F;
+    }
+
     if (method == CV_INTER_CUBIC
         && (MIN(ssize.width, dsize.width) <= 4
             || MIN(ssize.height, dsize.height) <= 4))
         method = CV_INTER_LINEAR;
 
-    if (icvResize_8u_C1R_p && MIN(ssize.width, dsize.width) > 4
+    if (icvResize_8u_C1R_p && !half && MIN(ssize.width, dsize.width) > 4
         && MIN(ssize.height, dsize.height) > 4)
     {
         CvResizeIPPFunc ipp_func = type == CV_8UC1    ? icvResize_8u_C1R_p
@@ -707,20 +833,25 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
         {
             int srcstep = src->step ? src->step : CV_STUB_STEP;
             int dststep = dst->step ? dst->step : CV_STUB_STEP;
-            IPPI_CALL(
-                ipp_func(src->data.ptr, ssize, srcstep,
+            if (ipp_func(src->data.ptr, ssize, srcstep,
                          cvRect(0, 0, ssize.width, ssize.height), dst->data.ptr,
                          dststep, dsize, (double)dsize.width / ssize.width,
-                         (double)dsize.height / ssize.height, 1 << method));
-            EXIT;
+                         (double)dsize.height / ssize.height, 1 << method)
+                >= 0)
+                EXIT;
         }
     }
 
+    job.src = src;
+    job.dst = dst;
+    job.ssize = ssize;
+    job.dsize = dsize;
+    job.cn = cn;
+
     if (method == CV_INTER_NN)
     {
-        IPPI_CALL(icvResize_NN_8u_C1R(src->data.ptr, src->step, ssize,
-                                      dst->data.ptr, dst->step, dsize,
-                                      CV_ELEM_SIZE(src->type)));
+        IPPI_CALL((CvStatus)cvParallelFor(dsize.height, ICV_WARP_MIN_BAND(dsize),
+                                          icvResizeNNBand, &job));
     }
     else if (method == CV_INTER_LINEAR || method == CV_INTER_AREA)
     {
@@ -735,7 +866,7 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                 && fabs(scale_y - iscale_y) < DBL_EPSILON)
             {
                 int area = iscale_x * iscale_y;
-                int srcstep = src->step / CV_ELEM_SIZE(depth);
+                int srcstep = src->step / CV_ELEM_SIZE1(type);
                 int* ofs =
                     (int*)cvStackAlloc((area + dsize.width * cn) * sizeof(int));
                 int* xofs = ofs + area;
@@ -756,8 +887,12 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                         xofs[dx * cn + k] = sx + k;
                 }
 
-                IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                               dst->step, dsize, cn, ofs, xofs));
+                job.func = (void*)func;
+                job.xofs = xofs;
+                job.yofs = ofs;
+                IPPI_CALL((CvStatus)cvParallelFor(dsize.height,
+                                                  ICV_WARP_MIN_BAND(dsize),
+                                                  icvResizeAreaFastBand, &job));
             }
             else
             {
@@ -775,7 +910,8 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                 if (buf_size < CV_MAX_LOCAL_SIZE)
                     buf = (float*)cvStackAlloc(buf_size);
                 else
-                    CV_CALL(temp_buf = buf = (float*)cvAlloc(buf_size));
+                    CV_CALL(temp_buf = buf =
+                                (float*)cvScratchAlloc(buf_size));
                 sum = buf + buf_len;
                 xofs = (CvDecimateAlpha*)(sum + buf_len);
 
@@ -829,7 +965,6 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
             float inv_scale_x = (float)dsize.width / ssize.width;
             float inv_scale_y = (float)dsize.height / ssize.height;
             int xmax = dsize.width, width = dsize.width * cn, buf_size;
-            float *buf0, *buf1;
             CvResizeAlpha *xofs, *yofs;
             int area_mode = method == CV_INTER_AREA;
             float fx, fy;
@@ -839,14 +974,12 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
             if (!func)
                 CV_ERROR(CV_StsUnsupportedFormat, "");
 
-            buf_size = width * 2 * sizeof(float)
-                       + (width + dsize.height) * sizeof(CvResizeAlpha);
+            buf_size = (width + dsize.height) * sizeof(CvResizeAlpha);
             if (buf_size < CV_MAX_LOCAL_SIZE)
-                buf0 = (float*)cvStackAlloc(buf_size);
+                xofs = (CvResizeAlpha*)cvStackAlloc(buf_size);
             else
-                CV_CALL(temp_buf = buf0 = (float*)cvAlloc(buf_size));
-            buf1 = buf0 + width;
-            xofs = (CvResizeAlpha*)(buf1 + width);
+                CV_CALL(temp_buf = xofs =
+                            (CvResizeAlpha*)cvScratchAlloc(buf_size));
             yofs = xofs + width;
 
             for (dx = 0; dx < dsize.width; dx++)
@@ -909,8 +1042,13 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                     yofs[dy].ialpha = CV_FLT_TO_FIX(fy, ICV_WARP_SHIFT);
             }
 
-            IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                           dst->step, dsize, cn, xmax, xofs, yofs, buf0, buf1));
+            job.func = (void*)func;
+            job.xmax = xmax;
+            job.xofs = xofs;
+            job.yofs = yofs;
+            IPPI_CALL((CvStatus)cvParallelFor(dsize.height,
+                                              ICV_WARP_MIN_BAND(dsize),
+                                              icvResizeBilinearBand, &job));
         }
     }
     else if (method == CV_INTER_CUBIC)
@@ -918,21 +1056,16 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
         int width = dsize.width * cn, buf_size;
         int xmin = dsize.width, xmax = -1;
         CvResizeAlpha* xofs;
-        float* buf[4];
         CvResizeBicubicFunc func = (CvResizeBicubicFunc)bicube_tab.fn_2d[depth];
 
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        buf_size = width * (4 * sizeof(float) + sizeof(xofs[0]));
+        buf_size = width * sizeof(xofs[0]);
         if (buf_size < CV_MAX_LOCAL_SIZE)
-            buf[0] = (float*)cvStackAlloc(buf_size);
+            xofs = (CvResizeAlpha*)cvStackAlloc(buf_size);
         else
-            CV_CALL(temp_buf = buf[0] = (float*)cvAlloc(buf_size));
-
-        for (k = 1; k < 4; k++)
-            buf[k] = buf[k - 1] + width;
-        xofs = (CvResizeAlpha*)(buf[3] + width);
+            CV_CALL(temp_buf = xofs = (CvResizeAlpha*)cvScratchAlloc(buf_size));
 
         icvInitCubicCoeffTab();
 
@@ -963,15 +1096,38 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
             }
         }
 
-        IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                       dst->step, dsize, cn, xmin, xmax, xofs, buf));
+        job.func = (void*)func;
+        job.xmin = xmin;
+        job.xmax = xmax;
+        job.xofs = xofs;
+        IPPI_CALL((CvStatus)cvParallelFor(dsize.height,
+                                          ICV_WARP_MIN_BAND(dsize),
+                                          icvResizeBicubicBand, &job));
     }
     else
         CV_ERROR(CV_StsBadFlag, "Unknown/unsupported interpolation method");
 
     __END__;
 
-    cvFree(&temp_buf);
+    cvScratchFree(&temp_buf);
+}
+
+CV_IMPL void cvResizePlanes(const CvArr** src, CvArr** dst, int count,
+                            int method)
+{
+    CV_FUNCNAME("cvResizePlanes");
+
+    __BEGIN__;
+
+    int i;
+
+    if (!src || !dst)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    for (i = 0; i < count; i++)
+        CV_CALL(cvResize(src[i], dst[i], method));
+
+    __END__;
 }
 
 /****************************************************************************************\
@@ -979,12 +1135,13 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
 \****************************************************************************************/
 
 #define ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(flavor, arrtype, worktype,           \
-                                          scale_alpha_macro, mul_one_macro,    \
-                                          descale_macro, cast_macro)           \
+                                          scale_alpha_macro, load_macro,       \
+                                          mul_one_macro, descale_macro,        \
+                                          cast_macro)                          \
     static CvStatus CV_STDCALL icvWarpAffine_Bilinear_##flavor##_CnR(          \
         const arrtype* src, int step, CvSize ssize, arrtype* dst, int dststep, \
         CvSize dsize, const double* matrix, int cn, const arrtype* fillval,    \
-        const int* ofs)                                                        \
+        const int* ofs, int y0, int y1)                                        \
     {                                                                          \
         int x, y, k;                                                           \
         double A12 = matrix[1], b1 = matrix[2];                                \
@@ -993,7 +1150,7 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
         step /= sizeof(src[0]);                                                \
         dststep /= sizeof(dst[0]);                                             \
                                                                                \
-        for (y = 0; y < dsize.height; y++, dst += dststep)                     \
+        for (y = y0, dst += y0 * dststep; y < y1; y++, dst += dststep)         \
         {                                                                      \
             int xs = CV_FLT_TO_FIX(A12 * y + b1, ICV_WARP_SHIFT);              \
             int ys = CV_FLT_TO_FIX(A22 * y + b2, ICV_WARP_SHIFT);              \
@@ -1015,10 +1172,14 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                                                                                \
                     for (k = 0; k < cn; k++)                                   \
                     {                                                          \
-                        p0 = mul_one_macro(ptr[k])                             \
-                             + a * (ptr[k + cn] - ptr[k]);                     \
-                        p1 = mul_one_macro(ptr[k + step])                      \
-                             + a * (ptr[k + cn + step] - ptr[k + step]);       \
+                        p0 = mul_one_macro(load_macro(ptr[k]))                 \
+                             + a                                               \
+                                   * (load_macro(ptr[k + cn])                  \
+                                      - load_macro(ptr[k]));                   \
+                        p1 = mul_one_macro(load_macro(ptr[k + step]))          \
+                             + a                                               \
+                                   * (load_macro(ptr[k + cn + step])           \
+                                      - load_macro(ptr[k + step]));            \
                         p0 = descale_macro(mul_one_macro(p0) + b * (p1 - p0)); \
                         dst[x * cn + k] = (arrtype)cast_macro(p0);             \
                     }                                                          \
@@ -1040,8 +1201,14 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                                                                                \
                     for (k = 0; k < cn; k++)                                   \
                     {                                                          \
-                        p0 = mul_one_macro(ptr0[k]) + a * (ptr1[k] - ptr0[k]); \
-                        p1 = mul_one_macro(ptr2[k]) + a * (ptr3[k] - ptr2[k]); \
+                        p0 = mul_one_macro(load_macro(ptr0[k]))                \
+                             + a                                               \
+                                   * (load_macro(ptr1[k])                      \
+                                      - load_macro(ptr0[k]));                  \
+                        p1 = mul_one_macro(load_macro(ptr2[k]))                \
+                             + a                                               \
+                                   * (load_macro(ptr3[k])                      \
+                                      - load_macro(ptr2[k]));                  \
                         p0 = descale_macro(mul_one_macro(p0) + b * (p1 - p0)); \
                         dst[x * cn + k] = (arrtype)cast_macro(p0);             \
                     }                                                          \
@@ -1057,28 +1224,32 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
 
 #define ICV_WARP_SCALE_ALPHA(x) ((x) * (1. / (ICV_WARP_MASK + 1)))
 
-ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(8u, uchar, int, CV_NOP, ICV_WARP_MUL_ONE_8U,
-                                  ICV_WARP_DESCALE_8U, CV_NOP)
+ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(8u, uchar, int, CV_NOP, CV_NOP,
+                                  ICV_WARP_MUL_ONE_8U, ICV_WARP_DESCALE_8U,
+                                  CV_NOP)
 // ICV_DEF_WARP_AFFINE_BILINEAR_FUNC( 8u, uchar, double, ICV_WARP_SCALE_ALPHA,
 // CV_NOP,
 //                                    CV_NOP, ICV_WARP_CAST_8U )
 ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(16u, ushort, double, ICV_WARP_SCALE_ALPHA,
-                                  CV_NOP, CV_NOP, cvRound)
+                                  CV_NOP, CV_NOP, CV_NOP, cvRound)
 ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(32f, float, double, ICV_WARP_SCALE_ALPHA,
-                                  CV_NOP, CV_NOP, CV_NOP)
+                                  CV_NOP, CV_NOP, CV_NOP, CV_NOP)
+ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(16f, ushort, double, ICV_WARP_SCALE_ALPHA,
+                                  cvHalfToFloat, CV_NOP, CV_NOP, cvFloatToHalf)
 
 typedef CvStatus(CV_STDCALL* CvWarpAffineFunc)(const void* src, int srcstep,
                                                CvSize ssize, void* dst,
                                                int dststep, CvSize dsize,
                                                const double* matrix, int cn,
                                                const void* fillval,
-                                               const int* ofs);
+                                               const int* ofs, int y0, int y1);
 
 static void icvInitWarpAffineTab(CvFuncTable* bilin_tab)
 {
     bilin_tab->fn_2d[CV_8U] = (void*)icvWarpAffine_Bilinear_8u_CnR;
     bilin_tab->fn_2d[CV_16U] = (void*)icvWarpAffine_Bilinear_16u_CnR;
     bilin_tab->fn_2d[CV_32F] = (void*)icvWarpAffine_Bilinear_32f_CnR;
+    bilin_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvWarpAffine_Bilinear_16f_CnR;
 }
 
 /////////////////////////////// IPP warpaffine functions
@@ -1095,6 +1266,44 @@ typedef CvStatus(CV_STDCALL* CvWarpAffineBackIPPFunc)(
     const void* src, CvSize srcsize, int srcstep, CvRect srcroi, void* dst,
     int dststep, CvRect dstroi, const double* coeffs, int interpolation);
 
+/* arguments of the warp functions processing the destination row bands */
+typedef struct CvWarpJob
+{
+    void* func;
+    const CvMat* src;
+    CvMat* dst;
+    CvSize ssize, dsize;
+    int srcstep, dststep;
+    const double* matrix;
+    int cn;
+    const void* fillval;
+    const int* ofs;
+    int interpolation;
+} CvWarpJob;
+
+/* the IPP warps (affine and perspective ones have the same signature) get
+   the band as the destination ROI */
+static int CV_CDECL icvWarpIPPBand(int y0, int y1, void* userdata)
+{
+    const CvWarpJob* job = (const CvWarpJob*)userdata;
+    CvRect srcroi = {0, 0, job->ssize.width, job->ssize.height};
+    CvRect dstroi = {0, y0, job->dsize.width, y1 - y0};
+
+    return ((CvWarpAffineBackIPPFunc)job->func)(
+        job->src->data.ptr, job->ssize, job->srcstep, srcroi,
+        job->dst->data.ptr, job->dststep, dstroi, job->matrix,
+        job->interpolation);
+}
+
+static int CV_CDECL icvWarpAffineBand(int y0, int y1, void* userdata)
+{
+    const CvWarpJob* job = (const CvWarpJob*)userdata;
+    return ((CvWarpAffineFunc)job->func)(
+        job->src->data.ptr, job->src->step, job->ssize, job->dst->data.ptr,
+        job->dst->step, job->dsize, job->matrix, job->cn, job->fillval,
+        job->ofs, y0, y1);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 CV_IMPL void cvWarpAffine(const CvArr* srcarr, CvArr* dstarr,
@@ -1113,9 +1322,11 @@ CV_IMPL void cvWarpAffine(const CvArr* srcarr, CvArr* dstarr,
     double src_matrix[6], dst_matrix[6];
     double fillbuf[4];
     int method = flags & 3;
+    int half = flags & CV_WARP_16F;
     CvMat srcAb = cvMat(2, 3, CV_64F, src_matrix),
           dstAb = cvMat(2, 3, CV_64F, dst_matrix), A, b, invA, invAb;
     CvWarpAffineFunc func;
+    CvWarpJob job;
     CvSize ssize, dsize;
 
     if (!inittab)
@@ -1156,10 +1367,25 @@ CV_IMPL void cvWarpAffine(const CvArr* srcarr, CvArr* dstarr,
     if (cn > 4)
         CV_ERROR(CV_BadNumChannels, "");
 
+    if (half)
+    {
+        if (depth != CV_16U)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Half-float data must be stored in 16u arrays");
+        depth = ICV_DEPTH_16F;
+    }
+
     ssize = cvGetMatSize(src);
     dsize = cvGetMatSize(dst);
 
-    if (icvWarpAffineBack_8u_C1R_p && MIN(ssize.width, dsize.width) >= 4
+    job.src = src;
+    job.dst = dst;
+    job.ssize = ssize;
+    job.dsize = dsize;
+    job.matrix = dst_matrix;
+    job.cn = cn;
+
+    if (icvWarpAffineBack_8u_C1R_p && !half && MIN(ssize.width, dsize.width) >= 4
         && MIN(ssize.height, dsize.height) >= 4)
     {
         CvWarpAffineBackIPPFunc ipp_func =
@@ -1173,23 +1399,25 @@ CV_IMPL void cvWarpAffine(const CvArr* srcarr, CvArr* dstarr,
 
         if (ipp_func && CV_INTER_NN <= method && method <= CV_INTER_AREA)
         {
-            int srcstep = src->step ? src->step : CV_STUB_STEP;
-            int dststep = dst->step ? dst->step : CV_STUB_STEP;
-            CvRect srcroi = {0, 0, ssize.width, ssize.height};
-            CvRect dstroi = {0, 0, dsize.width, dsize.height};
-
             // this is not the most efficient way to fill outliers
             if (flags & CV_WARP_FILL_OUTLIERS)
                 cvSet(dst, fillval);
 
-            if (ipp_func(src->data.ptr, ssize, srcstep, srcroi, dst->data.ptr,
-                         dststep, dstroi, dstAb.data.db, 1 << method)
+            job.func = (void*)ipp_func;
+            job.srcstep = src->step ? src->step : CV_STUB_STEP;
+            job.dststep = dst->step ? dst->step : CV_STUB_STEP;
+            job.interpolation = 1 << method;
+            if (cvParallelFor(dsize.height, ICV_WARP_MIN_BAND(dsize),
+                              icvWarpIPPBand, &job)
                 >= 0)
                 EXIT;
         }
     }
 
-    cvScalarToRawData(&fillval, fillbuf, CV_MAT_TYPE(src->type), 0);
+    if (half)
+        icvScalarToHalf(&fillval, (ushort*)fillbuf, cn);
+    else
+        cvScalarToRawData(&fillval, fillbuf, CV_MAT_TYPE(src->type), 0);
     ofs = (int*)cvStackAlloc(dst->cols * 2 * sizeof(ofs[0]));
     for (k = 0; k < dst->cols; k++)
     {
@@ -1203,14 +1431,37 @@ CV_IMPL void cvWarpAffine(const CvArr* srcarr, CvArr* dstarr,
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                       dst->step, dsize, dst_matrix, cn,
-                       flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0, ofs));
+        job.func = (void*)func;
+        job.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        job.ofs = ofs;
+        IPPI_CALL((CvStatus)cvParallelFor(dsize.height,
+                                          ICV_WARP_MIN_BAND(dsize),
+                                          icvWarpAffineBand, &job));
     }
 
     __END__;
 }
 
+CV_IMPL void cvWarpAffinePlanes(const CvArr** src, CvArr** dst, int count,
+                                const CvMat* matrix, int flags,
+                                CvScalar fillval)
+{
+    CV_FUNCNAME("cvWarpAffinePlanes");
+
+    __BEGIN__;
+
+    int i;
+
+    if (!src || !dst)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    for (i = 0; i < count; i++)
+        CV_CALL(cvWarpAffine(src[i], dst[i], matrix, flags,
+                             cvScalarAll(fillval.val[MIN(i, 3)])));
+
+    __END__;
+}
+
 CV_IMPL CvMat* cv2DRotationMatrix(CvPoint2D32f center, double angle,
                                   double scale, CvMat* matrix)
 {
@@ -1251,7 +1502,8 @@ CV_IMPL CvMat* cv2DRotationMatrix(CvPoint2D32f center, double angle,
                                                cast_macro)                     \
     static CvStatus CV_STDCALL icvWarpPerspective_Bilinear_##flavor##_CnR(     \
         const arrtype* src, int step, CvSize ssize, arrtype* dst, int dststep, \
-        CvSize dsize, const double* matrix, int cn, const arrtype* fillval)    \
+        CvSize dsize, const double* matrix, int cn, const arrtype* fillval,    \
+        int y0, int y1)                                                        \
     {                                                                          \
         int x, y, k;                                                           \
         float A11 = (float)matrix[0], A12 = (float)matrix[1],                  \
@@ -1264,7 +1516,7 @@ CV_IMPL CvMat* cv2DRotationMatrix(CvPoint2D32f center, double angle,
         step /= sizeof(src[0]);                                                \
         dststep /= sizeof(dst[0]);                                             \
                                                                                \
-        for (y = 0; y < dsize.height; y++, dst += dststep)                     \
+        for (y = y0, dst += y0 * dststep; y < y1; y++, dst += dststep)         \
         {                                                                      \
             float xs0 = A12 * y + A13;                                         \
             float ys0 = A22 * y + A23;                                         \
@@ -1342,16 +1594,30 @@ CV_IMPL CvMat* cv2DRotationMatrix(CvPoint2D32f center, double angle,
 ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(8u, uchar, CV_8TO32F, cvRound)
 ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(16u, ushort, CV_NOP, cvRound)
 ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(32f, float, CV_NOP, CV_NOP)
+ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(16f, ushort, cvHalfToFloat,
+                                       cvFloatToHalf)
 
 typedef CvStatus(CV_STDCALL* CvWarpPerspectiveFunc)(
     const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
-    CvSize dsize, const double* matrix, int cn, const void* fillval);
+    CvSize dsize, const double* matrix, int cn, const void* fillval, int y0,
+    int y1);
+
+static int CV_CDECL icvWarpPerspectiveBand(int y0, int y1, void* userdata)
+{
+    const CvWarpJob* job = (const CvWarpJob*)userdata;
+    return ((CvWarpPerspectiveFunc)job->func)(
+        job->src->data.ptr, job->src->step, job->ssize, job->dst->data.ptr,
+        job->dst->step, job->dsize, job->matrix, job->cn, job->fillval, y0,
+        y1);
+}
 
 static void icvInitWarpPerspectiveTab(CvFuncTable* bilin_tab)
 {
     bilin_tab->fn_2d[CV_8U] = (void*)icvWarpPerspective_Bilinear_8u_CnR;
     bilin_tab->fn_2d[CV_16U] = (void*)icvWarpPerspective_Bilinear_16u_CnR;
     bilin_tab->fn_2d[CV_32F] = (void*)icvWarpPerspective_Bilinear_32f_CnR;
+    bilin_tab->fn_2d[ICV_DEPTH_16F] =
+        (void*)icvWarpPerspective_Bilinear_16f_CnR;
 }
 
 /////////////////////////// IPP warpperspective functions
@@ -1391,11 +1657,13 @@ CV_IMPL void cvWarpPerspective(const CvArr* srcarr, CvArr* dstarr,
     CvMat dststub, *dst = (CvMat*)dstarr;
     int type, depth, cn;
     int method = flags & 3;
+    int half = flags & CV_WARP_16F;
     double src_matrix[9], dst_matrix[9];
     double fillbuf[4];
     CvMat A = cvMat(3, 3, CV_64F, src_matrix),
           invA = cvMat(3, 3, CV_64F, dst_matrix);
     CvWarpPerspectiveFunc func;
+    CvWarpJob job;
     CvSize ssize, dsize;
 
     if (method == CV_INTER_NN || method == CV_INTER_AREA)
@@ -1433,10 +1701,25 @@ CV_IMPL void cvWarpPerspective(const CvArr* srcarr, CvArr* dstarr,
     if (cn > 4)
         CV_ERROR(CV_BadNumChannels, "");
 
+    if (half)
+    {
+        if (depth != CV_16U)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Half-float data must be stored in 16u arrays");
+        depth = ICV_DEPTH_16F;
+    }
+
     ssize = cvGetMatSize(src);
     dsize = cvGetMatSize(dst);
 
-    if (icvWarpPerspectiveBack_8u_C1R_p)
+    job.src = src;
+    job.dst = dst;
+    job.ssize = ssize;
+    job.dsize = dsize;
+    job.matrix = dst_matrix;
+    job.cn = cn;
+
+    if (icvWarpPerspectiveBack_8u_C1R_p && !half)
     {
         CvWarpPerspectiveBackIPPFunc ipp_func =
             type == CV_8UC1    ? icvWarpPerspectiveBack_8u_C1R_p
@@ -1451,20 +1734,17 @@ CV_IMPL void cvWarpPerspective(const CvArr* srcarr, CvArr* dstarr,
             && MIN(ssize.width, ssize.height) >= 4
             && MIN(dsize.width, dsize.height) >= 4)
         {
-            int srcstep = src->step ? src->step : CV_STUB_STEP;
-            int dststep = dst->step ? dst->step : CV_STUB_STEP;
-            CvStatus status;
-            CvRect srcroi = {0, 0, ssize.width, ssize.height};
-            CvRect dstroi = {0, 0, dsize.width, dsize.height};
-
             // this is not the most efficient way to fill outliers
             if (flags & CV_WARP_FILL_OUTLIERS)
                 cvSet(dst, fillval);
 
-            status =
-                ipp_func(src->data.ptr, ssize, srcstep, srcroi, dst->data.ptr,
-                         dststep, dstroi, invA.data.db, 1 << method);
-            if (status >= 0)
+            job.func = (void*)ipp_func;
+            job.srcstep = src->step ? src->step : CV_STUB_STEP;
+            job.dststep = dst->step ? dst->step : CV_STUB_STEP;
+            job.interpolation = 1 << method;
+            if (cvParallelFor(dsize.height, ICV_WARP_MIN_BAND(dsize),
+                              icvWarpIPPBand, &job)
+                >= 0)
                 EXIT;
 
             ipp_func = type == CV_8UC1    ? icvWarpPerspective_8u_C1R_p
@@ -1480,16 +1760,21 @@ CV_IMPL void cvWarpPerspective(const CvArr* srcarr, CvArr* dstarr,
                 if (flags & CV_WARP_INVERSE_MAP)
                     cvInvert(&invA, &A, CV_SVD);
 
-                status = ipp_func(src->data.ptr, ssize, srcstep, srcroi,
-                                  dst->data.ptr, dststep, dstroi, A.data.db,
-                                  1 << method);
-                if (status >= 0)
+                job.func = (void*)ipp_func;
+                job.matrix = A.data.db;
+                if (cvParallelFor(dsize.height, ICV_WARP_MIN_BAND(dsize),
+                                  icvWarpIPPBand, &job)
+                    >= 0)
                     EXIT;
+                job.matrix = dst_matrix;
             }
         }
     }
 
-    cvScalarToRawData(&fillval, fillbuf, CV_MAT_TYPE(src->type), 0);
+    if (half)
+        icvScalarToHalf(&fillval, (ushort*)fillbuf, cn);
+    else
+        cvScalarToRawData(&fillval, fillbuf, CV_MAT_TYPE(src->type), 0);
 
     /*if( method == CV_INTER_LINEAR )*/
     {
@@ -1497,14 +1782,36 @@ CV_IMPL void cvWarpPerspective(const CvArr* srcarr, CvArr* dstarr,
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                       dst->step, dsize, dst_matrix, cn,
-                       flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0));
+        job.func = (void*)func;
+        job.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        IPPI_CALL((CvStatus)cvParallelFor(dsize.height,
+                                          ICV_WARP_MIN_BAND(dsize),
+                                          icvWarpPerspectiveBand, &job));
     }
 
     __END__;
 }
 
+CV_IMPL void cvWarpPerspectivePlanes(const CvArr** src, CvArr** dst, int count,
+                                     const CvMat* matrix, int flags,
+                                     CvScalar fillval)
+{
+    CV_FUNCNAME("cvWarpPerspectivePlanes");
+
+    __BEGIN__;
+
+    int i;
+
+    if (!src || !dst)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    for (i = 0; i < count; i++)
+        CV_CALL(cvWarpPerspective(src[i], dst[i], matrix, flags,
+                                  cvScalarAll(fillval.val[MIN(i, 3)])));
+
+    __END__;
+}
+
 /* Calculates coefficients of perspective transformation
  * which maps (xi,yi) to (ui,vi), (i=1,2,3,4):
  *
@@ -1804,10 +2111,163 @@ CV_IMPL CvMat* cvGetAffineTransform(const CvPoint2D32f* src,
 ICV_DEF_REMAP_BILINEAR_FUNC(8u, uchar, CV_8TO32F, cvRound)
 ICV_DEF_REMAP_BILINEAR_FUNC(16u, ushort, CV_NOP, cvRound)
 ICV_DEF_REMAP_BILINEAR_FUNC(32f, float, CV_NOP, CV_NOP)
+ICV_DEF_REMAP_BILINEAR_FUNC(16f, ushort, cvHalfToFloat, cvFloatToHalf)
 
 ICV_DEF_REMAP_BICUBIC_FUNC(8u, uchar, int, CV_8TO32F, cvRound, CV_FAST_CAST_8U)
 ICV_DEF_REMAP_BICUBIC_FUNC(16u, ushort, int, CV_NOP, cvRound, CV_CAST_16U)
 ICV_DEF_REMAP_BICUBIC_FUNC(32f, float, float, CV_NOP, CV_NOP, CV_NOP)
+ICV_DEF_REMAP_BICUBIC_FUNC(16f, ushort, float, cvHalfToFloat, CV_NOP,
+                           cvFloatToHalf)
+
+/* bilinear weights of the fixed-point maps: 8u ones are scaled by
+   1 << ICV_REMAP_FIX_WEIGHT_SHIFT and sum up to exactly that */
+#define ICV_REMAP_FIX_WEIGHT_SHIFT 15
+#define ICV_REMAP_FIX_DESCALE_8U(x) CV_DESCALE((x), ICV_REMAP_FIX_WEIGHT_SHIFT)
+
+static int icvRemapFixTab_8u[ICV_REMAP_FIX_TAB_SIZE][4];
+static float icvRemapFixTab_32f[ICV_REMAP_FIX_TAB_SIZE][4];
+
+static void icvInitRemapFixTab()
+{
+    static int inittab = 0;
+    if (!inittab)
+    {
+        int i, j, k;
+        float scale = 1.f / (ICV_REMAP_FIX_MASK + 1);
+
+        for (i = 0; i <= ICV_REMAP_FIX_MASK; i++)
+            for (j = 0; j <= ICV_REMAP_FIX_MASK; j++)
+            {
+                int idx = (i << ICV_REMAP_FIX_SHIFT) + j, sum = 0, kmax = 0;
+                float* w = icvRemapFixTab_32f[idx];
+                int* iw = icvRemapFixTab_8u[idx];
+                float a = j * scale, b = i * scale;
+
+                w[0] = (1.f - a) * (1.f - b);
+                w[1] = a * (1.f - b);
+                w[2] = (1.f - a) * b;
+                w[3] = a * b;
+
+                for (k = 0; k < 4; k++)
+                {
+                    iw[k] = cvRound(w[k] * (1 << ICV_REMAP_FIX_WEIGHT_SHIFT));
+                    sum += iw[k];
+                    if (iw[k] > iw[kmax])
+                        kmax = k;
+                }
+
+                // put the rounding error into the largest weight
+                iw[kmax] += (1 << ICV_REMAP_FIX_WEIGHT_SHIFT) - sum;
+            }
+
+        inittab = 1;
+    }
+}
+
+void icvConvertMapRow(const float* mapx, const float* mapy, short* mapxy,
+                      ushort* mapa, int width)
+{
+    int j;
+
+    if (mapa)
+        for (j = 0; j < width; j++)
+        {
+            float x = MIN(MAX(mapx[j], (float)SHRT_MIN), (float)SHRT_MAX);
+            float y = MIN(MAX(mapy[j], (float)SHRT_MIN), (float)SHRT_MAX);
+            int ix = cvRound(x * (ICV_REMAP_FIX_MASK + 1));
+            int iy = cvRound(y * (ICV_REMAP_FIX_MASK + 1));
+
+            mapxy[j * 2] = (short)CV_CAST_16S(ix >> ICV_REMAP_FIX_SHIFT);
+            mapxy[j * 2 + 1] = (short)CV_CAST_16S(iy >> ICV_REMAP_FIX_SHIFT);
+            mapa[j] = (ushort)(((iy & ICV_REMAP_FIX_MASK) << ICV_REMAP_FIX_SHIFT)
+                               + (ix & ICV_REMAP_FIX_MASK));
+        }
+    else
+        for (j = 0; j < width; j++)
+        {
+            float x = MIN(MAX(mapx[j], (float)SHRT_MIN), (float)SHRT_MAX);
+            float y = MIN(MAX(mapy[j], (float)SHRT_MIN), (float)SHRT_MAX);
+
+            mapxy[j * 2] = (short)cvRound(x);
+            mapxy[j * 2 + 1] = (short)cvRound(y);
+        }
+}
+
+/* remaps with the fixed-point maps; without the fractional map or with
+   CV_INTER_NN it is a pure gather */
+#define ICV_DEF_REMAP_FIXED_FUNC(flavor, arrtype, worktype, load_macro,        \
+                                 cast_macro)                                   \
+    static CvStatus CV_STDCALL icvRemap_Fixed_##flavor##_CnR(                  \
+        const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,           \
+        int dststep, CvSize dsize, const short* mapxy, int xystep,             \
+        const ushort* mapa, int astep, int cn, const arrtype* fillval,         \
+        int nearest, const worktype(*tab)[4])                                  \
+    {                                                                          \
+        int i, j, k;                                                           \
+                                                                               \
+        srcstep /= sizeof(src[0]);                                             \
+        dststep /= sizeof(dst[0]);                                             \
+        xystep /= sizeof(mapxy[0]);                                            \
+        astep /= sizeof(ushort);                                               \
+                                                                               \
+        for (i = 0; i < dsize.height;                                          \
+             i++, dst += dststep, mapxy += xystep, mapa += astep)              \
+        {                                                                      \
+            if (mapa && !nearest)                                              \
+                for (j = 0; j < dsize.width; j++)                              \
+                {                                                              \
+                    unsigned sx = mapxy[j * 2], sy = mapxy[j * 2 + 1];         \
+                                                                               \
+                    if (sx < (unsigned)(ssize.width - 1)                       \
+                        && sy < (unsigned)(ssize.height - 1))                  \
+                    {                                                          \
+                        const arrtype* s = src + sy * srcstep + sx * cn;       \
+                        const worktype* w = tab[mapa[j]];                      \
+                                                                               \
+                        for (k = 0; k < cn; k++, s++)                          \
+                            dst[j * cn + k] = (arrtype)cast_macro(             \
+                                load_macro(s[0]) * w[0]                        \
+                                + load_macro(s[cn]) * w[1]                     \
+                                + load_macro(s[srcstep]) * w[2]                \
+                                + load_macro(s[srcstep + cn]) * w[3]);         \
+                    }                                                          \
+                    else if (fillval)                                          \
+                        for (k = 0; k < cn; k++)                               \
+                            dst[j * cn + k] = fillval[k];                      \
+                }                                                              \
+            else                                                               \
+                for (j = 0; j < dsize.width; j++)                              \
+                {                                                              \
+                    int sx = mapxy[j * 2], sy = mapxy[j * 2 + 1];              \
+                                                                               \
+                    if (mapa)                                                  \
+                    {                                                          \
+                        /* round to the nearest pixel */                       \
+                        int a = mapa[j];                                       \
+                        sx += (a >> (ICV_REMAP_FIX_SHIFT - 1)) & 1;            \
+                        sy += a >> (ICV_REMAP_FIX_SHIFT * 2 - 1);              \
+                    }                                                          \
+                                                                               \
+                    if ((unsigned)sx < (unsigned)ssize.width                   \
+                        && (unsigned)sy < (unsigned)ssize.height)              \
+                    {                                                          \
+                        const arrtype* s = src + sy * srcstep + sx * cn;       \
+                        for (k = 0; k < cn; k++)                               \
+                            dst[j * cn + k] = s[k];                            \
+                    }                                                          \
+                    else if (fillval)                                          \
+                        for (k = 0; k < cn; k++)                               \
+                            dst[j * cn + k] = fillval[k];                      \
+                }                                                              \
+        }                                                                      \
+                                                                               \
+        return CV_OK;                                                          \
+    }
+
+ICV_DEF_REMAP_FIXED_FUNC(8u, uchar, int, CV_NOP, ICV_REMAP_FIX_DESCALE_8U)
+ICV_DEF_REMAP_FIXED_FUNC(16u, ushort, float, CV_NOP, cvRound)
+ICV_DEF_REMAP_FIXED_FUNC(32f, float, float, CV_NOP, CV_NOP)
+ICV_DEF_REMAP_FIXED_FUNC(16f, ushort, float, cvHalfToFloat, cvFloatToHalf)
 
 typedef CvStatus(CV_STDCALL* CvRemapFunc)(const void* src, int srcstep,
                                           CvSize ssize, void* dst, int dststep,
@@ -1816,15 +2276,28 @@ typedef CvStatus(CV_STDCALL* CvRemapFunc)(const void* src, int srcstep,
                                           int mystep, int cn,
                                           const void* fillval);
 
-static void icvInitRemapTab(CvFuncTable* bilinear_tab, CvFuncTable* bicubic_tab)
+typedef CvStatus(CV_STDCALL* CvRemapFixedFunc)(
+    const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
+    CvSize dsize, const short* mapxy, int xystep, const ushort* mapa,
+    int astep, int cn, const void* fillval, int nearest, const void* tab);
+
+static void icvInitRemapTab(CvFuncTable* bilinear_tab, CvFuncTable* bicubic_tab,
+                            CvFuncTable* fixed_tab)
 {
     bilinear_tab->fn_2d[CV_8U] = (void*)icvRemap_Bilinear_8u_CnR;
     bilinear_tab->fn_2d[CV_16U] = (void*)icvRemap_Bilinear_16u_CnR;
     bilinear_tab->fn_2d[CV_32F] = (void*)icvRemap_Bilinear_32f_CnR;
+    bilinear_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvRemap_Bilinear_16f_CnR;
 
     bicubic_tab->fn_2d[CV_8U] = (void*)icvRemap_Bicubic_8u_CnR;
     bicubic_tab->fn_2d[CV_16U] = (void*)icvRemap_Bicubic_16u_CnR;
     bicubic_tab->fn_2d[CV_32F] = (void*)icvRemap_Bicubic_32f_CnR;
+    bicubic_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvRemap_Bicubic_16f_CnR;
+
+    fixed_tab->fn_2d[CV_8U] = (void*)icvRemap_Fixed_8u_CnR;
+    fixed_tab->fn_2d[CV_16U] = (void*)icvRemap_Fixed_16u_CnR;
+    fixed_tab->fn_2d[CV_32F] = (void*)icvRemap_Fixed_32f_CnR;
+    fixed_tab->fn_2d[ICV_DEPTH_16F] = (void*)icvRemap_Fixed_16f_CnR;
 }
 
 /******************** IPP remap functions *********************/
@@ -1844,6 +2317,65 @@ icvRemap_32f_C1R_t icvRemap_32f_C1R_p = 0;
 icvRemap_32f_C3R_t icvRemap_32f_C3R_p = 0;
 icvRemap_32f_C4R_t icvRemap_32f_C4R_p = 0;
 
+/* arguments of the remap functions processing the destination row bands */
+typedef struct CvRemapJob
+{
+    void* func;
+    const CvMat* src;
+    CvMat* dst;
+    const CvMat* mapx;
+    const CvMat* mapy;
+    CvSize ssize;
+    int srcstep, dststep, mxstep, mystep;
+    int cn;
+    const void* fillval;
+    int interpolation;
+    const void* tab; // the weights of the fixed-point maps
+} CvRemapJob;
+
+static int CV_CDECL icvRemapIPPBand(int y0, int y1, void* userdata)
+{
+    const CvRemapJob* job = (const CvRemapJob*)userdata;
+    CvRect srcroi = {0, 0, job->ssize.width, job->ssize.height};
+
+    return ((CvRemapIPPFunc)job->func)(
+        job->src->data.ptr, job->ssize, job->srcstep, srcroi,
+        (const float*)(job->mapx->data.ptr + y0 * job->mxstep), job->mxstep,
+        (const float*)(job->mapy->data.ptr + y0 * job->mystep), job->mystep,
+        job->dst->data.ptr + y0 * job->dststep, job->dststep,
+        cvSize(job->dst->cols, y1 - y0), job->interpolation);
+}
+
+static int CV_CDECL icvRemapBand(int y0, int y1, void* userdata)
+{
+    const CvRemapJob* job = (const CvRemapJob*)userdata;
+
+    return ((CvRemapFunc)job->func)(
+        job->src->data.ptr, job->src->step, job->ssize,
+        job->dst->data.ptr + y0 * job->dst->step, job->dst->step,
+        cvSize(job->dst->cols, y1 - y0),
+        (const float*)(job->mapx->data.ptr + y0 * job->mapx->step),
+        job->mapx->step,
+        (const float*)(job->mapy->data.ptr + y0 * job->mapy->step),
+        job->mapy->step, job->cn, job->fillval);
+}
+
+static int CV_CDECL icvRemapFixedBand(int y0, int y1, void* userdata)
+{
+    const CvRemapJob* job = (const CvRemapJob*)userdata;
+    const CvMat* mapa = job->mapy;
+
+    return ((CvRemapFixedFunc)job->func)(
+        job->src->data.ptr, job->src->step, job->ssize,
+        job->dst->data.ptr + y0 * job->dst->step, job->dst->step,
+        cvSize(job->dst->cols, y1 - y0),
+        (const short*)(job->mapx->data.ptr + y0 * job->mapx->step),
+        job->mapx->step,
+        mapa ? (const ushort*)(mapa->data.ptr + y0 * mapa->step) : 0,
+        mapa ? mapa->step : 0, job->cn, job->fillval, job->interpolation,
+        job->tab);
+}
+
 /**************************************************************/
 
 CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
@@ -1851,6 +2383,7 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
 {
     static CvFuncTable bilinear_tab;
     static CvFuncTable bicubic_tab;
+    static CvFuncTable fixed_tab;
     static int inittab = 0;
 
     CV_FUNCNAME("cvRemap");
@@ -1863,32 +2396,60 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
     CvMat mystub, *mapy = (CvMat*)_mapy;
     int type, depth, cn;
     int method = flags & 3;
+    int half = flags & CV_WARP_16F;
+    int fixed;
     double fillbuf[4];
+    CvRemapJob job;
     CvSize ssize, dsize;
 
     if (!inittab)
     {
-        icvInitRemapTab(&bilinear_tab, &bicubic_tab);
+        icvInitRemapTab(&bilinear_tab, &bicubic_tab, &fixed_tab);
         icvInitLinearCoeffTab();
         icvInitCubicCoeffTab();
+        icvInitRemapFixTab();
         inittab = 1;
     }
 
     CV_CALL(src = cvGetMat(srcarr, &srcstub));
     CV_CALL(dst = cvGetMat(dstarr, &dststub));
     CV_CALL(mapx = cvGetMat(mapx, &mxstub));
-    CV_CALL(mapy = cvGetMat(mapy, &mystub));
 
     if (!CV_ARE_TYPES_EQ(src, dst))
         CV_ERROR(CV_StsUnmatchedFormats, "");
 
-    if (!CV_ARE_TYPES_EQ(mapx, mapy) || CV_MAT_TYPE(mapx->type) != CV_32FC1)
-        CV_ERROR(CV_StsUnmatchedFormats,
-                 "Both map arrays must have 32fC1 type");
+    // the fixed-point maps made by cvConvertMaps: mapx is 16sC2 and mapy is
+    // either 16uC1 or NULL
+    fixed = CV_MAT_TYPE(mapx->type) == CV_16SC2;
+
+    if (fixed)
+    {
+        if (mapy)
+        {
+            CV_CALL(mapy = cvGetMat(mapy, &mystub));
+            if (CV_MAT_TYPE(mapy->type) != CV_16UC1)
+                CV_ERROR(CV_StsUnmatchedFormats,
+                         "The fractional map must have 16uC1 type");
+            if (!CV_ARE_SIZES_EQ(mapx, mapy))
+                CV_ERROR(CV_StsUnmatchedSizes, "");
+        }
 
-    if (!CV_ARE_SIZES_EQ(mapx, mapy) || !CV_ARE_SIZES_EQ(mapx, dst))
-        CV_ERROR(CV_StsUnmatchedSizes, "Both map arrays and the destination "
-                                       "array must have the same size");
+        if (!CV_ARE_SIZES_EQ(mapx, dst))
+            CV_ERROR(CV_StsUnmatchedSizes, "The map arrays and the destination "
+                                           "array must have the same size");
+    }
+    else
+    {
+        CV_CALL(mapy = cvGetMat(mapy, &mystub));
+
+        if (!CV_ARE_TYPES_EQ(mapx, mapy) || CV_MAT_TYPE(mapx->type) != CV_32FC1)
+            CV_ERROR(CV_StsUnmatchedFormats,
+                     "Both map arrays must have 32fC1 type");
+
+        if (!CV_ARE_SIZES_EQ(mapx, mapy) || !CV_ARE_SIZES_EQ(mapx, dst))
+            CV_ERROR(CV_StsUnmatchedSizes, "Both map arrays and the destination "
+                                           "array must have the same size");
+    }
 
     type = CV_MAT_TYPE(src->type);
     depth = CV_MAT_DEPTH(type);
@@ -1896,10 +2457,25 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
     if (cn > 4)
         CV_ERROR(CV_BadNumChannels, "");
 
+    if (half)
+    {
+        if (depth != CV_16U)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Half-float data must be stored in 16u arrays");
+        depth = ICV_DEPTH_16F;
+    }
+
     ssize = cvGetMatSize(src);
     dsize = cvGetMatSize(dst);
 
-    if (icvRemap_8u_C1R_p)
+    job.src = src;
+    job.dst = dst;
+    job.mapx = mapx;
+    job.mapy = mapy;
+    job.ssize = ssize;
+    job.cn = cn;
+
+    if (icvRemap_8u_C1R_p && !half && !fixed)
     {
         CvRemapIPPFunc ipp_func = type == CV_8UC1    ? icvRemap_8u_C1R_p
                                   : type == CV_8UC3  ? icvRemap_8u_C3R_p
@@ -1911,31 +2487,51 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
 
         if (ipp_func)
         {
-            int srcstep = src->step ? src->step : CV_STUB_STEP;
-            int dststep = dst->step ? dst->step : CV_STUB_STEP;
-            int mxstep = mapx->step ? mapx->step : CV_STUB_STEP;
-            int mystep = mapy->step ? mapy->step : CV_STUB_STEP;
-            CvStatus status;
-            CvRect srcroi = {0, 0, ssize.width, ssize.height};
-
             // this is not the most efficient way to fill outliers
             if (flags & CV_WARP_FILL_OUTLIERS)
                 cvSet(dst, fillval);
 
-            status = ipp_func(
-                src->data.ptr, ssize, srcstep, srcroi, mapx->data.fl, mxstep,
-                mapy->data.fl, mystep, dst->data.ptr, dststep, dsize,
+            job.func = (void*)ipp_func;
+            job.srcstep = src->step ? src->step : CV_STUB_STEP;
+            job.dststep = dst->step ? dst->step : CV_STUB_STEP;
+            job.mxstep = mapx->step ? mapx->step : CV_STUB_STEP;
+            job.mystep = mapy->step ? mapy->step : CV_STUB_STEP;
+            job.interpolation =
                 1 << (method == CV_INTER_NN || method == CV_INTER_LINEAR
                               || method == CV_INTER_CUBIC
                           ? method
-                          : CV_INTER_LINEAR));
-            if (status >= 0)
+                          : CV_INTER_LINEAR);
+            if (cvParallelFor(dsize.height, ICV_WARP_MIN_BAND(dsize),
+                              icvRemapIPPBand, &job)
+                >= 0)
                 EXIT;
         }
     }
 
-    cvScalarToRawData(&fillval, fillbuf, CV_MAT_TYPE(src->type), 0);
+    if (half)
+        icvScalarToHalf(&fillval, (ushort*)fillbuf, cn);
+    else
+        cvScalarToRawData(&fillval, fillbuf, CV_MAT_TYPE(src->type), 0);
 
+    if (fixed)
+    {
+        // bicubic interpolation is not supported by the fixed-point maps
+        // and falls back to the bilinear one
+        CvRemapFixedFunc func = (CvRemapFixedFunc)fixed_tab.fn_2d[depth];
+
+        if (!func)
+            CV_ERROR(CV_StsUnsupportedFormat, "");
+
+        job.func = (void*)func;
+        job.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        job.interpolation = method == CV_INTER_NN;
+        job.tab = depth == CV_8U ? (const void*)icvRemapFixTab_8u
+                                 : (const void*)icvRemapFixTab_32f;
+        IPPI_CALL((CvStatus)cvParallelFor(dsize.height,
+                                          ICV_WARP_MIN_BAND(dsize),
+                                          icvRemapFixedBand, &job));
+    }
+    else
     {
         CvRemapFunc func = method == CV_INTER_CUBIC
                                ? (CvRemapFunc)bicubic_tab.fn_2d[depth]
@@ -1944,14 +2540,80 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        func(src->data.ptr, src->step, ssize, dst->data.ptr, dst->step, dsize,
-             mapx->data.fl, mapx->step, mapy->data.fl, mapy->step, cn,
-             flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0);
+        job.func = (void*)func;
+        job.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        cvParallelFor(dsize.height, ICV_WARP_MIN_BAND(dsize), icvRemapBand,
+                      &job);
     }
 
     __END__;
 }
 
+CV_IMPL void cvRemapPlanes(const CvArr** src, CvArr** dst, int count,
+                           const CvArr* mapx, const CvArr* mapy, int flags,
+                           CvScalar fillval)
+{
+    CV_FUNCNAME("cvRemapPlanes");
+
+    __BEGIN__;
+
+    int i;
+
+    if (!src || !dst)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    for (i = 0; i < count; i++)
+        CV_CALL(cvRemap(src[i], dst[i], mapx, mapy, flags,
+                        cvScalarAll(fillval.val[MIN(i, 3)])));
+
+    __END__;
+}
+
+CV_IMPL void cvConvertMaps(const CvArr* _mapx, const CvArr* _mapy,
+                           CvArr* _mapxy, CvArr* _mapalpha)
+{
+    CV_FUNCNAME("cvConvertMaps");
+
+    __BEGIN__;
+
+    CvMat mxstub, *mapx = (CvMat*)_mapx;
+    CvMat mystub, *mapy = (CvMat*)_mapy;
+    CvMat xystub, *mapxy = (CvMat*)_mapxy;
+    CvMat astub, *mapa = (CvMat*)_mapalpha;
+    CvSize size;
+    int i;
+
+    CV_CALL(mapx = cvGetMat(mapx, &mxstub));
+    CV_CALL(mapy = cvGetMat(mapy, &mystub));
+    CV_CALL(mapxy = cvGetMat(mapxy, &xystub));
+    if (mapa)
+        CV_CALL(mapa = cvGetMat(mapa, &astub));
+
+    if (!CV_ARE_TYPES_EQ(mapx, mapy) || CV_MAT_TYPE(mapx->type) != CV_32FC1)
+        CV_ERROR(CV_StsUnmatchedFormats,
+                 "Both source map arrays must have 32fC1 type");
+
+    if (CV_MAT_TYPE(mapxy->type) != CV_16SC2
+        || (mapa && CV_MAT_TYPE(mapa->type) != CV_16UC1))
+        CV_ERROR(CV_StsUnmatchedFormats, "The destination maps must have 16sC2 "
+                                         "and 16uC1 types");
+
+    if (!CV_ARE_SIZES_EQ(mapx, mapy) || !CV_ARE_SIZES_EQ(mapx, mapxy)
+        || (mapa && !CV_ARE_SIZES_EQ(mapx, mapa)))
+        CV_ERROR(CV_StsUnmatchedSizes, "");
+
+    size = cvGetMatSize(mapx);
+
+    for (i = 0; i < size.height; i++)
+        icvConvertMapRow(
+            (const float*)(mapx->data.ptr + i * mapx->step),
+            (const float*)(mapy->data.ptr + i * mapy->step),
+            (short*)(mapxy->data.ptr + i * mapxy->step),
+            mapa ? (ushort*)(mapa->data.ptr + i * mapa->step) : 0, size.width);
+
+    __END__;
+}
+
 /****************************************************************************************\
 *                                   Log-Polar Transform *
 \****************************************************************************************/
@@ -1986,14 +2648,15 @@ CV_IMPL void cvLogPolar(const CvArr* srcarr, CvArr* dstarr, CvPoint2D32f center,
     ssize = cvGetMatSize(src);
     dsize = cvGetMatSize(dst);
 
-    CV_CALL(mapx = cvCreateMat(dsize.height, dsize.width, CV_32F));
-    CV_CALL(mapy = cvCreateMat(dsize.height, dsize.width, CV_32F));
+    CV_CALL(mapx = cvCreateScratchMat(dsize.height, dsize.width, CV_32F));
+    CV_CALL(mapy = cvCreateScratchMat(dsize.height, dsize.width, CV_32F));
 
     if (!(flags & CV_WARP_INVERSE_MAP))
     {
         int phi, rho;
 
-        CV_CALL(exp_tab = (double*)cvAlloc(dsize.width * sizeof(exp_tab[0])));
+        CV_CALL(exp_tab =
+                    (double*)cvScratchAlloc(dsize.width * sizeof(exp_tab[0])));
 
         for (rho = 0; rho < dst->width; rho++)
             exp_tab[rho] = exp(rho / M);
@@ -2022,7 +2685,8 @@ CV_IMPL void cvLogPolar(const CvArr* srcarr, CvArr* dstarr, CvPoint2D32f center,
         CvMat bufx, bufy, bufp, bufa;
         double ascale = (ssize.width - 1) / (2 * CV_PI);
 
-        CV_CALL(buf = (float*)cvAlloc(4 * dsize.width * sizeof(buf[0])));
+        CV_CALL(buf =
+                    (float*)cvScratchAlloc(4 * dsize.width * sizeof(buf[0])));
 
         bufx = cvMat(1, dsize.width, CV_32F, buf);
         bufy = cvMat(1, dsize.width, CV_32F, buf + dsize.width);
@@ -2079,10 +2743,10 @@ CV_IMPL void cvLogPolar(const CvArr* srcarr, CvArr* dstarr, CvPoint2D32f center,
 
     __END__;
 
-    cvFree(&exp_tab);
-    cvFree(&buf);
-    cvReleaseMat(&mapx);
-    cvReleaseMat(&mapy);
+    cvScratchFree(&buf);
+    cvScratchFree(&exp_tab);
+    cvScratchFree(&mapy);
+    cvScratchFree(&mapx);
 }
 
 /* End of file. */
@@ -314,6 +314,18 @@ int CvMorphology::fill_cyclic_buffer(const uchar* src, int src_step, int y0,
 
         if (border_mode != IPL_BORDER_CONSTANT)
         {
+            // the border pixels that are inside the image refer to themselves
+            // in border_tab; copy them from src, as the base class does
+            for (i = 0; i < bsz; i += sizeof(int))
+            {
+                int k = i < bsz1 ? i : i + width_n;
+                if (border_tab[i] == k)
+                {
+                    int t = *(int*)(src + k - bsz1);
+                    *(int*)(trow + k) = CV_TOGGLE_FLT(t);
+                }
+            }
+
             for (i = 0; i < bsz1; i++)
             {
                 int j = border_tab[i];
@@ -0,0 +1,1379 @@
+/* ////////////////////////////////////////////////////////////////////
+//
+//  Built-in SSE4.1/AVX2 kernels for the geometrical transform IPP
+//  function slots (resize, warps, remap). They are registered under
+//  the IPP names and used when no IPP plugin provides the function
+//  (see cvRegisterNativeFuncs). The results are bit-exact with the
+//  generic code in cvimgwarp.cpp; the cases the generic code handles
+//  differently (bicubic resize and remap, source ROIs, destination
+//  ROIs not starting at column 0) are declined with a negative status
+//  so that the caller falls back to it.
+//
+// */
+
+#include "_cv.h"
+
+#if CV_SIMD_X86
+
+#include <smmintrin.h>
+#include <immintrin.h>
+
+static int icvHaveAVX2()
+{
+    static int have_avx2 = -1;
+    if (have_avx2 < 0)
+        have_avx2 = cvCheckHardwareSupport(CV_CPU_AVX2);
+    return have_avx2;
+}
+
+#define ICV_IS_FULL_ROI(roi, size)                                   \
+    ((roi).x == 0 && (roi).y == 0 && (roi).width == (size).width \
+     && (roi).height == (size).height)
+
+#define ICV_WARP_MUL_ONE_8U(x) ((x) << ICV_WARP_SHIFT)
+#define ICV_WARP_CLIP_X(x)                       \
+    ((unsigned)(x) < (unsigned)ssize.width ? (x) \
+     : (x) < 0                             ? 0   \
+                                           : ssize.width - 1)
+#define ICV_WARP_CLIP_Y(y)                        \
+    ((unsigned)(y) < (unsigned)ssize.height ? (y) \
+     : (y) < 0                              ? 0   \
+                                            : ssize.height - 1)
+
+/****************************************************************************************\
+*                                         Resize *
+\****************************************************************************************/
+
+/* vertical pass: dst = b0 + fy*(b1 - b0), b1 == 0 means a single source row */
+
+static CV_TARGET_SSE4_1 void icvResizeVLine_8u_sse4(const int* b0,
+                                                    const int* b1, int fy,
+                                                    uchar* dst, int width)
+{
+    int x = 0;
+
+    if (b1)
+    {
+        const __m128i vfy = _mm_set1_epi32(fy);
+        const __m128i delta = _mm_set1_epi32(1 << (ICV_WARP_SHIFT * 2 - 1));
+
+        for (; x <= width - 8; x += 8)
+        {
+            __m128i p0 = _mm_loadu_si128((const __m128i*)(b0 + x));
+            __m128i p1 = _mm_loadu_si128((const __m128i*)(b1 + x));
+            __m128i q0 = _mm_loadu_si128((const __m128i*)(b0 + x + 4));
+            __m128i q1 = _mm_loadu_si128((const __m128i*)(b1 + x + 4));
+
+            p0 = _mm_add_epi32(_mm_slli_epi32(p0, ICV_WARP_SHIFT),
+                               _mm_mullo_epi32(vfy, _mm_sub_epi32(p1, p0)));
+            q0 = _mm_add_epi32(_mm_slli_epi32(q0, ICV_WARP_SHIFT),
+                               _mm_mullo_epi32(vfy, _mm_sub_epi32(q1, q0)));
+            p0 = _mm_srai_epi32(_mm_add_epi32(p0, delta), ICV_WARP_SHIFT * 2);
+            q0 = _mm_srai_epi32(_mm_add_epi32(q0, delta), ICV_WARP_SHIFT * 2);
+            p0 = _mm_packs_epi32(p0, q0);
+            _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(p0, p0));
+        }
+
+        for (; x < width; x++)
+            dst[x] = (uchar)CV_DESCALE(
+                (b0[x] << ICV_WARP_SHIFT) + fy * (b1[x] - b0[x]),
+                ICV_WARP_SHIFT * 2);
+    }
+    else
+    {
+        for (; x < width; x++)
+            dst[x] = (uchar)CV_DESCALE(b0[x] << ICV_WARP_SHIFT,
+                                       ICV_WARP_SHIFT * 2);
+    }
+}
+
+static CV_TARGET_AVX2 void icvResizeVLine_8u_avx2(const int* b0,
+                                                  const int* b1, int fy,
+                                                  uchar* dst, int width)
+{
+    int x = 0;
+
+    if (!b1)
+    {
+        icvResizeVLine_8u_sse4(b0, b1, fy, dst, width);
+        return;
+    }
+
+    const __m256i vfy = _mm256_set1_epi32(fy);
+    const __m256i delta = _mm256_set1_epi32(1 << (ICV_WARP_SHIFT * 2 - 1));
+
+    for (; x <= width - 16; x += 16)
+    {
+        __m256i p0 = _mm256_loadu_si256((const __m256i*)(b0 + x));
+        __m256i p1 = _mm256_loadu_si256((const __m256i*)(b1 + x));
+        __m256i q0 = _mm256_loadu_si256((const __m256i*)(b0 + x + 8));
+        __m256i q1 = _mm256_loadu_si256((const __m256i*)(b1 + x + 8));
+
+        p0 = _mm256_add_epi32(_mm256_slli_epi32(p0, ICV_WARP_SHIFT),
+                              _mm256_mullo_epi32(vfy, _mm256_sub_epi32(p1, p0)));
+        q0 = _mm256_add_epi32(_mm256_slli_epi32(q0, ICV_WARP_SHIFT),
+                              _mm256_mullo_epi32(vfy, _mm256_sub_epi32(q1, q0)));
+        p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, delta), ICV_WARP_SHIFT * 2);
+        q0 = _mm256_srai_epi32(_mm256_add_epi32(q0, delta), ICV_WARP_SHIFT * 2);
+
+        // the packs work within the 128-bit lanes, restore the order
+        p0 = _mm256_permute4x64_epi64(_mm256_packs_epi32(p0, q0), 0xD8);
+        __m128i r = _mm_packus_epi16(_mm256_castsi256_si128(p0),
+                                     _mm256_extracti128_si256(p0, 1));
+        _mm_storeu_si128((__m128i*)(dst + x), r);
+    }
+
+    if (x < width)
+        icvResizeVLine_8u_sse4(b0 + x, b1 + x, fy, dst + x, width - x);
+}
+
+static CV_TARGET_SSE4_1 void icvResizeVLine_16u_sse4(const float* b0,
+                                                     const float* b1, float fy,
+                                                     ushort* dst, int width)
+{
+    int x = 0;
+
+    if (b1)
+    {
+        const __m128 vfy = _mm_set1_ps(fy);
+
+        for (; x <= width - 8; x += 8)
+        {
+            __m128 p0 = _mm_loadu_ps(b0 + x);
+            __m128 q0 = _mm_loadu_ps(b0 + x + 4);
+            p0 = _mm_add_ps(
+                p0, _mm_mul_ps(vfy, _mm_sub_ps(_mm_loadu_ps(b1 + x), p0)));
+            q0 = _mm_add_ps(
+                q0, _mm_mul_ps(vfy, _mm_sub_ps(_mm_loadu_ps(b1 + x + 4), q0)));
+            _mm_storeu_si128((__m128i*)(dst + x),
+                             _mm_packus_epi32(_mm_cvtps_epi32(p0),
+                                              _mm_cvtps_epi32(q0)));
+        }
+
+        for (; x < width; x++)
+            dst[x] = (ushort)cvRound(b0[x] + fy * (b1[x] - b0[x]));
+    }
+    else
+    {
+        for (; x <= width - 8; x += 8)
+            _mm_storeu_si128(
+                (__m128i*)(dst + x),
+                _mm_packus_epi32(_mm_cvtps_epi32(_mm_loadu_ps(b0 + x)),
+                                 _mm_cvtps_epi32(_mm_loadu_ps(b0 + x + 4))));
+
+        for (; x < width; x++)
+            dst[x] = (ushort)cvRound(b0[x]);
+    }
+}
+
+static CV_TARGET_AVX2 void icvResizeVLine_16u_avx2(const float* b0,
+                                                   const float* b1, float fy,
+                                                   ushort* dst, int width)
+{
+    int x = 0;
+
+    if (!b1)
+    {
+        icvResizeVLine_16u_sse4(b0, b1, fy, dst, width);
+        return;
+    }
+
+    const __m256 vfy = _mm256_set1_ps(fy);
+
+    for (; x <= width - 16; x += 16)
+    {
+        __m256 p0 = _mm256_loadu_ps(b0 + x);
+        __m256 q0 = _mm256_loadu_ps(b0 + x + 8);
+        p0 = _mm256_add_ps(
+            p0, _mm256_mul_ps(vfy, _mm256_sub_ps(_mm256_loadu_ps(b1 + x), p0)));
+        q0 = _mm256_add_ps(
+            q0,
+            _mm256_mul_ps(vfy, _mm256_sub_ps(_mm256_loadu_ps(b1 + x + 8), q0)));
+        __m256i r = _mm256_packus_epi32(_mm256_cvtps_epi32(p0),
+                                        _mm256_cvtps_epi32(q0));
+        _mm256_storeu_si256((__m256i*)(dst + x),
+                            _mm256_permute4x64_epi64(r, 0xD8));
+    }
+
+    if (x < width)
+        icvResizeVLine_16u_sse4(b0 + x, b1 + x, fy, dst + x, width - x);
+}
+
+static CV_TARGET_SSE4_1 void icvResizeVLine_32f_sse4(const float* b0,
+                                                     const float* b1, float fy,
+                                                     float* dst, int width)
+{
+    int x = 0;
+
+    if (b1)
+    {
+        const __m128 vfy = _mm_set1_ps(fy);
+
+        for (; x <= width - 4; x += 4)
+        {
+            __m128 p0 = _mm_loadu_ps(b0 + x);
+            p0 = _mm_add_ps(
+                p0, _mm_mul_ps(vfy, _mm_sub_ps(_mm_loadu_ps(b1 + x), p0)));
+            _mm_storeu_ps(dst + x, p0);
+        }
+
+        for (; x < width; x++)
+            dst[x] = b0[x] + fy * (b1[x] - b0[x]);
+    }
+    else
+        memcpy(dst, b0, width * sizeof(dst[0]));
+}
+
+static CV_TARGET_AVX2 void icvResizeVLine_32f_avx2(const float* b0,
+                                                   const float* b1, float fy,
+                                                   float* dst, int width)
+{
+    int x = 0;
+
+    if (!b1)
+    {
+        icvResizeVLine_32f_sse4(b0, b1, fy, dst, width);
+        return;
+    }
+
+    const __m256 vfy = _mm256_set1_ps(fy);
+
+    for (; x <= width - 8; x += 8)
+    {
+        __m256 p0 = _mm256_loadu_ps(b0 + x);
+        p0 = _mm256_add_ps(
+            p0, _mm256_mul_ps(vfy, _mm256_sub_ps(_mm256_loadu_ps(b1 + x), p0)));
+        _mm256_storeu_ps(dst + x, p0);
+    }
+
+    if (x < width)
+        icvResizeVLine_32f_sse4(b0 + x, b1 + x, fy, dst + x, width - x);
+}
+
+/* horizontal pass, the same arithmetic as icvResize_Bilinear_*_CnR */
+#define ICV_DEF_RESIZE_HLINE_FUNC(flavor, arrtype, worktype, mul_one_macro) \
+    static void icvResizeHLine_##flavor(const arrtype* src, worktype* buf,  \
+                                        int width, int xmax, int cn,        \
+                                        const int* xidx,                    \
+                                        const worktype* xalpha)             \
+    {                                                                       \
+        int dx = 0;                                                         \
+                                                                            \
+        for (; dx < xmax; dx++)                                             \
+        {                                                                   \
+            int sx = xidx[dx];                                              \
+            worktype t = src[sx];                                           \
+            buf[dx] = mul_one_macro(t) + xalpha[dx] * (src[sx + cn] - t);   \
+        }                                                                   \
+                                                                            \
+        for (; dx < width; dx++)                                            \
+            buf[dx] = mul_one_macro(src[xidx[dx]]);                         \
+    }
+
+ICV_DEF_RESIZE_HLINE_FUNC(8u, uchar, int, ICV_WARP_MUL_ONE_8U)
+ICV_DEF_RESIZE_HLINE_FUNC(16u, ushort, float, CV_NOP)
+ICV_DEF_RESIZE_HLINE_FUNC(32f, float, float, CV_NOP)
+
+static CV_TARGET_AVX2 void icvResizeHLine_32f_avx2(const float* src,
+                                                   float* buf, int width,
+                                                   int xmax, int cn,
+                                                   const int* xidx,
+                                                   const float* xalpha)
+{
+    const __m256i vcn = _mm256_set1_epi32(cn);
+    int dx = 0;
+
+    for (; dx <= xmax - 8; dx += 8)
+    {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(xidx + dx));
+        __m256 t = _mm256_i32gather_ps(src, idx, 4);
+        __m256 t1 = _mm256_i32gather_ps(src, _mm256_add_epi32(idx, vcn), 4);
+        t = _mm256_add_ps(t, _mm256_mul_ps(_mm256_loadu_ps(xalpha + dx),
+                                           _mm256_sub_ps(t1, t)));
+        _mm256_storeu_ps(buf + dx, t);
+    }
+
+    for (; dx < xmax; dx++)
+    {
+        int sx = xidx[dx];
+        float t = src[sx];
+        buf[dx] = t + xalpha[dx] * (src[sx + cn] - t);
+    }
+
+    for (; dx < width; dx++)
+        buf[dx] = src[xidx[dx]];
+}
+
+/* the tables of the linear resize shared by the row bands */
+typedef struct CvResizeLinearJob
+{
+    const void* src;
+    int srcstep;
+    CvSize ssize;
+    void* dst;
+    int dststep;
+    int width, xmax, cn;
+    const int *xidx, *yidx;
+    const void *xalpha, *yalpha;
+} CvResizeLinearJob;
+
+#define ICV_DEF_RESIZE_LINEAR_FUNC(flavor, arrtype, worktype, fix_macro,      \
+                                   hline_avx2)                                \
+    static int CV_CDECL icvResizeLinearBand_##flavor(int y0, int y1,          \
+                                                     void* userdata)          \
+    {                                                                         \
+        const CvResizeLinearJob* job = (const CvResizeLinearJob*)userdata;    \
+        void (*hline)(const arrtype*, worktype*, int, int, int, const int*,   \
+                      const worktype*) = icvResizeHLine_##flavor;             \
+        void (*vline)(const worktype*, const worktype*, worktype, arrtype*,   \
+                      int) = icvHaveAVX2() ? icvResizeVLine_##flavor##_avx2   \
+                                           : icvResizeVLine_##flavor##_sse4;  \
+        const arrtype* src = (const arrtype*)job->src;                        \
+        int srcstep = job->srcstep / sizeof(src[0]);                          \
+        int dststep = job->dststep / sizeof(src[0]);                          \
+        arrtype* dst = (arrtype*)job->dst + y0 * dststep;                     \
+        int width = job->width, xmax = job->xmax, cn = job->cn;               \
+        const int *xidx = job->xidx, *yidx = job->yidx;                       \
+        const worktype* xalpha = (const worktype*)job->xalpha;                \
+        const worktype* yalpha = (const worktype*)job->yalpha;                \
+        int dy, row_idx[2] = {-1, -1};                                        \
+        int buf_size = width * 2 * sizeof(worktype);                          \
+        worktype* rows[2];                                                    \
+        void* temp_buf = 0;                                                   \
+                                                                              \
+        if (hline_avx2 && icvHaveAVX2())                                      \
+            hline = hline_avx2;                                               \
+                                                                              \
+        if (buf_size < CV_MAX_LOCAL_SIZE)                                     \
+            rows[0] = (worktype*)cvStackAlloc(buf_size);                      \
+        else if (!(temp_buf = rows[0] = (worktype*)cvAlloc(buf_size)))        \
+            return CV_OUTOFMEM_ERR;                                           \
+        rows[1] = rows[0] + width;                                            \
+                                                                              \
+        for (dy = y0; dy < y1; dy++, dst += dststep)                          \
+        {                                                                     \
+            worktype fy = yalpha[dy], *swap_t;                                \
+            int sy0 = yidx[dy],                                               \
+                sy1 = sy0 + (fy > 0 && sy0 < job->ssize.height - 1);          \
+                                                                              \
+            /* keep the horizontally interpolated rows while they are used */ \
+            if (row_idx[1] == sy0)                                            \
+            {                                                                 \
+                CV_SWAP(rows[0], rows[1], swap_t);                            \
+                row_idx[0] = sy0;                                             \
+                row_idx[1] = -1;                                              \
+            }                                                                 \
+            if (row_idx[0] != sy0)                                            \
+            {                                                                 \
+                hline(src + sy0 * srcstep, rows[0], width, xmax * cn, cn,     \
+                      xidx, xalpha);                                          \
+                row_idx[0] = sy0;                                             \
+            }                                                                 \
+            if (sy1 != sy0 && row_idx[1] != sy1)                              \
+            {                                                                 \
+                hline(src + sy1 * srcstep, rows[1], width, xmax * cn, cn,     \
+                      xidx, xalpha);                                          \
+                row_idx[1] = sy1;                                             \
+            }                                                                 \
+                                                                              \
+            vline(rows[0], sy1 != sy0 ? rows[1] : 0, fy, dst, width);         \
+        }                                                                     \
+                                                                              \
+        if (temp_buf)                                                         \
+            cvFree(&temp_buf);                                                \
+                                                                              \
+        return CV_OK;                                                         \
+    }                                                                         \
+                                                                              \
+    static CvStatus CV_STDCALL icvResizeLinear_##flavor##_CnR_n(              \
+        const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,          \
+        int dststep, CvSize dsize, int cn)                                    \
+    {                                                                         \
+        float scale_x = (float)ssize.width / dsize.width;                     \
+        float scale_y = (float)ssize.height / dsize.height;                   \
+        int width = dsize.width * cn, xmax = dsize.width;                     \
+        int k, sx, sy, dx, dy;                                                \
+        int buf_size =                                                        \
+            (width + dsize.height) * (sizeof(int) + sizeof(worktype));        \
+        worktype *xalpha, *yalpha;                                            \
+        int *xidx, *yidx;                                                     \
+        void* temp_buf = 0;                                                   \
+        CvResizeLinearJob job;                                                \
+        CvStatus status;                                                      \
+                                                                              \
+        if (buf_size < CV_MAX_LOCAL_SIZE)                                     \
+            xalpha = (worktype*)cvStackAlloc(buf_size);                       \
+        else if (!(temp_buf = xalpha = (worktype*)cvAlloc(buf_size)))         \
+            return CV_OUTOFMEM_ERR;                                           \
+        yalpha = xalpha + width;                                              \
+        xidx = (int*)(yalpha + dsize.height);                                 \
+        yidx = xidx + width;                                                  \
+                                                                              \
+        for (dx = 0; dx < dsize.width; dx++)                                  \
+        {                                                                     \
+            float fx = (float)((dx + 0.5) * scale_x - 0.5);                   \
+            sx = cvFloor(fx);                                                 \
+            fx -= sx;                                                         \
+                                                                              \
+            if (sx < 0)                                                       \
+                fx = 0, sx = 0;                                               \
+                                                                              \
+            if (sx >= ssize.width - 1)                                        \
+            {                                                                 \
+                fx = 0, sx = ssize.width - 1;                                 \
+                if (xmax >= dsize.width)                                      \
+                    xmax = dx;                                                \
+            }                                                                 \
+                                                                              \
+            for (k = 0, sx *= cn; k < cn; k++)                                \
+            {                                                                 \
+                xidx[dx * cn + k] = sx + k;                                   \
+                xalpha[dx * cn + k] = (worktype)fix_macro(fx);                \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        for (dy = 0; dy < dsize.height; dy++)                                 \
+        {                                                                     \
+            float fy = (float)((dy + 0.5) * scale_y - 0.5);                   \
+            sy = cvFloor(fy);                                                 \
+            fy -= sy;                                                         \
+            if (sy < 0)                                                       \
+                sy = 0, fy = 0;                                               \
+            yidx[dy] = sy;                                                    \
+            yalpha[dy] = (worktype)fix_macro(fy);                             \
+        }                                                                     \
+                                                                              \
+        job.src = src;                                                        \
+        job.srcstep = srcstep;                                                \
+        job.ssize = ssize;                                                    \
+        job.dst = dst;                                                        \
+        job.dststep = dststep;                                                \
+        job.width = width;                                                    \
+        job.xmax = xmax;                                                      \
+        job.cn = cn;                                                          \
+        job.xidx = xidx;                                                      \
+        job.yidx = yidx;                                                      \
+        job.xalpha = xalpha;                                                  \
+        job.yalpha = yalpha;                                                  \
+                                                                              \
+        status = (CvStatus)cvParallelFor(                                     \
+            dsize.height, MAX((1 << 15) / width, 1),                          \
+            icvResizeLinearBand_##flavor, &job);                              \
+                                                                              \
+        if (temp_buf)                                                         \
+            cvFree(&temp_buf);                                                \
+                                                                              \
+        return status;                                                        \
+    }
+
+#define ICV_RESIZE_FIX_ALPHA(x) CV_FLT_TO_FIX(x, ICV_WARP_SHIFT)
+
+ICV_DEF_RESIZE_LINEAR_FUNC(8u, uchar, int, ICV_RESIZE_FIX_ALPHA, 0)
+ICV_DEF_RESIZE_LINEAR_FUNC(16u, ushort, float, CV_NOP, 0)
+ICV_DEF_RESIZE_LINEAR_FUNC(32f, float, float, CV_NOP, icvResizeHLine_32f_avx2)
+
+#define ICV_DEF_RESIZE_NATIVE_FUNC(flavor, arrtype, cn)                      \
+    static CvStatus CV_STDCALL icvResize_##flavor##_C##cn##R_n(              \
+        const void* src, CvSize ssize, int srcstep, CvRect srcroi,           \
+        void* dst, int dststep, CvSize dsize, double, double,                \
+        int interpolation)                                                   \
+    {                                                                        \
+        if (interpolation != (1 << CV_INTER_LINEAR))                         \
+            return CV_BADFLAG_ERR;                                           \
+        if (!ICV_IS_FULL_ROI(srcroi, ssize))                                 \
+            return CV_BADROI_ERR;                                            \
+        return icvResizeLinear_##flavor##_CnR_n((const arrtype*)src, srcstep, \
+                                                ssize, (arrtype*)dst,        \
+                                                dststep, dsize, cn);         \
+    }
+
+ICV_DEF_RESIZE_NATIVE_FUNC(8u, uchar, 1)
+ICV_DEF_RESIZE_NATIVE_FUNC(8u, uchar, 3)
+ICV_DEF_RESIZE_NATIVE_FUNC(8u, uchar, 4)
+ICV_DEF_RESIZE_NATIVE_FUNC(16u, ushort, 1)
+ICV_DEF_RESIZE_NATIVE_FUNC(16u, ushort, 3)
+ICV_DEF_RESIZE_NATIVE_FUNC(16u, ushort, 4)
+ICV_DEF_RESIZE_NATIVE_FUNC(32f, float, 1)
+ICV_DEF_RESIZE_NATIVE_FUNC(32f, float, 3)
+ICV_DEF_RESIZE_NATIVE_FUNC(32f, float, 4)
+
+/****************************************************************************************\
+*                                 Warps and Remap *
+\****************************************************************************************/
+
+/* The warps are processed in blocks of destination pixels. The source
+   coordinates and the interpolation weights of a block are computed first,
+   then every pixel inside the source image is interpolated:
+   - single-channel pixels are gathered into "lanes" that are interpolated
+     with SIMD across the pixels,
+   - 3- and 4-channel pixels are interpolated with SIMD across the channels.
+   The pixels outside of the source image are left untouched, the callers
+   have filled them if requested. */
+
+#define ICV_WARP_BLOCK 64
+
+typedef struct CvWarpBlock
+{
+    int ix[ICV_WARP_BLOCK];
+    int iy[ICV_WARP_BLOCK];
+    int ia[ICV_WARP_BLOCK];
+    int ib[ICV_WARP_BLOCK];
+    float a[ICV_WARP_BLOCK];
+    float b[ICV_WARP_BLOCK];
+} CvWarpBlock;
+
+typedef struct CvWarpLanes
+{
+    int count;
+    int didx[ICV_WARP_BLOCK];
+    union
+    {
+        int i[4][ICV_WARP_BLOCK];
+        float f[4][ICV_WARP_BLOCK];
+    } v;
+    union
+    {
+        int i[2][ICV_WARP_BLOCK];
+        float f[2][ICV_WARP_BLOCK];
+    } w;
+} CvWarpLanes;
+
+/* finds the four neighbours of the source pixel (ixs, iys); the pixels on
+   the border get the clipped neighbours if clip_border != 0, the pixels
+   outside of the image are skipped */
+#define ICV_WARP_NEIGHBOURS(src, step, cn, ixs, iys, clip_border)             \
+    if ((unsigned)(ixs) < (unsigned)(ssize.width - 1)                         \
+        && (unsigned)(iys) < (unsigned)(ssize.height - 1))                    \
+    {                                                                         \
+        ptr0 = (src) + (step) * (iys) + (ixs) * (cn);                         \
+        ptr1 = ptr0 + (cn);                                                   \
+        ptr2 = ptr0 + (step);                                                 \
+        ptr3 = ptr2 + (cn);                                                   \
+    }                                                                         \
+    else if ((clip_border)                                                    \
+             && (unsigned)((ixs) + 1) < (unsigned)(ssize.width + 1)           \
+             && (unsigned)((iys) + 1) < (unsigned)(ssize.height + 1))         \
+    {                                                                         \
+        int x0 = ICV_WARP_CLIP_X(ixs), y0 = ICV_WARP_CLIP_Y(iys);             \
+        int x1 = ICV_WARP_CLIP_X((ixs) + 1), y1 = ICV_WARP_CLIP_Y((iys) + 1); \
+                                                                              \
+        ptr0 = (src) + y0 * (step) + x0 * (cn);                               \
+        ptr1 = (src) + y0 * (step) + x1 * (cn);                               \
+        ptr2 = (src) + y1 * (step) + x0 * (cn);                               \
+        ptr3 = (src) + y1 * (step) + x1 * (cn);                               \
+    }                                                                         \
+    else                                                                      \
+        continue;
+
+/* gathers the single-channel pixels of the block into the lanes */
+#define ICV_DEF_WARP_GATHER_FUNC(name, arrtype, worktype, field, load_macro,  \
+                                 weight_a, weight_b)                          \
+    static void icvWarpGather_##name(const arrtype* src, int step,            \
+                                     CvSize ssize, const CvWarpBlock* blk,    \
+                                     int n, int clip_border,                  \
+                                     CvWarpLanes* lanes)                      \
+    {                                                                         \
+        int j, count = 0;                                                     \
+        step /= sizeof(src[0]);                                               \
+                                                                              \
+        for (j = 0; j < n; j++)                                               \
+        {                                                                     \
+            const arrtype *ptr0, *ptr1, *ptr2, *ptr3;                         \
+            ICV_WARP_NEIGHBOURS(src, step, 1, blk->ix[j], blk->iy[j],         \
+                                clip_border)                                  \
+                                                                              \
+            lanes->v.field[0][count] = load_macro(*ptr0);                     \
+            lanes->v.field[1][count] = load_macro(*ptr1);                     \
+            lanes->v.field[2][count] = load_macro(*ptr2);                     \
+            lanes->v.field[3][count] = load_macro(*ptr3);                     \
+            lanes->w.field[0][count] = blk->weight_a[j];                      \
+            lanes->w.field[1][count] = blk->weight_b[j];                      \
+            lanes->didx[count++] = j;                                         \
+        }                                                                     \
+                                                                              \
+        lanes->count = count;                                                 \
+    }
+
+ICV_DEF_WARP_GATHER_FUNC(8u_fix, uchar, int, i, CV_NOP, ia, ib)
+ICV_DEF_WARP_GATHER_FUNC(8u_flt, uchar, float, f, CV_8TO32F, a, b)
+ICV_DEF_WARP_GATHER_FUNC(32f, float, float, f, CV_NOP, a, b)
+
+/* stores the interpolated lanes to the destination row */
+#define ICV_DEF_WARP_SCATTER_FUNC(flavor, arrtype)                        \
+    static void icvWarpScatter_##flavor(const arrtype* out,               \
+                                        const CvWarpLanes* lanes, int n,  \
+                                        arrtype* dst)                     \
+    {                                                                     \
+        int i;                                                            \
+                                                                          \
+        if (lanes->count == n)                                            \
+            memcpy(dst, out, n * sizeof(dst[0]));                         \
+        else                                                              \
+            for (i = 0; i < lanes->count; i++)                            \
+                dst[lanes->didx[i]] = out[i];                             \
+    }
+
+ICV_DEF_WARP_SCATTER_FUNC(8u, uchar)
+ICV_DEF_WARP_SCATTER_FUNC(32f, float)
+
+/* lanes: fixed-point bilinear interpolation of WarpAffine 8u */
+static CV_TARGET_SSE4_1 void icvWarpBlend_8u_fix(const CvWarpLanes* lanes,
+                                                 uchar* out)
+{
+    const int *v0 = lanes->v.i[0], *v1 = lanes->v.i[1];
+    const int *v2 = lanes->v.i[2], *v3 = lanes->v.i[3];
+    const int *wa = lanes->w.i[0], *wb = lanes->w.i[1];
+    const __m128i delta = _mm_set1_epi32(1 << (ICV_WARP_SHIFT * 2 - 1));
+    int x = 0, len = lanes->count;
+
+    for (; x <= len - 4; x += 4)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(wa + x));
+        __m128i b = _mm_loadu_si128((const __m128i*)(wb + x));
+        __m128i t0 = _mm_loadu_si128((const __m128i*)(v0 + x));
+        __m128i t1 = _mm_loadu_si128((const __m128i*)(v1 + x));
+        __m128i t2 = _mm_loadu_si128((const __m128i*)(v2 + x));
+        __m128i t3 = _mm_loadu_si128((const __m128i*)(v3 + x));
+        __m128i p0 = _mm_add_epi32(_mm_slli_epi32(t0, ICV_WARP_SHIFT),
+                                   _mm_mullo_epi32(a, _mm_sub_epi32(t1, t0)));
+        __m128i p1 = _mm_add_epi32(_mm_slli_epi32(t2, ICV_WARP_SHIFT),
+                                   _mm_mullo_epi32(a, _mm_sub_epi32(t3, t2)));
+        p0 = _mm_add_epi32(_mm_slli_epi32(p0, ICV_WARP_SHIFT),
+                           _mm_mullo_epi32(b, _mm_sub_epi32(p1, p0)));
+        p0 = _mm_srai_epi32(_mm_add_epi32(p0, delta), ICV_WARP_SHIFT * 2);
+        p0 = _mm_packs_epi32(p0, p0);
+        *(int*)(out + x) = _mm_cvtsi128_si32(_mm_packus_epi16(p0, p0));
+    }
+
+    for (; x < len; x++)
+    {
+        int p0 = ICV_WARP_MUL_ONE_8U(v0[x]) + wa[x] * (v1[x] - v0[x]);
+        int p1 = ICV_WARP_MUL_ONE_8U(v2[x]) + wa[x] * (v3[x] - v2[x]);
+        out[x] = (uchar)CV_DESCALE(ICV_WARP_MUL_ONE_8U(p0) + wb[x] * (p1 - p0),
+                                   ICV_WARP_SHIFT * 2);
+    }
+}
+
+/* lanes: double-precision bilinear interpolation of WarpAffine 32f, the
+   differences are taken in single precision as in the generic code */
+static CV_TARGET_AVX2 void icvWarpBlend_32f_dbl(const CvWarpLanes* lanes,
+                                                float* out)
+{
+    const float *v0 = lanes->v.f[0], *v1 = lanes->v.f[1];
+    const float *v2 = lanes->v.f[2], *v3 = lanes->v.f[3];
+    const float *wa = lanes->w.f[0], *wb = lanes->w.f[1];
+    int x = 0, len = lanes->count;
+
+    for (; x <= len - 4; x += 4)
+    {
+        __m256d a = _mm256_cvtps_pd(_mm_loadu_ps(wa + x));
+        __m256d b = _mm256_cvtps_pd(_mm_loadu_ps(wb + x));
+        __m128 t0 = _mm_loadu_ps(v0 + x), t2 = _mm_loadu_ps(v2 + x);
+        __m128 d0 = _mm_sub_ps(_mm_loadu_ps(v1 + x), t0);
+        __m128 d1 = _mm_sub_ps(_mm_loadu_ps(v3 + x), t2);
+        __m256d p0 = _mm256_add_pd(_mm256_cvtps_pd(t0),
+                                   _mm256_mul_pd(a, _mm256_cvtps_pd(d0)));
+        __m256d p1 = _mm256_add_pd(_mm256_cvtps_pd(t2),
+                                   _mm256_mul_pd(a, _mm256_cvtps_pd(d1)));
+        p0 = _mm256_add_pd(p0, _mm256_mul_pd(b, _mm256_sub_pd(p1, p0)));
+        _mm_storeu_ps(out + x, _mm256_cvtpd_ps(p0));
+    }
+
+    for (; x < len; x++)
+    {
+        double a = wa[x], b = wb[x];
+        double p0 = v0[x] + a * (v1[x] - v0[x]);
+        double p1 = v2[x] + a * (v3[x] - v2[x]);
+        out[x] = (float)(p0 + b * (p1 - p0));
+    }
+}
+
+static void icvWarpBlend_32f_dbl_c(const CvWarpLanes* lanes, float* out)
+{
+    const float *v0 = lanes->v.f[0], *v1 = lanes->v.f[1];
+    const float *v2 = lanes->v.f[2], *v3 = lanes->v.f[3];
+    const float *wa = lanes->w.f[0], *wb = lanes->w.f[1];
+    int x, len = lanes->count;
+
+    for (x = 0; x < len; x++)
+    {
+        double a = wa[x], b = wb[x];
+        double p0 = v0[x] + a * (v1[x] - v0[x]);
+        double p1 = v2[x] + a * (v3[x] - v2[x]);
+        out[x] = (float)(p0 + b * (p1 - p0));
+    }
+}
+
+/* lanes: single-precision bilinear interpolation of WarpPerspective */
+static CV_TARGET_SSE4_1 void icvWarpBlend_32f_lerp(const CvWarpLanes* lanes,
+                                                   float* out)
+{
+    const float *v0 = lanes->v.f[0], *v1 = lanes->v.f[1];
+    const float *v2 = lanes->v.f[2], *v3 = lanes->v.f[3];
+    const float *wa = lanes->w.f[0], *wb = lanes->w.f[1];
+    int x = 0, len = lanes->count;
+
+    for (; x <= len - 4; x += 4)
+    {
+        __m128 a = _mm_loadu_ps(wa + x), b = _mm_loadu_ps(wb + x);
+        __m128 t0 = _mm_loadu_ps(v0 + x), t2 = _mm_loadu_ps(v2 + x);
+        __m128 p0 =
+            _mm_add_ps(t0, _mm_mul_ps(a, _mm_sub_ps(_mm_loadu_ps(v1 + x), t0)));
+        __m128 p1 =
+            _mm_add_ps(t2, _mm_mul_ps(a, _mm_sub_ps(_mm_loadu_ps(v3 + x), t2)));
+        _mm_storeu_ps(out + x, _mm_add_ps(p0, _mm_mul_ps(b, _mm_sub_ps(p1, p0))));
+    }
+
+    for (; x < len; x++)
+    {
+        float p0 = v0[x] + wa[x] * (v1[x] - v0[x]);
+        float p1 = v2[x] + wa[x] * (v3[x] - v2[x]);
+        out[x] = p0 + wb[x] * (p1 - p0);
+    }
+}
+
+/* lanes: single-precision interpolation of Remap with the icvLinearCoeffs
+   weights */
+static CV_TARGET_SSE4_1 void icvWarpBlend_32f_remap(const CvWarpLanes* lanes,
+                                                    float* out)
+{
+    const float *v0 = lanes->v.f[0], *v1 = lanes->v.f[1];
+    const float *v2 = lanes->v.f[2], *v3 = lanes->v.f[3];
+    const float *wa = lanes->w.f[0], *wb = lanes->w.f[1];
+    const __m128 one = _mm_set1_ps(1.f);
+    int x = 0, len = lanes->count;
+
+    for (; x <= len - 4; x += 4)
+    {
+        __m128 x0 = _mm_loadu_ps(wa + x), x1 = _mm_sub_ps(one, x0);
+        __m128 y0 = _mm_loadu_ps(wb + x), y1 = _mm_sub_ps(one, y0);
+        __m128 t0 = _mm_add_ps(_mm_mul_ps(x1, _mm_loadu_ps(v0 + x)),
+                               _mm_mul_ps(x0, _mm_loadu_ps(v1 + x)));
+        __m128 t1 = _mm_add_ps(_mm_mul_ps(x1, _mm_loadu_ps(v2 + x)),
+                               _mm_mul_ps(x0, _mm_loadu_ps(v3 + x)));
+        _mm_storeu_ps(out + x,
+                      _mm_add_ps(_mm_mul_ps(y1, t0), _mm_mul_ps(y0, t1)));
+    }
+
+    for (; x < len; x++)
+    {
+        float x0 = wa[x], x1 = 1.f - x0, y0 = wb[x], y1 = 1.f - y0;
+        float t0 = x1 * v0[x] + x0 * v1[x];
+        float t1 = x1 * v2[x] + x0 * v3[x];
+        out[x] = y1 * t0 + y0 * t1;
+    }
+}
+
+/* lanes: cvRound + saturation of the interpolated 8u values */
+static CV_TARGET_SSE4_1 void icvWarpRound_8u(const float* src, int len,
+                                             uchar* dst)
+{
+    int x = 0;
+
+    for (; x <= len - 8; x += 8)
+    {
+        __m128i r0 = _mm_cvtps_epi32(_mm_loadu_ps(src + x));
+        __m128i r1 = _mm_cvtps_epi32(_mm_loadu_ps(src + x + 4));
+        r0 = _mm_packs_epi32(r0, r1);
+        _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(r0, r0));
+    }
+
+    for (; x < len; x++)
+        dst[x] = CV_CAST_8U(cvRound(src[x]));
+}
+
+/* pixels: loads and stores of 3- and 4-channel pixels (no access beyond
+   the pixel) */
+static CV_TARGET_SSE4_1 inline __m128i icvLoadPix_8u(const uchar* p, int cn)
+{
+    int v = cn == 4 ? *(const int*)p : p[0] | (p[1] << 8) | (p[2] << 16);
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v));
+}
+
+static CV_TARGET_SSE4_1 inline void icvStorePix_8u(__m128i v, uchar* p, int cn)
+{
+    v = _mm_packs_epi32(v, v);
+    int r = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+    if (cn == 4)
+        *(int*)p = r;
+    else
+    {
+        p[0] = (uchar)r;
+        p[1] = (uchar)(r >> 8);
+        p[2] = (uchar)(r >> 16);
+    }
+}
+
+static CV_TARGET_SSE4_1 inline __m128 icvLoadPix_32f(const float* p, int cn)
+{
+    if (cn == 4)
+        return _mm_loadu_ps(p);
+    return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)p)),
+                         _mm_load_ss(p + 2));
+}
+
+static CV_TARGET_SSE4_1 inline void icvStorePix_32f(__m128 v, float* p, int cn)
+{
+    if (cn == 4)
+        _mm_storeu_ps(p, v);
+    else
+    {
+        _mm_store_sd((double*)p, _mm_castps_pd(v));
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+}
+
+static CV_TARGET_SSE4_1 inline __m128 icvLoadPix_8u32f(const uchar* p, int cn)
+{
+    return _mm_cvtepi32_ps(icvLoadPix_8u(p, cn));
+}
+
+static CV_TARGET_SSE4_1 inline void icvStorePix_32f8u(__m128 v, uchar* p,
+                                                      int cn)
+{
+    icvStorePix_8u(_mm_cvtps_epi32(v), p, cn);
+}
+
+/*************************************** WarpAffine ***************************************/
+
+static CV_TARGET_SSE4_1 void icvWarpAffinePix_8u(const CvWarpBlock* blk, int n,
+                                                 const uchar* src, int step,
+                                                 CvSize ssize, int cn,
+                                                 uchar* dst)
+{
+    const __m128i delta = _mm_set1_epi32(1 << (ICV_WARP_SHIFT * 2 - 1));
+    int j;
+
+    for (j = 0; j < n; j++)
+    {
+        const uchar *ptr0, *ptr1, *ptr2, *ptr3;
+        ICV_WARP_NEIGHBOURS(src, step, cn, blk->ix[j], blk->iy[j], 1)
+
+        __m128i a = _mm_set1_epi32(blk->ia[j]), b = _mm_set1_epi32(blk->ib[j]);
+        __m128i t0 = icvLoadPix_8u(ptr0, cn), t1 = icvLoadPix_8u(ptr1, cn);
+        __m128i t2 = icvLoadPix_8u(ptr2, cn), t3 = icvLoadPix_8u(ptr3, cn);
+        __m128i p0 = _mm_add_epi32(_mm_slli_epi32(t0, ICV_WARP_SHIFT),
+                                   _mm_mullo_epi32(a, _mm_sub_epi32(t1, t0)));
+        __m128i p1 = _mm_add_epi32(_mm_slli_epi32(t2, ICV_WARP_SHIFT),
+                                   _mm_mullo_epi32(a, _mm_sub_epi32(t3, t2)));
+        p0 = _mm_add_epi32(_mm_slli_epi32(p0, ICV_WARP_SHIFT),
+                           _mm_mullo_epi32(b, _mm_sub_epi32(p1, p0)));
+        p0 = _mm_srai_epi32(_mm_add_epi32(p0, delta), ICV_WARP_SHIFT * 2);
+        icvStorePix_8u(p0, dst + j * cn, cn);
+    }
+}
+
+static CV_TARGET_AVX2 void icvWarpAffinePix_32f(const CvWarpBlock* blk, int n,
+                                                const float* src, int step,
+                                                CvSize ssize, int cn,
+                                                float* dst)
+{
+    int j;
+
+    for (j = 0; j < n; j++)
+    {
+        const float *ptr0, *ptr1, *ptr2, *ptr3;
+        ICV_WARP_NEIGHBOURS(src, step, cn, blk->ix[j], blk->iy[j], 1)
+
+        __m256d a = _mm256_set1_pd(blk->a[j]), b = _mm256_set1_pd(blk->b[j]);
+        __m128 t0 = icvLoadPix_32f(ptr0, cn), t2 = icvLoadPix_32f(ptr2, cn);
+        __m128 d0 = _mm_sub_ps(icvLoadPix_32f(ptr1, cn), t0);
+        __m128 d1 = _mm_sub_ps(icvLoadPix_32f(ptr3, cn), t2);
+        __m256d p0 = _mm256_add_pd(_mm256_cvtps_pd(t0),
+                                   _mm256_mul_pd(a, _mm256_cvtps_pd(d0)));
+        __m256d p1 = _mm256_add_pd(_mm256_cvtps_pd(t2),
+                                   _mm256_mul_pd(a, _mm256_cvtps_pd(d1)));
+        p0 = _mm256_add_pd(p0, _mm256_mul_pd(b, _mm256_sub_pd(p1, p0)));
+        icvStorePix_32f(_mm256_cvtpd_ps(p0), dst + j * cn, cn);
+    }
+}
+
+static void icvWarpAffinePix_32f_c(const CvWarpBlock* blk, int n,
+                                   const float* src, int step, CvSize ssize,
+                                   int cn, float* dst)
+{
+    int j, k;
+
+    for (j = 0; j < n; j++)
+    {
+        const float *ptr0, *ptr1, *ptr2, *ptr3;
+        ICV_WARP_NEIGHBOURS(src, step, cn, blk->ix[j], blk->iy[j], 1)
+
+        double a = blk->a[j], b = blk->b[j];
+        for (k = 0; k < cn; k++)
+        {
+            double p0 = ptr0[k] + a * (ptr1[k] - ptr0[k]);
+            double p1 = ptr2[k] + a * (ptr3[k] - ptr2[k]);
+            dst[j * cn + k] = (float)(p0 + b * (p1 - p0));
+        }
+    }
+}
+
+static CvStatus icvWarpAffineBack_8u_CnR_n(const uchar* src, CvSize ssize,
+                                           int srcstep, uchar* dst,
+                                           int dststep, CvRect dstroi,
+                                           const double* matrix, int cn)
+{
+    int* ofs = (int*)cvStackAlloc(dstroi.width * 2 * sizeof(ofs[0]));
+    CvWarpBlock blk;
+    CvWarpLanes lanes;
+    uchar out[ICV_WARP_BLOCK];
+    int x, y, j;
+
+    for (x = 0; x < dstroi.width; x++)
+    {
+        ofs[2 * x] = CV_FLT_TO_FIX(matrix[0] * x, ICV_WARP_SHIFT);
+        ofs[2 * x + 1] = CV_FLT_TO_FIX(matrix[3] * x, ICV_WARP_SHIFT);
+    }
+
+    for (y = dstroi.y, dst += y * dststep; y < dstroi.y + dstroi.height;
+         y++, dst += dststep)
+    {
+        int xs = CV_FLT_TO_FIX(matrix[1] * y + matrix[2], ICV_WARP_SHIFT);
+        int ys = CV_FLT_TO_FIX(matrix[4] * y + matrix[5], ICV_WARP_SHIFT);
+
+        for (x = 0; x < dstroi.width; x += ICV_WARP_BLOCK)
+        {
+            int n = MIN(dstroi.width - x, ICV_WARP_BLOCK);
+
+            for (j = 0; j < n; j++)
+            {
+                int ixs = xs + ofs[(x + j) * 2];
+                int iys = ys + ofs[(x + j) * 2 + 1];
+                blk.ia[j] = ixs & ICV_WARP_MASK;
+                blk.ib[j] = iys & ICV_WARP_MASK;
+                blk.ix[j] = ixs >> ICV_WARP_SHIFT;
+                blk.iy[j] = iys >> ICV_WARP_SHIFT;
+            }
+
+            if (cn == 1)
+            {
+                icvWarpGather_8u_fix(src, srcstep, ssize, &blk, n, 1, &lanes);
+                icvWarpBlend_8u_fix(&lanes, out);
+                icvWarpScatter_8u(out, &lanes, n, dst + x);
+            }
+            else
+                icvWarpAffinePix_8u(&blk, n, src, srcstep, ssize, cn,
+                                    dst + x * cn);
+        }
+    }
+
+    return CV_OK;
+}
+
+static CvStatus icvWarpAffineBack_32f_CnR_n(const float* src, CvSize ssize,
+                                            int srcstep, float* dst,
+                                            int dststep, CvRect dstroi,
+                                            const double* matrix, int cn)
+{
+    int* ofs = (int*)cvStackAlloc(dstroi.width * 2 * sizeof(ofs[0]));
+    int have_avx2 = icvHaveAVX2();
+    CvWarpBlock blk;
+    CvWarpLanes lanes;
+    float out[ICV_WARP_BLOCK];
+    int x, y, j;
+
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+
+    for (x = 0; x < dstroi.width; x++)
+    {
+        ofs[2 * x] = CV_FLT_TO_FIX(matrix[0] * x, ICV_WARP_SHIFT);
+        ofs[2 * x + 1] = CV_FLT_TO_FIX(matrix[3] * x, ICV_WARP_SHIFT);
+    }
+
+    for (y = dstroi.y, dst += y * dststep; y < dstroi.y + dstroi.height;
+         y++, dst += dststep)
+    {
+        int xs = CV_FLT_TO_FIX(matrix[1] * y + matrix[2], ICV_WARP_SHIFT);
+        int ys = CV_FLT_TO_FIX(matrix[4] * y + matrix[5], ICV_WARP_SHIFT);
+
+        for (x = 0; x < dstroi.width; x += ICV_WARP_BLOCK)
+        {
+            int n = MIN(dstroi.width - x, ICV_WARP_BLOCK);
+
+            for (j = 0; j < n; j++)
+            {
+                int ixs = xs + ofs[(x + j) * 2];
+                int iys = ys + ofs[(x + j) * 2 + 1];
+                // (x & ICV_WARP_MASK)/1024 is exact in single precision
+                blk.a[j] = (ixs & ICV_WARP_MASK) * (1.f / (ICV_WARP_MASK + 1));
+                blk.b[j] = (iys & ICV_WARP_MASK) * (1.f / (ICV_WARP_MASK + 1));
+                blk.ix[j] = ixs >> ICV_WARP_SHIFT;
+                blk.iy[j] = iys >> ICV_WARP_SHIFT;
+            }
+
+            if (cn == 1)
+            {
+                icvWarpGather_32f(src, srcstep * sizeof(src[0]), ssize, &blk,
+                                  n, 1, &lanes);
+                if (have_avx2)
+                    icvWarpBlend_32f_dbl(&lanes, out);
+                else
+                    icvWarpBlend_32f_dbl_c(&lanes, out);
+                icvWarpScatter_32f(out, &lanes, n, dst + x);
+            }
+            else if (have_avx2)
+                icvWarpAffinePix_32f(&blk, n, src, srcstep, ssize, cn,
+                                     dst + x * cn);
+            else
+                icvWarpAffinePix_32f_c(&blk, n, src, srcstep, ssize, cn,
+                                       dst + x * cn);
+        }
+    }
+
+    return CV_OK;
+}
+
+#define ICV_DEF_WARP_AFFINE_NATIVE_FUNC(flavor, arrtype, cn)                   \
+    static CvStatus CV_STDCALL icvWarpAffineBack_##flavor##_C##cn##R_n(        \
+        const void* src, CvSize ssize, int srcstep, CvRect srcroi, void* dst,  \
+        int dststep, CvRect dstroi, const double* coeffs, int)                 \
+    {                                                                          \
+        if (!ICV_IS_FULL_ROI(srcroi, ssize) || dstroi.x != 0)                  \
+            return CV_BADROI_ERR;                                              \
+        return icvWarpAffineBack_##flavor##_CnR_n(                             \
+            (const arrtype*)src, ssize, srcstep, (arrtype*)dst, dststep,       \
+            dstroi, coeffs, cn);                                               \
+    }
+
+ICV_DEF_WARP_AFFINE_NATIVE_FUNC(8u, uchar, 1)
+ICV_DEF_WARP_AFFINE_NATIVE_FUNC(8u, uchar, 3)
+ICV_DEF_WARP_AFFINE_NATIVE_FUNC(8u, uchar, 4)
+ICV_DEF_WARP_AFFINE_NATIVE_FUNC(32f, float, 1)
+ICV_DEF_WARP_AFFINE_NATIVE_FUNC(32f, float, 3)
+ICV_DEF_WARP_AFFINE_NATIVE_FUNC(32f, float, 4)
+
+/************************************ WarpPerspective *************************************/
+
+/* source coordinates of a block of WarpPerspective; xs0, ys0 and ws are
+   accumulated serially by the caller, exactly as in the generic code */
+static CV_TARGET_SSE4_1 void icvWarpPerspectiveCoords(const float* xs0,
+                                                      const float* ys0,
+                                                      const float* ws, int n,
+                                                      CvWarpBlock* blk)
+{
+    const __m128 one = _mm_set1_ps(1.f);
+    int j = 0;
+
+    for (; j <= n - 4; j += 4)
+    {
+        __m128 inv_ws = _mm_div_ps(one, _mm_loadu_ps(ws + j));
+        __m128 xs = _mm_mul_ps(_mm_loadu_ps(xs0 + j), inv_ws);
+        __m128 ys = _mm_mul_ps(_mm_loadu_ps(ys0 + j), inv_ws);
+        __m128 fx = _mm_floor_ps(xs), fy = _mm_floor_ps(ys);
+
+        _mm_storeu_si128((__m128i*)(blk->ix + j), _mm_cvtps_epi32(fx));
+        _mm_storeu_si128((__m128i*)(blk->iy + j), _mm_cvtps_epi32(fy));
+        _mm_storeu_ps(blk->a + j, _mm_sub_ps(xs, fx));
+        _mm_storeu_ps(blk->b + j, _mm_sub_ps(ys, fy));
+    }
+
+    for (; j < n; j++)
+    {
+        float inv_ws = 1.f / ws[j];
+        float xs = xs0[j] * inv_ws;
+        float ys = ys0[j] * inv_ws;
+        int ixs = cvFloor(xs);
+        int iys = cvFloor(ys);
+        blk->ix[j] = ixs;
+        blk->iy[j] = iys;
+        blk->a[j] = xs - ixs;
+        blk->b[j] = ys - iys;
+    }
+}
+
+/* pixels: single-precision bilinear interpolation (WarpPerspective) and
+   the icvLinearCoeffs one (Remap) */
+#define ICV_DEF_WARP_PIX_FLT_FUNC(flavor, arrtype, load_pix, store_pix)      \
+    static CV_TARGET_SSE4_1 void icvWarpPerspectivePix_##flavor(             \
+        const CvWarpBlock* blk, int n, const arrtype* src, int step,         \
+        CvSize ssize, int cn, arrtype* dst)                                  \
+    {                                                                        \
+        int j;                                                               \
+                                                                             \
+        for (j = 0; j < n; j++)                                              \
+        {                                                                    \
+            const arrtype *ptr0, *ptr1, *ptr2, *ptr3;                        \
+            ICV_WARP_NEIGHBOURS(src, step, cn, blk->ix[j], blk->iy[j], 1)    \
+                                                                             \
+            __m128 a = _mm_set1_ps(blk->a[j]), b = _mm_set1_ps(blk->b[j]);   \
+            __m128 t0 = load_pix(ptr0, cn), t2 = load_pix(ptr2, cn);         \
+            __m128 p0 = _mm_add_ps(                                          \
+                t0, _mm_mul_ps(a, _mm_sub_ps(load_pix(ptr1, cn), t0)));      \
+            __m128 p1 = _mm_add_ps(                                          \
+                t2, _mm_mul_ps(a, _mm_sub_ps(load_pix(ptr3, cn), t2)));      \
+            p0 = _mm_add_ps(p0, _mm_mul_ps(b, _mm_sub_ps(p1, p0)));          \
+            store_pix(p0, dst + j * cn, cn);                                 \
+        }                                                                    \
+    }                                                                        \
+                                                                             \
+    static CV_TARGET_SSE4_1 void icvRemapPix_##flavor(                       \
+        const CvWarpBlock* blk, int n, const arrtype* src, int step,         \
+        CvSize ssize, int cn, arrtype* dst)                                  \
+    {                                                                        \
+        const __m128 one = _mm_set1_ps(1.f);                                 \
+        int j;                                                               \
+                                                                             \
+        for (j = 0; j < n; j++)                                              \
+        {                                                                    \
+            const arrtype *ptr0, *ptr1, *ptr2, *ptr3;                        \
+            ICV_WARP_NEIGHBOURS(src, step, cn, blk->ix[j], blk->iy[j], 0)    \
+                                                                             \
+            __m128 x0 = _mm_set1_ps(blk->a[j]), x1 = _mm_sub_ps(one, x0);    \
+            __m128 y0 = _mm_set1_ps(blk->b[j]), y1 = _mm_sub_ps(one, y0);    \
+            __m128 t0 = _mm_add_ps(_mm_mul_ps(x1, load_pix(ptr0, cn)),       \
+                                   _mm_mul_ps(x0, load_pix(ptr1, cn)));      \
+            __m128 t1 = _mm_add_ps(_mm_mul_ps(x1, load_pix(ptr2, cn)),       \
+                                   _mm_mul_ps(x0, load_pix(ptr3, cn)));      \
+            store_pix(_mm_add_ps(_mm_mul_ps(y1, t0), _mm_mul_ps(y0, t1)),    \
+                      dst + j * cn, cn);                                     \
+        }                                                                    \
+    }
+
+ICV_DEF_WARP_PIX_FLT_FUNC(8u, uchar, icvLoadPix_8u32f, icvStorePix_32f8u)
+ICV_DEF_WARP_PIX_FLT_FUNC(32f, float, icvLoadPix_32f, icvStorePix_32f)
+
+#define ICV_WARP_STORE_8U(buf, out, len) icvWarpRound_8u(buf, len, out)
+#define ICV_WARP_STORE_32F(buf, out, len)
+
+#define ICV_DEF_WARP_PERSPECTIVE_FUNC(flavor, arrtype, gather_func,           \
+                                      store_macro)                            \
+    static CvStatus icvWarpPerspectiveBack_##flavor##_CnR_n(                  \
+        const arrtype* src, CvSize ssize, int srcstep, arrtype* dst,          \
+        int dststep, CvRect dstroi, const double* matrix, int cn)             \
+    {                                                                         \
+        float A11 = (float)matrix[0], A12 = (float)matrix[1],                 \
+              A13 = (float)matrix[2];                                         \
+        float A21 = (float)matrix[3], A22 = (float)matrix[4],                 \
+              A23 = (float)matrix[5];                                         \
+        float A31 = (float)matrix[6], A32 = (float)matrix[7],                 \
+              A33 = (float)matrix[8];                                         \
+        float xs0[ICV_WARP_BLOCK], ys0[ICV_WARP_BLOCK], ws[ICV_WARP_BLOCK];   \
+        float buf[ICV_WARP_BLOCK];                                            \
+        arrtype* out = (arrtype*)buf;                                         \
+        CvWarpBlock blk;                                                      \
+        CvWarpLanes lanes;                                                    \
+        int x, y, j;                                                          \
+                                                                              \
+        srcstep /= sizeof(src[0]);                                            \
+        dststep /= sizeof(dst[0]);                                            \
+                                                                              \
+        for (y = dstroi.y, dst += y * dststep; y < dstroi.y + dstroi.height;  \
+             y++, dst += dststep)                                             \
+        {                                                                     \
+            float cx = A12 * y + A13;                                         \
+            float cy = A22 * y + A23;                                         \
+            float cw = A32 * y + A33;                                         \
+                                                                              \
+            for (x = 0; x < dstroi.width; x += ICV_WARP_BLOCK)                 \
+            {                                                                 \
+                int n = MIN(dstroi.width - x, ICV_WARP_BLOCK);                 \
+                                                                              \
+                for (j = 0; j < n; j++, cx += A11, cy += A21, cw += A31)      \
+                {                                                             \
+                    xs0[j] = cx;                                              \
+                    ys0[j] = cy;                                              \
+                    ws[j] = cw;                                               \
+                }                                                             \
+                                                                              \
+                icvWarpPerspectiveCoords(xs0, ys0, ws, n, &blk);              \
+                if (cn == 1)                                                  \
+                {                                                             \
+                    gather_func(src, srcstep * sizeof(src[0]), ssize, &blk,   \
+                                n, 1, &lanes);                                \
+                    icvWarpBlend_32f_lerp(&lanes, buf);                       \
+                    store_macro(buf, out, lanes.count);                       \
+                    icvWarpScatter_##flavor(out, &lanes, n, dst + x);         \
+                }                                                             \
+                else                                                          \
+                    icvWarpPerspectivePix_##flavor(&blk, n, src, srcstep,     \
+                                                   ssize, cn, dst + x * cn);  \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        return CV_OK;                                                         \
+    }
+
+ICV_DEF_WARP_PERSPECTIVE_FUNC(8u, uchar, icvWarpGather_8u_flt,
+                              ICV_WARP_STORE_8U)
+ICV_DEF_WARP_PERSPECTIVE_FUNC(32f, float, icvWarpGather_32f,
+                              ICV_WARP_STORE_32F)
+
+#define ICV_DEF_WARP_PERSPECTIVE_NATIVE_FUNC(flavor, arrtype, cn)              \
+    static CvStatus CV_STDCALL icvWarpPerspectiveBack_##flavor##_C##cn##R_n(   \
+        const void* src, CvSize ssize, int srcstep, CvRect srcroi, void* dst,  \
+        int dststep, CvRect dstroi, const double* coeffs, int)                 \
+    {                                                                          \
+        if (!ICV_IS_FULL_ROI(srcroi, ssize) || dstroi.x != 0)                  \
+            return CV_BADROI_ERR;                                              \
+        return icvWarpPerspectiveBack_##flavor##_CnR_n(                        \
+            (const arrtype*)src, ssize, srcstep, (arrtype*)dst, dststep,       \
+            dstroi, coeffs, cn);                                               \
+    }
+
+ICV_DEF_WARP_PERSPECTIVE_NATIVE_FUNC(8u, uchar, 1)
+ICV_DEF_WARP_PERSPECTIVE_NATIVE_FUNC(8u, uchar, 3)
+ICV_DEF_WARP_PERSPECTIVE_NATIVE_FUNC(8u, uchar, 4)
+ICV_DEF_WARP_PERSPECTIVE_NATIVE_FUNC(32f, float, 1)
+ICV_DEF_WARP_PERSPECTIVE_NATIVE_FUNC(32f, float, 3)
+ICV_DEF_WARP_PERSPECTIVE_NATIVE_FUNC(32f, float, 4)
+
+/***************************************** Remap ******************************************/
+
+/* fixed-point map coordinates and the icvLinearCoeffs weights */
+static CV_TARGET_SSE4_1 void icvRemapCoords(const float* mapx,
+                                            const float* mapy, int n,
+                                            CvWarpBlock* blk)
+{
+    const __m128 scale = _mm_set1_ps((float)(1 << ICV_WARP_SHIFT));
+    const __m128 inv_scale = _mm_set1_ps(1.f / ICV_LINEAR_TAB_SIZE);
+    const __m128i mask = _mm_set1_epi32(ICV_WARP_MASK);
+    int j = 0;
+
+    for (; j <= n - 4; j += 4)
+    {
+        __m128i ix = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(mapx + j), scale));
+        __m128i iy = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(mapy + j), scale));
+
+        _mm_storeu_ps(blk->a + j,
+                      _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(ix, mask)),
+                                 inv_scale));
+        _mm_storeu_ps(blk->b + j,
+                      _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(iy, mask)),
+                                 inv_scale));
+        _mm_storeu_si128((__m128i*)(blk->ix + j),
+                         _mm_srai_epi32(ix, ICV_WARP_SHIFT));
+        _mm_storeu_si128((__m128i*)(blk->iy + j),
+                         _mm_srai_epi32(iy, ICV_WARP_SHIFT));
+    }
+
+    for (; j < n; j++)
+    {
+        int ix = cvRound(mapx[j] * (1 << ICV_WARP_SHIFT));
+        int iy = cvRound(mapy[j] * (1 << ICV_WARP_SHIFT));
+        blk->a[j] = icvLinearCoeffs[(ix & ICV_WARP_MASK) * 2];
+        blk->b[j] = icvLinearCoeffs[(iy & ICV_WARP_MASK) * 2];
+        blk->ix[j] = ix >> ICV_WARP_SHIFT;
+        blk->iy[j] = iy >> ICV_WARP_SHIFT;
+    }
+}
+
+#define ICV_DEF_REMAP_FUNC(flavor, arrtype, gather_func, store_macro)         \
+    static CvStatus icvRemap_##flavor##_CnR_n(                                \
+        const arrtype* src, CvSize ssize, int srcstep, const float* mapx,     \
+        int mxstep, const float* mapy, int mystep, arrtype* dst,              \
+        int dststep, CvSize dsize, int cn)                                    \
+    {                                                                         \
+        float buf[ICV_WARP_BLOCK];                                            \
+        arrtype* out = (arrtype*)buf;                                         \
+        CvWarpBlock blk;                                                      \
+        CvWarpLanes lanes;                                                    \
+        int x, y;                                                             \
+                                                                              \
+        srcstep /= sizeof(src[0]);                                            \
+        dststep /= sizeof(dst[0]);                                            \
+        mxstep /= sizeof(mapx[0]);                                            \
+        mystep /= sizeof(mapy[0]);                                            \
+                                                                              \
+        for (y = 0; y < dsize.height;                                         \
+             y++, dst += dststep, mapx += mxstep, mapy += mystep)             \
+        {                                                                     \
+            for (x = 0; x < dsize.width; x += ICV_WARP_BLOCK)                 \
+            {                                                                 \
+                int n = MIN(dsize.width - x, ICV_WARP_BLOCK);                 \
+                                                                              \
+                icvRemapCoords(mapx + x, mapy + x, n, &blk);                  \
+                if (cn == 1)                                                  \
+                {                                                             \
+                    gather_func(src, srcstep * sizeof(src[0]), ssize, &blk,   \
+                                n, 0, &lanes);                                \
+                    icvWarpBlend_32f_remap(&lanes, buf);                      \
+                    store_macro(buf, out, lanes.count);                       \
+                    icvWarpScatter_##flavor(out, &lanes, n, dst + x);         \
+                }                                                             \
+                else                                                          \
+                    icvRemapPix_##flavor(&blk, n, src, srcstep, ssize, cn,    \
+                                         dst + x * cn);                       \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        return CV_OK;                                                         \
+    }
+
+ICV_DEF_REMAP_FUNC(8u, uchar, icvWarpGather_8u_flt, ICV_WARP_STORE_8U)
+ICV_DEF_REMAP_FUNC(32f, float, icvWarpGather_32f, ICV_WARP_STORE_32F)
+
+/* the generic code treats everything but bicubic as bilinear */
+#define ICV_DEF_REMAP_NATIVE_FUNC(flavor, arrtype, cn)                         \
+    static CvStatus CV_STDCALL icvRemap_##flavor##_C##cn##R_n(                 \
+        const void* src, CvSize ssize, int srcstep, CvRect srcroi,             \
+        const float* mapx, int mxstep, const float* mapy, int mystep,          \
+        void* dst, int dststep, CvSize dsize, int interpolation)               \
+    {                                                                          \
+        if (interpolation == (1 << CV_INTER_CUBIC))                            \
+            return CV_BADFLAG_ERR;                                             \
+        if (!ICV_IS_FULL_ROI(srcroi, ssize))                                   \
+            return CV_BADROI_ERR;                                              \
+        return icvRemap_##flavor##_CnR_n((const arrtype*)src, ssize, srcstep,  \
+                                         mapx, mxstep, mapy, mystep,           \
+                                         (arrtype*)dst, dststep, dsize, cn);   \
+    }
+
+ICV_DEF_REMAP_NATIVE_FUNC(8u, uchar, 1)
+ICV_DEF_REMAP_NATIVE_FUNC(8u, uchar, 3)
+ICV_DEF_REMAP_NATIVE_FUNC(8u, uchar, 4)
+ICV_DEF_REMAP_NATIVE_FUNC(32f, float, 1)
+ICV_DEF_REMAP_NATIVE_FUNC(32f, float, 3)
+ICV_DEF_REMAP_NATIVE_FUNC(32f, float, 4)
+
+/****************************************************************************************\
+*                                  Registration *
+\****************************************************************************************/
+
+static const CvNativeFuncInfo icv_cv_native_tab[] = {
+    {"ippiResize_8u_C1R", (void*)icvResize_8u_C1R_n},
+    {"ippiResize_8u_C3R", (void*)icvResize_8u_C3R_n},
+    {"ippiResize_8u_C4R", (void*)icvResize_8u_C4R_n},
+    {"ippiResize_16u_C1R", (void*)icvResize_16u_C1R_n},
+    {"ippiResize_16u_C3R", (void*)icvResize_16u_C3R_n},
+    {"ippiResize_16u_C4R", (void*)icvResize_16u_C4R_n},
+    {"ippiResize_32f_C1R", (void*)icvResize_32f_C1R_n},
+    {"ippiResize_32f_C3R", (void*)icvResize_32f_C3R_n},
+    {"ippiResize_32f_C4R", (void*)icvResize_32f_C4R_n},
+    {"ippiWarpAffineBack_8u_C1R", (void*)icvWarpAffineBack_8u_C1R_n},
+    {"ippiWarpAffineBack_8u_C3R", (void*)icvWarpAffineBack_8u_C3R_n},
+    {"ippiWarpAffineBack_8u_C4R", (void*)icvWarpAffineBack_8u_C4R_n},
+    {"ippiWarpAffineBack_32f_C1R", (void*)icvWarpAffineBack_32f_C1R_n},
+    {"ippiWarpAffineBack_32f_C3R", (void*)icvWarpAffineBack_32f_C3R_n},
+    {"ippiWarpAffineBack_32f_C4R", (void*)icvWarpAffineBack_32f_C4R_n},
+    {"ippiWarpPerspectiveBack_8u_C1R", (void*)icvWarpPerspectiveBack_8u_C1R_n},
+    {"ippiWarpPerspectiveBack_8u_C3R", (void*)icvWarpPerspectiveBack_8u_C3R_n},
+    {"ippiWarpPerspectiveBack_8u_C4R", (void*)icvWarpPerspectiveBack_8u_C4R_n},
+    {"ippiWarpPerspectiveBack_32f_C1R",
+     (void*)icvWarpPerspectiveBack_32f_C1R_n},
+    {"ippiWarpPerspectiveBack_32f_C3R",
+     (void*)icvWarpPerspectiveBack_32f_C3R_n},
+    {"ippiWarpPerspectiveBack_32f_C4R",
+     (void*)icvWarpPerspectiveBack_32f_C4R_n},
+    {"ippiRemap_8u_C1R", (void*)icvRemap_8u_C1R_n},
+    {"ippiRemap_8u_C3R", (void*)icvRemap_8u_C3R_n},
+    {"ippiRemap_8u_C4R", (void*)icvRemap_8u_C4R_n},
+    {"ippiRemap_32f_C1R", (void*)icvRemap_32f_C1R_n},
+    {"ippiRemap_32f_C3R", (void*)icvRemap_32f_C3R_n},
+    {"ippiRemap_32f_C4R", (void*)icvRemap_32f_C4R_n},
+    {0, 0}};
+
+static int icvRegisterCvNativeFuncs()
+{
+    if (!cvCheckHardwareSupport(CV_CPU_SSE4_1))
+        return 0;
+    icvInitLinearCoeffTab();
+    return cvRegisterNativeFuncs(icv_cv_native_tab);
+}
+
+static int icv_cv_native_funcs = icvRegisterCvNativeFuncs();
+
+#endif /* CV_SIMD_X86 */
+
+/* End of file. */
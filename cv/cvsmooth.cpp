@@ -158,19 +158,28 @@ void CvBoxFilter::init(int _max_width, int _src_type, int _dst_type,
 
 void CvBoxFilter::start_process(CvSlice x_range, int width)
 {
-    CvBaseImageFilter::start_process(x_range, width);
+    // the base class keeps the buffer layout if the stripe placement has
+    // not changed since the previous call, so the sum row is already there
+    bool same_range = x_range.start_index == prev_x_range.start_index
+                      && x_range.end_index == prev_x_range.end_index
+                      && width == prev_width;
     int i, psz = CV_ELEM_SIZE(work_type);
+    int bw = x_range.end_index - x_range.start_index;
     uchar* s;
-    buf_end -= buf_step;
-    buf_max_count--;
-    assert(buf_max_count >= max_ky * 2 + 1);
-    s = sum =
-        buf_end
-        + cvAlign((width + ksize.width - 1) * CV_ELEM_SIZE(src_type), ALIGN);
+
+    CvBaseImageFilter::start_process(x_range, width);
+    if (!same_range)
+    {
+        buf_end -= buf_step;
+        buf_max_count--;
+        assert(buf_max_count >= max_ky * 2 + 1);
+    }
+    s = sum = buf_end
+              + cvAlign((bw + ksize.width - 1) * CV_ELEM_SIZE(src_type), ALIGN);
     sum_count = 0;
 
-    width *= psz;
-    for (i = 0; i < width; i++)
+    bw *= psz;
+    for (i = 0; i < bw; i++)
         s[i] = (uchar)0;
 }
 
@@ -987,6 +996,182 @@ static CvStatus CV_STDCALL icvBilateralFiltering_8u_CnR(
 #undef COLOR_DISTANCE_C3
 }
 
+/****************************************************************************************\
+                                Recursive Gaussian Filter
+\****************************************************************************************/
+
+/* Young & van Vliet recursive approximation of the Gaussian filter. Unlike
+   the separable filter, its cost does not depend on sigma, so cvSmooth uses
+   it for large sigmas when the kernel size is not specified */
+#define ICV_IIR_GAUSSIAN_MIN_SIGMA 12.
+
+/* c[0] is the input weight, c[1..3] are the feedback weights and c[4..12] is
+   the matrix (scaled by c[0]) of Triggs & Sdika, which gives the initial
+   state of the anti-causal pass for the replicated border */
+static void icvRecursiveGaussianCoeffs(double sigma, double* c)
+{
+    double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330
+                            : 3.97156 - 4.14554 * sqrt(1 - 0.26891 * sigma);
+    double q2 = q * q, q3 = q2 * q;
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    double a1, a2, a3, scale;
+
+    a1 = c[1] = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+    a2 = c[2] = -(1.4281 * q2 + 1.26661 * q3) / b0;
+    a3 = c[3] = 0.422205 * q3 / b0;
+    c[0] = 1 - (a1 + a2 + a3);
+
+    scale = c[0] / ((1 + a1 - a2 + a3) * (1 - a1 - a2 - a3)
+                    * (1 + a2 + (a1 - a3) * a3));
+    c[4] = scale * (1 - a1 * a3 - a2 - a3 * a3);
+    c[5] = scale * (a3 + a1) * (a2 + a3 * a1);
+    c[6] = scale * a3 * (a1 + a3 * a2);
+    c[7] = scale * (a1 + a3 * a2);
+    c[8] = -scale * (a2 - 1) * (a2 + a3 * a1);
+    c[9] = -scale * a3 * (a3 * a1 + a3 * a3 + a2 - 1);
+    c[10] = scale * (a3 * a1 + a2 + a1 * a1 - a2 * a2);
+    c[11] = scale * (a1 * a2 + a3 * a2 * a2 - a1 * a3 * a3 - a3 * a3 * a3
+                     - a3 * a2 + a3);
+    c[12] = scale * a3 * (a1 + a3 * a2);
+}
+
+/* the causal and anti-causal passes along the rows, in place. The border
+   pixels are replicated */
+static void icvRecursiveGaussianRows_32f(float* data, int step, CvSize size,
+                                         int cn, const double* c)
+{
+    int x, y, k, width = size.width * cn;
+    int x1 = MAX(size.width - 2, 0) * cn, x2 = MAX(size.width - 3, 0) * cn;
+
+    step /= sizeof(data[0]);
+
+    for (y = 0; y < size.height; y++, data += step)
+        for (k = 0; k < cn; k++)
+        {
+            float* row = data + k;
+            double y1, y2, y3, u0, u1, u2, up = row[width - cn];
+
+            y1 = y2 = y3 = row[0];
+            for (x = 0; x < width; x += cn)
+            {
+                double t = c[0] * row[x] + c[1] * y1 + c[2] * y2 + c[3] * y3;
+                y3 = y2;
+                y2 = y1;
+                y1 = t;
+                row[x] = (float)t;
+            }
+
+            u0 = row[width - cn] - up;
+            u1 = row[x1] - up;
+            u2 = row[x2] - up;
+            y1 = c[4] * u0 + c[5] * u1 + c[6] * u2 + up;
+            y2 = c[7] * u0 + c[8] * u1 + c[9] * u2 + up;
+            y3 = c[10] * u0 + c[11] * u1 + c[12] * u2 + up;
+            row[width - cn] = (float)y1;
+
+            for (x = width - cn * 2; x >= 0; x -= cn)
+            {
+                double t = c[0] * row[x] + c[1] * y1 + c[2] * y2 + c[3] * y3;
+                y3 = y2;
+                y2 = y1;
+                y1 = t;
+                row[x] = (float)t;
+            }
+        }
+}
+
+/* the same along the columns. The whole rows are processed at once, the
+   filter state (3 rows) and the last source row are kept in buf */
+static void icvRecursiveGaussianCols_32f(float* data, int step, CvSize size,
+                                         int cn, const double* c, double* buf)
+{
+    int i, y, width = size.width * cn;
+    double *y1 = buf, *y2 = buf + width, *y3 = buf + width * 2, *t;
+    double* up = buf + width * 3;
+    float* row = data;
+    const float *row0, *row1, *row2;
+
+    step /= sizeof(data[0]);
+    row0 = data + (size.height - 1) * step;
+    row1 = data + MAX(size.height - 2, 0) * step;
+    row2 = data + MAX(size.height - 3, 0) * step;
+
+    for (i = 0; i < width; i++)
+    {
+        y1[i] = y2[i] = y3[i] = row[i];
+        up[i] = row0[i];
+    }
+
+    for (y = 0; y < size.height; y++, row += step)
+    {
+        for (i = 0; i < width; i++)
+        {
+            double s = c[0] * row[i] + c[1] * y1[i] + c[2] * y2[i]
+                       + c[3] * y3[i];
+            y3[i] = s;
+            row[i] = (float)s;
+        }
+        t = y3;
+        y3 = y2;
+        y2 = y1;
+        y1 = t;
+    }
+
+    for (i = 0; i < width; i++)
+    {
+        double u0 = row0[i] - up[i], u1 = row1[i] - up[i],
+               u2 = row2[i] - up[i];
+        y1[i] = c[4] * u0 + c[5] * u1 + c[6] * u2 + up[i];
+        y2[i] = c[7] * u0 + c[8] * u1 + c[9] * u2 + up[i];
+        y3[i] = c[10] * u0 + c[11] * u1 + c[12] * u2 + up[i];
+    }
+
+    row = data + (size.height - 1) * step;
+    for (i = 0; i < width; i++)
+        row[i] = (float)y1[i];
+
+    for (y = size.height - 2, row -= step; y >= 0; y--, row -= step)
+    {
+        for (i = 0; i < width; i++)
+        {
+            double s = c[0] * row[i] + c[1] * y1[i] + c[2] * y2[i]
+                       + c[3] * y3[i];
+            y3[i] = s;
+            row[i] = (float)s;
+        }
+        t = y3;
+        y3 = y2;
+        y2 = y1;
+        y1 = t;
+    }
+}
+
+static void icvRecursiveGaussian_32f(CvMat* mat, double sigma1, double sigma2)
+{
+    double* buf = 0;
+
+    CV_FUNCNAME("icvRecursiveGaussian_32f");
+
+    __BEGIN__;
+
+    CvSize size = cvGetMatSize(mat);
+    int cn = CV_MAT_CN(mat->type);
+    double cx[13], cy[13];
+
+    icvRecursiveGaussianCoeffs(sigma1, cx);
+    icvRecursiveGaussianCoeffs(sigma2, cy);
+
+    CV_CALL(buf = (double*)cvScratchAlloc(size.width * cn * 4
+                                          * sizeof(buf[0])));
+
+    icvRecursiveGaussianRows_32f(mat->data.fl, mat->step, size, cn, cx);
+    icvRecursiveGaussianCols_32f(mat->data.fl, mat->step, size, cn, cy, buf);
+
+    __END__;
+
+    cvScratchFree(&buf);
+}
+
 //////////////////////////////// IPP smoothing functions
 ////////////////////////////////////
 
@@ -1027,6 +1212,7 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
     int src_type, dst_type, depth, cn;
     double sigma1 = 0, sigma2 = 0;
     bool have_ipp = icvFilterMedian_8u_C1R_p != 0;
+    bool use_iir = false;
 
     CV_CALL(src = cvGetMat(src, &srcstub, &coi1));
     CV_CALL(dst = cvGetMat(dst, &dststub, &coi2));
@@ -1057,6 +1243,13 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
             sigma1 = param3;
             sigma2 = param4 ? param4 : param3;
 
+            // the recursive filter is an approximation, so it is off
+            // after cvUseOptimized(0)
+            use_iir = param1 == 0 && param2 == 0
+                      && (depth == CV_16U || depth == CV_32F)
+                      && MIN(sigma1, sigma2) >= ICV_IIR_GAUSSIAN_MIN_SIGMA
+                      && cvGetUseOptimized();
+
             if (param1 == 0 && sigma1 > 0)
                 param1 = cvRound(sigma1 * (depth == CV_8U ? 3 : 4) * 2 + 1) | 1;
             if (param2 == 0 && sigma2 > 0)
@@ -1146,6 +1339,25 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
         IPPI_CALL(icvMedianBlur_8u_CnR(src->data.ptr, src->step, dst->data.ptr,
                                        dst->step, size, param1, cn));
     }
+    else if (smooth_type == CV_GAUSSIAN && use_iir)
+    {
+        CvMat* buf = dst;
+
+        if (depth == CV_16U)
+        {
+            CV_CALL(temp = cvCreateScratchMat(size.height, size.width,
+                                              CV_MAKETYPE(CV_32F, cn)));
+            CV_CALL(cvConvert(src, temp));
+            buf = temp;
+        }
+        else if (src->data.ptr != dst->data.ptr)
+            CV_CALL(cvCopy(src, dst));
+
+        CV_CALL(icvRecursiveGaussian_32f(buf, sigma1, sigma2));
+
+        if (buf != dst)
+            CV_CALL(cvConvert(buf, dst));
+    }
     else if (smooth_type == CV_GAUSSIAN)
     {
         CvSize ksize = {param1, param2};
@@ -1193,7 +1405,7 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
 
     __END__;
 
-    cvReleaseMat(&temp);
+    cvScratchFree(&temp);
 }
 
 /* End of file. */
@@ -205,7 +205,7 @@ CV_IMPL void cvUndistort2(const CvArr* _src, CvArr* _dst, const CvMat* A,
 
         if (func && icvUndistortGetSize_p(size, &buf_size) >= 0 && buf_size > 0)
         {
-            CV_CALL(buffer = (uchar*)cvAlloc(buf_size));
+            CV_CALL(buffer = (uchar*)cvScratchAlloc(buf_size));
             if (func(src->data.ptr, src_step, dst->data.ptr, dst_step, size,
                      a[0], a[4], a[2], a[5], k[0], k[1], buffer)
                 >= 0)
@@ -218,7 +218,7 @@ CV_IMPL void cvUndistort2(const CvArr* _src, CvArr* _dst, const CvMat* A,
 
     __END__;
 
-    cvFree(&buffer);
+    cvScratchFree(&buffer);
 }
 
 CV_IMPL void cvInitUndistortMap(const CvMat* A, const CvMat* dist_coeffs,
@@ -237,23 +237,38 @@ CV_IMPL void cvInitUndistortMap(const CvMat* A, const CvMat* dist_coeffs,
     float *mapx, *mapy;
     CvMat _a = cvMat(3, 3, CV_32F, a), _k;
     int mapxstep, mapystep;
-    int u, v;
+    int u, v, fixed;
     float u0, v0, fx, fy, _fx, _fy, k1, k2, p1, p2;
     CvSize size;
 
     CV_CALL(_mapx = cvGetMat(_mapx, &mapxstub, &coi1));
-    CV_CALL(_mapy = cvGetMat(_mapy, &mapystub, &coi2));
+
+    // the fixed-point maps (see cvConvertMaps) may go without the
+    // fractional part
+    fixed = CV_MAT_TYPE(_mapx->type) == CV_16SC2;
+    if (_mapy || !fixed)
+        CV_CALL(_mapy = cvGetMat(_mapy, &mapystub, &coi2));
 
     if (coi1 != 0 || coi2 != 0)
         CV_ERROR(CV_BadCOI, "The function does not support COI");
 
-    if (CV_MAT_TYPE(_mapx->type) != CV_32FC1)
-        CV_ERROR(CV_StsUnsupportedFormat, "Both maps must have 32fC1 type");
+    if (fixed)
+    {
+        if (_mapy && CV_MAT_TYPE(_mapy->type) != CV_16UC1)
+            CV_ERROR(CV_StsUnmatchedFormats,
+                     "The fractional map must have 16uC1 type");
+    }
+    else
+    {
+        if (CV_MAT_TYPE(_mapx->type) != CV_32FC1)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Both maps must have 32fC1 type");
 
-    if (!CV_ARE_TYPES_EQ(_mapx, _mapy))
-        CV_ERROR(CV_StsUnmatchedFormats, "");
+        if (!CV_ARE_TYPES_EQ(_mapx, _mapy))
+            CV_ERROR(CV_StsUnmatchedFormats, "");
+    }
 
-    if (!CV_ARE_SIZES_EQ(_mapx, _mapy))
+    if (_mapy && !CV_ARE_SIZES_EQ(_mapx, _mapy))
         CV_ERROR(CV_StsUnmatchedSizes, "");
 
     if (!CV_IS_MAT(A) || A->rows != 3 || A->cols != 3
@@ -287,13 +302,25 @@ CV_IMPL void cvInitUndistortMap(const CvMat* A, const CvMat* dist_coeffs,
     p1 = k[2];
     p2 = k[3];
 
-    mapxstep = _mapx->step ? _mapx->step : CV_STUB_STEP;
-    mapystep = _mapy->step ? _mapy->step : CV_STUB_STEP;
-    mapx = _mapx->data.fl;
-    mapy = _mapy->data.fl;
-
     size = cvGetMatSize(_mapx);
 
+    if (fixed)
+    {
+        // the rows are computed in floating-point and then converted
+        CV_CALL(buffer =
+                    (uchar*)cvScratchAlloc(size.width * 2 * sizeof(float)));
+        mapx = (float*)buffer;
+        mapy = mapx + size.width;
+        mapxstep = mapystep = 0;
+    }
+    else
+    {
+        mapxstep = _mapx->step ? _mapx->step : CV_STUB_STEP;
+        mapystep = _mapy->step ? _mapy->step : CV_STUB_STEP;
+        mapx = _mapx->data.fl;
+        mapy = _mapy->data.fl;
+    }
+
     /*if( icvUndistortGetSize_p && icvCreateMapCameraUndistort_32f_C1R_p )
     {
         int buf_size = 0;
@@ -329,11 +356,17 @@ CV_IMPL void cvInitUndistortMap(const CvMat* A, const CvMat* dist_coeffs,
             mapx[u] = _u;
             mapy[u] = _v;
         }
+
+        if (fixed)
+            icvConvertMapRow(
+                mapx, mapy, (short*)(_mapx->data.ptr + v * _mapx->step),
+                _mapy ? (ushort*)(_mapy->data.ptr + v * _mapy->step) : 0,
+                size.width);
     }
 
     __END__;
 
-    cvFree(&buffer);
+    cvScratchFree(&buffer);
 }
 
 /*  End of file  */
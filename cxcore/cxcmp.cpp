@@ -805,19 +805,19 @@ CV_IMPL void cvCmpS(const void* srcarr, double value, void* dstarr, int cmp_op)
     ipp_cmp_op = cmp_op == CV_CMP_EQ   ? cvCmpEq
                  : cmp_op == CV_CMP_GE ? cvCmpGreaterEq
                                        : cvCmpGreater;
-    if (type == CV_8U && icvCompare_8u_C1R_p)
+    if (type == CV_8U && icvCompareC_8u_C1R_p)
     {
         IPPI_CALL(icvCompareC_8u_C1R_p(src1->data.ptr, src1_step, (uchar)ival,
                                        dst->data.ptr, dst_step, size,
                                        ipp_cmp_op));
     }
-    else if (type == CV_16S && icvCompare_16s_C1R_p)
+    else if (type == CV_16S && icvCompareC_16s_C1R_p)
     {
         IPPI_CALL(icvCompareC_16s_C1R_p(src1->data.s, src1_step, (short)ival,
                                         dst->data.s, dst_step, size,
                                         ipp_cmp_op));
     }
-    else if (type == CV_32F && icvCompare_32f_C1R_p)
+    else if (type == CV_32F && icvCompareC_32f_C1R_p)
     {
         IPPI_CALL(icvCompareC_32f_C1R_p(src1->data.fl, src1_step, (float)value,
                                         dst->data.fl, dst_step, size,
@@ -101,6 +101,47 @@ extern "C"
     CVAPI(void) cvFree_(void* ptr);
 #define cvFree(ptr) (cvFree_(*(ptr)), *(ptr) = 0)
 
+    /* Allocates a temporary buffer from the scratch arena of the calling
+       thread. The arena memory is reused, so the functions that allocate the
+       same temporaries over and over (e.g. for every frame of a video) do not
+       touch the heap once the arena has grown to their working set. The
+       blocks must be released by the same thread, preferably in the reverse
+       order; the memory of a block is reclaimed once all the blocks
+       allocated after it are released */
+    CVAPI(void*) cvScratchAlloc(size_t size);
+
+    /* Releases the block allocated by cvScratchAlloc */
+    CVAPI(void) cvScratchFree_(void* ptr);
+#define cvScratchFree(ptr) (cvScratchFree_(*(ptr)), *(ptr) = 0)
+
+    /* Allocates a matrix, header and data, with cvScratchAlloc.
+       It is released with cvScratchFree */
+    CVAPI(CvMat*) cvCreateScratchMat(int rows, int cols, int type);
+
+    /* Marks the current scratch arena top. cvEndScratchFrame releases all the
+       blocks allocated since the matching cvBeginScratchFrame call, e.g. at
+       the end of processing a frame */
+    CVAPI(int) cvBeginScratchFrame(void);
+    CVAPI(void) cvEndScratchFrame(int frame);
+
+    typedef struct CvScratchStats
+    {
+        size_t used;       // the memory taken by the blocks in use
+        size_t high_water; // the maximum of used
+        size_t capacity;   // the memory held by the arena
+        int blocks;        // the number of blocks in use
+        int heap_allocs;   // the number of times the arena has grown
+    } CvScratchStats;
+
+    /* Retrieves the scratch arena statistics of the calling thread.
+       If reset is set, high_water and heap_allocs are restarted */
+    CVAPI(void) cvGetScratchStats(CvScratchStats* stats,
+                                  int reset CV_DEFAULT(0));
+
+    /* Returns the scratch arena memory of the calling thread to the heap.
+       The arena must be empty. It is also released when the thread exits */
+    CVAPI(void) cvReleaseScratch(void);
+
     /* Allocates and initializes IplImage header */
     CVAPI(IplImage*) cvCreateImageHeader(CvSize size, int depth, int channels);
 
@@ -1551,12 +1592,37 @@ extern "C"
      * code */
     CVAPI(int) cvUseOptimized(int on_off);
 
+    /* Returns 0 after cvUseOptimized(0), when the built-in optimized code
+       which is not bit-exact with the pure C code must be off too */
+    CVAPI(int) cvGetUseOptimized(void);
+
+    /* Sets the number of threads the row-band parallel implementations
+       (see cvParallelFor) run on: 1 (the default) - serially, <= 0 - one
+       thread per processor. Returns the previous setting */
+    CVAPI(int) cvSetParallelThreads(int threads CV_DEFAULT(1));
+    CVAPI(int) cvGetParallelThreads(void);
+
     /* Retrieves information about the registered modules and loaded optimized
      * plugins */
     CVAPI(void)
     cvGetModuleInfo(const char* module_name, const char** version,
                     const char** loaded_addon_plugins);
 
+    /* Adds a table of built-in optimized functions. They are looked up by the
+       IPP primitive names used in the modules' function tables and fill the
+       slots that no loaded plugin provides */
+    CVAPI(int) cvRegisterNativeFuncs(const CvNativeFuncInfo* func_tab);
+
+#define CV_CPU_NONE 0
+#define CV_CPU_SSE2 3
+#define CV_CPU_SSE4_1 6
+#define CV_CPU_SSE4_2 7
+#define CV_CPU_AVX 10
+#define CV_CPU_AVX2 11
+
+    /* Checks whether the processor and the OS support the CV_CPU_* feature */
+    CVAPI(int) cvCheckHardwareSupport(int feature);
+
     /* Get current OpenCV error status */
     CVAPI(int) cvGetErrStatus(void);
 
@@ -1794,7 +1860,8 @@ extern "C"
         return cvRead(fs, cvGetFileNodeByName(fs, map, name), attributes);
     }
 
-    /* starts reading data from sequence or scalar numeric node */
+    /* starts reading data from sequence or scalar numeric node
+       (base64 data, see CV_STORAGE_BASE64, can only be read with cvReadRawData) */
     CVAPI(void)
     cvStartReadRawData(const CvFileStorage* fs, const CvFileNode* src,
                        CvSeqReader* reader);
@@ -1859,6 +1926,18 @@ extern "C"
     /* get index of the thread being executed */
     CVAPI(int) cvGetThreadNum(void);
 
+    /* processes the range [start, end) of a row-band parallel loop */
+    typedef int(CV_CDECL* CvParallelLoopBody)(int start, int end,
+                                              void* userdata);
+
+    /* splits [0, count) into bands of at least min_band items and runs body
+       on them, concurrently if cvSetParallelThreads allows it. The bands are
+       independent, so the result is the same as of body(0, count, userdata).
+       Returns the smallest (i.e. the first error) of the body return values */
+    CVAPI(int)
+    cvParallelFor(int count, int min_band, CvParallelLoopBody body,
+                  void* userdata);
+
 #ifdef __cplusplus
 }
 
@@ -48,6 +48,8 @@ direct,
 
 #include "_cxcore.h"
 
+#include <pthread.h>
+
 // On Win64 (IA64) optimized versions of DFT and DCT fail the tests
 #if defined WIN64 && !defined EM64T
 #pragma optimize("", off)
@@ -1935,6 +1937,231 @@ typedef CvStatus(CV_STDCALL* CvDFTFunc)(const void* src, void* dst, int n,
                                         const void* spec, void* buf, int inv,
                                         double scale);
 
+/* DFT plans: the factorization of the transform length, the twiddle factors
+   and the permutation table. The plans are cached per thread, the most
+   recently used first, so the transforms repeated on the arrays of the
+   same size do not recompute the tables */
+#define ICV_DFT_PLAN_CACHE_SIZE 8
+
+typedef struct CvDFTPlan
+{
+    struct CvDFTPlan* next;
+    int len, elem_size;
+    int inv_itab; // the permutation table is stored for the inverse real DFT
+    int nf, factors[34];
+    int* itab;
+    uchar* wave;
+} CvDFTPlan;
+
+static pthread_key_t icvDFTPlanKey;
+static pthread_once_t icvDFTPlanKeyOnce = PTHREAD_ONCE_INIT;
+
+static void icvReleaseDFTPlans(void* ptr)
+{
+    CvDFTPlan* plan = (CvDFTPlan*)ptr;
+    while (plan)
+    {
+        CvDFTPlan* next = plan->next;
+        cvFree(&plan);
+        plan = next;
+    }
+}
+
+static void icvCreateDFTPlanKey(void)
+{
+    pthread_key_create(&icvDFTPlanKey, icvReleaseDFTPlans);
+}
+
+static CvDFTPlan* icvGetDFTPlan(int len, int elem_size, int inv_itab)
+{
+    CvDFTPlan *plan = 0, *head, *prev = 0;
+    int count = 0;
+
+    CV_FUNCNAME("icvGetDFTPlan");
+
+    __BEGIN__;
+
+    pthread_once(&icvDFTPlanKeyOnce, icvCreateDFTPlanKey);
+    head = (CvDFTPlan*)pthread_getspecific(icvDFTPlanKey);
+
+    // inv_itab matters only if the transform is not done in-place
+    for (plan = head; plan; prev = plan, plan = plan->next, count++)
+        if (plan->len == len && plan->elem_size == elem_size
+            && (plan->inv_itab == inv_itab
+                || plan->factors[0] == plan->factors[plan->nf - 1]))
+            break;
+
+    if (plan)
+    {
+        if (prev)
+        {
+            prev->next = plan->next;
+            plan->next = head;
+        }
+    }
+    else
+    {
+        CV_CALL(plan = (CvDFTPlan*)cvAlloc(sizeof(*plan) + 16
+                                           + len * (elem_size + sizeof(int))));
+        plan->len = len;
+        plan->elem_size = elem_size;
+        plan->inv_itab = inv_itab;
+        plan->nf = icvDFTFactorize(len, plan->factors);
+        plan->wave = (uchar*)cvAlignPtr(plan + 1, 16);
+        plan->itab = (int*)(plan->wave + len * elem_size);
+        icvDFTInit(len, plan->nf, plan->factors, plan->itab, elem_size,
+                   plan->wave, inv_itab);
+        plan->next = head;
+
+        // drop the least recently used plan
+        if (count >= ICV_DFT_PLAN_CACHE_SIZE)
+        {
+            for (prev = plan; prev->next->next; prev = prev->next)
+                ;
+            cvFree(&prev->next);
+        }
+    }
+
+    pthread_setspecific(icvDFTPlanKey, plan);
+
+    __END__;
+
+    return plan;
+}
+
+/* the minimal number of the elements transformed in a band of the parallel
+   loops of cvDFT */
+#define ICV_DFT_MIN_BAND_SIZE (1 << 14)
+
+/* arguments of the cvDFT loops processing the bands of the rows (stage 0)
+   or of the column pairs (stage 1) */
+typedef struct CvDFTJob
+{
+    CvDFTFunc dft_func;
+    const CvDFTPlan* plan; // 0 if IPP is used
+    const void* spec;
+    uchar *sptr, *dptr;
+    int sstep, dstep;
+    int len, count, flags;
+    int elem_size, complex_elem_size;
+    int use_buf, buf_size;
+    int dst_full_len, dptr_offset;
+    double scale;
+} CvDFTJob;
+
+/* allocates the work buffer of a band and copies the factors, which the
+   real transforms modify temporarily */
+static uchar* icvDFTBandInit(const CvDFTJob* job, int* factors, int* nf)
+{
+    *nf = 0;
+    if (job->plan)
+    {
+        *nf = job->plan->nf;
+        memcpy(factors, job->plan->factors, *nf * sizeof(factors[0]));
+    }
+
+    return (uchar*)cvScratchAlloc(job->buf_size + 32);
+}
+
+static int CV_CDECL icvDFTRowBand(int i0, int i1, void* userdata)
+{
+    const CvDFTJob* job = (const CvDFTJob*)userdata;
+    const int* itab = job->plan ? job->plan->itab : 0;
+    const uchar* wave = job->plan ? job->plan->wave : 0;
+    int factors[34], nf, len = job->len, i;
+    uchar *buffer, *ptr, *tmp_buf = 0;
+    CvStatus status = CV_OK;
+
+    buffer = icvDFTBandInit(job, factors, &nf);
+    if (!buffer)
+        return CV_OUTOFMEM_ERR;
+
+    ptr = (uchar*)cvAlignPtr(buffer, 16);
+    if (job->use_buf)
+    {
+        tmp_buf = ptr;
+        ptr += len * job->complex_elem_size;
+    }
+
+    for (i = i0; i < i1 && status >= 0; i++)
+    {
+        uchar* sptr = job->sptr + i * job->sstep;
+        uchar* dptr0 = job->dptr + i * job->dstep;
+        uchar* dptr = tmp_buf ? tmp_buf : dptr0;
+
+        status = job->dft_func(sptr, dptr, len, nf, factors, itab, wave, len,
+                               job->spec, ptr, job->flags, job->scale);
+        if (dptr != dptr0)
+            memcpy(dptr0, dptr + job->dptr_offset, job->dst_full_len);
+    }
+
+    cvScratchFree(&buffer);
+    return status;
+}
+
+static int CV_CDECL icvDFTColumnBand(int p0, int p1, void* userdata)
+{
+    const CvDFTJob* job = (const CvDFTJob*)userdata;
+    const int* itab = job->plan ? job->plan->itab : 0;
+    const uchar* wave = job->plan ? job->plan->wave : 0;
+    int factors[34], nf, len = job->len, p;
+    int complex_elem_size = job->complex_elem_size;
+    uchar *buffer, *ptr, *buf0, *buf1, *dbuf0, *dbuf1;
+    CvStatus status = CV_OK;
+
+    buffer = icvDFTBandInit(job, factors, &nf);
+    if (!buffer)
+        return CV_OUTOFMEM_ERR;
+
+    ptr = (uchar*)cvAlignPtr(buffer, 16);
+    buf0 = ptr;
+    ptr += len * complex_elem_size;
+    buf1 = ptr;
+    ptr += len * complex_elem_size;
+    dbuf0 = buf0, dbuf1 = buf1;
+
+    if (job->use_buf)
+    {
+        dbuf1 = ptr;
+        dbuf0 = buf1;
+        ptr += len * complex_elem_size;
+    }
+
+    for (p = p0; p < p1 && status >= 0; p++)
+    {
+        uchar* sptr0 = job->sptr + p * 2 * complex_elem_size;
+        uchar* dptr0 = job->dptr + p * 2 * complex_elem_size;
+        int pair = p * 2 + 1 < job->count;
+
+        if (pair)
+        {
+            icvCopyFrom2Columns(sptr0, job->sstep, buf0, buf1, len,
+                                complex_elem_size);
+            status = job->dft_func(buf1, dbuf1, len, nf, factors, itab, wave,
+                                   len, job->spec, ptr, job->flags,
+                                   job->scale);
+            if (status < 0)
+                break;
+        }
+        else
+            icvCopyColumn(sptr0, job->sstep, buf0, complex_elem_size, len,
+                          complex_elem_size);
+
+        status = job->dft_func(buf0, dbuf0, len, nf, factors, itab, wave, len,
+                               job->spec, ptr, job->flags, job->scale);
+
+        if (pair)
+            icvCopyTo2Columns(dbuf0, dbuf1, dptr0, job->dstep, len,
+                              complex_elem_size);
+        else
+            icvCopyColumn(dbuf0, complex_elem_size, dptr0, job->dstep, len,
+                          complex_elem_size);
+    }
+
+    cvScratchFree(&buffer);
+    return status;
+}
+
 CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                    int nonzero_rows)
 {
@@ -1942,7 +2169,6 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
     static int inittab = 0;
 
     void* buffer = 0;
-    int local_alloc = 1;
     int depth = -1;
     void *spec_c = 0, *spec_r = 0, *spec = 0;
 
@@ -1950,7 +2176,7 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
 
     __BEGIN__;
 
-    int prev_len = 0, buf_size = 0, stage = 0;
+    int stage = 0;
     int nf = 0, inv = (flags & CV_DXT_INVERSE) != 0;
     int real_transform = 0;
     CvMat *src = (CvMat*)srcarr, *dst = (CvMat*)dstarr;
@@ -2056,12 +2282,10 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
     for (;;)
     {
         double scale = 1;
-        uchar* wave = 0;
-        int* itab = 0;
-        uchar* ptr;
-        int i, len, count, sz = 0;
+        int i, len, count, work_sz = 0;
         int use_buf = 0, odd_real = 0;
-        CvDFTFunc dft_func;
+        CvDFTPlan* plan = 0;
+        CvDFTJob job;
 
         if (stage == 0) // row-wise transform
         {
@@ -2078,15 +2302,12 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
         {
             len = dst->rows;
             count = !inv ? src0->cols : dst->cols;
-            sz = 2 * len * complex_elem_size;
         }
 
         spec = 0;
         if (len * count >= 64
             && icvDFTInitAlloc_R_32f_p != 0) // use IPP DFT if available
         {
-            int ipp_sz = 0;
-
             if (real_transform && stage == 0)
             {
                 if (depth == CV_32F)
@@ -2095,7 +2316,7 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                         IPPI_CALL(icvDFTFree_R_32f_p(spec_r));
                     IPPI_CALL(icvDFTInitAlloc_R_32f_p(
                         &spec_r, len, ipp_norm_flag, cvAlgHintNone));
-                    IPPI_CALL(icvDFTGetBufSize_R_32f_p(spec_r, &ipp_sz));
+                    IPPI_CALL(icvDFTGetBufSize_R_32f_p(spec_r, &work_sz));
                 }
                 else
                 {
@@ -2103,7 +2324,7 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                         IPPI_CALL(icvDFTFree_R_64f_p(spec_r));
                     IPPI_CALL(icvDFTInitAlloc_R_64f_p(
                         &spec_r, len, ipp_norm_flag, cvAlgHintNone));
-                    IPPI_CALL(icvDFTGetBufSize_R_64f_p(spec_r, &ipp_sz));
+                    IPPI_CALL(icvDFTGetBufSize_R_64f_p(spec_r, &work_sz));
                 }
                 spec = spec_r;
             }
@@ -2115,7 +2336,7 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                         IPPI_CALL(icvDFTFree_C_32fc_p(spec_c));
                     IPPI_CALL(icvDFTInitAlloc_C_32fc_p(
                         &spec_c, len, ipp_norm_flag, cvAlgHintNone));
-                    IPPI_CALL(icvDFTGetBufSize_C_32fc_p(spec_c, &ipp_sz));
+                    IPPI_CALL(icvDFTGetBufSize_C_32fc_p(spec_c, &work_sz));
                 }
                 else
                 {
@@ -2123,95 +2344,59 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                         IPPI_CALL(icvDFTFree_C_64fc_p(spec_c));
                     IPPI_CALL(icvDFTInitAlloc_C_64fc_p(
                         &spec_c, len, ipp_norm_flag, cvAlgHintNone));
-                    IPPI_CALL(icvDFTGetBufSize_C_64fc_p(spec_c, &ipp_sz));
+                    IPPI_CALL(icvDFTGetBufSize_C_64fc_p(spec_c, &work_sz));
                 }
                 spec = spec_c;
             }
-
-            sz += ipp_sz;
         }
         else
         {
-            if (len != prev_len)
-                nf = icvDFTFactorize(len, factors);
+            // the tables of the real inverse transform are different
+            CV_CALL(plan = icvGetDFTPlan(len, complex_elem_size,
+                                         stage == 0 && inv && real_transform));
+            nf = plan->nf;
+            memcpy(factors, plan->factors, nf * sizeof(factors[0]));
 
             inplace_transform = factors[0] == factors[nf - 1];
-            sz += len * (complex_elem_size + sizeof(int));
             i = nf > 1 && (factors[0] & 1) == 0;
             if ((factors[i] & 1) != 0 && factors[i] > 5)
-                sz += (factors[i] + 1) * complex_elem_size;
+                work_sz = (factors[i] + 1) * complex_elem_size;
 
             if (stage == 0
                     && (src->data.ptr == dst->data.ptr && !inplace_transform
                         || odd_real)
                 || stage == 1 && !inplace_transform)
-            {
                 use_buf = 1;
-                sz += len * complex_elem_size;
-            }
         }
 
-        if (sz > buf_size)
-        {
-            prev_len = 0; // because we release the buffer,
-                          // force recalculation of
-                          // twiddle factors and permutation table
-            if (!local_alloc && buffer)
-                cvFree(&buffer);
-            if (sz <= CV_MAX_LOCAL_DFT_SIZE)
-            {
-                buf_size = sz = CV_MAX_LOCAL_DFT_SIZE;
-                buffer = cvStackAlloc(sz + 32);
-                local_alloc = 1;
-            }
-            else
-            {
-                CV_CALL(buffer = cvAlloc(sz + 32));
-                buf_size = sz;
-                local_alloc = 0;
-            }
-        }
-
-        ptr = (uchar*)buffer;
-        if (!spec)
-        {
-            wave = ptr;
-            ptr += len * complex_elem_size;
-            itab = (int*)ptr;
-            ptr = (uchar*)cvAlignPtr(ptr + len * sizeof(int), 16);
-
-            if (len != prev_len
-                || (!inplace_transform && inv && real_transform))
-                icvDFTInit(len, nf, factors, itab, complex_elem_size, wave,
-                           stage == 0 && inv && real_transform);
-            // otherwise reuse the tables calculated on the previous stage
-        }
+        job.plan = plan;
+        job.spec = spec;
+        job.len = len;
+        job.elem_size = elem_size;
+        job.complex_elem_size = complex_elem_size;
+        job.use_buf = use_buf;
+        job.buf_size = work_sz + (use_buf ? len * complex_elem_size : 0);
 
         if (stage == 0)
         {
-            uchar* tmp_buf = 0;
-            int dptr_offset = 0;
-            int dst_full_len = len * elem_size;
             int _flags = inv
                          + (CV_MAT_CN(src->type) != CV_MAT_CN(dst->type)
                                 ? ICV_DFT_COMPLEX_INPUT_OR_OUTPUT
                                 : 0);
-            if (use_buf)
-            {
-                tmp_buf = ptr;
-                ptr += len * complex_elem_size;
-                if (odd_real && !inv && len > 1
-                    && !(_flags & ICV_DFT_COMPLEX_INPUT_OR_OUTPUT))
-                    dptr_offset = elem_size;
-            }
+
+            job.dptr_offset = 0;
+            job.dst_full_len = len * elem_size;
+            if (use_buf && odd_real && !inv && len > 1
+                && !(_flags & ICV_DFT_COMPLEX_INPUT_OR_OUTPUT))
+                job.dptr_offset = elem_size;
 
             if (!inv && (_flags & ICV_DFT_COMPLEX_INPUT_OR_OUTPUT))
-                dst_full_len += (len & 1) ? elem_size : complex_elem_size;
+                job.dst_full_len += (len & 1) ? elem_size : complex_elem_size;
 
-            dft_func = dft_tbl[(!real_transform ? 0
-                                : !inv          ? 1
-                                                : 2)
-                               + (depth == CV_64F) * 3];
+            job.dft_func = dft_tbl[(!real_transform ? 0
+                                    : !inv          ? 1
+                                                    : 2)
+                                   + (depth == CV_64F) * 3];
 
             if (count > 1 && !(flags & CV_DXT_ROWS)
                 && (!inv || !real_transform))
@@ -2222,25 +2407,22 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
             if (nonzero_rows <= 0 || nonzero_rows > count)
                 nonzero_rows = count;
 
-            for (i = 0; i < nonzero_rows; i++)
-            {
-                uchar* sptr = src->data.ptr + i * src->step;
-                uchar* dptr0 = dst->data.ptr + i * dst->step;
-                uchar* dptr = dptr0;
-
-                if (tmp_buf)
-                    dptr = tmp_buf;
+            job.sptr = src->data.ptr;
+            job.dptr = dst->data.ptr;
+            job.sstep = src->step;
+            job.dstep = dst->step;
+            job.count = nonzero_rows;
+            job.flags = _flags;
+            job.scale = scale;
 
-                dft_func(sptr, dptr, len, nf, factors, itab, wave, len, spec,
-                         ptr, _flags, scale);
-                if (dptr != dptr0)
-                    memcpy(dptr0, dptr + dptr_offset, dst_full_len);
-            }
+            IPPI_CALL((CvStatus)cvParallelFor(
+                nonzero_rows, ICV_DFT_MIN_BAND_SIZE / len, icvDFTRowBand,
+                &job));
 
-            for (; i < count; i++)
+            for (i = nonzero_rows; i < count; i++)
             {
                 uchar* dptr0 = dst->data.ptr + i * dst->step;
-                memset(dptr0, 0, dst_full_len);
+                memset(dptr0, 0, job.dst_full_len);
             }
 
             if (stage != 1)
@@ -2250,23 +2432,14 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
         else
         {
             int a = 0, b = count;
-            uchar *buf0, *buf1, *dbuf0, *dbuf1;
+            uchar *buf0, *buf1, *dbuf0, *dbuf1, *ptr;
             uchar* sptr0 = src->data.ptr;
             uchar* dptr0 = dst->data.ptr;
-            buf0 = ptr;
-            ptr += len * complex_elem_size;
-            buf1 = ptr;
-            ptr += len * complex_elem_size;
-            dbuf0 = buf0, dbuf1 = buf1;
+            CvDFTFunc dft_func = dft_tbl[(depth == CV_64F) * 3];
+            int* itab = plan ? plan->itab : 0;
+            uchar* wave = plan ? plan->wave : 0;
 
-            if (use_buf)
-            {
-                dbuf1 = ptr;
-                dbuf0 = buf1;
-                ptr += len * complex_elem_size;
-            }
-
-            dft_func = dft_tbl[(depth == CV_64F) * 3];
+            job.buf_size += 2 * len * complex_elem_size;
 
             if (real_transform && inv && src->cols > 1)
                 stage = 0;
@@ -2279,6 +2452,26 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                 a = 1;
                 even = (count & 1) == 0;
                 b = (count + 1) / 2;
+
+                // the first and, if the number of columns is even, the last
+                // columns are transformed here, the rest on the parallel
+                // bands
+                CV_CALL(buffer = cvScratchAlloc(job.buf_size + 32));
+
+                ptr = (uchar*)cvAlignPtr(buffer, 16);
+                buf0 = ptr;
+                ptr += len * complex_elem_size;
+                buf1 = ptr;
+                ptr += len * complex_elem_size;
+                dbuf0 = buf0, dbuf1 = buf1;
+
+                if (use_buf)
+                {
+                    dbuf1 = ptr;
+                    dbuf0 = buf1;
+                    ptr += len * complex_elem_size;
+                }
+
                 if (!inv)
                 {
                     memset(buf0, 0, len * complex_elem_size);
@@ -2372,33 +2565,22 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                                       len, complex_elem_size);
                     dptr0 += complex_elem_size;
                 }
-            }
 
-            for (i = a; i < b; i += 2)
-            {
-                if (i + 1 < b)
-                {
-                    icvCopyFrom2Columns(sptr0, src->step, buf0, buf1, len,
-                                        complex_elem_size);
-                    IPPI_CALL(dft_func(buf1, dbuf1, len, nf, factors, itab,
-                                       wave, len, spec, ptr, inv, scale));
-                }
-                else
-                    icvCopyColumn(sptr0, src->step, buf0, complex_elem_size,
-                                  len, complex_elem_size);
+                cvScratchFree(&buffer);
+            }
 
-                IPPI_CALL(dft_func(buf0, dbuf0, len, nf, factors, itab, wave,
-                                   len, spec, ptr, inv, scale));
+            job.dft_func = dft_func;
+            job.sptr = sptr0;
+            job.dptr = dptr0;
+            job.sstep = src->step;
+            job.dstep = dst->step;
+            job.count = b - a;
+            job.flags = inv;
+            job.scale = scale;
 
-                if (i + 1 < b)
-                    icvCopyTo2Columns(dbuf0, dbuf1, dptr0, dst->step, len,
-                                      complex_elem_size);
-                else
-                    icvCopyColumn(dbuf0, complex_elem_size, dptr0, dst->step,
-                                  len, complex_elem_size);
-                sptr0 += 2 * complex_elem_size;
-                dptr0 += 2 * complex_elem_size;
-            }
+            IPPI_CALL((CvStatus)cvParallelFor(
+                (b - a + 1) / 2, ICV_DFT_MIN_BAND_SIZE / (len * 2),
+                icvDFTColumnBand, &job));
 
             if (stage != 0)
                 break;
@@ -2408,8 +2590,8 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
 
     __END__;
 
-    if (buffer && !local_alloc)
-        cvFree(&buffer);
+    if (buffer)
+        cvScratchFree(&buffer);
 
     if (spec_c)
     {
@@ -2979,7 +3161,7 @@ CV_IMPL void cvDCT(const CvArr* srcarr, CvArr* dstarr, int flags)
             if (sz > buf_size)
             {
                 if (!local_alloc && buffer)
-                    cvFree(&buffer);
+                    cvScratchFree(&buffer);
                 if (sz <= CV_MAX_LOCAL_DFT_SIZE)
                 {
                     buf_size = sz = CV_MAX_LOCAL_DFT_SIZE;
@@ -2988,7 +3170,7 @@ CV_IMPL void cvDCT(const CvArr* srcarr, CvArr* dstarr, int flags)
                 }
                 else
                 {
-                    CV_CALL(buffer = cvAlloc(sz + 32));
+                    CV_CALL(buffer = cvScratchAlloc(sz + 32));
                     buf_size = sz;
                     local_alloc = 0;
                 }
@@ -3041,7 +3223,7 @@ CV_IMPL void cvDCT(const CvArr* srcarr, CvArr* dstarr, int flags)
     }
 
     if (buffer && !local_alloc)
-        cvFree(&buffer);
+        cvScratchFree(&buffer);
 }
 
 static const int icvOptimalDFTSize[] = {
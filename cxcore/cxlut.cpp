@@ -52,6 +52,147 @@ direct,
 *                                    LUT Transform *
 \****************************************************************************************/
 
+/* the image is split into row bands of at least that many elements (see
+   cvParallelFor) */
+#define ICV_LUT_MIN_BAND_SIZE (1 << 16)
+
+/* AVX2 versions of the transforms. The table entries are fetched with the
+   gather instructions, 8 elements at a time; the elements of the different
+   channels are looked up in the interleaved multi-channel tables by adding
+   the channel index to the scaled source values. The 8u and 16u tables
+   are widened to 32 bits first. The functions return a negative value
+   when the processor has no AVX2 or the image is too small for the
+   table setup to pay off, and the generic code is used then */
+#if CV_SIMD_X86
+
+#include <immintrin.h>
+
+#define ICV_LUT_GATHER_MIN_SIZE 1024
+
+static int icvHaveAVX2()
+{
+    static int have_avx2 = -1;
+    if (have_avx2 < 0)
+        have_avx2 = cvCheckHardwareSupport(CV_CPU_AVX2);
+    return have_avx2;
+}
+
+/* the table indices of 8 source elements starting with the channel k. The
+   source values are multiplied by cn with madd, which is much cheaper than
+   mullo, as they fit into the low 16-bit halves of the lanes */
+#define ICV_LUT_IDX_AVX2(src, k)                                            \
+    _mm256_add_epi32(                                                       \
+        _mm256_madd_epi16(                                                  \
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src))), \
+            vcn),                                                           \
+        ofs[k])
+
+#define ICV_LUT_GATHER_8U_AVX2(dst, lut, idx)                             \
+    {                                                                     \
+        __m256i v = _mm256_i32gather_epi32(lut, idx, 4);                  \
+        __m128i t = _mm_packus_epi32(_mm256_castsi256_si128(v),           \
+                                     _mm256_extracti128_si256(v, 1));     \
+        _mm_storel_epi64((__m128i*)(dst), _mm_packus_epi16(t, t));        \
+    }
+#define ICV_LUT_GATHER_16U_AVX2(dst, lut, idx)                            \
+    {                                                                     \
+        __m256i v = _mm256_i32gather_epi32(lut, idx, 4);                  \
+        _mm_storeu_si128((__m128i*)(dst),                                 \
+                         _mm_packus_epi32(_mm256_castsi256_si128(v),      \
+                                          _mm256_extracti128_si256(v, 1))); \
+    }
+#define ICV_LUT_GATHER_32S_AVX2(dst, lut, idx) \
+    _mm256_storeu_si256((__m256i*)(dst), _mm256_i32gather_epi32(lut, idx, 4))
+/* the masked gather with an explicit zero source, as GCC warns that the
+   source _mm256_i32gather_pd leaves undefined may be used uninitialized */
+#define ICV_LUT_GATHER_64F_AVX2(dst, lut, idx)                             \
+    {                                                                      \
+        __m256d z = _mm256_setzero_pd();                                   \
+        __m256d m = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));           \
+        _mm256_storeu_pd(dst, _mm256_mask_i32gather_pd(                    \
+                                  z, lut, _mm256_castsi256_si128(idx), m,  \
+                                  8));                                     \
+        _mm256_storeu_pd((dst) + 4,                                        \
+                         _mm256_mask_i32gather_pd(                         \
+                             z, lut, _mm256_extracti128_si256(idx, 1), m,  \
+                             8));                                          \
+    }
+
+/* the rows are processed in groups of cn vectors, so that every vector
+   starts with the same channel in all the iterations */
+#define ICV_DEF_LUT_GATHER_AVX2(flavor, dsttype, luttype, gather_macro)      \
+    static CV_TARGET_AVX2 void icvLUTGather_##flavor##_avx2(                 \
+        const uchar* src, int srcstep, dsttype* dst, int dststep,            \
+        CvSize size, const luttype* lut, const dsttype* _lut, int cn)        \
+    {                                                                        \
+        __m256i ofs[4], vcn = _mm256_set1_epi32(cn);                         \
+        int i, k;                                                            \
+                                                                             \
+        for (k = 0; k < cn; k++)                                             \
+            ofs[k] = _mm256_setr_epi32(                                      \
+                (k * 8) % cn, (k * 8 + 1) % cn, (k * 8 + 2) % cn,            \
+                (k * 8 + 3) % cn, (k * 8 + 4) % cn, (k * 8 + 5) % cn,        \
+                (k * 8 + 6) % cn, (k * 8 + 7) % cn);                         \
+                                                                             \
+        for (; size.height--; src += srcstep, dst += dststep)                \
+        {                                                                    \
+            for (i = 0; i <= size.width - cn * 8; i += cn * 8)               \
+                for (k = 0; k < cn; k++)                                     \
+                    gather_macro(dst + i + k * 8, lut,                       \
+                                 ICV_LUT_IDX_AVX2(src + i + k * 8, k));      \
+                                                                             \
+            for (; i < size.width; i++)                                      \
+                dst[i] = _lut[src[i] * cn + i % cn];                         \
+        }                                                                    \
+    }
+
+ICV_DEF_LUT_GATHER_AVX2(8u, uchar, int, ICV_LUT_GATHER_8U_AVX2)
+ICV_DEF_LUT_GATHER_AVX2(16u, ushort, int, ICV_LUT_GATHER_16U_AVX2)
+ICV_DEF_LUT_GATHER_AVX2(32s, int, int, ICV_LUT_GATHER_32S_AVX2)
+ICV_DEF_LUT_GATHER_AVX2(64f, double, double, ICV_LUT_GATHER_64F_AVX2)
+
+/* widen: 1 if the table is copied to a temporary 32-bit one */
+#define ICV_DEF_LUT_GATHER_FUNC(flavor, dsttype, luttype, widen)              \
+    static int icvLUTGather_##flavor(const uchar* src, int srcstep,           \
+                                     dsttype* dst, int dststep, CvSize size,  \
+                                     const dsttype* _lut, int cn)             \
+    {                                                                         \
+        luttype buf[widen ? 256 * 4 : 1];                                     \
+        const luttype* lut = (const luttype*)_lut;                            \
+        int i;                                                                \
+                                                                              \
+        if (!icvHaveAVX2()                                                    \
+            || size.width * size.height < ICV_LUT_GATHER_MIN_SIZE)            \
+            return -1;                                                        \
+                                                                              \
+        if (widen)                                                            \
+        {                                                                     \
+            for (i = 0; i < 256 * cn; i++)                                    \
+                buf[i] = (luttype)_lut[i];                                    \
+            lut = buf;                                                        \
+        }                                                                     \
+                                                                              \
+        size.width *= cn;                                                     \
+        icvLUTGather_##flavor##_avx2(src, srcstep, dst,                       \
+                                     dststep / sizeof(dst[0]), size, lut,     \
+                                     _lut, cn);                               \
+        return CV_OK;                                                         \
+    }
+
+ICV_DEF_LUT_GATHER_FUNC(8u, uchar, int, 1)
+ICV_DEF_LUT_GATHER_FUNC(16u, ushort, int, 1)
+ICV_DEF_LUT_GATHER_FUNC(32s, int, int, 0)
+ICV_DEF_LUT_GATHER_FUNC(64f, double, double, 0)
+
+#else
+
+#define icvLUTGather_8u(src, srcstep, dst, dststep, size, lut, cn) -1
+#define icvLUTGather_16u(src, srcstep, dst, dststep, size, lut, cn) -1
+#define icvLUTGather_32s(src, srcstep, dst, dststep, size, lut, cn) -1
+#define icvLUTGather_64f(src, srcstep, dst, dststep, size, lut, cn) -1
+
+#endif /* CV_SIMD_X86 */
+
 #define ICV_LUT_CASE_C1(type)                \
     for (i = 0; i <= size.width - 4; i += 4) \
     {                                        \
@@ -110,6 +251,10 @@ direct,
         const uchar* src, int srcstep, dsttype* dst, int dststep, CvSize size, \
         const dsttype* lut)                                                    \
     {                                                                          \
+        if (icvLUTGather_##flavor(src, srcstep, dst, dststep, size, lut, cn)   \
+            >= 0)                                                              \
+            return CV_OK;                                                      \
+                                                                               \
         size.width *= cn;                                                      \
         dststep /= sizeof(dst[0]);                                             \
         for (; size.height--; src += srcstep, dst += dststep)                  \
@@ -139,6 +284,10 @@ ICV_DEF_LUT_FUNC_8U_CN(8u, uchar, 4)
         dsttype lutp[1024];                                                    \
         int i, k;                                                              \
                                                                                \
+        if (icvLUTGather_##flavor(src, srcstep, dst, dststep, size, _lut, cn)  \
+            >= 0)                                                              \
+            return CV_OK;                                                      \
+                                                                               \
         size.width *= cn;                                                      \
         dststep /= sizeof(dst[0]);                                             \
                                                                                \
@@ -177,7 +326,7 @@ ICV_DEF_LUT_FUNC_8U_CN(8u, uchar, 4)
                 }                                                              \
                 src -= cn;                                                     \
                 dst -= cn;                                                     \
-                i += limit;                                                    \
+                i = limit;                                                     \
             }                                                                  \
         }                                                                      \
                                                                                \
@@ -209,6 +358,47 @@ typedef CvStatus(CV_STDCALL* CvLUT_TransformCnFunc)(const void* src,
                                                     int dststep, CvSize size,
                                                     const void* lut, int cn);
 
+/* arguments of the transform functions processing the row bands. A single
+   row (a continuous array) is split into the column bands */
+typedef struct CvLUTJob
+{
+    CvLUT_TransformFunc func;
+    CvLUT_TransformCnFunc cn_func;
+    const uchar* src;
+    uchar* dst;
+    int srcstep, dststep;
+    int src_pix_size, dst_pix_size;
+    CvSize size;
+    const uchar* lut;
+    int cn;
+} CvLUTJob;
+
+static int CV_CDECL icvLUTBand(int start, int end, void* userdata)
+{
+    const CvLUTJob* job = (const CvLUTJob*)userdata;
+    const uchar* src = job->src;
+    uchar* dst = job->dst;
+    CvSize size = job->size;
+
+    if (size.height == 1)
+    {
+        src += start * job->src_pix_size;
+        dst += start * job->dst_pix_size;
+        size.width = end - start;
+    }
+    else
+    {
+        src += start * job->srcstep;
+        dst += start * job->dststep;
+        size.height = end - start;
+    }
+
+    if (job->func)
+        return job->func(src, job->srcstep, dst, job->dststep, size, job->lut);
+    return job->cn_func(src, job->srcstep, dst, job->dststep, size, job->lut,
+                        job->cn);
+}
+
 CV_IMPL void cvLUT(const void* srcarr, void* dstarr, const void* lutarr)
 {
     static CvFuncTable lut_c1_tab, lut_cn_tab;
@@ -227,6 +417,7 @@ CV_IMPL void cvLUT(const void* srcarr, void* dstarr, const void* lutarr)
     uchar* lut_data;
     uchar* shuffled_lut = 0;
     CvSize size;
+    CvLUTJob job;
 
     if (!inittab)
     {
@@ -297,28 +488,48 @@ CV_IMPL void cvLUT(const void* srcarr, void* dstarr, const void* lutarr)
         lut_data = shuffled_lut;
     }
 
+    job.func = 0;
+    job.cn_func = 0;
+
     if (lut_cn == 1 || lut_cn <= 4 && depth == CV_8U)
     {
-        CvLUT_TransformFunc func =
-            depth == CV_8U ? lut_8u_tab[cn - 1]
-                           : (CvLUT_TransformFunc)(lut_c1_tab.fn_2d[depth]);
+        job.func = depth == CV_8U
+                       ? lut_8u_tab[cn - 1]
+                       : (CvLUT_TransformFunc)(lut_c1_tab.fn_2d[depth]);
 
-        if (!func)
+        if (!job.func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
-
-        IPPI_CALL(func(src->data.ptr, src->step, dst->data.ptr, dst->step, size,
-                       lut_data));
     }
     else
     {
-        CvLUT_TransformCnFunc func =
-            (CvLUT_TransformCnFunc)(lut_cn_tab.fn_2d[depth]);
+        job.cn_func = (CvLUT_TransformCnFunc)(lut_cn_tab.fn_2d[depth]);
 
-        if (!func)
+        if (!job.cn_func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
+    }
 
-        IPPI_CALL(func(src->data.ptr, src->step, dst->data.ptr, dst->step, size,
-                       lut_data, cn));
+    job.src = src->data.ptr;
+    job.dst = dst->data.ptr;
+    job.srcstep = src->step;
+    job.dststep = dst->step;
+    job.src_pix_size = cn;
+    job.dst_pix_size = CV_ELEM_SIZE1(depth) * cn;
+    job.size = size;
+    job.lut = lut_data;
+    job.cn = cn;
+
+    if (size.height == 1)
+    {
+        IPPI_CALL((CvStatus)cvParallelFor(size.width,
+                                          ICV_LUT_MIN_BAND_SIZE / cn,
+                                          icvLUTBand, &job));
+    }
+    else
+    {
+        IPPI_CALL((CvStatus)cvParallelFor(
+            size.height,
+            MAX(ICV_LUT_MIN_BAND_SIZE / MAX(size.width * cn, 1), 1),
+            icvLUTBand, &job));
     }
 
     __END__;
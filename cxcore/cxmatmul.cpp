@@ -124,7 +124,238 @@ static void icvGEMM_TransposeBlock(const uchar* src, int src_step, uchar* dst,
     }
 }
 
-#define ICV_DEF_GEMM_SINGLE_MUL(flavor, arrtype, worktype)                     \
+/* the minimal number of multiply-adds in a band of the parallel loops of
+   cvGEMM and of the transformation functions */
+#define ICV_MATMUL_MIN_BAND_OPS (1 << 16)
+
+/* SSE2/AVX2 kernels computing a row of a product of a row vector and a
+   matrix: d[j] = (do_acc ? d[j] : 0) + sum_k a[k]*b[k][j]. They process the
+   longest prefix of the row that fills whole vectors and return its length.
+   The sums are accumulated in double precision in the same order as in
+   the generic code, so the results are the same */
+#if CV_SIMD_X86
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+static int icvMatMulSimdLevel()
+{
+    static int level = -1;
+    if (level < 0)
+        level = cvCheckHardwareSupport(CV_CPU_AVX2)   ? 2
+                : cvCheckHardwareSupport(CV_CPU_SSE2) ? 1
+                                                      : 0;
+    return level;
+}
+
+#define ICV_LOAD_32F64F_SSE2(p) \
+    _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(p))))
+#define ICV_LOAD_64F_SSE2(p) _mm_loadu_pd(p)
+#define ICV_LOAD_32F64F_AVX2(p) _mm256_cvtps_pd(_mm_loadu_ps(p))
+#define ICV_LOAD_64F_AVX2(p) _mm256_loadu_pd(p)
+
+#define ICV_DEF_GEMM_ROW_MUL_SIMD(flavor, arrtype, load_sse2, load_avx2)     \
+    static CV_TARGET_SSE2 int icvGEMMRowMul_##flavor##_sse2(                 \
+        const arrtype* a, const arrtype* b, size_t b_step, double* d, int n, \
+        int m, int do_acc)                                                   \
+    {                                                                        \
+        int j = 0, k;                                                        \
+        for (; j <= m - 8; j += 8)                                           \
+        {                                                                    \
+            const arrtype* bk = b + j;                                       \
+            __m128d s0, s1, s2, s3;                                          \
+            if (do_acc)                                                      \
+            {                                                                \
+                s0 = _mm_loadu_pd(d + j);                                    \
+                s1 = _mm_loadu_pd(d + j + 2);                                \
+                s2 = _mm_loadu_pd(d + j + 4);                                \
+                s3 = _mm_loadu_pd(d + j + 6);                                \
+            }                                                                \
+            else                                                             \
+                s0 = s1 = s2 = s3 = _mm_setzero_pd();                        \
+            for (k = 0; k < n; k++, bk += b_step)                            \
+            {                                                                \
+                __m128d ak = _mm_set1_pd(a[k]);                              \
+                s0 = _mm_add_pd(s0, _mm_mul_pd(ak, load_sse2(bk)));          \
+                s1 = _mm_add_pd(s1, _mm_mul_pd(ak, load_sse2(bk + 2)));      \
+                s2 = _mm_add_pd(s2, _mm_mul_pd(ak, load_sse2(bk + 4)));      \
+                s3 = _mm_add_pd(s3, _mm_mul_pd(ak, load_sse2(bk + 6)));      \
+            }                                                                \
+            _mm_storeu_pd(d + j, s0);                                        \
+            _mm_storeu_pd(d + j + 2, s1);                                    \
+            _mm_storeu_pd(d + j + 4, s2);                                    \
+            _mm_storeu_pd(d + j + 6, s3);                                    \
+        }                                                                    \
+        return j;                                                            \
+    }                                                                        \
+                                                                             \
+    static CV_TARGET_AVX2 int icvGEMMRowMul_##flavor##_avx2(                 \
+        const arrtype* a, const arrtype* b, size_t b_step, double* d, int n, \
+        int m, int do_acc)                                                   \
+    {                                                                        \
+        int j = 0, k;                                                        \
+        for (; j <= m - 16; j += 16)                                         \
+        {                                                                    \
+            const arrtype* bk = b + j;                                       \
+            __m256d s0, s1, s2, s3;                                          \
+            if (do_acc)                                                      \
+            {                                                                \
+                s0 = _mm256_loadu_pd(d + j);                                 \
+                s1 = _mm256_loadu_pd(d + j + 4);                             \
+                s2 = _mm256_loadu_pd(d + j + 8);                             \
+                s3 = _mm256_loadu_pd(d + j + 12);                            \
+            }                                                                \
+            else                                                             \
+                s0 = s1 = s2 = s3 = _mm256_setzero_pd();                     \
+            for (k = 0; k < n; k++, bk += b_step)                            \
+            {                                                                \
+                __m256d ak = _mm256_set1_pd(a[k]);                           \
+                s0 = _mm256_add_pd(s0, _mm256_mul_pd(ak, load_avx2(bk)));    \
+                s1 = _mm256_add_pd(s1,                                       \
+                                   _mm256_mul_pd(ak, load_avx2(bk + 4)));    \
+                s2 = _mm256_add_pd(s2,                                       \
+                                   _mm256_mul_pd(ak, load_avx2(bk + 8)));    \
+                s3 = _mm256_add_pd(s3,                                       \
+                                   _mm256_mul_pd(ak, load_avx2(bk + 12)));   \
+            }                                                                \
+            _mm256_storeu_pd(d + j, s0);                                     \
+            _mm256_storeu_pd(d + j + 4, s1);                                 \
+            _mm256_storeu_pd(d + j + 8, s2);                                 \
+            _mm256_storeu_pd(d + j + 12, s3);                                \
+        }                                                                    \
+        return j;                                                            \
+    }                                                                        \
+                                                                             \
+    static int icvGEMMRowMul_##flavor##_simd(                                \
+        const arrtype* a, const arrtype* b, size_t b_step, double* d, int n, \
+        int m, int do_acc)                                                   \
+    {                                                                        \
+        int level = icvMatMulSimdLevel();                                    \
+        if (level == 2)                                                      \
+            return icvGEMMRowMul_##flavor##_avx2(a, b, b_step, d, n, m,      \
+                                                 do_acc);                    \
+        if (level == 1)                                                      \
+            return icvGEMMRowMul_##flavor##_sse2(a, b, b_step, d, n, m,      \
+                                                 do_acc);                    \
+        return 0;                                                            \
+    }
+
+ICV_DEF_GEMM_ROW_MUL_SIMD(32f_C1R, float, ICV_LOAD_32F64F_SSE2,
+                          ICV_LOAD_32F64F_AVX2)
+ICV_DEF_GEMM_ROW_MUL_SIMD(64f_C1R, double, ICV_LOAD_64F_SSE2,
+                          ICV_LOAD_64F_AVX2)
+
+/* the same for a product of a row vector and a transposed matrix:
+   d[j] = (do_acc ? d[j] : 0) + sum_k a[k]*b[j][k]. As in the generic code,
+   the products with the even and the odd k are summed separately */
+#define ICV_DEF_GEMM_ROW_MUL_T_SIMD(flavor, arrtype, load2)                  \
+    static CV_TARGET_SSE2 int icvGEMMRowMulT_##flavor##_sse2(                \
+        const arrtype* a, const arrtype* b, size_t b_step, double* d, int n, \
+        int m, int do_acc)                                                   \
+    {                                                                        \
+        int j = 0, k;                                                        \
+        for (; j <= m - 2; j += 2, b += b_step * 2)                          \
+        {                                                                    \
+            const arrtype* b1 = b + b_step;                                  \
+            __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();            \
+            double buf[4];                                                   \
+            if (do_acc)                                                      \
+            {                                                                \
+                s0 = _mm_setr_pd(d[j], 0);                                   \
+                s1 = _mm_setr_pd(d[j + 1], 0);                               \
+            }                                                                \
+            for (k = 0; k <= n - 2; k += 2)                                  \
+            {                                                                \
+                __m128d ak = load2(a + k);                                   \
+                s0 = _mm_add_pd(s0, _mm_mul_pd(ak, load2(b + k)));           \
+                s1 = _mm_add_pd(s1, _mm_mul_pd(ak, load2(b1 + k)));          \
+            }                                                                \
+            _mm_storeu_pd(buf, s0);                                          \
+            _mm_storeu_pd(buf + 2, s1);                                      \
+            if (k < n)                                                       \
+            {                                                                \
+                buf[0] += (double)a[k] * b[k];                               \
+                buf[2] += (double)a[k] * b1[k];                              \
+            }                                                                \
+            d[j] = buf[0] + buf[1];                                          \
+            d[j + 1] = buf[2] + buf[3];                                      \
+        }                                                                    \
+        return j;                                                            \
+    }                                                                        \
+                                                                             \
+    static CV_TARGET_AVX2 int icvGEMMRowMulT_##flavor##_avx2(                \
+        const arrtype* a, const arrtype* b, size_t b_step, double* d, int n, \
+        int m, int do_acc)                                                   \
+    {                                                                        \
+        int j = 0, k, t;                                                     \
+        for (; j <= m - 4; j += 4, b += b_step * 4)                          \
+        {                                                                    \
+            const arrtype *b1 = b + b_step, *b2 = b1 + b_step,               \
+                          *b3 = b2 + b_step;                                 \
+            __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();      \
+            double buf[8];                                                   \
+            if (do_acc)                                                      \
+            {                                                                \
+                s0 = _mm256_setr_pd(d[j], 0, d[j + 1], 0);                   \
+                s1 = _mm256_setr_pd(d[j + 2], 0, d[j + 3], 0);               \
+            }                                                                \
+            for (k = 0; k <= n - 2; k += 2)                                  \
+            {                                                                \
+                __m128d ak = load2(a + k);                                   \
+                __m256d ak2 =                                                \
+                    _mm256_insertf128_pd(_mm256_castpd128_pd256(ak), ak, 1); \
+                __m256d bk0 = _mm256_insertf128_pd(                          \
+                    _mm256_castpd128_pd256(load2(b + k)), load2(b1 + k), 1); \
+                __m256d bk1 = _mm256_insertf128_pd(                          \
+                    _mm256_castpd128_pd256(load2(b2 + k)), load2(b3 + k),    \
+                    1);                                                      \
+                s0 = _mm256_add_pd(s0, _mm256_mul_pd(ak2, bk0));             \
+                s1 = _mm256_add_pd(s1, _mm256_mul_pd(ak2, bk1));             \
+            }                                                                \
+            _mm256_storeu_pd(buf, s0);                                       \
+            _mm256_storeu_pd(buf + 4, s1);                                   \
+            if (k < n)                                                       \
+            {                                                                \
+                buf[0] += (double)a[k] * b[k];                               \
+                buf[2] += (double)a[k] * b1[k];                              \
+                buf[4] += (double)a[k] * b2[k];                              \
+                buf[6] += (double)a[k] * b3[k];                              \
+            }                                                                \
+            for (t = 0; t < 4; t++)                                          \
+                d[j + t] = buf[t * 2] + buf[t * 2 + 1];                      \
+        }                                                                    \
+        return j;                                                            \
+    }                                                                        \
+                                                                             \
+    static int icvGEMMRowMulT_##flavor##_simd(                               \
+        const arrtype* a, const arrtype* b, size_t b_step, double* d, int n, \
+        int m, int do_acc)                                                   \
+    {                                                                        \
+        int level = icvMatMulSimdLevel();                                    \
+        if (level == 2)                                                      \
+            return icvGEMMRowMulT_##flavor##_avx2(a, b, b_step, d, n, m,     \
+                                                  do_acc);                   \
+        if (level == 1)                                                      \
+            return icvGEMMRowMulT_##flavor##_sse2(a, b, b_step, d, n, m,     \
+                                                  do_acc);                   \
+        return 0;                                                            \
+    }
+
+ICV_DEF_GEMM_ROW_MUL_T_SIMD(32f_C1R, float, ICV_LOAD_32F64F_SSE2)
+ICV_DEF_GEMM_ROW_MUL_T_SIMD(64f_C1R, double, ICV_LOAD_64F_SSE2)
+
+#else
+
+#define icvGEMMRowMul_32f_C1R_simd(a, b, b_step, d, n, m, do_acc) 0
+#define icvGEMMRowMul_64f_C1R_simd(a, b, b_step, d, n, m, do_acc) 0
+#define icvGEMMRowMulT_32f_C1R_simd(a, b, b_step, d, n, m, do_acc) 0
+#define icvGEMMRowMulT_64f_C1R_simd(a, b, b_step, d, n, m, do_acc) 0
+
+#endif /* CV_SIMD_X86 */
+
+#define icvGEMMRowMul_noSIMD(a, b, b_step, d, n, m, do_acc) 0
+
+#define ICV_DEF_GEMM_SINGLE_MUL(flavor, arrtype, worktype, row_mul)            \
     static CvStatus CV_STDCALL icvGEMMSingleMul_##flavor(                      \
         const arrtype* a_data, size_t a_step, const arrtype* b_data,           \
         size_t b_step, const arrtype* c_data, size_t c_step, arrtype* d_data,  \
@@ -253,6 +484,8 @@ static void icvGEMM_TransposeBlock(const uchar* src, int src_step, uchar* dst,
         }                                                                      \
         else if (d_size.width * sizeof(d_data[0]) <= 1600)                     \
         {                                                                      \
+            worktype* d_buf = (worktype*)cvStackAlloc(m * sizeof(d_buf[0]));   \
+                                                                               \
             for (i = 0; i < drows; i++, _a_data += a_step0,                    \
                 _c_data += c_step0, d_data += d_step)                          \
             {                                                                  \
@@ -265,7 +498,17 @@ static void icvGEMM_TransposeBlock(const uchar* src, int src_step, uchar* dst,
                     a_data = a_buf;                                            \
                 }                                                              \
                                                                                \
-                for (j = 0; j <= m - 4; j += 4, c_data += 4 * c_step1)         \
+                j = row_mul(a_data, _b_data, b_step, d_buf, n, m, 0);          \
+                for (k = 0; k < j; k++, c_data += c_step1)                     \
+                {                                                              \
+                    worktype t = d_buf[k] * alpha;                             \
+                    if (!c_data)                                               \
+                        d_data[k] = arrtype(t);                                \
+                    else                                                       \
+                        d_data[k] = arrtype(t + c_data[0] * beta);             \
+                }                                                              \
+                                                                               \
+                for (; j <= m - 4; j += 4, c_data += 4 * c_step1)              \
                 {                                                              \
                     const arrtype* b = _b_data + j;                            \
                     worktype s0(0), s1(0), s2(0), s3(0);                       \
@@ -320,6 +563,7 @@ static void icvGEMM_TransposeBlock(const uchar* src, int src_step, uchar* dst,
         else                                                                   \
         {                                                                      \
             worktype* d_buf = (worktype*)cvStackAlloc(m * sizeof(d_buf[0]));   \
+            int j0;                                                            \
                                                                                \
             for (i = 0; i < drows; i++, _a_data += a_step0,                    \
                 _c_data += c_step0, d_data += d_step)                          \
@@ -335,14 +579,15 @@ static void icvGEMM_TransposeBlock(const uchar* src, int src_step, uchar* dst,
                     a_data = a_buf;                                            \
                 }                                                              \
                                                                                \
-                for (j = 0; j < m; j++)                                        \
+                j0 = row_mul(a_data, b_data, b_step, d_buf, n, m, 0);          \
+                for (j = j0; j < m; j++)                                       \
                     d_buf[j] = worktype(0);                                    \
                                                                                \
                 for (k = 0; k < n; k++, b_data += b_step)                      \
                 {                                                              \
                     worktype al(a_data[k]);                                    \
                                                                                \
-                    for (j = 0; j <= m - 4; j += 4)                            \
+                    for (j = j0; j <= m - 4; j += 4)                           \
                     {                                                          \
                         worktype t0 = d_buf[j] + b_data[j] * al;               \
                         worktype t1 = d_buf[j + 1] + b_data[j + 1] * al;       \
@@ -372,122 +617,125 @@ static void icvGEMM_TransposeBlock(const uchar* src, int src_step, uchar* dst,
         return CV_OK;                                                          \
     }
 
-#define ICV_DEF_GEMM_BLOCK_MUL(flavor, arrtype, worktype)                  \
-    static CvStatus CV_STDCALL icvGEMMBlockMul_##flavor(                   \
-        const arrtype* a_data, size_t a_step, const arrtype* b_data,       \
-        size_t b_step, worktype* d_data, size_t d_step, CvSize a_size,     \
-        CvSize d_size, int flags)                                          \
-    {                                                                      \
-        int i, j, k, n = a_size.width, m = d_size.width;                   \
-        const arrtype *_a_data = a_data, *_b_data = b_data;                \
-        arrtype* a_buf = 0;                                                \
-        size_t a_step0, a_step1, t_step;                                   \
-        int do_acc = flags & 16;                                           \
-                                                                           \
-        a_step /= sizeof(a_data[0]);                                       \
-        b_step /= sizeof(b_data[0]);                                       \
-        d_step /= sizeof(d_data[0]);                                       \
-                                                                           \
-        a_step0 = a_step;                                                  \
-        a_step1 = 1;                                                       \
-                                                                           \
-        if (flags & CV_GEMM_A_T)                                           \
-        {                                                                  \
-            CV_SWAP(a_step0, a_step1, t_step);                             \
-            n = a_size.height;                                             \
-            a_buf = (arrtype*)cvStackAlloc(n * sizeof(a_data[0]));         \
-        }                                                                  \
-                                                                           \
-        if (flags & CV_GEMM_B_T)                                           \
-        {                                                                  \
-            /* second operand is transposed */                             \
-            for (i = 0; i < d_size.height;                                 \
-                 i++, _a_data += a_step0, d_data += d_step)                \
-            {                                                              \
-                a_data = _a_data;                                          \
-                b_data = _b_data;                                          \
-                                                                           \
-                if (a_buf)                                                 \
-                {                                                          \
-                    for (k = 0; k < n; k++)                                \
-                        a_buf[k] = a_data[a_step1 * k];                    \
-                    a_data = a_buf;                                        \
-                }                                                          \
-                                                                           \
-                for (j = 0; j < d_size.width; j++, b_data += b_step)       \
-                {                                                          \
-                    worktype s0 = do_acc ? d_data[j] : worktype(0), s1(0); \
-                    for (k = 0; k <= n - 2; k += 2)                        \
-                    {                                                      \
-                        s0 += worktype(a_data[k]) * b_data[k];             \
-                        s1 += worktype(a_data[k + 1]) * b_data[k + 1];     \
-                    }                                                      \
-                                                                           \
-                    for (; k < n; k++)                                     \
-                        s0 += worktype(a_data[k]) * b_data[k];             \
-                                                                           \
-                    d_data[j] = s0 + s1;                                   \
-                }                                                          \
-            }                                                              \
-        }                                                                  \
-        else                                                               \
-        {                                                                  \
-            for (i = 0; i < d_size.height;                                 \
-                 i++, _a_data += a_step0, d_data += d_step)                \
-            {                                                              \
-                a_data = _a_data, b_data = _b_data;                        \
-                                                                           \
-                if (a_buf)                                                 \
-                {                                                          \
-                    for (k = 0; k < n; k++)                                \
-                        a_buf[k] = a_data[a_step1 * k];                    \
-                    a_data = a_buf;                                        \
-                }                                                          \
-                                                                           \
-                for (j = 0; j <= m - 4; j += 4)                            \
-                {                                                          \
-                    worktype s0, s1, s2, s3;                               \
-                    const arrtype* b = b_data + j;                         \
-                                                                           \
-                    if (do_acc)                                            \
-                    {                                                      \
-                        s0 = d_data[j];                                    \
-                        s1 = d_data[j + 1];                                \
-                        s2 = d_data[j + 2];                                \
-                        s3 = d_data[j + 3];                                \
-                    }                                                      \
-                    else                                                   \
-                        s0 = s1 = s2 = s3 = worktype(0);                   \
-                                                                           \
-                    for (k = 0; k < n; k++, b += b_step)                   \
-                    {                                                      \
-                        worktype a(a_data[k]);                             \
-                        s0 += a * b[0];                                    \
-                        s1 += a * b[1];                                    \
-                        s2 += a * b[2];                                    \
-                        s3 += a * b[3];                                    \
-                    }                                                      \
-                                                                           \
-                    d_data[j] = s0;                                        \
-                    d_data[j + 1] = s1;                                    \
-                    d_data[j + 2] = s2;                                    \
-                    d_data[j + 3] = s3;                                    \
-                }                                                          \
-                                                                           \
-                for (; j < m; j++)                                         \
-                {                                                          \
-                    const arrtype* b = b_data + j;                         \
-                    worktype s0 = do_acc ? d_data[j] : worktype(0);        \
-                                                                           \
-                    for (k = 0; k < n; k++, b += b_step)                   \
-                        s0 += worktype(a_data[k]) * b[0];                  \
-                                                                           \
-                    d_data[j] = s0;                                        \
-                }                                                          \
-            }                                                              \
-        }                                                                  \
-                                                                           \
-        return CV_OK;                                                      \
+#define ICV_DEF_GEMM_BLOCK_MUL(flavor, arrtype, worktype, row_mul, row_mul_t) \
+    static CvStatus CV_STDCALL icvGEMMBlockMul_##flavor(                      \
+        const arrtype* a_data, size_t a_step, const arrtype* b_data,          \
+        size_t b_step, worktype* d_data, size_t d_step, CvSize a_size,        \
+        CvSize d_size, int flags)                                             \
+    {                                                                         \
+        int i, j, k, n = a_size.width, m = d_size.width;                      \
+        const arrtype *_a_data = a_data, *_b_data = b_data;                   \
+        arrtype* a_buf = 0;                                                   \
+        size_t a_step0, a_step1, t_step;                                      \
+        int do_acc = flags & 16;                                              \
+                                                                              \
+        a_step /= sizeof(a_data[0]);                                          \
+        b_step /= sizeof(b_data[0]);                                          \
+        d_step /= sizeof(d_data[0]);                                          \
+                                                                              \
+        a_step0 = a_step;                                                     \
+        a_step1 = 1;                                                          \
+                                                                              \
+        if (flags & CV_GEMM_A_T)                                              \
+        {                                                                     \
+            CV_SWAP(a_step0, a_step1, t_step);                                \
+            n = a_size.height;                                                \
+            a_buf = (arrtype*)cvStackAlloc(n * sizeof(a_data[0]));            \
+        }                                                                     \
+                                                                              \
+        if (flags & CV_GEMM_B_T)                                              \
+        {                                                                     \
+            /* second operand is transposed */                                \
+            for (i = 0; i < d_size.height;                                    \
+                 i++, _a_data += a_step0, d_data += d_step)                   \
+            {                                                                 \
+                a_data = _a_data;                                             \
+                b_data = _b_data;                                             \
+                                                                              \
+                if (a_buf)                                                    \
+                {                                                             \
+                    for (k = 0; k < n; k++)                                   \
+                        a_buf[k] = a_data[a_step1 * k];                       \
+                    a_data = a_buf;                                           \
+                }                                                             \
+                                                                              \
+                j = row_mul_t(a_data, b_data, b_step, d_data, n, m, do_acc);  \
+                for (b_data += j * b_step; j < d_size.width;                  \
+                     j++, b_data += b_step)                                   \
+                {                                                             \
+                    worktype s0 = do_acc ? d_data[j] : worktype(0), s1(0);    \
+                    for (k = 0; k <= n - 2; k += 2)                           \
+                    {                                                         \
+                        s0 += worktype(a_data[k]) * b_data[k];                \
+                        s1 += worktype(a_data[k + 1]) * b_data[k + 1];        \
+                    }                                                         \
+                                                                              \
+                    for (; k < n; k++)                                        \
+                        s0 += worktype(a_data[k]) * b_data[k];                \
+                                                                              \
+                    d_data[j] = s0 + s1;                                      \
+                }                                                             \
+            }                                                                 \
+        }                                                                     \
+        else                                                                  \
+        {                                                                     \
+            for (i = 0; i < d_size.height;                                    \
+                 i++, _a_data += a_step0, d_data += d_step)                   \
+            {                                                                 \
+                a_data = _a_data, b_data = _b_data;                           \
+                                                                              \
+                if (a_buf)                                                    \
+                {                                                             \
+                    for (k = 0; k < n; k++)                                   \
+                        a_buf[k] = a_data[a_step1 * k];                       \
+                    a_data = a_buf;                                           \
+                }                                                             \
+                                                                              \
+                j = row_mul(a_data, b_data, b_step, d_data, n, m, do_acc);    \
+                for (; j <= m - 4; j += 4)                                    \
+                {                                                             \
+                    worktype s0, s1, s2, s3;                                  \
+                    const arrtype* b = b_data + j;                            \
+                                                                              \
+                    if (do_acc)                                               \
+                    {                                                         \
+                        s0 = d_data[j];                                       \
+                        s1 = d_data[j + 1];                                   \
+                        s2 = d_data[j + 2];                                   \
+                        s3 = d_data[j + 3];                                   \
+                    }                                                         \
+                    else                                                      \
+                        s0 = s1 = s2 = s3 = worktype(0);                      \
+                                                                              \
+                    for (k = 0; k < n; k++, b += b_step)                      \
+                    {                                                         \
+                        worktype a(a_data[k]);                                \
+                        s0 += a * b[0];                                       \
+                        s1 += a * b[1];                                       \
+                        s2 += a * b[2];                                       \
+                        s3 += a * b[3];                                       \
+                    }                                                         \
+                                                                              \
+                    d_data[j] = s0;                                           \
+                    d_data[j + 1] = s1;                                       \
+                    d_data[j + 2] = s2;                                       \
+                    d_data[j + 3] = s3;                                       \
+                }                                                             \
+                                                                              \
+                for (; j < m; j++)                                            \
+                {                                                             \
+                    const arrtype* b = b_data + j;                            \
+                    worktype s0 = do_acc ? d_data[j] : worktype(0);           \
+                                                                              \
+                    for (k = 0; k < n; k++, b += b_step)                      \
+                        s0 += worktype(a_data[k]) * b[0];                     \
+                                                                              \
+                    d_data[j] = s0;                                           \
+                }                                                             \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        return CV_OK;                                                         \
     }
 
 #define ICV_DEF_GEMM_STORE(flavor, arrtype, worktype)                     \
@@ -559,20 +807,26 @@ static void icvGEMM_TransposeBlock(const uchar* src, int src_step, uchar* dst,
         return CV_OK;                                                     \
     }
 
-ICV_DEF_GEMM_SINGLE_MUL(32f_C1R, float, double)
-ICV_DEF_GEMM_BLOCK_MUL(32f_C1R, float, double)
+ICV_DEF_GEMM_SINGLE_MUL(32f_C1R, float, double, icvGEMMRowMul_32f_C1R_simd)
+ICV_DEF_GEMM_BLOCK_MUL(32f_C1R, float, double, icvGEMMRowMul_32f_C1R_simd,
+                       icvGEMMRowMulT_32f_C1R_simd)
 ICV_DEF_GEMM_STORE(32f_C1R, float, double)
 
-ICV_DEF_GEMM_SINGLE_MUL(64f_C1R, double, double)
-ICV_DEF_GEMM_BLOCK_MUL(64f_C1R, double, double)
+ICV_DEF_GEMM_SINGLE_MUL(64f_C1R, double, double, icvGEMMRowMul_64f_C1R_simd)
+ICV_DEF_GEMM_BLOCK_MUL(64f_C1R, double, double, icvGEMMRowMul_64f_C1R_simd,
+                       icvGEMMRowMulT_64f_C1R_simd)
 ICV_DEF_GEMM_STORE(64f_C1R, double, double)
 
-ICV_DEF_GEMM_SINGLE_MUL(32f_C2R, CvComplex32f, CvComplex64f)
-ICV_DEF_GEMM_BLOCK_MUL(32f_C2R, CvComplex32f, CvComplex64f)
+ICV_DEF_GEMM_SINGLE_MUL(32f_C2R, CvComplex32f, CvComplex64f,
+                        icvGEMMRowMul_noSIMD)
+ICV_DEF_GEMM_BLOCK_MUL(32f_C2R, CvComplex32f, CvComplex64f,
+                       icvGEMMRowMul_noSIMD, icvGEMMRowMul_noSIMD)
 ICV_DEF_GEMM_STORE(32f_C2R, CvComplex32f, CvComplex64f)
 
-ICV_DEF_GEMM_SINGLE_MUL(64f_C2R, CvComplex64f, CvComplex64f)
-ICV_DEF_GEMM_BLOCK_MUL(64f_C2R, CvComplex64f, CvComplex64f)
+ICV_DEF_GEMM_SINGLE_MUL(64f_C2R, CvComplex64f, CvComplex64f,
+                        icvGEMMRowMul_noSIMD)
+ICV_DEF_GEMM_BLOCK_MUL(64f_C2R, CvComplex64f, CvComplex64f,
+                       icvGEMMRowMul_noSIMD, icvGEMMRowMul_noSIMD)
 ICV_DEF_GEMM_STORE(64f_C2R, CvComplex64f, CvComplex64f)
 
 typedef CvStatus(CV_STDCALL* CvGEMMSingleMulFunc)(
@@ -610,6 +864,149 @@ static void icvInitGEMMTable(CvBigFuncTable* single_mul_tab,
     store_tab->fn_2d[CV_64FC2] = (void*)icvGEMMStore_64f_C2R;
 }
 
+/* arguments of the cvGEMM loops processing the bands of the rows of D.
+   In the blocked mode the bands are counted in the row blocks */
+typedef struct CvGEMMJob
+{
+    CvGEMMSingleMulFunc single_mul_func;
+    CvGEMMBlockMulFunc block_mul_func;
+    CvGEMMStoreFunc store_func;
+    const CvMat *A, *B, *C;
+    CvMat* D;
+    int b_step, len, flags;
+    double alpha, beta;
+    int a_step0, a_step1, b_step0, b_step1, c_step0, c_step1;
+
+    // the blocked mode parameters
+    int is_a_t, is_b_t;
+    int elem_size, work_elem_size;
+    int dm0, dn0, dk0, block_rows;
+    int a_buf_size, b_buf_size, d_buf_size;
+} CvGEMMJob;
+
+static int CV_CDECL icvGEMMSingleMulBand(int i0, int i1, void* userdata)
+{
+    const CvGEMMJob* job = (const CvGEMMJob*)userdata;
+    const uchar* c = job->C->data.ptr;
+
+    return job->single_mul_func(
+        job->A->data.ptr + i0 * job->a_step0, job->A->step, job->B->data.ptr,
+        job->b_step, c ? c + i0 * job->c_step0 : 0, job->C->step,
+        job->D->data.ptr + i0 * job->D->step, job->D->step,
+        cvSize(job->A->cols, job->A->rows), cvSize(job->D->cols, i1 - i0),
+        job->alpha, job->beta, job->flags);
+}
+
+static int CV_CDECL icvGEMMBlockMulBand(int bi0, int bi1, void* userdata)
+{
+    const CvGEMMJob* job = (const CvGEMMJob*)userdata;
+    const CvMat *A = job->A, *B = job->B, *C = job->C, *D = job->D;
+    CvSize d_size = cvGetMatSize(D);
+    int elem_size = job->elem_size, work_elem_size = job->work_elem_size;
+    int len = job->len, b_step = job->b_step;
+    int dm0 = job->dm0, dn0 = job->dn0, dk0 = job->dk0;
+    int i, j, k, di, dj = 0, dk = 0, flags;
+    uchar *buffer, *a_buf = 0, *b_buf, *d_buf;
+
+    buffer = (uchar*)cvScratchAlloc(job->a_buf_size + job->b_buf_size
+                                    + job->d_buf_size);
+    if (!buffer)
+        return CV_OUTOFMEM_ERR;
+
+    d_buf = buffer;
+    b_buf = d_buf + job->d_buf_size;
+    if (job->is_a_t)
+        a_buf = b_buf + job->b_buf_size;
+
+    for (i = bi0 * dm0; bi0 < bi1; bi0++, i += di)
+    {
+        // the last block takes the remaining rows
+        di = bi0 < job->block_rows - 1 ? dm0 : d_size.height - i;
+
+        for (j = 0; j < d_size.width; j += dj)
+        {
+            uchar* _d = D->data.ptr + i * D->step + j * elem_size;
+            const uchar* _c =
+                C->data.ptr + i * job->c_step0 + j * job->c_step1;
+            int _d_step = D->step;
+            dj = dn0;
+
+            if (j + dj >= d_size.width || 8 * (j + dj) + dj > 8 * d_size.width)
+                dj = d_size.width - j;
+
+            flags = job->flags;
+            if (dk0 < len)
+            {
+                _d = d_buf;
+                _d_step = dj * work_elem_size;
+            }
+
+            for (k = 0; k < len; k += dk)
+            {
+                const uchar* _a = A->data.ptr + i * job->a_step0
+                                  + k * job->a_step1;
+                int _a_step = A->step;
+                const uchar* _b = B->data.ptr + k * job->b_step0
+                                  + j * job->b_step1;
+                int _b_step = b_step;
+                CvSize a_bl_size;
+
+                dk = dk0;
+                if (k + dk >= len || 8 * (k + dk) + dk > 8 * len)
+                    dk = len - k;
+
+                if (!job->is_a_t)
+                    a_bl_size.width = dk, a_bl_size.height = di;
+                else
+                    a_bl_size.width = di, a_bl_size.height = dk;
+
+                if (a_buf)
+                {
+                    int t;
+                    _a_step = dk * elem_size;
+                    icvGEMM_TransposeBlock(_a, A->step, a_buf, _a_step,
+                                           a_bl_size, elem_size);
+                    CV_SWAP(a_bl_size.width, a_bl_size.height, t);
+                    _a = a_buf;
+                }
+
+                if (dj < d_size.width)
+                {
+                    CvSize b_size;
+                    if (!job->is_b_t)
+                        b_size.width = dj, b_size.height = dk;
+                    else
+                        b_size.width = dk, b_size.height = dj;
+
+                    _b_step = b_size.width * elem_size;
+                    icvGEMM_CopyBlock(_b, b_step, b_buf, _b_step, b_size,
+                                      elem_size);
+                    _b = b_buf;
+                }
+
+                if (dk0 < len)
+                    job->block_mul_func(_a, _a_step, _b, _b_step, _d, _d_step,
+                                        a_bl_size, cvSize(dj, di), flags);
+                else
+                    job->single_mul_func(_a, _a_step, _b, _b_step, _c, C->step,
+                                         _d, _d_step, a_bl_size,
+                                         cvSize(dj, di), job->alpha,
+                                         job->beta, flags);
+                flags |= 16;
+            }
+
+            if (dk0 < len)
+                job->store_func(_c, C->step, _d, _d_step,
+                                D->data.ptr + i * D->step + j * elem_size,
+                                D->step, cvSize(dj, di), job->alpha,
+                                job->beta, flags);
+        }
+    }
+
+    cvScratchFree(&buffer);
+    return CV_OK;
+}
+
 CV_IMPL void cvGEMM(const CvArr* Aarr, const CvArr* Barr, double alpha,
                     const CvArr* Carr, double beta, CvArr* Darr, int flags)
 {
@@ -623,7 +1020,6 @@ CV_IMPL void cvGEMM(const CvArr* Aarr, const CvArr* Barr, double alpha,
 
     uchar* buffer = 0;
     int local_alloc = 0;
-    uchar* block_buffer = 0;
 
     CV_FUNCNAME("cvGEMM");
 
@@ -1155,171 +1551,111 @@ CV_IMPL void cvGEMM(const CvArr* Aarr, const CvArr* Barr, double alpha,
                           D->data.ptr, &ldd);
             }
         }
-        else if (d_size.height <= block_lin_size / 2
-                 || d_size.width <= block_lin_size / 2 || len <= 10
-                 || d_size.width <= block_lin_size
-                        && d_size.height <= block_lin_size
-                        && len <= block_lin_size)
-        {
-            single_mul_func(A->data.ptr, A->step, B->data.ptr, b_step,
-                            C->data.ptr, C->step, D->data.ptr, D->step, a_size,
-                            d_size, alpha, beta, flags);
-        }
         else
         {
-            int is_a_t = flags & CV_GEMM_A_T;
-            int is_b_t = flags & CV_GEMM_B_T;
+            CvGEMMJob job;
             int elem_size = CV_ELEM_SIZE(type);
-            int dk0_1, dk0_2;
-            int a_buf_size = 0, b_buf_size, d_buf_size;
-            uchar* a_buf = 0;
-            uchar* b_buf = 0;
-            uchar* d_buf = 0;
-            int i, j, k, di = 0, dj = 0, dk = 0;
-            int dm0, dn0, dk0;
-            int a_step0, a_step1, b_step0, b_step1, c_step0, c_step1;
-            int work_elem_size = elem_size
-                                 << (CV_MAT_DEPTH(type) == CV_32F ? 1 : 0);
-            CvGEMMBlockMulFunc block_mul_func =
-                (CvGEMMBlockMulFunc)block_mul_tab.fn_2d[type];
-            CvGEMMStoreFunc store_func = (CvGEMMStoreFunc)store_tab.fn_2d[type];
-
-            assert(block_mul_func && store_func);
-
-            if (!is_a_t)
-                a_step0 = A->step, a_step1 = elem_size;
+
+            job.single_mul_func = single_mul_func;
+            job.A = A;
+            job.B = B;
+            job.C = C;
+            job.D = D;
+            job.b_step = b_step;
+            job.len = len;
+            job.alpha = alpha;
+            job.beta = beta;
+
+            if (!(flags & CV_GEMM_A_T))
+                job.a_step0 = A->step, job.a_step1 = elem_size;
             else
-                a_step0 = elem_size, a_step1 = A->step;
+                job.a_step0 = elem_size, job.a_step1 = A->step;
 
-            if (!is_b_t)
-                b_step0 = b_step, b_step1 = elem_size;
+            if (!(flags & CV_GEMM_B_T))
+                job.b_step0 = b_step, job.b_step1 = elem_size;
             else
-                b_step0 = elem_size, b_step1 = b_step;
+                job.b_step0 = elem_size, job.b_step1 = b_step;
 
             if (!C->data.ptr)
             {
-                c_step0 = c_step1 = 0;
+                job.c_step0 = job.c_step1 = 0;
                 flags &= ~CV_GEMM_C_T;
             }
             else if (!(flags & CV_GEMM_C_T))
-                c_step0 = C->step, c_step1 = elem_size;
+                job.c_step0 = C->step, job.c_step1 = elem_size;
             else
-                c_step0 = elem_size, c_step1 = C->step;
-
-            dm0 = MIN(block_lin_size, d_size.height);
-            dn0 = MIN(block_lin_size, d_size.width);
-            dk0_1 = block_size / dm0;
-            dk0_2 = block_size / dn0;
-            dk0 = MAX(dk0_1, dk0_2);
-            dk0 = MIN(dk0, len);
-            if (dk0 * dm0 > block_size)
-                dm0 = block_size / dk0;
-            if (dk0 * dn0 > block_size)
-                dn0 = block_size / dk0;
-
-            dk0_1 = (dn0 + dn0 / 8 + 2) & -2;
-            b_buf_size = (dk0 + dk0 / 8 + 1) * dk0_1 * elem_size;
-            d_buf_size = (dk0 + dk0 / 8 + 1) * dk0_1 * work_elem_size;
-
-            if (is_a_t)
+                job.c_step0 = elem_size, job.c_step1 = C->step;
+
+            if (d_size.height <= block_lin_size / 2
+                || d_size.width <= block_lin_size / 2 || len <= 10
+                || d_size.width <= block_lin_size
+                       && d_size.height <= block_lin_size
+                       && len <= block_lin_size)
             {
-                a_buf_size = (dm0 + dm0 / 8 + 1) * ((dk0 + dk0 / 8 + 2) & -2)
-                             * elem_size;
-                flags &= ~CV_GEMM_A_T;
+                job.flags = flags;
+                IPPI_CALL((CvStatus)cvParallelFor(
+                    d_size.height,
+                    ICV_MATMUL_MIN_BAND_OPS / MAX(d_size.width * len, 1),
+                    icvGEMMSingleMulBand, &job));
             }
-
-            CV_CALL(block_buffer =
-                        (uchar*)cvAlloc(a_buf_size + b_buf_size + d_buf_size));
-            d_buf = block_buffer;
-            b_buf = d_buf + d_buf_size;
-
-            if (is_a_t)
-                a_buf = b_buf + b_buf_size;
-
-            for (i = 0; i < d_size.height; i += di)
+            else
             {
-                di = dm0;
-                if (i + di >= d_size.height
-                    || 8 * (i + di) + di > 8 * d_size.height)
-                    di = d_size.height - i;
-
-                for (j = 0; j < d_size.width; j += dj)
+                int dk0_1, dk0_2, i, di;
+                int dm0, dn0, dk0;
+
+                job.block_mul_func =
+                    (CvGEMMBlockMulFunc)block_mul_tab.fn_2d[type];
+                job.store_func = (CvGEMMStoreFunc)store_tab.fn_2d[type];
+                assert(job.block_mul_func && job.store_func);
+
+                job.is_a_t = flags & CV_GEMM_A_T;
+                job.is_b_t = flags & CV_GEMM_B_T;
+                job.elem_size = elem_size;
+                job.work_elem_size =
+                    elem_size << (CV_MAT_DEPTH(type) == CV_32F ? 1 : 0);
+
+                dm0 = MIN(block_lin_size, d_size.height);
+                dn0 = MIN(block_lin_size, d_size.width);
+                dk0_1 = block_size / dm0;
+                dk0_2 = block_size / dn0;
+                dk0 = MAX(dk0_1, dk0_2);
+                dk0 = MIN(dk0, len);
+                if (dk0 * dm0 > block_size)
+                    dm0 = block_size / dk0;
+                if (dk0 * dn0 > block_size)
+                    dn0 = block_size / dk0;
+
+                dk0_1 = (dn0 + dn0 / 8 + 2) & -2;
+                job.b_buf_size = (dk0 + dk0 / 8 + 1) * dk0_1 * elem_size;
+                job.d_buf_size =
+                    (dk0 + dk0 / 8 + 1) * dk0_1 * job.work_elem_size;
+                job.a_buf_size = 0;
+
+                if (job.is_a_t)
                 {
-                    uchar* _d = D->data.ptr + i * D->step + j * elem_size;
-                    const uchar* _c = C->data.ptr + i * c_step0 + j * c_step1;
-                    int _d_step = D->step;
-                    dj = dn0;
-
-                    if (j + dj >= d_size.width
-                        || 8 * (j + dj) + dj > 8 * d_size.width)
-                        dj = d_size.width - j;
-
-                    flags &= 15;
-                    if (dk0 < len)
-                    {
-                        _d = d_buf;
-                        _d_step = dj * work_elem_size;
-                    }
-
-                    for (k = 0; k < len; k += dk)
-                    {
-                        const uchar* _a =
-                            A->data.ptr + i * a_step0 + k * a_step1;
-                        int _a_step = A->step;
-                        const uchar* _b =
-                            B->data.ptr + k * b_step0 + j * b_step1;
-                        int _b_step = b_step;
-                        CvSize a_bl_size;
-
-                        dk = dk0;
-                        if (k + dk >= len || 8 * (k + dk) + dk > 8 * len)
-                            dk = len - k;
-
-                        if (!is_a_t)
-                            a_bl_size.width = dk, a_bl_size.height = di;
-                        else
-                            a_bl_size.width = di, a_bl_size.height = dk;
-
-                        if (a_buf && is_a_t)
-                        {
-                            int t;
-                            _a_step = dk * elem_size;
-                            icvGEMM_TransposeBlock(_a, A->step, a_buf, _a_step,
-                                                   a_bl_size, elem_size);
-                            CV_SWAP(a_bl_size.width, a_bl_size.height, t);
-                            _a = a_buf;
-                        }
+                    job.a_buf_size = (dm0 + dm0 / 8 + 1)
+                                     * ((dk0 + dk0 / 8 + 2) & -2) * elem_size;
+                    flags &= ~CV_GEMM_A_T;
+                }
 
-                        if (dj < d_size.width)
-                        {
-                            CvSize b_size;
-                            if (!is_b_t)
-                                b_size.width = dj, b_size.height = dk;
-                            else
-                                b_size.width = dk, b_size.height = dj;
-
-                            _b_step = b_size.width * elem_size;
-                            icvGEMM_CopyBlock(_b, b_step, b_buf, _b_step,
-                                              b_size, elem_size);
-                            _b = b_buf;
-                        }
+                // the number of the row blocks; the last one may be up to
+                // 1/8 taller than the others
+                job.block_rows = 0;
+                for (i = 0; i < d_size.height; i += di, job.block_rows++)
+                {
+                    di = dm0;
+                    if (i + di >= d_size.height
+                        || 8 * (i + di) + di > 8 * d_size.height)
+                        di = d_size.height - i;
+                }
 
-                        if (dk0 < len)
-                            block_mul_func(_a, _a_step, _b, _b_step, _d,
-                                           _d_step, a_bl_size, cvSize(dj, di),
-                                           flags);
-                        else
-                            single_mul_func(_a, _a_step, _b, _b_step, _c,
-                                            C->step, _d, _d_step, a_bl_size,
-                                            cvSize(dj, di), alpha, beta, flags);
-                        flags |= 16;
-                    }
+                job.dm0 = dm0;
+                job.dn0 = dn0;
+                job.dk0 = dk0;
+                job.flags = flags & 15;
 
-                    if (dk0 < len)
-                        store_func(_c, C->step, _d, _d_step,
-                                   D->data.ptr + i * D->step + j * elem_size,
-                                   D->step, cvSize(dj, di), alpha, beta, flags);
-                }
+                IPPI_CALL((CvStatus)cvParallelFor(job.block_rows, 1,
+                                                  icvGEMMBlockMulBand, &job));
             }
         }
 
@@ -1331,8 +1667,6 @@ CV_IMPL void cvGEMM(const CvArr* Aarr, const CvArr* Barr, double alpha,
 
     if (buffer && !local_alloc)
         cvFree(&buffer);
-    if (block_buffer)
-        cvFree(&block_buffer);
 }
 
 /****************************************************************************************\
@@ -1650,6 +1984,195 @@ typedef CvStatus(CV_STDCALL* CvDiagTransformFunc)(const void* src, int srcstep,
                                                   void* dst, int dststep,
                                                   CvSize size, const void* mat);
 
+/* AVX2 versions of the 3- and 4-channel floating-point transforms. Every
+   pixel is converted to a vector of doubles and multiplied by the matrix
+   columns, accumulating the sums in the same order as the generic code,
+   so the results are the same */
+#if CV_SIMD_X86
+
+static CV_TARGET_AVX2 int icvTransformRow_32f_C3_avx2(const float* src,
+                                                      float* dst, int width,
+                                                      const double* mat)
+{
+    __m256d c0 = _mm256_setr_pd(mat[0], mat[4], mat[8], 0);
+    __m256d c1 = _mm256_setr_pd(mat[1], mat[5], mat[9], 0);
+    __m256d c2 = _mm256_setr_pd(mat[2], mat[6], mat[10], 0);
+    __m256d c3 = _mm256_setr_pd(mat[3], mat[7], mat[11], 0);
+    __m128 r[4];
+    int i, k;
+
+    // every pixel is loaded with 4 floats, so the last one is left for the
+    // scalar code
+    for (i = 0; i <= width - 5; i += 4, src += 12, dst += 12)
+    {
+        for (k = 0; k < 4; k++)
+        {
+            __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(src + k * 3));
+            __m256d t = _mm256_mul_pd(c0, _mm256_permute4x64_pd(v, 0x00));
+            t = _mm256_add_pd(
+                t, _mm256_mul_pd(c1, _mm256_permute4x64_pd(v, 0x55)));
+            t = _mm256_add_pd(
+                t, _mm256_mul_pd(c2, _mm256_permute4x64_pd(v, 0xAA)));
+            r[k] = _mm256_cvtpd_ps(_mm256_add_pd(t, c3));
+        }
+
+        // pack the 4 xyz_ vectors into 3 vectors
+        _mm_storeu_ps(dst, _mm_blend_ps(r[0],
+                                        _mm_shuffle_ps(r[1], r[1], 0), 8));
+        _mm_storeu_ps(dst + 4,
+                      _mm_shuffle_ps(r[1], r[2], _MM_SHUFFLE(1, 0, 2, 1)));
+        r[2] = _mm_shuffle_ps(r[2], r[3], _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(dst + 8,
+                      _mm_shuffle_ps(r[2], r[3], _MM_SHUFFLE(2, 1, 2, 0)));
+    }
+
+    return i;
+}
+
+static CV_TARGET_AVX2 int icvTransformRow_32f_C4_avx2(const float* src,
+                                                      float* dst, int width,
+                                                      const double* mat)
+{
+    __m256d c0 = _mm256_setr_pd(mat[0], mat[5], mat[10], mat[15]);
+    __m256d c1 = _mm256_setr_pd(mat[1], mat[6], mat[11], mat[16]);
+    __m256d c2 = _mm256_setr_pd(mat[2], mat[7], mat[12], mat[17]);
+    __m256d c3 = _mm256_setr_pd(mat[3], mat[8], mat[13], mat[18]);
+    __m256d c4 = _mm256_setr_pd(mat[4], mat[9], mat[14], mat[19]);
+    int i;
+
+    for (i = 0; i < width; i++, src += 4, dst += 4)
+    {
+        __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(src));
+        __m256d t = _mm256_mul_pd(c0, _mm256_permute4x64_pd(v, 0x00));
+        t = _mm256_add_pd(t,
+                          _mm256_mul_pd(c1, _mm256_permute4x64_pd(v, 0x55)));
+        t = _mm256_add_pd(t,
+                          _mm256_mul_pd(c2, _mm256_permute4x64_pd(v, 0xAA)));
+        t = _mm256_add_pd(t,
+                          _mm256_mul_pd(c3, _mm256_permute4x64_pd(v, 0xFF)));
+        _mm_storeu_ps(dst, _mm256_cvtpd_ps(_mm256_add_pd(t, c4)));
+    }
+
+    return i;
+}
+
+static CvStatus CV_STDCALL icvTransform_32f_C3R_simd(const float* src,
+                                                     int srcstep, float* dst,
+                                                     int dststep, CvSize size,
+                                                     const double* mat,
+                                                     int dst_cn)
+{
+    if (dst_cn != 3)
+        return icvTransform_32f_C3R(src, srcstep, dst, dststep, size, mat,
+                                    dst_cn);
+
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = icvTransformRow_32f_C3_avx2(src, dst, size.width, mat);
+        if (i < size.width)
+            icvTransform_32f_C3R(src + i * 3, CV_STUB_STEP, dst + i * 3,
+                                 CV_STUB_STEP, cvSize(size.width - i, 1), mat,
+                                 dst_cn);
+    }
+
+    return CV_OK;
+}
+
+static CvStatus CV_STDCALL icvTransform_32f_C4R_simd(const float* src,
+                                                     int srcstep, float* dst,
+                                                     int dststep, CvSize size,
+                                                     const double* mat,
+                                                     int dst_cn)
+{
+    if (dst_cn != 4)
+        return icvTransform_32f_C4R(src, srcstep, dst, dststep, size, mat,
+                                    dst_cn);
+
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+    for (; size.height--; src += srcstep, dst += dststep)
+        icvTransformRow_32f_C4_avx2(src, dst, size.width, mat);
+
+    return CV_OK;
+}
+
+#endif /* CV_SIMD_X86 */
+
+/* replaces the generic transform functions with the vectorized ones, if
+   the CPU supports them */
+static void icvInitTransformSIMD(CvBigFuncTable* tab)
+{
+#if CV_SIMD_X86
+    if (icvMatMulSimdLevel() == 2)
+    {
+        tab->fn_2d[CV_32FC3] = (void*)icvTransform_32f_C3R_simd;
+        tab->fn_2d[CV_32FC4] = (void*)icvTransform_32f_C4R_simd;
+    }
+#else
+    (void)tab;
+#endif
+}
+
+/* arguments of the cvTransform and cvPerspectiveTransform loops processing
+   the bands of rows or, if the arrays are continuous, the pixel ranges of
+   the single row */
+typedef struct CvTransformJob
+{
+    CvTransformFunc func;
+    CvDiagTransformFunc diag_func;
+    CvFunc2D_2A1P persp_func;
+    uchar* src;
+    uchar* dst;
+    int srcstep, dststep;
+    int src_pix_size, dst_pix_size;
+    CvSize size;
+    double* mat;
+    int dst_cn;
+} CvTransformJob;
+
+static int CV_CDECL icvTransformBand(int i0, int i1, void* userdata)
+{
+    const CvTransformJob* job = (const CvTransformJob*)userdata;
+    uchar* src = job->src;
+    uchar* dst = job->dst;
+    CvSize size = job->size;
+
+    if (size.height > 1)
+    {
+        src += i0 * job->srcstep;
+        dst += i0 * job->dststep;
+        size.height = i1 - i0;
+    }
+    else
+    {
+        src += i0 * job->src_pix_size;
+        dst += i0 * job->dst_pix_size;
+        size.width = i1 - i0;
+    }
+
+    if (job->func)
+        return job->func(src, job->srcstep, dst, job->dststep, size, job->mat,
+                         job->dst_cn);
+    if (job->diag_func)
+        return job->diag_func(src, job->srcstep, dst, job->dststep, size,
+                              job->mat);
+    return job->persp_func(src, job->srcstep, dst, job->dststep, size,
+                           job->mat);
+}
+
+/* runs the job on the parallel bands; ops is the number of multiply-adds
+   per pixel */
+static int icvRunTransformJob(CvTransformJob* job, int ops)
+{
+    int count = job->size.height > 1 ? job->size.height : job->size.width;
+    int row_ops = ops * (job->size.height > 1 ? job->size.width : 1);
+
+    return cvParallelFor(count, ICV_MATMUL_MIN_BAND_OPS / MAX(row_ops, 1),
+                         icvTransformBand, job);
+}
+
 ///////////////////// IPP transform functions //////////////////
 
 icvColorTwist_8u_C3R_t icvColorTwist_8u_C3R_p = 0;
@@ -1703,6 +2226,7 @@ CV_IMPL void cvTransform(const CvArr* srcarr, CvArr* dstarr,
     {
         icvInitTransformRTable(&transform_tab);
         icvInitDiagTransformRTable(&diag_transform_tab);
+        icvInitTransformSIMD(&transform_tab);
         inittab = 1;
     }
 
@@ -1980,12 +2504,26 @@ CV_IMPL void cvTransform(const CvArr* srcarr, CvArr* dstarr,
                 IPPI_CALL(ipp_func(src->data.ptr, srcstep, dst->data.ptr,
                                    dststep, size, ipp_coeffs));
             }
-            else if (diag_transform)
-                diag_func(src->data.ptr, src->step, dst->data.ptr, dst->step,
-                          size, buffer);
             else
-                func(src->data.ptr, src->step, dst->data.ptr, dst->step, size,
-                     buffer, dst_cn);
+            {
+                CvTransformJob job;
+
+                job.func = diag_transform ? 0 : func;
+                job.diag_func = diag_transform ? diag_func : 0;
+                job.persp_func = 0;
+                job.src = src->data.ptr;
+                job.dst = dst->data.ptr;
+                job.srcstep = srcstep;
+                job.dststep = dststep;
+                job.src_pix_size = CV_ELEM_SIZE(src->type);
+                job.dst_pix_size = CV_ELEM_SIZE(dst->type);
+                job.size = size;
+                job.mat = buffer;
+                job.dst_cn = dst_cn;
+
+                IPPI_CALL((CvStatus)icvRunTransformJob(
+                    &job, diag_transform ? 1 : (cn + 1) * dst_cn));
+            }
         }
         else
         {
@@ -2120,6 +2658,75 @@ ICV_PERSPECTIVE_TRANSFORM_FUNC_2(64f, double)
 ICV_PERSPECTIVE_TRANSFORM_FUNC_3(32f, float)
 ICV_PERSPECTIVE_TRANSFORM_FUNC_3(64f, double)
 
+#if CV_SIMD_X86
+
+/* AVX2 version of the 3-channel floating-point perspective transform, see
+   icvTransformRow_32f_C3_avx2 */
+static CV_TARGET_AVX2 int icvPerspectiveTransformRow_32f_C3_avx2(
+    const float* src, float* dst, int width, const double* mat)
+{
+    __m256d c0 = _mm256_setr_pd(mat[0], mat[4], mat[8], mat[12]);
+    __m256d c1 = _mm256_setr_pd(mat[1], mat[5], mat[9], mat[13]);
+    __m256d c2 = _mm256_setr_pd(mat[2], mat[6], mat[10], mat[14]);
+    __m256d c3 = _mm256_setr_pd(mat[3], mat[7], mat[11], mat[15]);
+    __m256d one = _mm256_set1_pd(1.), eps = _mm256_set1_pd(FLT_EPSILON);
+    __m256d sign_mask = _mm256_set1_pd(-0.);
+    __m128 r[4];
+    int i, k;
+
+    for (i = 0; i <= width - 5; i += 4, src += 12, dst += 12)
+    {
+        for (k = 0; k < 4; k++)
+        {
+            __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(src + k * 3));
+            __m256d t = _mm256_mul_pd(c0, _mm256_permute4x64_pd(v, 0x00));
+            __m256d w, nz;
+            t = _mm256_add_pd(
+                t, _mm256_mul_pd(c1, _mm256_permute4x64_pd(v, 0x55)));
+            t = _mm256_add_pd(
+                t, _mm256_mul_pd(c2, _mm256_permute4x64_pd(v, 0xAA)));
+            t = _mm256_add_pd(t, c3);
+
+            // the points mapped to infinity are set to 0
+            w = _mm256_permute4x64_pd(t, 0xFF);
+            nz = _mm256_cmp_pd(_mm256_andnot_pd(sign_mask, w), eps, _CMP_GT_OQ);
+            t = _mm256_mul_pd(t, _mm256_div_pd(one, w));
+            r[k] = _mm256_cvtpd_ps(_mm256_and_pd(t, nz));
+        }
+
+        _mm_storeu_ps(dst, _mm_blend_ps(r[0],
+                                        _mm_shuffle_ps(r[1], r[1], 0), 8));
+        _mm_storeu_ps(dst + 4,
+                      _mm_shuffle_ps(r[1], r[2], _MM_SHUFFLE(1, 0, 2, 1)));
+        r[2] = _mm_shuffle_ps(r[2], r[3], _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(dst + 8,
+                      _mm_shuffle_ps(r[2], r[3], _MM_SHUFFLE(2, 1, 2, 0)));
+    }
+
+    return i;
+}
+
+static CvStatus CV_STDCALL icvPerspectiveTransform_32f_C3R_simd(
+    const float* src, int srcstep, float* dst, int dststep, CvSize size,
+    const double* mat)
+{
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i =
+            icvPerspectiveTransformRow_32f_C3_avx2(src, dst, size.width, mat);
+        if (i < size.width)
+            icvPerspectiveTransform_32f_C3R(src + i * 3, CV_STUB_STEP,
+                                            dst + i * 3, CV_STUB_STEP,
+                                            cvSize(size.width - i, 1), mat);
+    }
+
+    return CV_OK;
+}
+
+#endif /* CV_SIMD_X86 */
+
 static void icvInitPerspectiveTransformTable(CvFuncTable* tab2,
                                              CvFuncTable* tab3)
 {
@@ -2127,6 +2734,10 @@ static void icvInitPerspectiveTransformTable(CvFuncTable* tab2,
     tab2->fn_2d[CV_64F] = (void*)icvPerspectiveTransform_64f_C2R;
     tab3->fn_2d[CV_32F] = (void*)icvPerspectiveTransform_32f_C3R;
     tab3->fn_2d[CV_64F] = (void*)icvPerspectiveTransform_64f_C3R;
+#if CV_SIMD_X86
+    if (icvMatMulSimdLevel() == 2)
+        tab3->fn_2d[CV_32F] = (void*)icvPerspectiveTransform_32f_C3R_simd;
+#endif
 }
 
 CV_IMPL void cvPerspectiveTransform(const CvArr* srcarr, CvArr* dstarr,
@@ -2145,6 +2756,7 @@ CV_IMPL void cvPerspectiveTransform(const CvArr* srcarr, CvArr* dstarr,
     int i, j, type, cn;
     CvFunc2D_2A1P func = 0;
     CvSize size;
+    CvTransformJob job;
 
     if (!inittab)
     {
@@ -2227,8 +2839,19 @@ CV_IMPL void cvPerspectiveTransform(const CvArr* srcarr, CvArr* dstarr,
         size.height = 1;
     }
 
-    IPPI_CALL(
-        func(src->data.ptr, src->step, dst->data.ptr, dst->step, size, buffer));
+    job.func = 0;
+    job.diag_func = 0;
+    job.persp_func = func;
+    job.src = src->data.ptr;
+    job.dst = dst->data.ptr;
+    job.srcstep = src->step;
+    job.dststep = dst->step;
+    job.src_pix_size = job.dst_pix_size = CV_ELEM_SIZE(type);
+    job.size = size;
+    job.mat = buffer;
+    job.dst_cn = cn;
+
+    IPPI_CALL((CvStatus)icvRunTransformJob(&job, (cn + 1) * (cn + 1)));
 
     CV_CHECK_NANS(dst);
 
@@ -269,6 +269,51 @@ CV_INLINE CvSize cvGetMatSize(const CvMat* mat)
 #define CV_DESCALE(x, n) (((x) + (1 << ((n) - 1))) >> (n))
 #define CV_FLT_TO_FIX(x, n) cvRound((x) * (1 << (n)))
 
+/* IEEE 754 half precision floats (as in OpenEXR) stored in 16u arrays */
+CV_INLINE float cvHalfToFloat(ushort h)
+{
+    Cv32suf v;
+    unsigned sign = (unsigned)(h & 0x8000) << 16;
+    unsigned exp = (h >> 10) & 0x1f, mant = h & 0x3ff;
+
+    if (exp == 0x1f) // inf, nan
+        v.u = sign | 0x7f800000 | (mant << 13);
+    else if (exp != 0)
+        v.u = sign | ((exp + 112) << 23) | (mant << 13);
+    else // zero, denormals: mant*2^-24
+    {
+        v.f = (float)mant * (1.f / (1 << 24));
+        v.u |= sign;
+    }
+
+    return v.f;
+}
+
+/* rounds to the nearest even, overflows to inf */
+CV_INLINE ushort cvFloatToHalf(float f)
+{
+    Cv32suf v;
+    unsigned sign, absv;
+
+    v.f = f;
+    sign = (v.u >> 16) & 0x8000;
+    absv = v.u & 0x7fffffff;
+
+    if (absv >= 0x7f800000) // inf, nan
+        return (ushort)(sign | 0x7c00 | (absv > 0x7f800000 ? 0x200 : 0));
+    if (absv >= 0x477ff000) // rounds to >= 65536
+        return (ushort)(sign | 0x7c00);
+    if (absv < 0x38800000) // denormals: adding 0.5 rounds the mantissa
+    {
+        v.u = absv;
+        v.f += 0.5f;
+        return (ushort)(sign | (v.u - 0x3f000000));
+    }
+
+    absv += ((absv >> 13) & 1) + 0xc8000fff; // rebias the exponent, round
+    return (ushort)(sign | (absv >> 13));
+}
+
 #if 0
 /* This is a small engine for performing fast division of multiple numbers
    by the same constant. Most compilers do it too if they know the divisor value
@@ -672,6 +717,7 @@ typedef enum CvStatus
 #define CV_PLUGIN_IPPS 4  /* IPP: signal processing */
 #define CV_PLUGIN_IPPVM 5 /* IPP: vector math functions */
 #define CV_PLUGIN_IPPCC 6 /* IPP: color space conversion */
+#define CV_PLUGIN_NATIVE 7 /* built-in SIMD kernels, see cvRegisterNativeFuncs */
 #define CV_PLUGIN_MKL 8   /* Intel Math Kernel Library */
 
 #define CV_PLUGIN_MAX 16
@@ -681,6 +727,23 @@ typedef enum CvStatus
 #define CV_PLUGINS3(lib1, lib2, lib3) \
     (((lib1) & 15) | (((lib2) & 15) << 4) | (((lib2) & 15) << 8))
 
+/* Per-function instruction set selection for the built-in SIMD kernels.
+   MSVC accepts the intrinsics without any extra options */
+#if defined __x86_64__ || defined __i386__ || defined _M_X64 || defined _M_IX86
+#define CV_SIMD_X86 1
+#if defined __GNUC__
+#define CV_TARGET_SSE2 __attribute__((target("sse2")))
+#define CV_TARGET_SSE4_1 __attribute__((target("sse4.1")))
+#define CV_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CV_TARGET_SSE2
+#define CV_TARGET_SSE4_1
+#define CV_TARGET_AVX2
+#endif
+#else
+#define CV_SIMD_X86 0
+#endif
+
 #define CV_NOTHROW throw()
 
 #ifndef IPCVAPI
@@ -0,0 +1,230 @@
+/* ////////////////////////////////////////////////////////////////////
+//
+//  Row-band parallel loops (cvParallelFor). The bands are processed
+//  by a small pool of worker threads and by the calling thread.
+//
+// */
+
+#include "_cxcore.h"
+
+#include <pthread.h>
+#if defined WIN32 || defined WIN64
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define ICV_MAX_PARALLEL_THREADS 64
+
+/* a loop is split into several bands per thread, so that the threads which
+   finish early take over the work of the slower ones */
+#define ICV_PARALLEL_BANDS_PER_THREAD 4
+
+typedef struct CvParallelJob
+{
+    CvParallelLoopBody body;
+    void* userdata;
+    int count;
+    int band;   // the number of items in a band
+    int next;   // the first item of the next unprocessed band
+    int status; // the smallest status returned by body
+    int active; // the number of workers still processing the job
+} CvParallelJob;
+
+static pthread_mutex_t icvPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t icvPoolWorkCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t icvPoolDoneCond = PTHREAD_COND_INITIALIZER;
+static pthread_t icvPoolWorkers[ICV_MAX_PARALLEL_THREADS];
+static int icvPoolWorkerCount = 0;
+static CvParallelJob* icvPoolJob = 0;
+static int icvPoolJobId = 0;
+static int icvPoolShutdown = 0;
+
+/* held while a loop runs on the pool; the loops started meanwhile (from the
+   other threads or from the loop bodies) run serially */
+static pthread_mutex_t icvParallelLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* written with both icvParallelLock and icvPoolMutex held, so that either of
+   them is enough to read it */
+static int icvParallelThreads = 1;
+
+static int icvGetNumProcs(void)
+{
+#if defined WIN32 || defined WIN64
+    SYSTEM_INFO sys;
+    GetSystemInfo(&sys);
+    return (int)sys.dwNumberOfProcessors;
+#elif defined _SC_NPROCESSORS_ONLN
+    return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    return 1;
+#endif
+}
+
+static void icvRunParallelJob(CvParallelJob* job)
+{
+    for (;;)
+    {
+        int start, end, status;
+
+        pthread_mutex_lock(&icvPoolMutex);
+        start = job->next;
+        job->next += job->band;
+        pthread_mutex_unlock(&icvPoolMutex);
+
+        if (start >= job->count)
+            break;
+
+        end = MIN(start + job->band, job->count);
+        status = job->body(start, end, job->userdata);
+
+        if (status < 0)
+        {
+            pthread_mutex_lock(&icvPoolMutex);
+            job->status = MIN(job->status, status);
+            pthread_mutex_unlock(&icvPoolMutex);
+        }
+    }
+}
+
+static void* icvParallelWorker(void* arg)
+{
+    // the id of the last job seen, so that a worker started right before a
+    // job is posted does not miss it
+    int job_id = (int)(size_t)arg;
+
+    pthread_mutex_lock(&icvPoolMutex);
+
+    for (;;)
+    {
+        CvParallelJob* job;
+
+        while (icvPoolJobId == job_id && !icvPoolShutdown)
+            pthread_cond_wait(&icvPoolWorkCond, &icvPoolMutex);
+
+        if (icvPoolShutdown)
+            break;
+
+        job_id = icvPoolJobId;
+        job = icvPoolJob;
+
+        pthread_mutex_unlock(&icvPoolMutex);
+        icvRunParallelJob(job);
+        pthread_mutex_lock(&icvPoolMutex);
+
+        if (--job->active == 0)
+            pthread_cond_signal(&icvPoolDoneCond);
+    }
+
+    pthread_mutex_unlock(&icvPoolMutex);
+    return 0;
+}
+
+/* stops the workers; icvParallelLock must be held */
+static void icvShutdownParallelPool(void)
+{
+    int i;
+
+    pthread_mutex_lock(&icvPoolMutex);
+    icvPoolShutdown = 1;
+    pthread_cond_broadcast(&icvPoolWorkCond);
+    pthread_mutex_unlock(&icvPoolMutex);
+
+    for (i = 0; i < icvPoolWorkerCount; i++)
+        pthread_join(icvPoolWorkers[i], 0);
+
+    icvPoolWorkerCount = 0;
+    icvPoolShutdown = 0;
+}
+
+CV_IMPL int cvSetParallelThreads(int threads)
+{
+    int prev_threads;
+
+    if (threads <= 0)
+        threads = icvGetNumProcs();
+    threads = MAX(threads, 1);
+    threads = MIN(threads, ICV_MAX_PARALLEL_THREADS);
+
+    pthread_mutex_lock(&icvParallelLock);
+    if (icvPoolWorkerCount > threads - 1)
+        icvShutdownParallelPool();
+    pthread_mutex_lock(&icvPoolMutex);
+    prev_threads = icvParallelThreads;
+    icvParallelThreads = threads;
+    pthread_mutex_unlock(&icvPoolMutex);
+    pthread_mutex_unlock(&icvParallelLock);
+
+    return prev_threads;
+}
+
+CV_IMPL int cvGetParallelThreads(void)
+{
+    int threads;
+
+    // not icvParallelLock, which is held by the thread running a loop
+    // while it calls the loop body
+    pthread_mutex_lock(&icvPoolMutex);
+    threads = icvParallelThreads;
+    pthread_mutex_unlock(&icvPoolMutex);
+
+    return threads;
+}
+
+CV_IMPL int cvParallelFor(int count, int min_band, CvParallelLoopBody body,
+                          void* userdata)
+{
+    CvParallelJob job;
+    int threads, bands;
+
+    if (count <= 0)
+        return CV_OK;
+
+    min_band = MAX(min_band, 1);
+    if (count / min_band <= 1 || pthread_mutex_trylock(&icvParallelLock) != 0)
+        return body(0, count, userdata);
+
+    threads = icvParallelThreads;
+    bands = MIN(count / min_band, threads * ICV_PARALLEL_BANDS_PER_THREAD);
+    if (threads <= 1 || bands <= 1)
+    {
+        pthread_mutex_unlock(&icvParallelLock);
+        return body(0, count, userdata);
+    }
+
+    job.body = body;
+    job.userdata = userdata;
+    job.count = count;
+    job.band = (count + bands - 1) / bands;
+    job.next = 0;
+    job.status = CV_OK;
+
+    pthread_mutex_lock(&icvPoolMutex);
+
+    // the workers are started on the first use
+    while (icvPoolWorkerCount < icvParallelThreads - 1
+           && pthread_create(&icvPoolWorkers[icvPoolWorkerCount], 0,
+                             icvParallelWorker, (void*)(size_t)icvPoolJobId)
+                  == 0)
+        icvPoolWorkerCount++;
+
+    job.active = icvPoolWorkerCount;
+    icvPoolJob = &job;
+    icvPoolJobId++;
+    pthread_cond_broadcast(&icvPoolWorkCond);
+    pthread_mutex_unlock(&icvPoolMutex);
+
+    icvRunParallelJob(&job);
+
+    pthread_mutex_lock(&icvPoolMutex);
+    while (job.active > 0)
+        pthread_cond_wait(&icvPoolDoneCond, &icvPoolMutex);
+    icvPoolJob = 0;
+    pthread_mutex_unlock(&icvPoolMutex);
+
+    pthread_mutex_unlock(&icvParallelLock);
+
+    return job.status;
+}
+
+/* End of file. */
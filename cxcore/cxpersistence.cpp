@@ -93,6 +93,19 @@ typedef struct CvFileMapNode
     struct CvFileMapNode* next;
 } CvFileMapNode;
 
+/* a top-level node that has been indexed but not parsed yet
+   (CV_STORAGE_READ_LAZY mode) */
+typedef struct CvFileLazyNode
+{
+    CvFileNode* map_node;        // the root map the node belongs to
+    CvFileMapNode* node;         // the placeholder in the map, 0 if parsed
+    const CvStringHashNode* key;
+    struct CvFileLazyNode* next; // the next pending node in the hash bucket
+    long offset;                 // the file offset of the line with the node
+    int column;                  // where the value (YAML) or tag (XML) starts
+    int lineno;
+} CvFileLazyNode;
+
 typedef struct CvXMLStackRecord
 {
     CvMemStoragePos pos;
@@ -147,6 +160,12 @@ typedef struct CvFileStorage
     int dummy_eof;
     const char* errmsg;
     char errmsgbuf[128];
+    int base64;
+
+    CvSeq* lazy_nodes;
+    CvFileLazyNode** lazy_table;
+    int lazy_tab_size;
+    int lazy_pending;
 
     CvStartWriteStruct start_write_struct;
     CvEndWriteStruct end_write_struct;
@@ -468,6 +487,11 @@ CV_IMPL CvStringHashNode* cvGetHashedKey(CvFileStorage* fs, const char* str,
     return node;
 }
 
+static CvFileNode* icvFSParseLazyNode(CvFileStorage* fs,
+                                      const CvFileNode* map_node,
+                                      const CvStringHashNode* key);
+static void icvFSParseLazyNodes(CvFileStorage* fs);
+
 CV_IMPL CvFileNode* cvGetFileNode(CvFileStorage* fs, CvFileNode* _map_node,
                                   const CvStringHashNode* key,
                                   int create_missing)
@@ -535,6 +559,18 @@ CV_IMPL CvFileNode* cvGetFileNode(CvFileStorage* fs, CvFileNode* _map_node,
                 CV_PARSE_ERROR("Duplicated key");
             }
 
+        if (fs->lazy_pending)
+        {
+            CV_CALL(value = icvFSParseLazyNode(fs, map_node, key));
+            if (value)
+            {
+                if (!create_missing)
+                    EXIT;
+                value = 0;
+                CV_PARSE_ERROR("Duplicated key");
+            }
+        }
+
         if (k == attempts - 1 && create_missing)
         {
             CvFileMapNode* node = (CvFileMapNode*)cvSetNew((CvSet*)map);
@@ -623,6 +659,20 @@ CV_IMPL CvFileNode* cvGetFileNodeByName(const CvFileStorage* fs,
                 EXIT;
             }
         }
+
+        if (fs->lazy_pending)
+        {
+            CvFileStorage* lazy_fs = (CvFileStorage*)fs;
+            const CvStringHashNode* key;
+
+            CV_CALL(key = cvGetHashedKey(lazy_fs, str, len, 0));
+            if (key)
+            {
+                CV_CALL(value = icvFSParseLazyNode(lazy_fs, map_node, key));
+                if (value)
+                    EXIT;
+            }
+        }
     }
 
     __END__;
@@ -642,6 +692,10 @@ CV_IMPL CvFileNode* cvGetRootFileNode(const CvFileStorage* fs, int stream_index)
     if (!fs->roots || (unsigned)stream_index >= (unsigned)fs->roots->total)
         EXIT;
 
+    // the whole tree is exposed, so the pending nodes are parsed all at once
+    if (fs->lazy_pending)
+        CV_CALL(icvFSParseLazyNodes((CvFileStorage*)fs));
+
     value = (CvFileNode*)cvGetSeqElem(fs->roots, stream_index);
 
     __END__;
@@ -1781,6 +1835,39 @@ static char* icvXMLParseTag(CvFileStorage* fs, char* ptr,
                             CvStringHashNode** _tag, CvAttrList** _list,
                             int* _tag_type);
 
+/* decodes the type_id attribute of an element */
+static int icvXMLParseTypeId(CvAttrList* list, CvTypeInfo** _info)
+{
+    int elem_type = CV_NODE_NONE;
+    CvTypeInfo* info = 0;
+
+    CV_FUNCNAME("icvXMLParseTypeId");
+
+    __BEGIN__;
+
+    const char* type_name = list ? cvAttrValue(list, "type_id") : 0;
+    if (type_name)
+    {
+        if (strcmp(type_name, "str") == 0)
+            elem_type = CV_NODE_STRING;
+        else if (strcmp(type_name, "map") == 0)
+            elem_type = CV_NODE_MAP;
+        else if (strcmp(type_name, "seq") == 0)
+            elem_type = CV_NODE_MAP;
+        else
+        {
+            CV_CALL(info = cvFindType(type_name));
+            if (info)
+                elem_type = CV_NODE_USER;
+        }
+    }
+
+    __END__;
+
+    *_info = info;
+    return elem_type;
+}
+
 static char* icvXMLParseValue(CvFileStorage* fs, char* ptr, CvFileNode* node,
                               int value_type CV_DEFAULT(CV_NODE_NONE))
 {
@@ -1817,7 +1904,6 @@ static char* icvXMLParseValue(CvFileStorage* fs, char* ptr, CvFileNode* node,
             CvTypeInfo* info = 0;
             int tag_type = 0;
             int is_noname = 0;
-            const char* type_name = 0;
             int elem_type = CV_NODE_NONE;
 
             if (d == '/')
@@ -1832,22 +1918,7 @@ static char* icvXMLParseValue(CvFileStorage* fs, char* ptr, CvFileNode* node,
 
             assert(tag_type == CV_XML_OPENING_TAG);
 
-            type_name = list ? cvAttrValue(list, "type_id") : 0;
-            if (type_name)
-            {
-                if (strcmp(type_name, "str") == 0)
-                    elem_type = CV_NODE_STRING;
-                else if (strcmp(type_name, "map") == 0)
-                    elem_type = CV_NODE_MAP;
-                else if (strcmp(type_name, "seq") == 0)
-                    elem_type = CV_NODE_MAP;
-                else
-                {
-                    CV_CALL(info = cvFindType(type_name));
-                    if (info)
-                        elem_type = CV_NODE_USER;
-                }
-            }
+            CV_CALL(elem_type = icvXMLParseTypeId(list, &info));
 
             is_noname = key->str.len == 1 && key->str.ptr[0] == '_';
             if (!CV_NODE_IS_COLLECTION(node->tag))
@@ -2250,6 +2321,506 @@ static void icvXMLParse(CvFileStorage* fs)
     __END__;
 }
 
+/****************************************************************************************\
+*                           Lazy (indexed) reading *
+\****************************************************************************************/
+
+/* In CV_STORAGE_READ_LAZY mode cvOpenFileStorage only scans the document and
+   records where the top-level nodes start. The placeholders of the nodes are
+   put into the root maps in the document order, but they are not linked into
+   the hash tables until the nodes are parsed, which happens when they are
+   looked up for the first time (or when cvGetRootFileNode exposes the whole
+   tree). */
+
+static CvFileNode* icvFSAddLazyRoot(CvFileStorage* fs, int create_map)
+{
+    CvFileNode* root = 0;
+
+    CV_FUNCNAME("icvFSAddLazyRoot");
+
+    __BEGIN__;
+
+    CV_CALL(root = (CvFileNode*)cvSeqPush(fs->roots, 0));
+    memset(root, 0, sizeof(*root));
+    if (create_map)
+        CV_CALL(icvFSCreateCollection(fs, CV_NODE_MAP, root));
+
+    __END__;
+
+    return root;
+}
+
+static void icvFSAddLazyNode(CvFileStorage* fs, CvFileNode* root,
+                             const char* key_str, int key_len, long offset,
+                             int column, int lineno)
+{
+    CV_FUNCNAME("icvFSAddLazyNode");
+
+    __BEGIN__;
+
+    CvStringHashNode* key;
+    CvFileMapNode* node;
+    CvFileLazyNode* lazy;
+
+    if (!CV_NODE_IS_MAP(root->tag))
+        CV_CALL(icvFSCreateCollection(fs, CV_NODE_MAP, root));
+
+    CV_CALL(key = cvGetHashedKey(fs, key_str, key_len, 1));
+    CV_CALL(node = (CvFileMapNode*)cvSetNew((CvSet*)root->data.map));
+    memset(&node->value, 0, sizeof(node->value));
+    node->key = key;
+    node->next = 0;
+
+    CV_CALL(lazy = (CvFileLazyNode*)cvSeqPush(fs->lazy_nodes, 0));
+    lazy->map_node = root;
+    lazy->node = node;
+    lazy->key = key;
+    lazy->next = 0;
+    lazy->offset = offset;
+    lazy->column = column;
+    lazy->lineno = lineno;
+
+    __END__;
+}
+
+/* scans YAML document for the keys of the top-level block maps.
+   Returns 0 if the document has some other layout (e.g. the top-level
+   collection is a sequence or a flow map); then it is parsed as a whole */
+static int icvYMLIndex(CvFileStorage* fs)
+{
+    int indexed = 0;
+
+    CV_FUNCNAME("icvYMLIndex");
+
+    __BEGIN__;
+
+    int max_size = (int)(fs->buffer_end - fs->buffer_start);
+    int lineno = 0, is_first = 1;
+    int state = 0; // 0 - before a stream, 1 - after "---", 2 - in the map
+    long offset = 0, line_offset;
+    CvFileNode* root = 0;
+
+    for (;;)
+    {
+        char *ptr = fgets(fs->buffer_start, max_size, fs->file), *endptr;
+        char c;
+        int len;
+
+        if (!ptr)
+            break;
+
+        len = (int)strlen(ptr);
+        line_offset = offset;
+        offset += len;
+        lineno++;
+
+        // too long lines are reported by the parser
+        if (ptr[len - 1] != '\n' && ptr[len - 1] != '\r' && !feof(fs->file))
+            EXIT;
+
+        c = ptr[0];
+        if (c == '\0' || c == '\n' || c == '\r' || c == '#')
+            continue;
+
+        if (c == ' ')
+        {
+            // a value of the current key; anything else is left to the parser
+            if (state != 2)
+            {
+                while (*ptr == ' ')
+                    ptr++;
+                if (cv_isprint(*ptr) && *ptr != '#')
+                    EXIT;
+            }
+        }
+        else if (c == '%')
+        {
+            if (state != 0
+                || (memcmp(ptr, "%YAML:", 6) == 0
+                    && memcmp(ptr, "%YAML:1.", 8) != 0))
+                EXIT;
+        }
+        else if (c == '-' || c == '.')
+        {
+            // the stream start ("---") and end ("...") markers
+            if (memcmp(ptr, c == '-' ? "---" : "...", 3) != 0
+                || (c == '-') != (state == 0))
+                EXIT;
+            for (ptr += 3; *ptr == ' ';)
+                ptr++;
+            if (cv_isprint(*ptr) && *ptr != '#')
+                EXIT;
+            state = c == '-';
+            is_first = 0;
+        }
+        else if (cv_isprint(c))
+        {
+            if (state == 0 && (!is_first || (!isalnum(c) && c != '_')))
+                EXIT;
+
+            endptr = ptr;
+            do
+                c = *++endptr;
+            while (cv_isprint(c) && c != ':');
+
+            if (c != ':')
+                EXIT;
+
+            len = (int)(endptr - ptr);
+            while (ptr[len - 1] == ' ')
+                len--;
+
+            if (state != 2)
+            {
+                CV_CALL(root = icvFSAddLazyRoot(fs, 1));
+                state = 2;
+            }
+
+            CV_CALL(icvFSAddLazyNode(fs, root, ptr, len, line_offset,
+                                     (int)(endptr + 1 - ptr), lineno));
+        }
+        else
+            EXIT;
+    }
+
+    indexed = 1;
+
+    __END__;
+
+    return indexed;
+}
+
+/* scans XML document for the elements of the top-level <opencv_storage>
+   maps. Returns 0 if the document has some other layout; then it is parsed
+   as a whole */
+static int icvXMLIndex(CvFileStorage* fs)
+{
+    int indexed = 0;
+
+    CV_FUNCNAME("icvXMLIndex");
+
+    __BEGIN__;
+
+    int max_size = (int)(fs->buffer_end - fs->buffer_start);
+    int lineno = 0, depth = 0, mode = 0, tag_type = 0, have_header = 0;
+    char quote = 0;
+    long offset = 0, line_offset;
+    CvFileNode* root = 0;
+
+    for (;;)
+    {
+        char* ptr = fgets(fs->buffer_start, max_size, fs->file);
+        int len;
+
+        if (!ptr)
+            break;
+
+        len = (int)strlen(ptr);
+        line_offset = offset;
+        offset += len;
+        lineno++;
+
+        // too long lines are reported by the parser
+        if (ptr[len - 1] != '\n' && ptr[len - 1] != '\r' && !feof(fs->file))
+            EXIT;
+
+        for (; *ptr != '\0'; ptr++)
+        {
+            char c = *ptr;
+
+            if (mode == CV_XML_INSIDE_COMMENT)
+            {
+                if (c == '-' && ptr[1] == '-' && ptr[2] == '>')
+                {
+                    mode = 0;
+                    ptr += 2;
+                }
+            }
+            else if (mode == CV_XML_INSIDE_TAG)
+            {
+                if (quote)
+                    quote = c == quote ? 0 : quote;
+                else if (c == '\"' || c == '\'')
+                    quote = c;
+                else if (c == '>')
+                {
+                    mode = 0;
+                    if (tag_type == CV_XML_CLOSING_TAG && --depth < 0)
+                        EXIT;
+                    if (tag_type == CV_XML_OPENING_TAG)
+                    {
+                        // empty tags are not supported at the top level
+                        if (ptr > fs->buffer_start && ptr[-1] == '/')
+                        {
+                            if (depth < 2)
+                                EXIT;
+                        }
+                        else
+                            depth++;
+                    }
+                }
+            }
+            else if (c == '<')
+            {
+                char* endptr = ptr + 1;
+
+                if (!have_header && ptr[1] != '?')
+                    EXIT;
+
+                if (ptr[1] == '!' && ptr[2] == '-' && ptr[3] == '-')
+                {
+                    mode = CV_XML_INSIDE_COMMENT;
+                    ptr += 3;
+                    continue;
+                }
+
+                mode = CV_XML_INSIDE_TAG;
+                if (ptr[1] == '?')
+                {
+                    if (have_header)
+                        EXIT;
+                    have_header = 1;
+                    tag_type = CV_XML_HEADER_TAG;
+                }
+                else if (ptr[1] == '/')
+                    tag_type = CV_XML_CLOSING_TAG;
+                else if (isalpha(ptr[1]) || ptr[1] == '_')
+                {
+                    while (isalnum(*endptr) || *endptr == '_'
+                           || *endptr == '-')
+                        endptr++;
+                    len = (int)(endptr - ptr - 1);
+
+                    if (depth == 0)
+                    {
+                        if (len != 14
+                            || memcmp(ptr + 1, "opencv_storage", len) != 0)
+                            EXIT;
+                        CV_CALL(root = icvFSAddLazyRoot(fs, 0));
+                    }
+                    else if (depth == 1)
+                    {
+                        // the sequences are not indexed
+                        if (len == 1 && ptr[1] == '_')
+                            EXIT;
+                        CV_CALL(icvFSAddLazyNode(
+                            fs, root, ptr + 1, len, line_offset,
+                            (int)(ptr - fs->buffer_start), lineno));
+                    }
+                    tag_type = CV_XML_OPENING_TAG;
+                    ptr = endptr - 1;
+                }
+                else
+                    EXIT;
+            }
+            else if (depth < 2 && !isspace(c))
+                EXIT;
+        }
+    }
+
+    indexed = depth == 0 && mode == 0;
+
+    __END__;
+
+    return indexed;
+}
+
+/* indexes the document that has been opened in CV_STORAGE_READ_LAZY mode.
+   Returns 0 if the document has to be parsed completely */
+static int icvFSIndex(CvFileStorage* fs)
+{
+    int indexed = 0;
+
+    CV_FUNCNAME("icvFSIndex");
+
+    __BEGIN__;
+
+    CvSeqReader reader;
+    int i, k, tab_size = 16;
+
+    CV_CALL(fs->lazy_nodes = cvCreateSeq(0, sizeof(CvSeq),
+                                         sizeof(CvFileLazyNode),
+                                         fs->memstorage));
+    if (fs->is_xml)
+    {
+        CV_CALL(indexed = icvXMLIndex(fs));
+    }
+    else
+    {
+        CV_CALL(indexed = icvYMLIndex(fs));
+    }
+
+    if (!indexed)
+    {
+        cvClearSeq(fs->roots);
+        fs->lazy_nodes = 0;
+        EXIT;
+    }
+
+    while (tab_size < fs->lazy_nodes->total)
+        tab_size *= 2;
+
+    // nothing is linked into the root maps yet, so their tables are replaced
+    // with the larger ones
+    for (k = 0; k < fs->roots->total; k++)
+    {
+        CvFileNode* root = (CvFileNode*)cvGetSeqElem(fs->roots, k);
+        CvFileNodeHash* map;
+
+        if (!CV_NODE_IS_MAP(root->tag))
+            continue;
+
+        map = root->data.map;
+        map->tab_size = tab_size;
+        CV_CALL(map->table = (void**)cvMemStorageAlloc(
+                    fs->memstorage, tab_size * sizeof(map->table[0])));
+        memset(map->table, 0, tab_size * sizeof(map->table[0]));
+    }
+
+    fs->lazy_tab_size = tab_size;
+    CV_CALL(fs->lazy_table = (CvFileLazyNode**)cvMemStorageAlloc(
+                fs->memstorage, tab_size * sizeof(fs->lazy_table[0])));
+    memset(fs->lazy_table, 0, tab_size * sizeof(fs->lazy_table[0]));
+
+    cvStartReadSeq(fs->lazy_nodes, &reader, 0);
+    for (i = 0; i < fs->lazy_nodes->total; i++)
+    {
+        CvFileLazyNode* lazy = (CvFileLazyNode*)reader.ptr;
+        CvFileLazyNode** bucket =
+            fs->lazy_table + (lazy->key->hashval & (tab_size - 1));
+        CvFileLazyNode* another;
+
+        for (another = *bucket; another != 0; another = another->next)
+            if (another->key == lazy->key && another->map_node == lazy->map_node)
+            {
+                fs->lineno = lazy->lineno;
+                CV_PARSE_ERROR("Duplicated key");
+            }
+
+        lazy->next = *bucket;
+        *bucket = lazy;
+        CV_NEXT_SEQ_ELEM(sizeof(*lazy), reader);
+    }
+
+    fs->lazy_pending = fs->lazy_nodes->total;
+
+    __END__;
+
+    return indexed;
+}
+
+/* parses the indexed node and links it into its map */
+static void icvFSReadLazyNode(CvFileStorage* fs, CvFileLazyNode* lazy)
+{
+    CV_FUNCNAME("icvFSReadLazyNode");
+
+    __BEGIN__;
+
+    CvFileMapNode* node = lazy->node;
+    CvFileNodeHash* map = lazy->map_node->data.map;
+    int max_size = (int)(fs->buffer_end - fs->buffer_start);
+    char* ptr = 0;
+    int i;
+
+    lazy->node = 0;
+    fs->lazy_pending--;
+    fs->lineno = lazy->lineno;
+    fs->dummy_eof = 0;
+
+    if (fseek(fs->file, lazy->offset, SEEK_SET) == 0)
+        ptr = fgets(fs->buffer_start, max_size, fs->file);
+    if (!ptr || (int)strlen(ptr) <= lazy->column)
+        CV_PARSE_ERROR("The file has been modified after it was opened");
+    ptr += lazy->column;
+
+    if (fs->is_xml)
+    {
+        CvStringHashNode *key = 0, *key2 = 0;
+        CvAttrList* list = 0;
+        CvTypeInfo* info = 0;
+        int tag_type = 0, elem_type;
+
+        CV_CALL(ptr = icvXMLParseTag(fs, ptr, &key, &list, &tag_type));
+        if (tag_type != CV_XML_OPENING_TAG || key != node->key)
+            CV_PARSE_ERROR("The file has been modified after it was opened");
+
+        CV_CALL(elem_type = icvXMLParseTypeId(list, &info));
+        CV_CALL(ptr = icvXMLParseValue(fs, ptr, &node->value, elem_type));
+        node->value.info = info;
+        CV_CALL(ptr = icvXMLParseTag(fs, ptr, &key2, &list, &tag_type));
+        if (tag_type != CV_XML_CLOSING_TAG || key2 != key)
+            CV_PARSE_ERROR("Mismatched closing tag");
+    }
+    else
+    {
+        CV_CALL(ptr = icvYMLSkipSpaces(fs, ptr, 1, INT_MAX));
+        CV_CALL(ptr = icvYMLParseValue(fs, ptr, &node->value, CV_NODE_MAP, 1));
+    }
+
+    node->value.tag |= CV_NODE_NAMED;
+
+    i = (int)(node->key->hashval & (map->tab_size - 1));
+    node->next = (CvFileMapNode*)(map->table[i]);
+    map->table[i] = node;
+
+    __END__;
+}
+
+/* parses the pending node with the given key, if there is one */
+static CvFileNode* icvFSParseLazyNode(CvFileStorage* fs,
+                                      const CvFileNode* map_node,
+                                      const CvStringHashNode* key)
+{
+    CvFileNode* value = 0;
+
+    CV_FUNCNAME("icvFSParseLazyNode");
+
+    __BEGIN__;
+
+    CvFileLazyNode *lazy, **prev;
+    CvFileMapNode* node;
+
+    prev = fs->lazy_table + (key->hashval & (fs->lazy_tab_size - 1));
+    for (; (lazy = *prev) != 0; prev = &lazy->next)
+        if (lazy->key == key && lazy->map_node == map_node)
+            break;
+
+    if (!lazy)
+        EXIT;
+
+    *prev = lazy->next;
+    node = lazy->node;
+    CV_CALL(icvFSReadLazyNode(fs, lazy));
+    value = &node->value;
+
+    __END__;
+
+    return value;
+}
+
+static void icvFSParseLazyNodes(CvFileStorage* fs)
+{
+    CV_FUNCNAME("icvFSParseLazyNodes");
+
+    __BEGIN__;
+
+    CvSeqReader reader;
+    int i;
+
+    memset(fs->lazy_table, 0, fs->lazy_tab_size * sizeof(fs->lazy_table[0]));
+
+    cvStartReadSeq(fs->lazy_nodes, &reader, 0);
+    for (i = 0; i < fs->lazy_nodes->total; i++)
+    {
+        CvFileLazyNode* lazy = (CvFileLazyNode*)reader.ptr;
+        if (lazy->node)
+            CV_CALL(icvFSReadLazyNode(fs, lazy));
+        CV_NEXT_SEQ_ELEM(sizeof(*lazy), reader);
+    }
+
+    __END__;
+}
+
 /****************************************************************************************\
 *                                       XML Emitter *
 \****************************************************************************************/
@@ -2699,6 +3270,7 @@ CV_IMPL CvFileStorage* cvOpenFileStorage(const char* filename,
 
     int default_block_size = 1 << 18;
     bool append = (flags & 3) == CV_STORAGE_APPEND;
+    bool lazy = (flags & 3) == 0 && (flags & CV_STORAGE_READ_LAZY) != 0;
 
     if (!filename)
         CV_ERROR(CV_StsNullPtr, "NULL filename");
@@ -2715,9 +3287,12 @@ CV_IMPL CvFileStorage* cvOpenFileStorage(const char* filename,
 
     fs->flags = CV_FILE_STORAGE;
     fs->write_mode = (flags & 3) != 0;
-    fs->file = fopen(fs->filename, !fs->write_mode ? "rt"
-                                   : !append       ? "wt"
-                                                   : "a+t");
+    fs->base64 = fs->write_mode && (flags & CV_STORAGE_BASE64) != 0;
+    // the indexed nodes are located by the byte offsets, hence "rb"
+    fs->file = fopen(fs->filename, lazy            ? "rb"
+                                   : !fs->write_mode ? "rt"
+                                   : !append         ? "wt"
+                                                     : "a+t");
     if (!fs->file)
         EXIT;
 
@@ -2848,17 +3423,32 @@ CV_IMPL CvFileStorage* cvOpenFileStorage(const char* filename,
         fs->buffer[0] = '\n';
         fs->buffer[1] = '\0';
 
-        // mode = cvGetErrMode();
-        // cvSetErrMode( CV_ErrModeSilent );
-        if (fs->is_xml)
-            icvXMLParse(fs);
-        else
-            icvYMLParse(fs);
-        // cvSetErrMode( mode );
+        if (lazy)
+        {
+            CV_CALL(lazy = icvFSIndex(fs) != 0);
+            if (!lazy)
+            {
+                fseek(fs->file, 0, SEEK_SET);
+                fs->lineno = 0;
+                fs->buffer[0] = '\n';
+                fs->buffer[1] = '\0';
+            }
+        }
 
-        // release resources that we do not need anymore
-        cvFree(&fs->buffer_start);
-        fs->buffer = fs->buffer_end = 0;
+        if (!lazy)
+        {
+            // mode = cvGetErrMode();
+            // cvSetErrMode( CV_ErrModeSilent );
+            if (fs->is_xml)
+                icvXMLParse(fs);
+            else
+                icvYMLParse(fs);
+            // cvSetErrMode( mode );
+
+            // release resources that we do not need anymore
+            cvFree(&fs->buffer_start);
+            fs->buffer = fs->buffer_end = 0;
+        }
     }
 
     __END__;
@@ -2869,7 +3459,7 @@ CV_IMPL CvFileStorage* cvOpenFileStorage(const char* filename,
         {
             cvReleaseFileStorage(&fs);
         }
-        else if (!fs->write_mode)
+        else if (!fs->write_mode && !fs->lazy_nodes)
         {
             fclose(fs->file);
             fs->file = 0;
@@ -3093,6 +3683,268 @@ static int icvDecodeSimpleFormat(const char* dt)
     return elem_type;
 }
 
+/* The data of the large matrices and images is written in base64
+   (CV_STORAGE_BASE64) as a sequence of strings: the header with the element
+   type followed by the little-endian data split into the chunks */
+#define CV_FS_BASE64_HEADER "$base64$"
+#define CV_FS_BASE64_CHUNK 768    // bytes per string, a multiple of 3 and 8
+#define CV_FS_BASE64_MIN_SIZE 256 // the smaller arrays are written as text
+
+static const char icvBase64Symbols[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const signed char icvBase64Values[] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+};
+
+static void icvBase64SwapBytes(uchar* data, int len, int elem_size)
+{
+#if (defined(WORDS_BIGENDIAN) && !defined(OPENCV_UNIVERSAL_BUILD)) \
+    || defined(__BIG_ENDIAN__)
+    int i, j;
+    for (i = 0; i < len; i += elem_size)
+        for (j = 0; j < elem_size / 2; j++)
+        {
+            uchar t = data[i + j];
+            data[i + j] = data[i + elem_size - 1 - j];
+            data[i + elem_size - 1 - j] = t;
+        }
+#else
+    (void)data;
+    (void)len;
+    (void)elem_size;
+#endif
+}
+
+static int icvBase64Encode(const uchar* src, int len, char* dst)
+{
+    char* dst0 = dst;
+    int i;
+
+    for (i = 0; i + 3 <= len; i += 3, dst += 4)
+    {
+        int v = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+        dst[0] = icvBase64Symbols[v >> 18];
+        dst[1] = icvBase64Symbols[(v >> 12) & 63];
+        dst[2] = icvBase64Symbols[(v >> 6) & 63];
+        dst[3] = icvBase64Symbols[v & 63];
+    }
+
+    if (i < len)
+    {
+        int v = (src[i] << 16) | (i + 1 < len ? src[i + 1] << 8 : 0);
+        dst[0] = icvBase64Symbols[v >> 18];
+        dst[1] = icvBase64Symbols[(v >> 12) & 63];
+        dst[2] = i + 1 < len ? icvBase64Symbols[(v >> 6) & 63] : '=';
+        dst[3] = '=';
+        dst += 4;
+    }
+
+    *dst = '\0';
+    return (int)(dst - dst0);
+}
+
+/* returns the number of decoded bytes, -1 if the string is not valid */
+static int icvBase64Decode(const char* _src, int len, uchar* dst)
+{
+    const uchar* src = (const uchar*)_src;
+    uchar* dst0 = dst;
+    int i;
+
+    if (len % 4 != 0)
+        return -1;
+
+    for (i = 0; i < len; i += 4, dst += 3)
+    {
+        int pad = 0, a, b, c, d, v;
+
+        if (i + 4 == len)
+            pad = src[i + 3] != '=' ? 0 : src[i + 2] != '=' ? 1 : 2;
+
+        if ((src[i] | src[i + 1] | src[i + 2] | src[i + 3]) & 128)
+            return -1;
+
+        a = icvBase64Values[src[i]];
+        b = icvBase64Values[src[i + 1]];
+        c = pad < 2 ? icvBase64Values[src[i + 2]] : 0;
+        d = pad < 1 ? icvBase64Values[src[i + 3]] : 0;
+        if ((a | b | c | d) < 0)
+            return -1;
+
+        v = (a << 18) | (b << 12) | (c << 6) | d;
+        dst[0] = (uchar)(v >> 16);
+        if (pad < 2)
+            dst[1] = (uchar)(v >> 8);
+        if (pad < 1)
+            dst[2] = (uchar)v;
+        dst -= pad;
+    }
+
+    return (int)(dst - dst0);
+}
+
+static void icvWriteBase64Chunk(CvFileStorage* fs, uchar* data, int len,
+                                int elem_size)
+{
+    CV_FUNCNAME("icvWriteBase64Chunk");
+
+    __BEGIN__;
+
+    char buf[CV_FS_BASE64_CHUNK / 3 * 4 + 16];
+
+    icvBase64SwapBytes(data, len, elem_size);
+    icvBase64Encode(data, len, buf);
+    CV_CALL(cvWriteString(fs, 0, buf, 1));
+
+    __END__;
+}
+
+/* writes a 2D array of elements of simple type dt as base64 data */
+static void icvWriteRawDataBase64(CvFileStorage* fs, const uchar* data,
+                                  int step, CvSize size, const char* dt)
+{
+    CV_FUNCNAME("icvWriteRawDataBase64");
+
+    __BEGIN__;
+
+    uchar chunk[CV_FS_BASE64_CHUNK];
+    char header[64];
+    int elem_type, elem_size, row_size, y, len = 0;
+
+    CV_CALL(elem_type = icvDecodeSimpleFormat(dt));
+    elem_size = CV_ELEM_SIZE1(elem_type);
+    row_size = size.width * CV_ELEM_SIZE(elem_type);
+
+    sprintf(header, CV_FS_BASE64_HEADER "%s", dt);
+    CV_CALL(cvWriteString(fs, 0, header, 1));
+
+    for (y = 0; y < size.height; y++, data += step)
+    {
+        int x, n;
+        for (x = 0; x < row_size; x += n)
+        {
+            n = MIN(row_size - x, CV_FS_BASE64_CHUNK - len);
+            memcpy(chunk + len, data + x, n);
+            len += n;
+            if (len == CV_FS_BASE64_CHUNK)
+            {
+                CV_CALL(icvWriteBase64Chunk(fs, chunk, len, elem_size));
+                len = 0;
+            }
+        }
+    }
+
+    if (len > 0)
+        CV_CALL(icvWriteBase64Chunk(fs, chunk, len, elem_size));
+
+    __END__;
+}
+
+/* returns the type of the base64 data stored in the node, 0 if the node
+   is not base64 data */
+static const char* icvBase64DataType(const CvFileNode* node)
+{
+    const CvFileNode* header;
+    int header_len = (int)sizeof(CV_FS_BASE64_HEADER) - 1;
+
+    if (!CV_NODE_IS_SEQ(node->tag) || node->data.seq->total == 0)
+        return 0;
+
+    header = (const CvFileNode*)cvGetSeqElem(node->data.seq, 0);
+    if (!CV_NODE_IS_STRING(header->tag)
+        || strncmp(header->data.str.ptr, CV_FS_BASE64_HEADER, header_len) != 0)
+        return 0;
+
+    return header->data.str.ptr + header_len;
+}
+
+/* returns the number of the scalars in base64 data, -1 if it is invalid */
+static int icvBase64DataLen(const CvFileNode* node, const char* dt)
+{
+    int count = -1;
+
+    CV_FUNCNAME("icvBase64DataLen");
+
+    __BEGIN__;
+
+    CvSeqReader reader;
+    int i, elem_type, elem_size, size = 0;
+
+    CV_CALL(elem_type = icvDecodeSimpleFormat(dt));
+    elem_size = CV_ELEM_SIZE1(elem_type);
+
+    cvStartReadSeq(node->data.seq, &reader, 0);
+    for (i = 1; i < node->data.seq->total; i++)
+    {
+        const CvFileNode* chunk;
+        int len;
+
+        CV_NEXT_SEQ_ELEM(sizeof(CvFileNode), reader);
+        chunk = (const CvFileNode*)reader.ptr;
+        if (!CV_NODE_IS_STRING(chunk->tag) || chunk->data.str.len % 4 != 0)
+            EXIT;
+
+        len = chunk->data.str.len;
+        size += len / 4 * 3;
+        if (len > 0)
+            size -= (chunk->data.str.ptr[len - 1] == '=')
+                    + (chunk->data.str.ptr[len - 2] == '=');
+    }
+
+    if (size % elem_size == 0)
+        count = size / elem_size;
+
+    __END__;
+
+    return count;
+}
+
+static void icvReadRawDataBase64(const CvFileNode* src, void* _data,
+                                 const char* src_dt, const char* dt)
+{
+    CV_FUNCNAME("icvReadRawDataBase64");
+
+    __BEGIN__;
+
+    uchar* data = (uchar*)_data;
+    CvSeqReader reader;
+    int i, src_type, elem_type, elem_size;
+
+    CV_CALL(src_type = icvDecodeSimpleFormat(src_dt));
+    CV_CALL(elem_type = icvDecodeSimpleFormat(dt));
+    if (CV_MAT_DEPTH(src_type) != CV_MAT_DEPTH(elem_type))
+        CV_ERROR(CV_StsUnsupportedFormat, "The base64 data can only be read "
+                                          "with the type it has been written");
+    elem_size = CV_ELEM_SIZE1(elem_type);
+
+    cvStartReadSeq(src->data.seq, &reader, 0);
+    for (i = 1; i < src->data.seq->total; i++)
+    {
+        const CvFileNode* chunk;
+        int len = -1;
+
+        CV_NEXT_SEQ_ELEM(sizeof(CvFileNode), reader);
+        chunk = (const CvFileNode*)reader.ptr;
+        if (CV_NODE_IS_STRING(chunk->tag))
+            len = icvBase64Decode(chunk->data.str.ptr, chunk->data.str.len,
+                                  data);
+        if (len < 0)
+            CV_ERROR(CV_StsParseError, "Invalid base64 data");
+
+        icvBase64SwapBytes(data, len, elem_size);
+        data += len;
+    }
+
+    __END__;
+}
+
 CV_IMPL void cvWriteRawData(CvFileStorage* fs, const void* _data, int len,
                             const char* dt)
 {
@@ -3219,6 +4071,11 @@ CV_IMPL void cvStartReadRawData(const CvFileStorage* fs, const CvFileNode* src,
     }
     else if (node_type == CV_NODE_SEQ)
     {
+        // the elements of base64 data are not file nodes, so it can not be
+        // read by slices
+        if (icvBase64DataType(src))
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "The base64 data can only be read with cvReadRawData");
         CV_CALL(cvStartReadSeq(src->data.seq, reader, 0));
     }
     else if (node_type == CV_NODE_NONE)
@@ -3394,11 +4251,20 @@ CV_IMPL void cvReadRawData(const CvFileStorage* fs, const CvFileNode* src,
     __BEGIN__;
 
     CvSeqReader reader;
+    const char* src_dt;
 
     if (!src || !data)
         CV_ERROR(CV_StsNullPtr,
                  "Null pointers to source file node or destination array");
 
+    src_dt = icvBase64DataType(src);
+    if (src_dt)
+    {
+        CV_CHECK_FILE_STORAGE(fs);
+        CV_CALL(icvReadRawDataBase64(src, data, src_dt, dt));
+        EXIT;
+    }
+
     CV_CALL(cvStartReadRawData(fs, src, &reader));
     cvReadRawDataSlice(fs, &reader,
                        CV_NODE_IS_SEQ(src->tag) ? src->data.seq->total : 1,
@@ -3558,8 +4424,16 @@ static void icvWriteMat(CvFileStorage* fs, const char* name,
         size.height = 1;
     }
 
-    for (y = 0; y < size.height; y++)
-        cvWriteRawData(fs, mat->data.ptr + y * mat->step, size.width, dt);
+    if (fs->base64
+        && (int64)size.width * size.height * CV_ELEM_SIZE(mat->type)
+               >= CV_FS_BASE64_MIN_SIZE)
+    {
+        CV_CALL(
+            icvWriteRawDataBase64(fs, mat->data.ptr, mat->step, size, dt));
+    }
+    else
+        for (y = 0; y < size.height; y++)
+            cvWriteRawData(fs, mat->data.ptr + y * mat->step, size.width, dt);
     cvEndWriteStruct(fs);
     cvEndWriteStruct(fs);
 
@@ -3568,6 +4442,10 @@ static void icvWriteMat(CvFileStorage* fs, const char* name,
 
 static int icvFileNodeSeqLen(CvFileNode* node)
 {
+    const char* dt = icvBase64DataType(node);
+    if (dt)
+        return icvBase64DataLen(node, dt);
+
     return CV_NODE_IS_COLLECTION(node->tag)
                ? node->data.seq->total
                : CV_NODE_TYPE(node->tag) != CV_NODE_NONE;
@@ -3627,7 +4505,8 @@ static void icvWriteMatND(CvFileStorage* fs, const char* name,
     void* mat = (void*)struct_ptr;
     CvMatND stub;
     CvNArrayIterator iterator;
-    int dims, sizes[CV_MAX_DIM];
+    int i, dims, sizes[CV_MAX_DIM];
+    int64 total;
     char dt[16];
 
     assert(CV_IS_MATND(mat));
@@ -3642,9 +4521,21 @@ static void icvWriteMatND(CvFileStorage* fs, const char* name,
 
     CV_CALL(cvInitNArrayIterator(1, &mat, 0, &stub, &iterator));
 
-    do
-        cvWriteRawData(fs, iterator.ptr[0], iterator.size.width, dt);
-    while (cvNextNArraySlice(&iterator));
+    for (total = 1, i = 0; i < dims; i++)
+        total *= sizes[i];
+
+    // a continuous array is iterated as one slice
+    if (fs->base64 && iterator.size.width == total
+        && (int64)total * CV_ELEM_SIZE(cvGetElemType(mat))
+               >= CV_FS_BASE64_MIN_SIZE)
+    {
+        CV_CALL(icvWriteRawDataBase64(fs, iterator.ptr[0], 0,
+                                      cvSize(iterator.size.width, 1), dt));
+    }
+    else
+        do
+            cvWriteRawData(fs, iterator.ptr[0], iterator.size.width, dt);
+        while (cvNextNArraySlice(&iterator));
     cvEndWriteStruct(fs);
     cvEndWriteStruct(fs);
 
@@ -3943,9 +4834,18 @@ static void icvWriteImage(CvFileStorage* fs, const char* name,
     }
 
     cvStartWriteStruct(fs, "data", CV_NODE_SEQ + CV_NODE_FLOW);
-    for (y = 0; y < size.height; y++)
-        cvWriteRawData(fs, image->imageData + y * image->widthStep, size.width,
-                       dt);
+    if (fs->base64
+        && (int64)size.width * size.height * image->nChannels
+                   * CV_ELEM_SIZE(depth)
+               >= CV_FS_BASE64_MIN_SIZE)
+    {
+        CV_CALL(icvWriteRawDataBase64(fs, (uchar*)image->imageData,
+                                      image->widthStep, size, dt));
+    }
+    else
+        for (y = 0; y < size.height; y++)
+            cvWriteRawData(fs, image->imageData + y * image->widthStep,
+                           size.width, dt);
     cvEndWriteStruct(fs);
     cvEndWriteStruct(fs);
 
@@ -3955,6 +4855,7 @@ static void icvWriteImage(CvFileStorage* fs, const char* name,
 static void* icvReadImage(CvFileStorage* fs, CvFileNode* node)
 {
     void* ptr = 0;
+    uchar* buffer = 0;
     CV_FUNCNAME("icvReadImage");
 
     __BEGIN__;
@@ -4013,6 +4914,27 @@ static void* icvReadImage(CvFileStorage* fs, CvFileNode* node)
         height = 1;
     }
 
+    if (icvBase64DataType(data))
+    {
+        // base64 data is decoded at once and, unless the image is
+        // continuous, then spread over the rows
+        int row_size = width * CV_ELEM_SIZE(elem_type);
+        if (height == 1)
+        {
+            CV_CALL(cvReadRawData(fs, data, image->imageData, dt));
+        }
+        else
+        {
+            CV_CALL(buffer = (uchar*)cvScratchAlloc((size_t)row_size * height));
+            CV_CALL(cvReadRawData(fs, data, buffer, dt));
+            for (y = 0; y < height; y++)
+                memcpy(image->imageData + y * image->widthStep,
+                       buffer + y * row_size, row_size);
+        }
+        ptr = image;
+        EXIT;
+    }
+
     width *= CV_MAT_CN(elem_type);
     cvStartReadRawData(fs, data, &reader);
     for (y = 0; y < height; y++)
@@ -4025,6 +4947,8 @@ static void* icvReadImage(CvFileStorage* fs, CvFileNode* node)
 
     __END__;
 
+    cvScratchFree(&buffer);
+
     return ptr;
 }
 
@@ -5143,7 +6067,10 @@ CV_IMPL void* cvLoad(const char* filename, CvMemStorage* memstorage,
     __BEGIN__;
 
     CvFileNode* node = 0;
-    CV_CALL(fs = cvOpenFileStorage(filename, memstorage, CV_STORAGE_READ));
+    // only the requested node is parsed when the name is given
+    CV_CALL(fs = cvOpenFileStorage(filename, memstorage,
+                                   name ? CV_STORAGE_READ_LAZY
+                                        : CV_STORAGE_READ));
 
     if (!fs)
         EXIT;
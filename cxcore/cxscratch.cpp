@@ -0,0 +1,362 @@
+/* ////////////////////////////////////////////////////////////////////
+//
+//  Per-thread scratch arenas for the temporary buffers of the library
+//  functions (cvScratchAlloc). The blocks are stacked in a few large
+//  chunks; when the arena is empty, the chunks are merged into one that
+//  fits the largest working set seen, so that in a steady state (e.g.
+//  the same processing applied to every frame of a video) no heap
+//  allocations are made.
+//
+// */
+
+#include "_cxcore.h"
+
+#include <pthread.h>
+
+/* the size of the first chunk of an arena */
+#define ICV_SCRATCH_MIN_CHUNK (1 << 16)
+
+#define ICV_SCRATCH_ALIGN_SIZE(size) \
+    (((size) + CV_MALLOC_ALIGN - 1) & ~(size_t)(CV_MALLOC_ALIGN - 1))
+
+typedef struct CvScratchChunk
+{
+    struct CvScratchChunk* prev;
+    struct CvScratchChunk* next; // the chunks after the current one are spare
+    uchar* prev_top;             // the top of prev when the chunk was entered
+    uchar* data;
+    size_t size;
+} CvScratchChunk;
+
+typedef struct CvScratchBlock
+{
+    struct CvScratchBlock* prev;
+    CvScratchChunk* chunk;
+    size_t size; // including the header
+    int freed;
+} CvScratchBlock;
+
+#define ICV_SCRATCH_HDR_SIZE ICV_SCRATCH_ALIGN_SIZE(sizeof(CvScratchBlock))
+
+typedef struct CvScratchArena
+{
+    CvScratchChunk* base;  // the first chunk
+    CvScratchChunk* chunk; // the current chunk, 0 if none has been entered
+    uchar* top;            // the first free byte of the current chunk
+    CvScratchBlock* last;  // the top block of the stack
+    int count;             // the number of blocks in the stack
+    CvScratchStats stats;
+} CvScratchArena;
+
+static pthread_key_t icvScratchKey;
+static pthread_once_t icvScratchKeyOnce = PTHREAD_ONCE_INIT;
+
+static void icvFreeScratchChunks(CvScratchArena* arena, CvScratchChunk* chunk)
+{
+    while (chunk)
+    {
+        CvScratchChunk* next = chunk->next;
+        arena->stats.capacity -= chunk->size;
+        cvFree(&chunk);
+        chunk = next;
+    }
+}
+
+static CvScratchChunk* icvNewScratchChunk(CvScratchArena* arena,
+                                          CvScratchChunk* prev, size_t size)
+{
+    CvScratchChunk* chunk = 0;
+
+    CV_FUNCNAME("icvNewScratchChunk");
+
+    __BEGIN__;
+
+    CV_CALL(chunk = (CvScratchChunk*)cvAlloc(sizeof(*chunk) + CV_MALLOC_ALIGN
+                                             + size));
+    chunk->prev = prev;
+    chunk->next = 0;
+    chunk->prev_top = 0;
+    chunk->data = (uchar*)cvAlignPtr(chunk + 1, CV_MALLOC_ALIGN);
+    chunk->size = size;
+
+    arena->stats.capacity += size;
+    arena->stats.heap_allocs++;
+
+    __END__;
+
+    return chunk;
+}
+
+static void icvDestroyScratchArena(void* ptr)
+{
+    CvScratchArena* arena = (CvScratchArena*)ptr;
+    if (arena)
+    {
+        icvFreeScratchChunks(arena, arena->base);
+        free(arena);
+    }
+}
+
+static void icvCreateScratchKey(void)
+{
+    pthread_key_create(&icvScratchKey, icvDestroyScratchArena);
+}
+
+static CvScratchArena* icvGetScratchArena(int create)
+{
+    CvScratchArena* arena;
+
+    pthread_once(&icvScratchKeyOnce, icvCreateScratchKey);
+    arena = (CvScratchArena*)pthread_getspecific(icvScratchKey);
+
+    if (!arena && create)
+    {
+        arena = (CvScratchArena*)calloc(1, sizeof(*arena));
+        if (arena)
+            pthread_setspecific(icvScratchKey, arena);
+    }
+
+    return arena;
+}
+
+/* removes the top block from the stack */
+static void icvPopScratchBlock(CvScratchArena* arena)
+{
+    CvScratchBlock* block = arena->last;
+    CvScratchChunk* chunk = block->chunk;
+
+    arena->last = block->prev;
+    arena->count--;
+    arena->stats.used -= block->size;
+    arena->stats.blocks--;
+    arena->top = (uchar*)block;
+
+    // the chunk is empty now; it is kept as a spare one
+    if (arena->top == chunk->data && chunk->prev)
+    {
+        arena->chunk = chunk->prev;
+        arena->top = chunk->prev_top;
+    }
+}
+
+/* pops the released blocks from the stack top. If the arena becomes empty
+   and it has grown over several chunks, they are replaced with a single
+   chunk, large enough for the high-water mark */
+static void icvTrimScratchArena(CvScratchArena* arena)
+{
+    while (arena->last && arena->last->freed)
+        icvPopScratchBlock(arena);
+
+    if (arena->count == 0 && arena->base && arena->base->next)
+    {
+        size_t size = MAX(arena->stats.high_water, ICV_SCRATCH_MIN_CHUNK);
+        icvFreeScratchChunks(arena, arena->base);
+        arena->base = arena->chunk = 0;
+        arena->top = 0;
+        arena->base = icvNewScratchChunk(arena, 0, size);
+    }
+}
+
+CV_IMPL void* cvScratchAlloc(size_t size)
+{
+    void* ptr = 0;
+
+    CV_FUNCNAME("cvScratchAlloc");
+
+    __BEGIN__;
+
+    CvScratchArena* arena;
+    CvScratchChunk* chunk;
+    CvScratchBlock* block;
+    size_t total;
+
+    if (size > CV_MAX_ALLOC_SIZE)
+        CV_ERROR(CV_StsOutOfRange,
+                 "Negative or too large argument of cvScratchAlloc function");
+
+    arena = icvGetScratchArena(1);
+    if (!arena)
+        CV_ERROR(CV_StsNoMem, "Out of memory");
+
+    total = ICV_SCRATCH_HDR_SIZE + ICV_SCRATCH_ALIGN_SIZE(size);
+    chunk = arena->chunk;
+
+    if (!chunk || (size_t)(chunk->data + chunk->size - arena->top) < total)
+    {
+        // go to the next chunk, allocate it if there is no spare one that
+        // is large enough
+        CvScratchChunk* next = chunk ? chunk->next : arena->base;
+
+        if (!next || next->size < total)
+        {
+            size_t chunk_size = MAX(total, ICV_SCRATCH_MIN_CHUNK);
+            if (chunk)
+                chunk_size = MAX(chunk_size + chunk->size, chunk->size * 2);
+
+            icvFreeScratchChunks(arena, next);
+            if (chunk)
+                chunk->next = 0;
+            else
+                arena->base = 0;
+
+            CV_CALL(next = icvNewScratchChunk(arena, chunk, chunk_size));
+            if (chunk)
+                chunk->next = next;
+            else
+                arena->base = next;
+        }
+
+        next->prev_top = arena->top;
+        arena->chunk = chunk = next;
+        arena->top = next->data;
+    }
+
+    block = (CvScratchBlock*)arena->top;
+    block->prev = arena->last;
+    block->chunk = chunk;
+    block->size = total;
+    block->freed = 0;
+
+    arena->top += total;
+    arena->last = block;
+    arena->count++;
+    arena->stats.blocks++;
+    arena->stats.used += total;
+    arena->stats.high_water = MAX(arena->stats.high_water, arena->stats.used);
+
+    ptr = (uchar*)block + ICV_SCRATCH_HDR_SIZE;
+
+    __END__;
+
+    return ptr;
+}
+
+CV_IMPL void cvScratchFree_(void* ptr)
+{
+    CV_FUNCNAME("cvScratchFree_");
+
+    __BEGIN__;
+
+    CvScratchArena* arena;
+    CvScratchBlock* block;
+
+    if (!ptr)
+        EXIT;
+
+    arena = icvGetScratchArena(0);
+    block = (CvScratchBlock*)((uchar*)ptr - ICV_SCRATCH_HDR_SIZE);
+
+    if (!arena || arena->count == 0 || block->freed)
+        CV_ERROR(CV_StsBadArg, "The block has not been allocated by "
+                               "cvScratchAlloc in this thread or it has "
+                               "been released already");
+
+    block->freed = 1;
+    icvTrimScratchArena(arena);
+
+    __END__;
+}
+
+CV_IMPL CvMat* cvCreateScratchMat(int rows, int cols, int type)
+{
+    CvMat* mat = 0;
+
+    CV_FUNCNAME("cvCreateScratchMat");
+
+    __BEGIN__;
+
+    int64 data_size;
+    size_t hdr_size = ICV_SCRATCH_ALIGN_SIZE(sizeof(CvMat));
+
+    if (rows <= 0 || cols <= 0)
+        CV_ERROR(CV_StsBadSize, "Non-positive width or height");
+
+    data_size = (int64)rows * cols * CV_ELEM_SIZE(type);
+    if (data_size > (int64)CV_MAX_ALLOC_SIZE)
+        CV_ERROR(CV_StsNoMem, "Too big buffer is allocated");
+
+    CV_CALL(mat = (CvMat*)cvScratchAlloc(hdr_size + (size_t)data_size));
+    cvInitMatHeader(mat, rows, cols, type, (uchar*)mat + hdr_size);
+
+    __END__;
+
+    return mat;
+}
+
+CV_IMPL int cvBeginScratchFrame(void)
+{
+    CvScratchArena* arena = icvGetScratchArena(0);
+    return arena ? arena->count : 0;
+}
+
+CV_IMPL void cvEndScratchFrame(int frame)
+{
+    CV_FUNCNAME("cvEndScratchFrame");
+
+    __BEGIN__;
+
+    CvScratchArena* arena = icvGetScratchArena(0);
+    int count = arena ? arena->count : 0;
+
+    if ((unsigned)frame > (unsigned)count)
+        CV_ERROR(CV_StsOutOfRange, "The frame has been ended already");
+
+    while (arena && arena->count > frame)
+        icvPopScratchBlock(arena);
+
+    if (arena)
+        icvTrimScratchArena(arena);
+
+    __END__;
+}
+
+CV_IMPL void cvGetScratchStats(CvScratchStats* stats, int reset)
+{
+    CV_FUNCNAME("cvGetScratchStats");
+
+    __BEGIN__;
+
+    CvScratchArena* arena;
+
+    if (!stats)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    arena = icvGetScratchArena(0);
+    if (!arena)
+    {
+        memset(stats, 0, sizeof(*stats));
+        EXIT;
+    }
+
+    *stats = arena->stats;
+    if (reset)
+    {
+        arena->stats.high_water = arena->stats.used;
+        arena->stats.heap_allocs = 0;
+    }
+
+    __END__;
+}
+
+CV_IMPL void cvReleaseScratch(void)
+{
+    CV_FUNCNAME("cvReleaseScratch");
+
+    __BEGIN__;
+
+    CvScratchArena* arena = icvGetScratchArena(0);
+
+    if (!arena)
+        EXIT;
+
+    if (arena->count > 0)
+        CV_ERROR(CV_StsError,
+                 "The scratch arena can not be released while it is in use");
+
+    icvFreeScratchChunks(arena, arena->base);
+    memset(arena, 0, sizeof(*arena));
+
+    __END__;
+}
+
+/* End of file. */
@@ -0,0 +1,359 @@
+/* ////////////////////////////////////////////////////////////////////
+//
+//  Built-in SSE2/AVX2 kernels for the cxcore IPP function slots.
+//  They are registered under the IPP names and used when no IPP
+//  plugin provides the function (see cvRegisterNativeFuncs).
+//
+// */
+
+#include "_cxcore.h"
+
+#if CV_SIMD_X86
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+static int icvHaveAVX2()
+{
+    static int have_avx2 = -1;
+    if (have_avx2 < 0)
+        have_avx2 = cvCheckHardwareSupport(CV_CPU_AVX2);
+    return have_avx2;
+}
+
+/****************************************************************************************\
+*                                    Compare *
+\****************************************************************************************/
+
+/* the rows are compared with one of these, the "less" operations swap the
+   arguments */
+#define ICV_CMP_GT 0
+#define ICV_CMP_GE 1
+#define ICV_CMP_EQ 2
+
+#define ICV_DEF_CMP_ROW_TAIL(flavor, arrtype)                                \
+    static void icvCmpRowTail_##flavor(const arrtype* a, const arrtype* b,   \
+                                       uchar* d, int x, int n, int op)       \
+    {                                                                        \
+        if (op == ICV_CMP_GT)                                                \
+            for (; x < n; x++)                                               \
+                d[x] = (uchar) - (a[x] > b[x]);                              \
+        else if (op == ICV_CMP_GE)                                           \
+            for (; x < n; x++)                                               \
+                d[x] = (uchar) - (a[x] >= b[x]);                             \
+        else                                                                 \
+            for (; x < n; x++)                                               \
+                d[x] = (uchar) - (a[x] == b[x]);                             \
+    }
+
+ICV_DEF_CMP_ROW_TAIL(8u, uchar)
+ICV_DEF_CMP_ROW_TAIL(16s, short)
+ICV_DEF_CMP_ROW_TAIL(32f, float)
+
+static CV_TARGET_SSE2 void icvCmpRow_8u_sse2(const uchar* a, const uchar* b,
+                                             uchar* d, int n, int op)
+{
+    const __m128i delta = _mm_set1_epi8((char)0x80);
+    int x = 0;
+
+    for (; x <= n - 16; x += 16)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + x));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + x));
+        __m128i r;
+
+        if (op == ICV_CMP_GT)
+            r = _mm_cmpgt_epi8(_mm_xor_si128(va, delta),
+                               _mm_xor_si128(vb, delta));
+        else if (op == ICV_CMP_GE)
+            r = _mm_cmpeq_epi8(_mm_max_epu8(va, vb), va);
+        else
+            r = _mm_cmpeq_epi8(va, vb);
+
+        _mm_storeu_si128((__m128i*)(d + x), r);
+    }
+
+    icvCmpRowTail_8u(a, b, d, x, n, op);
+}
+
+static CV_TARGET_AVX2 void icvCmpRow_8u_avx2(const uchar* a, const uchar* b,
+                                             uchar* d, int n, int op)
+{
+    const __m256i delta = _mm256_set1_epi8((char)0x80);
+    int x = 0;
+
+    for (; x <= n - 32; x += 32)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + x));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + x));
+        __m256i r;
+
+        if (op == ICV_CMP_GT)
+            r = _mm256_cmpgt_epi8(_mm256_xor_si256(va, delta),
+                                  _mm256_xor_si256(vb, delta));
+        else if (op == ICV_CMP_GE)
+            r = _mm256_cmpeq_epi8(_mm256_max_epu8(va, vb), va);
+        else
+            r = _mm256_cmpeq_epi8(va, vb);
+
+        _mm256_storeu_si256((__m256i*)(d + x), r);
+    }
+
+    icvCmpRowTail_8u(a, b, d, x, n, op);
+}
+
+static CV_TARGET_SSE2 void icvCmpRow_16s_sse2(const short* a, const short* b,
+                                              uchar* d, int n, int op)
+{
+    const __m128i ones = _mm_set1_epi32(-1);
+    int x = 0;
+
+    for (; x <= n - 16; x += 16)
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(a + x));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(a + x + 8));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(b + x));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(b + x + 8));
+        __m128i r0, r1;
+
+        if (op == ICV_CMP_GT)
+        {
+            r0 = _mm_cmpgt_epi16(a0, b0);
+            r1 = _mm_cmpgt_epi16(a1, b1);
+        }
+        else if (op == ICV_CMP_GE)
+        {
+            r0 = _mm_xor_si128(_mm_cmpgt_epi16(b0, a0), ones);
+            r1 = _mm_xor_si128(_mm_cmpgt_epi16(b1, a1), ones);
+        }
+        else
+        {
+            r0 = _mm_cmpeq_epi16(a0, b0);
+            r1 = _mm_cmpeq_epi16(a1, b1);
+        }
+
+        _mm_storeu_si128((__m128i*)(d + x), _mm_packs_epi16(r0, r1));
+    }
+
+    icvCmpRowTail_16s(a, b, d, x, n, op);
+}
+
+static CV_TARGET_AVX2 void icvCmpRow_16s_avx2(const short* a, const short* b,
+                                              uchar* d, int n, int op)
+{
+    const __m256i ones = _mm256_set1_epi32(-1);
+    int x = 0;
+
+    for (; x <= n - 32; x += 32)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(a + x));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(a + x + 16));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(b + x));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + x + 16));
+        __m256i r0, r1;
+
+        if (op == ICV_CMP_GT)
+        {
+            r0 = _mm256_cmpgt_epi16(a0, b0);
+            r1 = _mm256_cmpgt_epi16(a1, b1);
+        }
+        else if (op == ICV_CMP_GE)
+        {
+            r0 = _mm256_xor_si256(_mm256_cmpgt_epi16(b0, a0), ones);
+            r1 = _mm256_xor_si256(_mm256_cmpgt_epi16(b1, a1), ones);
+        }
+        else
+        {
+            r0 = _mm256_cmpeq_epi16(a0, b0);
+            r1 = _mm256_cmpeq_epi16(a1, b1);
+        }
+
+        // packs works within the 128-bit lanes, restore the element order
+        r0 = _mm256_permute4x64_epi64(_mm256_packs_epi16(r0, r1), 0xD8);
+        _mm256_storeu_si256((__m256i*)(d + x), r0);
+    }
+
+    icvCmpRowTail_16s(a, b, d, x, n, op);
+}
+
+static CV_TARGET_SSE2 void icvCmpRow_32f_sse2(const float* a, const float* b,
+                                              uchar* d, int n, int op)
+{
+    int x = 0;
+
+    for (; x <= n - 16; x += 16)
+    {
+        __m128 m[4];
+        int k;
+
+        for (k = 0; k < 4; k++)
+        {
+            __m128 va = _mm_loadu_ps(a + x + k * 4);
+            __m128 vb = _mm_loadu_ps(b + x + k * 4);
+            m[k] = op == ICV_CMP_GT   ? _mm_cmpgt_ps(va, vb)
+                   : op == ICV_CMP_GE ? _mm_cmpge_ps(va, vb)
+                                      : _mm_cmpeq_ps(va, vb);
+        }
+
+        __m128i r0 = _mm_packs_epi32(_mm_castps_si128(m[0]),
+                                     _mm_castps_si128(m[1]));
+        __m128i r1 = _mm_packs_epi32(_mm_castps_si128(m[2]),
+                                     _mm_castps_si128(m[3]));
+        _mm_storeu_si128((__m128i*)(d + x), _mm_packs_epi16(r0, r1));
+    }
+
+    icvCmpRowTail_32f(a, b, d, x, n, op);
+}
+
+static CV_TARGET_AVX2 void icvCmpRow_32f_avx2(const float* a, const float* b,
+                                              uchar* d, int n, int op)
+{
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int x = 0;
+
+    for (; x <= n - 32; x += 32)
+    {
+        __m256 m[4];
+        int k;
+
+        for (k = 0; k < 4; k++)
+        {
+            __m256 va = _mm256_loadu_ps(a + x + k * 8);
+            __m256 vb = _mm256_loadu_ps(b + x + k * 8);
+            m[k] = op == ICV_CMP_GT   ? _mm256_cmp_ps(va, vb, _CMP_GT_OQ)
+                   : op == ICV_CMP_GE ? _mm256_cmp_ps(va, vb, _CMP_GE_OQ)
+                                      : _mm256_cmp_ps(va, vb, _CMP_EQ_OQ);
+        }
+
+        __m256i r0 = _mm256_packs_epi32(_mm256_castps_si256(m[0]),
+                                        _mm256_castps_si256(m[1]));
+        __m256i r1 = _mm256_packs_epi32(_mm256_castps_si256(m[2]),
+                                        _mm256_castps_si256(m[3]));
+        r0 = _mm256_permutevar8x32_epi32(_mm256_packs_epi16(r0, r1), order);
+        _mm256_storeu_si256((__m256i*)(d + x), r0);
+    }
+
+    icvCmpRowTail_32f(a, b, d, x, n, op);
+}
+
+/* converts CvCmpOp to ICV_CMP_*, returns 1 if the operands are to be
+   swapped, -1 if the operation is unknown */
+static int icvNormalizeCmpOp(int cmp_op, int* op)
+{
+    switch (cmp_op)
+    {
+    case cvCmpLess:
+        *op = ICV_CMP_GT;
+        return 1;
+    case cvCmpLessEq:
+        *op = ICV_CMP_GE;
+        return 1;
+    case cvCmpEq:
+        *op = ICV_CMP_EQ;
+        return 0;
+    case cvCmpGreaterEq:
+        *op = ICV_CMP_GE;
+        return 0;
+    case cvCmpGreater:
+        *op = ICV_CMP_GT;
+        return 0;
+    }
+    return -1;
+}
+
+#define ICV_CMP_SCALAR_BUF 256
+
+#define ICV_DEF_COMPARE_FUNC(flavor, arrtype)                                  \
+    static CvStatus CV_STDCALL icvCompare_##flavor##_C1R_n(                    \
+        const arrtype* src1, int step1, const arrtype* src2, int step2,        \
+        arrtype* dstarr, int step, CvSize size, int cmp_op)                    \
+    {                                                                          \
+        void (*row_func)(const arrtype*, const arrtype*, uchar*, int, int) =   \
+            icvHaveAVX2() ? icvCmpRow_##flavor##_avx2                          \
+                          : icvCmpRow_##flavor##_sse2;                         \
+        uchar* dst = (uchar*)dstarr;                                           \
+        int op, swap = icvNormalizeCmpOp(cmp_op, &op);                         \
+                                                                               \
+        if (swap < 0)                                                          \
+            return CV_BADFLAG_ERR;                                             \
+        step1 /= sizeof(src1[0]);                                              \
+        step2 /= sizeof(src2[0]);                                              \
+                                                                               \
+        for (; size.height--; src1 += step1, src2 += step2, dst += step)       \
+        {                                                                      \
+            if (swap)                                                          \
+                row_func(src2, src1, dst, size.width, op);                     \
+            else                                                               \
+                row_func(src1, src2, dst, size.width, op);                     \
+        }                                                                      \
+                                                                               \
+        return CV_OK;                                                          \
+    }
+
+#define ICV_DEF_COMPAREC_FUNC(flavor, arrtype)                                 \
+    static CvStatus CV_STDCALL icvCompareC_##flavor##_C1R_n(                   \
+        const arrtype* src1, int step1, arrtype scalar, arrtype* dstarr,       \
+        int step, CvSize size, int cmp_op)                                     \
+    {                                                                          \
+        void (*row_func)(const arrtype*, const arrtype*, uchar*, int, int) =   \
+            icvHaveAVX2() ? icvCmpRow_##flavor##_avx2                          \
+                          : icvCmpRow_##flavor##_sse2;                         \
+        arrtype buf[ICV_CMP_SCALAR_BUF];                                       \
+        uchar* dst = (uchar*)dstarr;                                           \
+        int i, op, swap = icvNormalizeCmpOp(cmp_op, &op);                      \
+                                                                               \
+        if (swap < 0)                                                          \
+            return CV_BADFLAG_ERR;                                             \
+        step1 /= sizeof(src1[0]);                                              \
+                                                                               \
+        for (i = 0; i < ICV_CMP_SCALAR_BUF; i++)                               \
+            buf[i] = scalar;                                                   \
+                                                                               \
+        for (; size.height--; src1 += step1, dst += step)                      \
+        {                                                                      \
+            for (i = 0; i < size.width; i += ICV_CMP_SCALAR_BUF)               \
+            {                                                                  \
+                int len = MIN(size.width - i, ICV_CMP_SCALAR_BUF);             \
+                if (swap)                                                      \
+                    row_func(buf, src1 + i, dst + i, len, op);                 \
+                else                                                           \
+                    row_func(src1 + i, buf, dst + i, len, op);                 \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        return CV_OK;                                                          \
+    }
+
+ICV_DEF_COMPARE_FUNC(8u, uchar)
+ICV_DEF_COMPARE_FUNC(16s, short)
+ICV_DEF_COMPARE_FUNC(32f, float)
+
+/* cvCmpS compares 32f arrays with a double-precision scalar, so there is no
+   32f CompareC (float scalar) */
+ICV_DEF_COMPAREC_FUNC(8u, uchar)
+ICV_DEF_COMPAREC_FUNC(16s, short)
+
+/****************************************************************************************\
+*                                  Registration *
+\****************************************************************************************/
+
+static const CvNativeFuncInfo icv_cxcore_native_tab[] = {
+    {"ippiCompare_8u_C1R", (void*)icvCompare_8u_C1R_n},
+    {"ippiCompare_16s_C1R", (void*)icvCompare_16s_C1R_n},
+    {"ippiCompare_32f_C1R", (void*)icvCompare_32f_C1R_n},
+    {"ippiCompareC_8u_C1R", (void*)icvCompareC_8u_C1R_n},
+    {"ippiCompareC_16s_C1R", (void*)icvCompareC_16s_C1R_n},
+    {0, 0}};
+
+static int icvRegisterCxcoreNativeFuncs()
+{
+    return cvCheckHardwareSupport(CV_CPU_SSE2)
+               ? cvRegisterNativeFuncs(icv_cxcore_native_tab)
+               : 0;
+}
+
+static int icv_cxcore_native_funcs = icvRegisterCxcoreNativeFuncs();
+
+#endif /* CV_SIMD_X86 */
+
+/* End of file. */
@@ -71,6 +71,14 @@ direct,
 #include <stdio.h>
 #include <ctype.h>
 
+#if CV_SIMD_X86
+#if defined _MSC_VER
+#include <intrin.h>
+#elif defined __GNUC__
+#include <cpuid.h>
+#endif
+#endif
+
 #define CV_PROC_GENERIC 0
 #define CV_PROC_SHIFT 10
 #define CV_PROC_ARCH_MASK ((1 << CV_PROC_SHIFT) - 1)
@@ -87,6 +95,7 @@ typedef struct CvProcessorInfo
     int model;
     int count;
     double frequency; // clocks per microsecond
+    int features;     // (1 << CV_CPU_*) for each supported SIMD extension
 } CvProcessorInfo;
 
 #undef MASM_INLINE_ASSEMBLY
@@ -274,6 +283,68 @@ static void icvInitProcessorInfo(CvProcessorInfo* cpu_info)
 #endif
 }
 
+/*
+   determine SIMD extensions supported by both the processor and the OS
+*/
+static int icvInitCpuFeatures()
+{
+    int features = 0;
+
+#if CV_SIMD_X86 && (defined _MSC_VER || defined __GNUC__)
+    unsigned regs[4] = {0, 0, 0, 0}, regs7[4] = {0, 0, 0, 0};
+    unsigned max_level = 0;
+
+#if defined _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    max_level = (unsigned)info[0];
+    if (max_level >= 1)
+    {
+        __cpuid(info, 1);
+        memcpy(regs, info, sizeof(regs));
+    }
+    if (max_level >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        memcpy(regs7, info, sizeof(regs7));
+    }
+#else
+    max_level = __get_cpuid_max(0, 0);
+    if (max_level >= 1)
+        __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+    if (max_level >= 7)
+        __cpuid_count(7, 0, regs7[0], regs7[1], regs7[2], regs7[3]);
+#endif
+
+    if (regs[3] & (1 << 26))
+        features |= 1 << CV_CPU_SSE2;
+    if (regs[2] & (1 << 19))
+        features |= 1 << CV_CPU_SSE4_1;
+    if (regs[2] & (1 << 20))
+        features |= 1 << CV_CPU_SSE4_2;
+
+    // AVX needs the OS to save the upper halves of the ymm registers
+    if ((regs[2] & (1 << 27)) && (regs[2] & (1 << 28)))
+    {
+        unsigned xcr0;
+#if defined _MSC_VER
+        xcr0 = (unsigned)_xgetbv(0);
+#else
+        unsigned edx;
+        __asm__ __volatile__("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+#endif
+        if ((xcr0 & 6) == 6)
+        {
+            features |= 1 << CV_CPU_AVX;
+            if (regs7[1] & (1 << 5))
+                features |= 1 << CV_CPU_AVX2;
+        }
+    }
+#endif
+
+    return features;
+}
+
 CV_INLINE const CvProcessorInfo* icvGetProcessorInfo()
 {
     static CvProcessorInfo cpu_info;
@@ -281,11 +352,18 @@ CV_INLINE const CvProcessorInfo* icvGetProcessorInfo()
     if (!init_cpu_info)
     {
         icvInitProcessorInfo(&cpu_info);
+        cpu_info.features = icvInitCpuFeatures();
         init_cpu_info = 1;
     }
     return &cpu_info;
 }
 
+CV_IMPL int cvCheckHardwareSupport(int feature)
+{
+    return (unsigned)feature < 32
+           && (icvGetProcessorInfo()->features & (1 << feature)) != 0;
+}
+
 /****************************************************************************************/
 /*                               Make functions descriptions */
 /****************************************************************************************/
@@ -344,6 +422,13 @@ typedef struct CvPluginInfo
 } CvPluginInfo;
 
 static CvPluginInfo plugins[CV_PLUGIN_MAX];
+
+#define CV_NATIVE_TAB_MAX 16
+
+// built-in kernels, used for the slots no plugin provides
+static const CvNativeFuncInfo* native_tabs[CV_NATIVE_TAB_MAX];
+static int native_tab_count = 0;
+static int use_native_funcs = 1;
 static CvModuleInfo cxcore_info = {0, "cxcore", CV_VERSION, cxcore_ipp_tab};
 
 CvModuleInfo *CvModule::first = 0, *CvModule::last = 0;
@@ -372,6 +457,39 @@ CvModule::~CvModule()
     }
 }
 
+/*
+   find a built-in kernel by one of the comma-separated names of a slot
+*/
+static void* icvFindNativeFunc(const char* func_names)
+{
+    const char* name_ptr = func_names;
+
+    while (name_ptr && *name_ptr)
+    {
+        const char* name_start = name_ptr;
+        while (!isalpha(name_start[0]) && name_start[0] != '\0')
+            name_start++;
+        const char* name_end = strchr(name_start, ',');
+        size_t name_len =
+            name_end ? (size_t)(name_end - name_start) : strlen(name_start);
+
+        for (int i = 0; i < native_tab_count; i++)
+        {
+            const CvNativeFuncInfo* tab = native_tabs[i];
+            for (; tab->func_name != 0; tab++)
+            {
+                if (tab->func_addr && strlen(tab->func_name) == name_len
+                    && strncmp(tab->func_name, name_start, name_len) == 0)
+                    return tab->func_addr;
+            }
+        }
+
+        name_ptr = name_end ? name_end + 1 : 0;
+    }
+
+    return 0;
+}
+
 static int icvUpdatePluginFuncTab(CvPluginFuncInfo* func_tab)
 {
     int i, loaded_functions = 0;
@@ -389,7 +507,7 @@ static int icvUpdatePluginFuncTab(CvPluginFuncInfo* func_tab)
     // ippopencv substitutes all the other IPP modules
     if (plugins[CV_PLUGIN_OPTCV].handle != 0)
     {
-        for (i = 2; i < CV_PLUGIN_MKL; i++)
+        for (i = 2; i < CV_PLUGIN_NATIVE; i++)
         {
             assert(plugins[i].handle == 0);
             plugins[i].handle = plugins[CV_PLUGIN_OPTCV].handle;
@@ -442,6 +560,15 @@ static int icvUpdatePluginFuncTab(CvPluginFuncInfo* func_tab)
                 name_ptr = name_end;
             }
 
+            // fall back to the built-in kernels
+            if (!addr && use_native_funcs && native_tab_count > 0)
+            {
+                addr = (uchar*)icvFindNativeFunc(func_tab[i].func_names);
+                idx = CV_PLUGIN_NATIVE;
+                strncpy(name, func_tab[i].func_names, sizeof(name) - 1);
+                name[sizeof(name) - 1] = '\0';
+            }
+
             if (addr)
             {
                 /*#ifdef WIN32
@@ -481,7 +608,7 @@ static int icvUpdatePluginFuncTab(CvPluginFuncInfo* func_tab)
 
     if (plugins[CV_PLUGIN_OPTCV].handle != 0)
     {
-        for (i = 2; i < CV_PLUGIN_MKL; i++)
+        for (i = 2; i < CV_PLUGIN_NATIVE; i++)
             plugins[i].handle = 0;
     }
 
@@ -537,6 +664,33 @@ CV_IMPL int cvRegisterModule(const CvModuleInfo* module)
     return module_copy ? 0 : -1;
 }
 
+CV_IMPL int cvRegisterNativeFuncs(const CvNativeFuncInfo* func_tab)
+{
+    int loaded_functions = 0;
+
+    CV_FUNCNAME("cvRegisterNativeFuncs");
+
+    __BEGIN__;
+
+    CvModuleInfo* module;
+
+    CV_ASSERT(func_tab != 0);
+
+    if (native_tab_count >= CV_NATIVE_TAB_MAX)
+        CV_ERROR(CV_StsOutOfRange, "Too many native function tables");
+
+    native_tabs[native_tab_count++] = func_tab;
+
+    // modules registered so far pick up the new functions right away, the
+    // others do when they register
+    for (module = CvModule::first; module != 0; module = module->next)
+        loaded_functions += icvUpdatePluginFuncTab(module->func_tab);
+
+    __END__;
+
+    return loaded_functions;
+}
+
 CV_IMPL int cvUseOptimized(int load_flag)
 {
     int i, loaded_modules = 0, loaded_functions = 0;
@@ -630,12 +784,16 @@ CV_IMPL int cvUseOptimized(int load_flag)
         }
     }
 
+    use_native_funcs = load_flag != 0;
+
     for (module = CvModule::first; module != 0; module = module->next)
         loaded_functions += icvUpdatePluginFuncTab(module->func_tab);
 
     return loaded_functions;
 }
 
+CV_IMPL int cvGetUseOptimized(void) { return use_native_funcs; }
+
 CvModule cxcore_module(&cxcore_info);
 
 CV_IMPL void cvGetModuleInfo(const char* name, const char** version,
@@ -709,6 +867,12 @@ CV_IMPL void cvGetModuleInfo(const char* name, const char** version,
                 ptr += strlen(ptr);
             }
 
+        if (use_native_funcs && native_tab_count > 0)
+        {
+            strcpy(ptr, "native, ");
+            ptr += strlen(ptr);
+        }
+
         if (ptr > plugin_list_buf)
         {
             ptr[-2] = '\0';
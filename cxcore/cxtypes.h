@@ -1582,6 +1582,10 @@ typedef struct CvFileStorage CvFileStorage;
 #define CV_STORAGE_WRITE_TEXT CV_STORAGE_WRITE
 #define CV_STORAGE_WRITE_BINARY CV_STORAGE_WRITE
 #define CV_STORAGE_APPEND 2
+/* index the top-level nodes on open, parse each of them on the first access */
+#define CV_STORAGE_READ_LAZY 4
+/* write the data of the large matrices and images in base64 */
+#define CV_STORAGE_BASE64 8
 
 /* list of attributes */
 typedef struct CvAttrList
@@ -1721,6 +1725,12 @@ typedef struct CvModuleInfo
     CvPluginFuncInfo* func_tab;
 } CvModuleInfo;
 
+typedef struct CvNativeFuncInfo
+{
+    const char* func_name;
+    void* func_addr;
+} CvNativeFuncInfo;
+
 #endif /*_CXCORE_TYPES_H_*/
 
 /* End of file. */
@@ -106,6 +106,78 @@ namespace PyGto
         return "unknown";
     }
 
+    // *****************************************************************************
+    // Size of one value and its Python buffer format character for the
+    // numeric gto types, or 0 / NULL for anything else
+    static size_t typeSize(int type)
+    {
+        switch (type)
+        {
+        case Gto::Int:
+            return sizeof(int);
+        case Gto::Float:
+            return sizeof(float);
+        case Gto::Double:
+            return sizeof(double);
+        case Gto::Short:
+            return sizeof(unsigned short);
+        case Gto::Byte:
+            return sizeof(unsigned char);
+        }
+        return 0;
+    }
+
+    static const char* typeAsFormat(int type)
+    {
+        switch (type)
+        {
+        case Gto::Int:
+            return "i";
+        case Gto::Float:
+            return "f";
+        case Gto::Double:
+            return "d";
+        case Gto::Short:
+            return "H";
+        case Gto::Byte:
+            return "B";
+        }
+        return NULL;
+    }
+
+    // *****************************************************************************
+    // Wraps the bytearray holding a property's data in a memoryview of the
+    // property's type, shaped (size,) for scalar properties and
+    // (size, partsPerElement) otherwise
+    static PyObject* newDataView(PyObject* buffer,
+                                 const Gto::Reader::PropertyInfo& pinfo)
+    {
+        PyObject* bytesView = PyMemoryView_FromObject(buffer);
+        if (bytesView == NULL)
+        {
+            return NULL;
+        }
+
+        const char* format = typeAsFormat(pinfo.type);
+        size_t esize = elementSize(pinfo.dims);
+
+        PyObject* view = NULL;
+        if ((pinfo.dims.x == 1 && pinfo.dims.y == 0) || pinfo.size == 0
+            || esize == 0)
+        {
+            view = PyObject_CallMethod(bytesView, "cast", "s", format);
+        }
+        else
+        {
+            view = PyObject_CallMethod(bytesView, "cast", "s(nn)", format,
+                                       (Py_ssize_t)pinfo.size,
+                                       (Py_ssize_t)esize);
+        }
+
+        Py_XDECREF(bytesView);
+        return view;
+    }
+
     // *****************************************************************************
     // The next several functions implement the methods on our derived C++
     // Gto::Reader class.  They get called by Gto::Reader::open(), and their
@@ -114,13 +186,19 @@ namespace PyGto
     // *****************************************************************************
 
     // *****************************************************************************
-    Reader::Reader(PyObject* callingInstance, unsigned int mode)
+    Reader::Reader(PyObject* callingInstance, unsigned int mode,
+                   bool dataAsBuffer)
         : m_callingInstance(callingInstance)
         , Gto::Reader(mode)
+        , m_dataAsBuffer(dataAsBuffer)
+        , m_dataBuffer(NULL)
     {
         // Nothing
     }
 
+    // *****************************************************************************
+    Reader::~Reader() { Py_XDECREF(m_dataBuffer); }
+
     // *****************************************************************************
     Request Reader::object(const std::string& name, const std::string& protocol,
                            unsigned int protocolVersion,
@@ -226,6 +304,21 @@ namespace PyGto
         size_t esize = elementSize(pinfo.dims);
         size_t nelements = esize * pinfo.size;
 
+        // Read numeric data directly into Python owned memory so dataRead
+        // doesn't need to convert it
+        if (m_dataAsBuffer && typeSize(pinfo.type))
+        {
+            Py_XDECREF(m_dataBuffer);
+            m_dataBuffer = PyByteArray_FromStringAndSize(
+                NULL, nelements * typeSize(pinfo.type));
+            if (m_dataBuffer == NULL)
+            {
+                fail();
+                return NULL;
+            }
+            return (void*)PyByteArray_AS_STRING(m_dataBuffer);
+        }
+
         switch (pinfo.type)
         {
         case Gto::Int:
@@ -257,6 +350,23 @@ namespace PyGto
     {
         assert(m_callingInstance != NULL);
 
+        // Hand over the buffer the data was read into, if there is one
+        if (m_dataBuffer)
+        {
+            PyObject* dataView = newDataView(m_dataBuffer, pinfo);
+            Py_XDECREF(m_dataBuffer);
+            m_dataBuffer = NULL;
+
+            if (dataView == NULL)
+            {
+                fail();
+                return;
+            }
+
+            callDataRead(pinfo, dataView);
+            return;
+        }
+
         // Build a tuple out of the data for this property
         PyObject* dataTuple = PyTuple_New(pinfo.size);
         for (size_t i = 0; i < pinfo.size; ++i)
@@ -344,16 +454,24 @@ namespace PyGto
 
         assert(dataTuple != NULL);
 
+        callDataRead(pinfo, dataTuple);
+    }
+
+    // *****************************************************************************
+    // Passes a property's data to the Python dataRead method, consuming the
+    // reference to 'data'
+    void Reader::callDataRead(const PropertyInfo& pinfo, PyObject* data)
+    {
         // Build the Python equivalent of the Gto::PropertyInfo struct
         PyObject* pi = newPropertyInfo(this, pinfo);
 
         PyObject* returnValue = NULL;
         returnValue = PyObject_CallMethod(m_callingInstance, "dataRead", "sOO",
                                           stringFromId(pinfo.name).c_str(),
-                                          dataTuple, pi);
+                                          data, pi);
 
         Py_XDECREF(pi);
-        Py_XDECREF(dataTuple);
+        Py_XDECREF(data);
         // The data method was not properly overridden...
         if (returnValue == NULL)
         {
@@ -369,8 +487,12 @@ namespace PyGto
     int gtoReader_init(PyObject* self, PyObject* args, PyObject* kwds)
     {
         int mode = Gto::Reader::None;
+        int buffers = 0;
+
+        static char* keywords[] = {(char*)"mode", (char*)"buffers", NULL};
 
-        if (!PyArg_ParseTuple(args, "|i:gtoReader_init", &mode))
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ip:gtoReader_init",
+                                         keywords, &mode, &buffers))
         {
             // Invalid parameters, let Python do a stack trace
             return -1;
@@ -380,7 +502,7 @@ namespace PyGto
         // instance and add it to this Python instance's dictionary
         gtoReader_PyObject* reader = (gtoReader_PyObject*)self;
 
-        reader->m_reader = new Reader((PyObject*)self, mode);
+        reader->m_reader = new Reader((PyObject*)self, mode, buffers != 0);
         if (!reader->m_reader)
         {
             PyErr_Format(gtoError(),
@@ -79,6 +79,16 @@ namespace PyGto
         "the "
         "\n"
         "   'name' argument for convenience sake.\n"
+        "\n"
+        "3. Constructing the reader with buffers=True (eg. gto.Reader( mode, "
+        "True ))\n"
+        "   passes numeric property data to dataRead as a memoryview instead "
+        "of a\n"
+        "   tuple.  The view has shape (size,) or (size, partsPerElement) "
+        "and\n"
+        "   can be handed to numpy.asarray() without copying.  String "
+        "properties\n"
+        "   are still passed as tuples.\n"
         "\n";
 
     typedef Gto::Reader::Request Request;
@@ -89,7 +99,9 @@ namespace PyGto
     class Reader : public Gto::Reader
     {
     public:
-        Reader(PyObject* callingInstance, unsigned int mode = None);
+        Reader(PyObject* callingInstance, unsigned int mode = None,
+               bool dataAsBuffer = false);
+        virtual ~Reader();
 
         virtual Request object(const std::string& name,
                                const std::string& protocol,
@@ -108,6 +120,8 @@ namespace PyGto
         virtual void dataRead(const PropertyInfo& pinfo);
 
     private:
+        void callDataRead(const PropertyInfo& pinfo, PyObject* data);
+
         // This is a handle to the instance of the Python class
         // (eg. "class myGtoReader( gto.Reader ): ...") which is using this
         // instance of the C++ "Reader : public Gto::Reader" class.
@@ -120,6 +134,11 @@ namespace PyGto
         std::vector<int> m_tmpIntData;
         std::vector<unsigned short> m_tmpShortData;
         std::vector<unsigned char> m_tmpCharData;
+
+        // When set, numeric property data is read straight into a Python
+        // bytearray (m_dataBuffer) which dataRead hands over as a memoryview
+        bool m_dataAsBuffer;
+        PyObject* m_dataBuffer;
     };
 
     // Function prototypes required for the table below
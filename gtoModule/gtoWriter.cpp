@@ -39,6 +39,7 @@
 
 #include <sstream>
 #include <assert.h>
+#include <string.h>
 
 namespace PyGto
 {
@@ -174,6 +175,113 @@ namespace PyGto
         return pos;
     }
 
+    // *****************************************************************************
+    // Returns true if the buffer holds native values of the given gto type.
+    // Only the item size and kind are compared, so eg. signed and unsigned
+    // bytes are both accepted for gto.BYTE.
+    static bool bufferMatchesType(const Py_buffer& view, int type)
+    {
+        const char* format = view.format ? view.format : "B";
+
+        // Skip a byte order mark if it is the native one
+        static const int one = 1;
+        bool littleEndian = *(const char*)&one == 1;
+        if (*format == '@' || *format == '='
+            || (*format == '<' && littleEndian)
+            || ((*format == '>' || *format == '!') && !littleEndian))
+        {
+            format++;
+        }
+        if (format[0] == 0 || format[1] != 0)
+        {
+            return false;
+        }
+
+        switch (type)
+        {
+        case Gto::Int:
+            return view.itemsize == sizeof(int) && strchr("iIlL", *format);
+        case Gto::Float:
+            return view.itemsize == sizeof(float) && *format == 'f';
+        case Gto::Double:
+            return view.itemsize == sizeof(double) && *format == 'd';
+        case Gto::Short:
+            return view.itemsize == sizeof(unsigned short)
+                   && strchr("hH", *format);
+        case Gto::Byte:
+            return view.itemsize == sizeof(unsigned char)
+                   && strchr("bBc", *format);
+        }
+        return false;
+    }
+
+    // *****************************************************************************
+    // Writes a property's data straight from a contiguous buffer (memoryview,
+    // array.array, numpy array, ...) without converting it item by item.
+    // Returns NULL with an exception set on failure.
+    static PyObject* propertyDataFromBuffer(gtoWriter_PyObject* writer,
+                                            const Gto::PropertyHeader& prop,
+                                            const char* propName,
+                                            PyObject* object)
+    {
+        Py_buffer view;
+        if (PyObject_GetBuffer(object, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT)
+            < 0)
+        {
+            return NULL;
+        }
+
+        int dataSize = prop.size * elementSize(prop.dims);
+
+        if (!bufferMatchesType(view, prop.type))
+        {
+            PyErr_Format(gtoError(),
+                         "Property '%s' was declared as type %d, which does "
+                         "not match buffer format '%s' (item size %d)",
+                         propName, prop.type, view.format ? view.format : "B",
+                         int(view.itemsize));
+            PyBuffer_Release(&view);
+            return NULL;
+        }
+
+        if (view.len / view.itemsize != dataSize)
+        {
+            PyErr_Format(
+                gtoError(),
+                "Property '%s' was declared as having %d"
+                " x %d values, but %d values were given for writing",
+                propName, prop.size, int(elementSize(prop.dims)),
+                int(view.len / view.itemsize));
+            PyBuffer_Release(&view);
+            return NULL;
+        }
+
+        switch (prop.type)
+        {
+        case Gto::Int:
+            writer->m_writer->propertyData((int*)view.buf);
+            break;
+        case Gto::Float:
+            writer->m_writer->propertyData((float*)view.buf);
+            break;
+        case Gto::Double:
+            writer->m_writer->propertyData((double*)view.buf);
+            break;
+        case Gto::Short:
+            writer->m_writer->propertyData((unsigned short*)view.buf);
+            break;
+        case Gto::Byte:
+            writer->m_writer->propertyData((unsigned char*)view.buf);
+            break;
+        }
+        writer->m_propCount++;
+
+        PyBuffer_Release(&view);
+
+        Py_XINCREF(Py_None);
+        return Py_None;
+    }
+
     // *****************************************************************************
     // The next several functions implement the methods on the Python gto.Writer
     // class.
@@ -640,6 +748,20 @@ namespace PyGto
         const char* currentPropName =
             (*writer->m_propertyNames)[writer->m_propCount].c_str();
 
+        // Numeric data in a buffer object is written without conversion.
+        // Bytes are excluded since they are string data here.
+        PyObject* bufferData = rawdata;
+        if (PyTuple_Check(rawdata) && PyTuple_Size(rawdata) == 1)
+        {
+            bufferData = PyTuple_GetItem(rawdata, 0);
+        }
+        if (prop.type != Gto::String && !PyBytes_Check(bufferData)
+            && PyObject_CheckBuffer(bufferData))
+        {
+            return propertyDataFromBuffer(writer, prop, currentPropName,
+                                          bufferData);
+        }
+
         // Determine how many elements we have in the data
         int dataSize = prop.size * elementSize(prop.dims);
 
@@ -113,7 +113,7 @@ namespace PyGto
         {"beginData", (PyCFunction)gtoWriter_beginData, METH_NOARGS,
          "beginData()"},
         {"propertyData", (PyCFunction)gtoWriter_propertyData, METH_VARARGS,
-         "propertyData( tuple data )"},
+         "propertyData( tuple or buffer data )"},
         {"endData", (PyCFunction)gtoWriter_endData, METH_NOARGS, "endData()"},
         {NULL}};
 
@@ -0,0 +1,330 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+// mp4v2bench: synthesizes an mp4 file through the public write API and
+// times the read paths the player depends on (open, time seeks,
+// sequential sample reads and metadata queries).
+//
+// mp4v2 does not write fragmented files, so fragmented layouts are
+// approximated by interleaving several tracks with short chunks, which
+// gives the same scattered chunk offsets and large stsc/stco tables.
+//
+
+#include <mp4v2/mp4v2.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+    struct Options
+    {
+        double duration = 600.0;      // seconds
+        uint32_t rate = 24;           // samples per second
+        uint32_t sampleSize = 4096;   // bytes
+        uint32_t syncInterval = 24;   // samples between sync samples
+        double chunkDuration = 1.0;   // seconds, 0 for mp4v2's default
+        uint32_t tracks = 1;          // interleaved tracks
+        uint32_t seeks = 10000;       // random time lookups
+        uint32_t iterations = 3;      // runs per measurement, best is shown
+        std::string path = "mp4v2bench.mp4";
+        bool keep = false;
+    };
+
+    class Timer
+    {
+    public:
+        Timer()
+            : m_start(std::chrono::steady_clock::now())
+        {
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - m_start)
+                .count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // keeps the timed loops from being optimized away
+    volatile uint32_t g_sink = 0;
+
+    // small deterministic generator so runs are comparable
+    uint32_t nextRandom(uint32_t& state)
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    void usage(const char* name)
+    {
+        fprintf(stderr,
+                "usage: %s [options]\n"
+                "  --duration SECONDS     media duration (600)\n"
+                "  --rate N               samples per second (24)\n"
+                "  --size BYTES           sample size (4096)\n"
+                "  --sync N               samples between sync samples (24)\n"
+                "  --chunk SECONDS        chunk duration, 0 for default (1)\n"
+                "  --tracks N             interleaved tracks (1)\n"
+                "  --seeks N              random time lookups (10000)\n"
+                "  --iterations N         runs per measurement (3)\n"
+                "  --file PATH            file to write (mp4v2bench.mp4)\n"
+                "  --keep                 keep the file afterwards\n",
+                name);
+    }
+
+    bool parseOptions(int argc, char** argv, Options& opts)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const char* arg = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+            if (!strcmp(arg, "--keep"))
+            {
+                opts.keep = true;
+                continue;
+            }
+
+            if (!value)
+            {
+                return false;
+            }
+            i++;
+
+            if (!strcmp(arg, "--duration"))
+                opts.duration = atof(value);
+            else if (!strcmp(arg, "--rate"))
+                opts.rate = strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "--size"))
+                opts.sampleSize = strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "--sync"))
+                opts.syncInterval = strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "--chunk"))
+                opts.chunkDuration = atof(value);
+            else if (!strcmp(arg, "--tracks"))
+                opts.tracks = strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "--seeks"))
+                opts.seeks = strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "--iterations"))
+                opts.iterations = strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "--file"))
+                opts.path = value;
+            else
+                return false;
+        }
+
+        return opts.duration > 0 && opts.rate > 0 && opts.sampleSize > 0
+               && opts.tracks > 0 && opts.iterations > 0;
+    }
+
+    bool writeFile(const Options& opts, uint32_t numSamples)
+    {
+        MP4FileHandle hFile = MP4Create(opts.path.c_str());
+        if (hFile == MP4_INVALID_FILE_HANDLE)
+        {
+            return false;
+        }
+
+        MP4SetTimeScale(hFile, opts.rate);
+
+        std::vector<MP4TrackId> trackIds;
+        for (uint32_t t = 0; t < opts.tracks; t++)
+        {
+            MP4TrackId trackId = MP4AddVideoTrack(
+                hFile, opts.rate, 1, 1920, 1080, MP4_MPEG4_VIDEO_TYPE);
+            if (trackId == MP4_INVALID_TRACK_ID)
+            {
+                MP4Close(hFile);
+                return false;
+            }
+
+            if (opts.chunkDuration > 0)
+            {
+                MP4Duration chunkDuration =
+                    (MP4Duration)(opts.chunkDuration * opts.rate);
+                MP4SetTrackDurationPerChunk(hFile, trackId,
+                                            chunkDuration ? chunkDuration : 1);
+            }
+
+            trackIds.push_back(trackId);
+        }
+
+        std::vector<uint8_t> sample(opts.sampleSize);
+        uint32_t state = 1;
+
+        bool ok = true;
+        for (uint32_t s = 0; s < numSamples && ok; s++)
+        {
+            // vary the sizes a little so stsz cannot collapse to one value
+            uint32_t numBytes =
+                opts.sampleSize - nextRandom(state) % (opts.sampleSize / 4 + 1);
+            bool isSync = opts.syncInterval <= 1 || s % opts.syncInterval == 0;
+
+            for (size_t t = 0; t < trackIds.size() && ok; t++)
+            {
+                ok = MP4WriteSample(hFile, trackIds[t], &sample[0], numBytes,
+                                    1, 0, isSync);
+            }
+        }
+
+        MP4Close(hFile);
+        return ok;
+    }
+
+    template <typename F> double best(uint32_t iterations, F run)
+    {
+        double result = 0;
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            Timer timer;
+            run();
+            double t = timer.elapsed();
+            if (i == 0 || t < result)
+            {
+                result = t;
+            }
+        }
+        return result;
+    }
+
+    void report(const char* name, double seconds, uint64_t count)
+    {
+        if (count)
+        {
+            printf("%-24s %12.3f ms %12.1f ns/op\n", name, seconds * 1e3,
+                   seconds * 1e9 / count);
+        }
+        else
+        {
+            printf("%-24s %12.3f ms\n", name, seconds * 1e3);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    MP4LogSetLevel(MP4_LOG_NONE);
+
+    uint32_t numSamples = (uint32_t)(opts.duration * opts.rate);
+    if (numSamples == 0)
+    {
+        numSamples = 1;
+    }
+
+    printf("%u track(s), %u samples each, %u bytes, chunk %.3fs, sync %u\n",
+           opts.tracks, numSamples, opts.sampleSize, opts.chunkDuration,
+           opts.syncInterval);
+
+    Timer writeTimer;
+    if (!writeFile(opts, numSamples))
+    {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], opts.path.c_str());
+        return 1;
+    }
+    report("write", writeTimer.elapsed(), 0);
+
+    int status = 0;
+
+    // open and parse the moov, including the sample tables
+    report("open", best(opts.iterations, [&]() {
+               MP4FileHandle hFile = MP4Read(opts.path.c_str());
+               MP4Close(hFile);
+           }),
+           0);
+
+    MP4FileHandle hFile = MP4Read(opts.path.c_str());
+    if (hFile == MP4_INVALID_FILE_HANDLE)
+    {
+        fprintf(stderr, "%s: cannot read %s\n", argv[0], opts.path.c_str());
+        return 1;
+    }
+
+    MP4TrackId trackId = MP4FindTrackId(hFile, 0);
+    MP4Duration trackDuration = MP4GetTrackDuration(hFile, trackId);
+    uint32_t sink = 0;
+
+    // random time to sample lookups, then snapping to the next sync sample
+    // (MP4GetSampleIdFromTime with wantSyncSample)
+    report("seek", best(opts.iterations, [&]() {
+               uint32_t state = 7;
+               for (uint32_t i = 0; i < opts.seeks; i++)
+               {
+                   MP4Timestamp when = nextRandom(state) % trackDuration;
+                   MP4SampleId sampleId =
+                       MP4GetSampleIdFromTime(hFile, trackId, when, true);
+                   sink += sampleId;
+               }
+           }),
+           opts.seeks);
+
+    // sequential reads of every sample of every track, interleaved the
+    // way playback does
+    uint32_t numTracks = MP4GetNumberOfTracks(hFile);
+    report("read sequential", best(opts.iterations, [&]() {
+               std::vector<uint8_t> buffer(opts.sampleSize);
+               for (MP4SampleId s = 1; s <= numSamples; s++)
+               {
+                   for (uint32_t t = 0; t < numTracks; t++)
+                   {
+                       MP4TrackId id = MP4FindTrackId(hFile, t);
+                       uint8_t* pBytes = &buffer[0];
+                       uint32_t numBytes = buffer.size();
+                       if (!MP4ReadSample(hFile, id, s, &pBytes, &numBytes))
+                       {
+                           status = 1;
+                           return;
+                       }
+                       sink += pBytes[0];
+                   }
+               }
+           }),
+           (uint64_t)numSamples * numTracks);
+
+    // per sample metadata queries used when building frame indices
+    report("metadata", best(opts.iterations, [&]() {
+               for (MP4SampleId s = 1; s <= numSamples; s++)
+               {
+                   sink += MP4GetSampleSize(hFile, trackId, s);
+                   sink += (uint32_t)MP4GetSampleTime(hFile, trackId, s);
+                   sink += MP4GetSampleSync(hFile, trackId, s);
+               }
+           }),
+           (uint64_t)numSamples * 3);
+
+    MP4Close(hFile);
+    g_sink = sink;
+
+    if (!opts.keep)
+    {
+        remove(opts.path.c_str());
+    }
+
+    if (status)
+    {
+        fprintf(stderr, "%s: sample read failed\n", argv[0]);
+    }
+
+    return status;
+}
@@ -113,6 +113,22 @@ namespace mp4v2
                 return false;
             }
 
+            const void* File::map(Size pos, Size size)
+            {
+                if (!_isOpen || pos < 0 || size < 0)
+                    return NULL;
+
+                return _provider.map(pos, size);
+            }
+
+            void File::prefetch(Size pos, Size size)
+            {
+                if (!_isOpen || pos < 0 || size <= 0)
+                    return;
+
+                _provider.prefetch(pos, size);
+            }
+
             bool File::close()
             {
                 if (!_isOpen)
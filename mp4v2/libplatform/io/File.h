@@ -14,6 +14,7 @@ namespace mp4v2
             {
             public:
                 static FileProvider& standard();
+                static FileProvider& mapped();
 
             public:
                 //! file operation mode flags
@@ -40,6 +41,14 @@ namespace mp4v2
                                    Size maxChunkSize) = 0;
                 virtual bool close() = 0;
 
+                //! pointer to size bytes at pos in a read-only mapping of the
+                //! file, or NULL if the provider does not map files
+                virtual const void* map(Size pos, Size size) { return NULL; }
+
+                //! hint that size bytes at pos will be read soon so the
+                //! provider can start fetching them in the background
+                virtual void prefetch(Size pos, Size size) {}
+
             protected:
                 FileProvider() {}
             };
@@ -182,6 +191,42 @@ namespace mp4v2
                 bool write(const void* buffer, Size size, Size& nout,
                            Size maxChunkSize = 0);
 
+                ///////////////////////////////////////////////////////////////////////////
+                //!
+                //! Direct access to mapped file contents.
+                //!
+                //! Returns a pointer to <b>size</b> bytes starting at
+                //! <b>pos</b> which stays valid until the file is closed.
+                //! The file position is not changed. The mapping follows the
+                //! file on disk: if another process truncates it, accessing
+                //! the bytes past the new end raises SIGBUS.
+                //!
+                //! @param pos file position in bytes.
+                //! @param size number of bytes required.
+                //!
+                //! @return pointer into the mapping, or NULL if the file is
+                //!     not mapped or the range is out of bounds.
+                //!
+                ///////////////////////////////////////////////////////////////////////////
+
+                const void* map(Size pos, Size size);
+
+                ///////////////////////////////////////////////////////////////////////////
+                //!
+                //! Read-ahead hint.
+                //!
+                //! Tells the provider that <b>size</b> bytes starting at
+                //! <b>pos</b> will be read soon. The call does not block and
+                //! the file position is not changed. Providers that can't
+                //! read ahead ignore it.
+                //!
+                //! @param pos file position in bytes.
+                //! @param size number of bytes expected to be read.
+                //!
+                ///////////////////////////////////////////////////////////////////////////
+
+                void prefetch(Size pos, Size size);
+
             private:
                 std::string _name;
                 bool _isOpen;
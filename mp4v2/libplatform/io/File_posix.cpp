@@ -1,4 +1,6 @@
 #include "libplatform/impl.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace mp4v2
 {
@@ -103,11 +105,169 @@ namespace mp4v2
 
             ///////////////////////////////////////////////////////////////////////////////
 
+            // Maps the whole file read-only in MODE_READ so map() can hand
+            // out pointers into the page cache. The mapping is shared, so if
+            // the file is truncated while it is open, touching a pointer past
+            // the new end raises SIGBUS; read() uses pread() instead and sees
+            // a short read there. Other modes, or files that can't be mapped,
+            // go through the standard provider.
+            class MappedFileProvider : public FileProvider
+            {
+            public:
+                MappedFileProvider();
+
+                bool open(std::string name, Mode mode);
+                bool seek(Size pos);
+                bool read(void* buffer, Size size, Size& nin,
+                          Size maxChunkSize);
+                bool write(const void* buffer, Size size, Size& nout,
+                           Size maxChunkSize);
+                bool close();
+                const void* map(Size pos, Size size);
+                void prefetch(Size pos, Size size);
+
+            private:
+                StandardFileProvider _standard;
+                int _fd;
+                uint8_t* _base;
+                Size _size;
+                Size _position;
+            };
+
+            ///////////////////////////////////////////////////////////////////////////////
+
+            MappedFileProvider::MappedFileProvider()
+                : _fd(-1)
+                , _base(NULL)
+                , _size(0)
+                , _position(0)
+            {
+            }
+
+            bool MappedFileProvider::open(std::string name, Mode mode)
+            {
+                if (mode == MODE_READ)
+                {
+                    int fd = ::open(name.c_str(), O_RDONLY);
+                    if (fd == -1)
+                        return true;
+
+                    struct stat st;
+                    void* base = MAP_FAILED;
+                    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)
+                        && st.st_size > 0)
+                    {
+                        base = mmap(NULL, (size_t)st.st_size, PROT_READ,
+                                    MAP_SHARED, fd, 0);
+                    }
+
+                    if (base != MAP_FAILED)
+                    {
+                        _fd = fd;
+                        _base = (uint8_t*)base;
+                        _size = st.st_size;
+                        _position = 0;
+                        return false;
+                    }
+                    ::close(fd);
+                }
+
+                return _standard.open(name, mode);
+            }
+
+            bool MappedFileProvider::seek(Size pos)
+            {
+                if (!_base)
+                    return _standard.seek(pos);
+
+                if (pos < 0)
+                    return true;
+                _position = pos;
+                return false;
+            }
+
+            bool MappedFileProvider::read(void* buffer, Size size, Size& nin,
+                                          Size maxChunkSize)
+            {
+                if (!_base)
+                    return _standard.read(buffer, size, nin, maxChunkSize);
+
+                // a short read is reported through nin, as at end-of-file
+                nin = 0;
+                while (nin < size)
+                {
+                    ssize_t n = pread(_fd, (uint8_t*)buffer + nin,
+                                      (size_t)(size - nin), _position + nin);
+                    if (n < 0 && errno == EINTR)
+                        continue;
+                    if (n < 0)
+                        return true;
+                    if (n == 0)
+                        break;
+                    nin += n;
+                }
+                _position += nin;
+                return false;
+            }
+
+            bool MappedFileProvider::write(const void* buffer, Size size,
+                                           Size& nout, Size maxChunkSize)
+            {
+                if (!_base)
+                    return _standard.write(buffer, size, nout, maxChunkSize);
+
+                return true;
+            }
+
+            bool MappedFileProvider::close()
+            {
+                if (!_base)
+                    return _standard.close();
+
+                bool failed = munmap(_base, (size_t)_size) != 0;
+                failed = ::close(_fd) != 0 || failed;
+                _fd = -1;
+                _base = NULL;
+                _size = 0;
+                _position = 0;
+                return failed;
+            }
+
+            const void* MappedFileProvider::map(Size pos, Size size)
+            {
+                if (!_base || pos > _size || size > _size - pos)
+                    return NULL;
+
+                return _base + pos;
+            }
+
+            void MappedFileProvider::prefetch(Size pos, Size size)
+            {
+                if (!_base || pos >= _size)
+                    return;
+
+                // madvise wants a page aligned start
+                const Size pageSize = sysconf(_SC_PAGESIZE);
+                Size start = pos - pos % pageSize;
+                Size end = std::min(pos + size, _size);
+
+                // asynchronous: the kernel starts reading the pages in and
+                // returns straight away
+                madvise(_base + start, (size_t)(end - start), MADV_WILLNEED);
+            }
+
+            ///////////////////////////////////////////////////////////////////////////////
+
             FileProvider& FileProvider::standard()
             {
                 return *new StandardFileProvider();
             }
 
+            FileProvider& FileProvider::mapped()
+            {
+                return *new MappedFileProvider();
+            }
+
             ///////////////////////////////////////////////////////////////////////////////
 
         } // namespace io
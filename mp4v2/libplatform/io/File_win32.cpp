@@ -272,6 +272,13 @@ namespace mp4v2
                 return *new StandardFileProvider();
             }
 
+            // no mapped provider on win32 yet, map() returns NULL and
+            // callers fall back to read()
+            FileProvider& FileProvider::mapped()
+            {
+                return *new StandardFileProvider();
+            }
+
             ///////////////////////////////////////////////////////////////////////////////
 
         } // namespace io
@@ -3,6 +3,7 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -174,6 +174,112 @@ bool MP4ReadSampleFromTime(
     MP4Duration* pRenderingOffset DEFAULT(NULL),
     bool* pIsSyncSample DEFAULT(NULL));
 
+/** Read a run of consecutive track samples.
+ *
+ *  MP4ReadSampleRange reads <b>numSamples</b> samples starting at
+ *  <b>sampleId</b> into <b>pBytes</b>, packed back to back in sample order.
+ *  Samples that are adjacent on disk, such as the samples of a chunk, and
+ *  chunks separated by small gaps are fetched with a single read rather
+ *  than one seek and read per sample.
+ *
+ *  The caller must supply a buffer large enough for all of the samples.
+ *  Its size can be determined before-hand using MP4GetSampleSize().
+ *
+ *  @param hFile handle of file for operation.
+ *  @param trackId id of track for operation.
+ *  @param sampleId id of the first sample to read.
+ *      Caveat: the first sample has id <b>1</b> not <b>0</b>.
+ *  @param numSamples number of samples to read.
+ *  @param pBytes buffer that will receive the sample data.
+ *  @param pNumBytes pointer to variable holding the size in bytes of
+ *      <b>pBytes</b> on input, and the number of bytes read on output.
+ *  @param pSampleSizes if non-NULL, array of <b>numSamples</b> entries that
+ *      will receive the size in bytes of each sample read.
+ *
+ *  @return <b>true</b> on success, <b>false</b> on failure.
+ *
+ *  @see MP4ReadSample().
+ *  @see MP4GetSampleSize().
+ */
+MP4V2_EXPORT
+bool MP4ReadSampleRange(
+    /* input parameters */
+    MP4FileHandle hFile, MP4TrackId trackId, MP4SampleId sampleId,
+    uint32_t numSamples,
+    /* input/output parameters */
+    uint8_t* pBytes, uint32_t* pNumBytes,
+    /* output parameters */
+    uint32_t* pSampleSizes DEFAULT(NULL));
+
+/** Read-only view of a track sample.
+ *
+ *  Filled in by MP4ReadSampleView() and returned with
+ *  MP4ReleaseSampleView().
+ */
+typedef struct MP4SampleView_s
+{
+    const uint8_t* bytes; /**< sample data */
+    uint32_t numBytes;    /**< size in bytes of sample data */
+    void* handle;         /**< library-owned buffer, NULL if none */
+} MP4SampleView;
+
+/** Read a track sample without copying it into a caller buffer.
+ *
+ *  MP4ReadSampleView is similar to MP4ReadSample() except the sample data
+ *  is not copied into a buffer owned by the caller. When the file is open
+ *  read-only and can be memory mapped, <b>pView</b> points straight into
+ *  the mapping. Otherwise, and for samples stored in an external data
+ *  reference file, the sample is read into a buffer from a pool owned by
+ *  the file, which is reused by later reads once released.
+ *
+ *  The view remains valid until it is passed to MP4ReleaseSampleView().
+ *  Every view must be released before the file is closed.
+ *
+ *  @param hFile handle of file for operation.
+ *  @param trackId id of track for operation.
+ *  @param sampleId specifies which sample is to be read.
+ *      Caveat: the first sample has id <b>1</b> not <b>0</b>.
+ *  @param pView pointer to the view that will receive the sample data.
+ *  @param pStartTime if non-NULL, pointer to variable that will receive the
+ *      starting timestamp for this sample. Caveat: The timestamp is in
+ *      <b>trackId</b>'s timescale.
+ *  @param pDuration if non-NULL, pointer to variable that will receive the
+ *      duration for this sample. Caveat: The duration is in
+ *      <b>trackId</b>'s timescale.
+ *  @param pRenderingOffset if non-NULL, pointer to variable that will
+ *      receive the rendering offset for this sample. Caveat: The offset
+ *      is in <b>trackId</b>'s timescale.
+ *  @param pIsSyncSample if non-NULL, pointer to variable that will receive
+ *      the state of the sync/random access flag for this sample.
+ *
+ *  @return <b>true</b> on success, <b>false</b> on failure.
+ *
+ *  @see MP4ReadSample().
+ *  @see MP4ReleaseSampleView().
+ */
+MP4V2_EXPORT
+bool MP4ReadSampleView(
+    /* input parameters */
+    MP4FileHandle hFile, MP4TrackId trackId, MP4SampleId sampleId,
+    /* output parameters */
+    MP4SampleView* pView, MP4Timestamp* pStartTime DEFAULT(NULL),
+    MP4Duration* pDuration DEFAULT(NULL),
+    MP4Duration* pRenderingOffset DEFAULT(NULL),
+    bool* pIsSyncSample DEFAULT(NULL));
+
+/** Release a sample view.
+ *
+ *  MP4ReleaseSampleView returns any buffer backing <b>pView</b> to the
+ *  file's pool and clears the view.
+ *
+ *  @param hFile handle of file the view was read from.
+ *  @param pView pointer to the view to release.
+ *
+ *  @see MP4ReadSampleView().
+ */
+MP4V2_EXPORT
+void MP4ReleaseSampleView(MP4FileHandle hFile, MP4SampleView* pView);
+
 /** Write a track sample.
  *
  *  MP4WriteSample writes the given sample at the end of the specified track.
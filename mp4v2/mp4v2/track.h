@@ -346,6 +346,28 @@ MP4V2_EXPORT
 bool MP4SetTrackDurationPerChunk(MP4FileHandle hFile, MP4TrackId trackId,
                                  MP4Duration duration);
 
+/** Set read-ahead for a track.
+ *
+ *  MP4SetTrackPrefetch enables background read-ahead while reading samples
+ *  from a read-only file. Each read asks the platform to start fetching up
+ *  to <b>numChunks</b> chunks following the chunk of the sample just read,
+ *  limited to <b>maxBytes</b> in total. Reading a sample outside the
+ *  current window, e.g. after a seek, restarts the window from there.
+ *
+ *  Read-ahead is off by default and only has an effect for files opened
+ *  with the default file provider on platforms that support it.
+ *
+ *  @param hFile handle of file for operation.
+ *  @param trackId id of track for operation.
+ *  @param numChunks number of chunks to read ahead, 0 to disable.
+ *  @param maxBytes maximum number of bytes to read ahead.
+ *
+ *  @return <b>true</b> on success, <b>false</b> on failure.
+ */
+MP4V2_EXPORT
+bool MP4SetTrackPrefetch(MP4FileHandle hFile, MP4TrackId trackId,
+                         uint32_t numChunks, uint32_t maxBytes);
+
 /**
  *  @param hFile handle of file for operation.
  *  @param trackId id of track for operation.
@@ -72,6 +72,7 @@ namespace mp4v2
 
                 MP4TableProperty* pTable =
                     new MP4TableProperty(*this, "entries", pCount);
+                pTable->SetDeferrable();
                 AddProperty(pTable);
 
                 pTable->AddProperty(
@@ -87,6 +88,7 @@ namespace mp4v2
 
                 MP4TableProperty* pTable =
                     new MP4TableProperty(*this, "entries", pCount);
+                pTable->SetDeferrable();
                 AddProperty(pTable);
 
                 pTable->AddProperty(new MP4Integer32Property(
@@ -399,6 +401,7 @@ namespace mp4v2
 
                 MP4TableProperty* pTable =
                     new MP4TableProperty(*this, "entries", pCount);
+                pTable->SetDeferrable();
                 AddProperty(pTable);
 
                 pTable->AddProperty(new MP4Integer32Property(
@@ -431,6 +434,7 @@ namespace mp4v2
 
                 MP4TableProperty* pTable =
                     new MP4TableProperty(*this, "entries", pCount);
+                pTable->SetDeferrable();
                 AddProperty(pTable);
 
                 pTable->AddProperty(new MP4Integer32Property(
@@ -445,6 +449,7 @@ namespace mp4v2
 
                 MP4TableProperty* pTable =
                     new MP4TableProperty(*this, "entries", pCount);
+                pTable->SetDeferrable();
                 AddProperty(pTable);
 
                 pTable->AddProperty(new MP4Integer32Property(
@@ -42,6 +42,7 @@ namespace mp4v2
 
             MP4TableProperty* pTable =
                 new MP4TableProperty(*this, "entries", pCount);
+            pTable->SetDeferrable();
             AddProperty(pTable); /* 4 */
 
             pTable->AddProperty(/* 4/0 */
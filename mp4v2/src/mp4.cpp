@@ -3279,6 +3279,80 @@ extern "C"
         return false;
     }
 
+    bool MP4ReadSampleRange(
+        /* input parameters */
+        MP4FileHandle hFile, MP4TrackId trackId, MP4SampleId sampleId,
+        uint32_t numSamples,
+        /* input/output parameters */
+        uint8_t* pBytes, uint32_t* pNumBytes,
+        /* output parameters */
+        uint32_t* pSampleSizes)
+    {
+        if (MP4_IS_VALID_FILE_HANDLE(hFile))
+        {
+            try
+            {
+                ((MP4File*)hFile)
+                    ->ReadSampleRange(trackId, sampleId, numSamples, pBytes,
+                                      pNumBytes, pSampleSizes);
+                return true;
+            }
+            catch (Exception* x)
+            {
+                mp4v2::impl::log.errorf(*x);
+                delete x;
+            }
+            catch (...)
+            {
+                mp4v2::impl::log.errorf("%s: failed", __FUNCTION__);
+            }
+        }
+        *pNumBytes = 0;
+        return false;
+    }
+
+    bool MP4ReadSampleView(
+        /* input parameters */
+        MP4FileHandle hFile, MP4TrackId trackId, MP4SampleId sampleId,
+        /* output parameters */
+        MP4SampleView* pView, MP4Timestamp* pStartTime,
+        MP4Duration* pDuration, MP4Duration* pRenderingOffset,
+        bool* pIsSyncSample)
+    {
+        if (MP4_IS_VALID_FILE_HANDLE(hFile))
+        {
+            try
+            {
+                ((MP4File*)hFile)
+                    ->ReadSampleView(trackId, sampleId, pView, pStartTime,
+                                     pDuration, pRenderingOffset,
+                                     pIsSyncSample);
+                return true;
+            }
+            catch (Exception* x)
+            {
+                mp4v2::impl::log.errorf(*x);
+                delete x;
+            }
+            catch (...)
+            {
+                mp4v2::impl::log.errorf("%s: failed", __FUNCTION__);
+            }
+        }
+        pView->bytes = NULL;
+        pView->numBytes = 0;
+        pView->handle = NULL;
+        return false;
+    }
+
+    void MP4ReleaseSampleView(MP4FileHandle hFile, MP4SampleView* pView)
+    {
+        if (MP4_IS_VALID_FILE_HANDLE(hFile))
+        {
+            ((MP4File*)hFile)->ReleaseSampleView(pView);
+        }
+    }
+
     bool MP4WriteSample(MP4FileHandle hFile, MP4TrackId trackId,
                         const uint8_t* pBytes, uint32_t numBytes,
                         MP4Duration duration, MP4Duration renderingOffset,
@@ -4933,4 +5007,30 @@ extern "C"
 
     ///////////////////////////////////////////////////////////////////////////////
 
+    bool MP4SetTrackPrefetch(MP4FileHandle hFile, MP4TrackId trackId,
+                             uint32_t numChunks, uint32_t maxBytes)
+    {
+        if (!MP4_IS_VALID_FILE_HANDLE(hFile))
+            return false;
+
+        try
+        {
+            ((MP4File*)hFile)->SetTrackPrefetch(trackId, numChunks, maxBytes);
+            return true;
+        }
+        catch (Exception* x)
+        {
+            mp4v2::impl::log.errorf(*x);
+            delete x;
+        }
+        catch (...)
+        {
+            mp4v2::impl::log.errorf("%s: failed", __FUNCTION__);
+        }
+
+        return false;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+
 } // extern "C"
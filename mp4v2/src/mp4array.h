@@ -116,6 +116,8 @@ namespace mp4v2
                                            m_maxNumElements * sizeof(type));   \
         }                                                                      \
                                                                                \
+        type* Elements() { return m_elements; }                                \
+                                                                               \
         type& operator[](MP4ArrayIndex index)                                  \
         {                                                                      \
             if (ValidIndex(index))                                             \
@@ -77,6 +77,8 @@ namespace mp4v2
             for (uint32_t i = 0; i < m_pTracks.Size(); i++)
                 delete m_pTracks[i];
             MP4Free(m_memoryBuffer); // just in case
+            for (size_t i = 0; i < m_sampleViewBuffers.size(); i++)
+                delete m_sampleViewBuffers[i];
             CHECK_AND_FREE(m_editName);
             delete m_file;
         }
@@ -266,6 +268,23 @@ namespace mp4v2
             return true;
         }
 
+        void MP4File::LoadDeferredTables(MP4Atom& atom)
+        {
+            for (uint32_t i = 0; i < atom.GetCount(); i++)
+            {
+                MP4Property* pProperty = atom.GetProperty(i);
+                if (pProperty->GetType() == TableProperty)
+                {
+                    ((MP4TableProperty*)pProperty)->LoadEntries();
+                }
+            }
+
+            for (uint32_t i = 0; i < atom.GetNumberOfChildAtoms(); i++)
+            {
+                LoadDeferredTables(*atom.GetChildAtom(i));
+            }
+        }
+
         void MP4File::Optimize(const char* srcFileName, const char* dstFileName)
         {
             File* src = NULL;
@@ -306,6 +325,10 @@ namespace mp4v2
                 ReadFromFile();
                 CacheProperties(); // of moov atom
 
+                // the deferred tables are read from m_file, which is about
+                // to become the destination
+                LoadDeferredTables(*m_pRootAtom);
+
                 src = m_file;
                 m_file = NULL;
 
@@ -429,9 +452,15 @@ namespace mp4v2
         {
             ASSERT(!m_file);
 
-            m_file = new File(name, mode,
-                              provider ? new io::CustomFileProvider(*provider)
-                                       : NULL);
+            // read-only files are mapped so sample reads avoid a syscall
+            // per call and share the page cache with other readers
+            io::FileProvider* fileProvider = NULL;
+            if (provider)
+                fileProvider = new io::CustomFileProvider(*provider);
+            else if (mode == File::MODE_READ)
+                fileProvider = &io::FileProvider::mapped();
+
+            m_file = new File(name, mode, fileProvider);
             if (m_file->open())
             {
                 ostringstream msg;
@@ -3379,6 +3408,79 @@ namespace mp4v2
                 dependencyFlags);
         }
 
+        void MP4File::ReadSampleRange(MP4TrackId trackId, MP4SampleId sampleId,
+                                      uint32_t numSamples, uint8_t* pBytes,
+                                      uint32_t* pNumBytes,
+                                      uint32_t* pSampleSizes)
+        {
+            m_pTracks[FindTrackIndex(trackId)]->ReadSampleRange(
+                sampleId, numSamples, pBytes, pNumBytes, pSampleSizes);
+        }
+
+        void MP4File::ReadSampleView(MP4TrackId trackId, MP4SampleId sampleId,
+                                     MP4SampleView* pView,
+                                     MP4Timestamp* pStartTime,
+                                     MP4Duration* pDuration,
+                                     MP4Duration* pRenderingOffset,
+                                     bool* pIsSyncSample)
+        {
+            MP4Track* pTrack = m_pTracks[FindTrackIndex(trackId)];
+
+            uint32_t numBytes = 0;
+            const uint8_t* pMapped = pTrack->MapSample(sampleId, &numBytes);
+            if (pMapped)
+            {
+                pTrack->GetSampleInfo(sampleId, pStartTime, pDuration,
+                                      pRenderingOffset, pIsSyncSample);
+
+                pView->bytes = pMapped;
+                pView->numBytes = numBytes;
+                pView->handle = NULL;
+                return;
+            }
+
+            vector<uint8_t>* pBuffer;
+            if (m_sampleViewBuffers.empty())
+            {
+                pBuffer = new vector<uint8_t>;
+            }
+            else
+            {
+                pBuffer = m_sampleViewBuffers.back();
+                m_sampleViewBuffers.pop_back();
+            }
+
+            try
+            {
+                // keep the buffer non-empty so it always has an address
+                numBytes = pTrack->GetSampleSize(sampleId);
+                pBuffer->resize(max(numBytes, (uint32_t)1));
+
+                uint8_t* pBytes = &(*pBuffer)[0];
+                pTrack->ReadSample(sampleId, &pBytes, &numBytes, pStartTime,
+                                   pDuration, pRenderingOffset, pIsSyncSample);
+            }
+            catch (Exception* x)
+            {
+                m_sampleViewBuffers.push_back(pBuffer);
+                throw x;
+            }
+
+            pView->bytes = &(*pBuffer)[0];
+            pView->numBytes = numBytes;
+            pView->handle = pBuffer;
+        }
+
+        void MP4File::ReleaseSampleView(MP4SampleView* pView)
+        {
+            if (pView->handle)
+                m_sampleViewBuffers.push_back((vector<uint8_t>*)pView->handle);
+
+            pView->bytes = NULL;
+            pView->numBytes = 0;
+            pView->handle = NULL;
+        }
+
         void MP4File::WriteSample(MP4TrackId trackId, const uint8_t* pBytes,
                                   uint32_t numBytes, MP4Duration duration,
                                   MP4Duration renderingOffset,
@@ -4654,6 +4756,13 @@ namespace mp4v2
             m_pTracks[FindTrackIndex(trackId)]->SetDurationPerChunk(duration);
         }
 
+        void MP4File::SetTrackPrefetch(MP4TrackId trackId, uint32_t numChunks,
+                                       uint32_t maxBytes)
+        {
+            m_pTracks[FindTrackIndex(trackId)]->SetPrefetch(numChunks,
+                                                            maxBytes);
+        }
+
         void MP4File::CopySample(MP4File* srcFile, MP4TrackId srcTrackId,
                                  MP4SampleId srcSampleId, MP4File* dstFile,
                                  MP4TrackId dstTrackId,
@@ -47,6 +47,7 @@ namespace mp4v2
         class MP4BytesProperty;
         class MP4Descriptor;
         class MP4DescriptorProperty;
+        class MP4TableProperty;
 
         class MP4File
         {
@@ -199,6 +200,25 @@ namespace mp4v2
                 bool* pIsSyncSample = NULL, bool* hasDependencyFlags = NULL,
                 uint32_t* dependencyFlags = NULL);
 
+            void ReadSampleRange(
+                // input parameters
+                MP4TrackId trackId, MP4SampleId sampleId, uint32_t numSamples,
+                // input/output parameters
+                uint8_t* pBytes, uint32_t* pNumBytes,
+                // output parameters
+                uint32_t* pSampleSizes = NULL);
+
+            void ReadSampleView(
+                // input parameters
+                MP4TrackId trackId, MP4SampleId sampleId,
+                // output parameters
+                MP4SampleView* pView, MP4Timestamp* pStartTime = NULL,
+                MP4Duration* pDuration = NULL,
+                MP4Duration* pRenderingOffset = NULL,
+                bool* pIsSyncSample = NULL);
+
+            void ReleaseSampleView(MP4SampleView* pView);
+
             void WriteSample(MP4TrackId trackId, const uint8_t* pBytes,
                              uint32_t numBytes, MP4Duration duration = 0,
                              MP4Duration renderingOffset = 0,
@@ -217,6 +237,8 @@ namespace mp4v2
 
             MP4Duration GetTrackDurationPerChunk(MP4TrackId);
             void SetTrackDurationPerChunk(MP4TrackId, MP4Duration);
+            void SetTrackPrefetch(MP4TrackId trackId, uint32_t numChunks,
+                                  uint32_t maxBytes);
 
             /* track level convenience functions */
 
@@ -671,6 +693,15 @@ namespace mp4v2
 
             void ReadBytes(uint8_t* buf, uint32_t bufsiz, File* file = NULL);
             void PeekBytes(uint8_t* buf, uint32_t bufsiz, File* file = NULL);
+            const uint8_t* MapBytes(uint64_t pos, uint32_t bufsiz,
+                                    File* file = NULL);
+            void PrefetchBytes(uint64_t pos, uint64_t size, File* file = NULL);
+
+            bool CanDeferReads();
+            void ReadDeferred(MP4TableProperty& table, uint64_t pos);
+
+            // reads the deferred tables of an atom and its descendants
+            void LoadDeferredTables(MP4Atom& atom);
 
             uint64_t ReadUInt(uint8_t size);
             uint8_t ReadUInt8();
@@ -850,6 +881,9 @@ namespace mp4v2
             uint64_t m_memoryBufferPosition;
             uint64_t m_memoryBufferSize;
 
+            // released buffers backing sample views, reused by later reads
+            vector<vector<uint8_t>*> m_sampleViewBuffers;
+
             // bit read/write buffering
             uint8_t m_numReadBits;
             uint8_t m_bufReadBits;
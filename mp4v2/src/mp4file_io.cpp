@@ -113,6 +113,78 @@ namespace mp4v2
             SetPosition(pos, file);
         }
 
+        const uint8_t* MP4File::MapBytes(uint64_t pos, uint32_t bufsiz,
+                                         File* file)
+        {
+            if (m_memoryBuffer)
+                return NULL;
+
+            if (!file)
+                file = m_file;
+
+            ASSERT(file);
+            return (const uint8_t*)file->map(pos, bufsiz);
+        }
+
+        void MP4File::PrefetchBytes(uint64_t pos, uint64_t size, File* file)
+        {
+            if (m_memoryBuffer)
+                return;
+
+            if (!file)
+                file = m_file;
+
+            ASSERT(file);
+            file->prefetch(pos, size);
+        }
+
+        bool MP4File::CanDeferReads()
+        {
+            // deferred reads go back to the file later, so it must stay
+            // unchanged and be what is being read from now
+            return m_file && !IsWriteMode() && !m_memoryBuffer
+                   && m_numReadBits == 0;
+        }
+
+        void MP4File::ReadDeferred(MP4TableProperty& table, uint64_t pos)
+        {
+            // read from the file whatever is going on at the moment, and
+            // put it all back afterwards
+            uint8_t* memoryBuffer = m_memoryBuffer;
+            uint64_t memoryBufferPosition = m_memoryBufferPosition;
+            uint64_t memoryBufferSize = m_memoryBufferSize;
+            m_memoryBuffer = NULL;
+
+            uint64_t oldPos = GetPosition();
+            try
+            {
+                SetPosition(pos);
+                table.ReadEntries(*this);
+                SetPosition(oldPos);
+            }
+            catch (Exception* x)
+            {
+                // the caller may go on reading from where it was
+                try
+                {
+                    SetPosition(oldPos);
+                }
+                catch (Exception* y)
+                {
+                    delete y;
+                }
+
+                m_memoryBuffer = memoryBuffer;
+                m_memoryBufferPosition = memoryBufferPosition;
+                m_memoryBufferSize = memoryBufferSize;
+                throw x;
+            }
+
+            m_memoryBuffer = memoryBuffer;
+            m_memoryBufferPosition = memoryBufferPosition;
+            m_memoryBufferSize = memoryBufferSize;
+        }
+
         void MP4File::EnableMemoryBuffer(uint8_t* pBytes, uint64_t numBytes)
         {
             ASSERT(!m_memoryBuffer);
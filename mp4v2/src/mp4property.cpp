@@ -35,6 +35,12 @@ namespace mp4v2
             m_name = name;
             m_readOnly = false;
             m_implicit = false;
+            m_pDeferredTable = NULL;
+        }
+
+        void MP4Property::ReadDeferredTable()
+        {
+            m_pDeferredTable->ReadDeferred();
         }
 
         bool MP4Property::FindProperty(const char* name,
@@ -779,6 +785,8 @@ namespace mp4v2
         {
             m_pCountProperty = pCountProperty;
             m_pCountProperty->SetReadOnly();
+            m_deferrable = false;
+            m_deferredStart = 0;
         }
 
         MP4TableProperty::~MP4TableProperty()
@@ -877,6 +885,38 @@ namespace mp4v2
                 return;
             }
 
+            // small tables are cheaper to read straight away
+            const uint32_t minDeferredEntries = 1024;
+
+            uint32_t numEntries = GetCount();
+            uint32_t entrySize = GetEntrySize();
+
+            if (m_deferrable && entrySize && numEntries >= minDeferredEntries
+                && file.CanDeferReads())
+            {
+                uint64_t start = file.GetPosition();
+                uint64_t end = start + (uint64_t)numEntries * entrySize;
+
+                // truncated tables are read now so they fail as usual
+                if (end <= file.GetSize())
+                {
+                    m_deferredStart = start;
+                    for (uint32_t j = 0; j < numProperties; j++)
+                    {
+                        m_pProperties[j]->SetDeferredTable(this);
+                    }
+
+                    file.SetPosition(end);
+                    return;
+                }
+            }
+
+            ReadEntries(file);
+        }
+
+        void MP4TableProperty::ReadEntries(MP4File& file)
+        {
+            uint32_t numProperties = m_pProperties.Size();
             uint32_t numEntries = GetCount();
 
             /* for each property set size */
@@ -891,6 +931,53 @@ namespace mp4v2
             }
         }
 
+        void MP4TableProperty::ReadDeferred()
+        {
+            for (uint32_t j = 0; j < m_pProperties.Size(); j++)
+            {
+                m_pProperties[j]->SetDeferredTable(NULL);
+            }
+
+            m_parentAtom.GetFile().ReadDeferred(*this, m_deferredStart);
+        }
+
+        uint32_t MP4TableProperty::GetEntrySize()
+        {
+            // entries can only be skipped when every column has a fixed size
+            uint32_t entrySize = 0;
+
+            for (uint32_t j = 0; j < m_pProperties.Size(); j++)
+            {
+                if (m_pProperties[j]->IsImplicit())
+                {
+                    continue;
+                }
+
+                switch (m_pProperties[j]->GetType())
+                {
+                case Integer8Property:
+                    entrySize += 1;
+                    break;
+                case Integer16Property:
+                    entrySize += 2;
+                    break;
+                case Integer24Property:
+                    entrySize += 3;
+                    break;
+                case Integer32Property:
+                    entrySize += 4;
+                    break;
+                case Integer64Property:
+                    entrySize += 8;
+                    break;
+                default:
+                    return 0;
+                }
+            }
+
+            return entrySize;
+        }
+
         void MP4TableProperty::ReadEntry(MP4File& file, uint32_t index)
         {
             for (uint32_t j = 0; j < m_pProperties.Size(); j++)
@@ -956,6 +1043,8 @@ namespace mp4v2
                 return;
             }
 
+            LoadEntries();
+
             uint32_t numProperties = m_pProperties.Size();
 
             if (numProperties == 0)
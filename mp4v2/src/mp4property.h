@@ -51,6 +51,8 @@ namespace mp4v2
             BasicTypeProperty,
         };
 
+        class MP4TableProperty;
+
         class MP4Property
         {
         public:
@@ -88,11 +90,32 @@ namespace mp4v2
                                       MP4Property** ppProperty,
                                       uint32_t* pIndex = NULL);
 
+            // set while this property is a column of a table whose entries
+            // haven't been read yet, see MP4TableProperty::SetDeferrable()
+            void SetDeferredTable(MP4TableProperty* pTable)
+            {
+                m_pDeferredTable = pTable;
+            }
+
+            bool IsDeferred() { return m_pDeferredTable != NULL; }
+
+        protected:
+            void LoadDeferred()
+            {
+                if (m_pDeferredTable)
+                {
+                    ReadDeferredTable();
+                }
+            }
+
+            void ReadDeferredTable();
+
         protected:
             MP4Atom& m_parentAtom;
             const char* m_name;
             bool m_readOnly;
             bool m_implicit;
+            MP4TableProperty* m_pDeferredTable;
 
         private:
             MP4Property();
@@ -138,14 +161,30 @@ namespace mp4v2
                                                                                \
         MP4PropertyType GetType() { return Integer##xsize##Property; }         \
                                                                                \
-        uint32_t GetCount() { return m_values.Size(); }                        \
-        void SetCount(uint32_t count) { m_values.Resize(count); }              \
+        uint32_t GetCount()                                                    \
+        {                                                                      \
+            LoadDeferred();                                                    \
+            return m_values.Size();                                            \
+        }                                                                      \
+        void SetCount(uint32_t count)                                          \
+        {                                                                      \
+            LoadDeferred();                                                    \
+            m_values.Resize(count);                                            \
+        }                                                                      \
                                                                                \
         uint##isize##_t GetValue(uint32_t index = 0)                           \
         {                                                                      \
+            LoadDeferred();                                                    \
             return m_values[index];                                            \
         }                                                                      \
                                                                                \
+        /* contiguous storage of all GetCount() values, for bulk access */     \
+        const uint##isize##_t* GetValues()                                     \
+        {                                                                      \
+            LoadDeferred();                                                    \
+            return m_values.Elements();                                        \
+        }                                                                      \
+                                                                               \
         void SetValue(uint##isize##_t value, uint32_t index = 0)               \
         {                                                                      \
             if (m_readOnly)                                                    \
@@ -155,16 +194,27 @@ namespace mp4v2
                 throw new PlatformException(msg.str().c_str(), EACCES,         \
                                             __FILE__, __LINE__, __FUNCTION__); \
             }                                                                  \
+            LoadDeferred();                                                    \
             m_values[index] = value;                                           \
         }                                                                      \
-        void AddValue(uint##isize##_t value) { m_values.Add(value); }          \
+        void AddValue(uint##isize##_t value)                                   \
+        {                                                                      \
+            LoadDeferred();                                                    \
+            m_values.Add(value);                                               \
+        }                                                                      \
         void InsertValue(uint##isize##_t value, uint32_t index)                \
         {                                                                      \
+            LoadDeferred();                                                    \
             m_values.Insert(value, index);                                     \
         }                                                                      \
-        void DeleteValue(uint32_t index) { m_values.Delete(index); }           \
+        void DeleteValue(uint32_t index)                                       \
+        {                                                                      \
+            LoadDeferred();                                                    \
+            m_values.Delete(index);                                            \
+        }                                                                      \
         void IncrementValue(int32_t increment = 1, uint32_t index = 0)         \
         {                                                                      \
+            LoadDeferred();                                                    \
             m_values[index] += increment;                                      \
         }                                                                      \
         void Read(MP4File& file, uint32_t index = 0)                           \
@@ -182,6 +232,7 @@ namespace mp4v2
             {                                                                  \
                 return;                                                        \
             }                                                                  \
+            LoadDeferred();                                                    \
             file.WriteUInt##xsize(m_values[index]);                            \
         }                                                                      \
         void Dump(uint8_t indent, bool dumpImplicits, uint32_t index = 0);     \
@@ -486,6 +537,22 @@ namespace mp4v2
             bool FindProperty(const char* name, MP4Property** ppProperty,
                               uint32_t* pIndex = NULL);
 
+            // allow Read() to skip over large tables of fixed size entries
+            // in read-only files, the entries are read on first access
+            void SetDeferrable(bool value = true) { m_deferrable = value; }
+
+            void ReadEntries(MP4File& file);
+            void ReadDeferred();
+
+            // reads the entries now if Read() has deferred them
+            void LoadEntries()
+            {
+                if (m_pProperties.Size() && m_pProperties[0]->IsDeferred())
+                {
+                    ReadDeferred();
+                }
+            }
+
         protected:
             virtual void ReadEntry(MP4File& file, uint32_t index);
             virtual void WriteEntry(MP4File& file, uint32_t index);
@@ -494,10 +561,15 @@ namespace mp4v2
                                        MP4Property** ppProperty,
                                        uint32_t* pIndex);
 
+            uint32_t GetEntrySize();
+
         protected:
             MP4IntegerProperty* m_pCountProperty;
             MP4PropertyArray m_pProperties;
 
+            bool m_deferrable;
+            uint64_t m_deferredStart;
+
         private:
             MP4TableProperty();
             MP4TableProperty(const MP4TableProperty& src);
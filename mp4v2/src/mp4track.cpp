@@ -71,6 +71,17 @@ namespace mp4v2
             m_cachedSttsSid = MP4_INVALID_SAMPLE_ID;
             m_cachedCttsSid = MP4_INVALID_SAMPLE_ID;
 
+            m_sampleIndexBuilt = false;
+
+            m_cachedStssIndex = 0;
+            m_editIndexBuilt = false;
+            m_cachedEditIndex = 0;
+
+            m_prefetchChunks = 0;
+            m_prefetchMaxBytes = 0;
+            m_prefetchChunkId = 0;
+            m_prefetchEndChunkId = 0;
+
             bool success = true;
 
             MP4Integer32Property* pTrackIdProperty;
@@ -252,6 +263,10 @@ namespace mp4v2
             }
             CalculateBytesPerSample();
 
+            m_stszSampleSizes32 =
+                m_stsz_sample_bits == 32
+                && m_pStszSampleSizeProperty->GetType() == Integer32Property;
+
             // update sdtp log from sdtp atom
             MP4SdtpAtom* sdtp =
                 (MP4SdtpAtom*)m_trakAtom.FindAtom("trak.mdia.minf.stbl.sdtp");
@@ -267,6 +282,7 @@ namespace mp4v2
 
         MP4Track::~MP4Track()
         {
+            CloseSampleFile();
             MP4Free(m_pCachedReadSample);
             m_pCachedReadSample = NULL;
             MP4Free(m_pChunkBuffer);
@@ -351,32 +367,10 @@ namespace mp4v2
                 m_File.SetPosition(fileOffset, fin);
                 m_File.ReadBytes(*ppBytes, *pNumBytes, fin);
 
-                if (pStartTime || pDuration)
-                {
-                    GetSampleTimes(sampleId, pStartTime, pDuration);
-
-                    log.verbose3f("\"%s\": ReadSample:  start %" PRIu64
-                                  " duration %" PRId64,
-                                  GetFile().GetFilename().c_str(),
-                                  (pStartTime ? *pStartTime : 0),
-                                  (pDuration ? *pDuration : 0));
-                }
-                if (pRenderingOffset)
-                {
-                    *pRenderingOffset = GetSampleRenderingOffset(sampleId);
+                PrefetchChunks(sampleId);
 
-                    log.verbose3f(
-                        "\"%s\": ReadSample:  renderingOffset %" PRId64,
-                        GetFile().GetFilename().c_str(), *pRenderingOffset);
-                }
-                if (pIsSyncSample)
-                {
-                    *pIsSyncSample = IsSyncSample(sampleId);
-
-                    log.verbose3f("\"%s\": ReadSample:  isSyncSample %u",
-                                  GetFile().GetFilename().c_str(),
-                                  *pIsSyncSample);
-                }
+                GetSampleInfo(sampleId, pStartTime, pDuration,
+                              pRenderingOffset, pIsSyncSample);
             }
 
             catch (Exception* x)
@@ -397,6 +391,219 @@ namespace mp4v2
                 m_File.SetPosition(oldPos, fin);
         }
 
+        void MP4Track::ReadSampleRange(MP4SampleId sampleId,
+                                       uint32_t numSamples, uint8_t* pBytes,
+                                       uint32_t* pNumBytes,
+                                       uint32_t* pSampleSizes)
+        {
+            // chunks further apart than this are read separately, and
+            // spans with gaps are capped so the scratch buffer stays small
+            const uint64_t maxGap = 64 * 1024;
+            const uint64_t maxGapSpan = 4 * 1024 * 1024;
+
+            if (sampleId == MP4_INVALID_SAMPLE_ID)
+                throw new Exception("sample id can't be zero", __FILE__,
+                                    __LINE__, __FUNCTION__);
+
+            if (numSamples == 0)
+            {
+                *pNumBytes = 0;
+                return;
+            }
+
+            MP4SampleId lastSampleId = sampleId + numSamples - 1;
+            if (lastSampleId < sampleId
+                || lastSampleId > GetNumberOfSamples())
+            {
+                throw new Exception("sample id out of range", __FILE__,
+                                    __LINE__, __FUNCTION__);
+            }
+
+            // handle unusual case of wanting to read samples
+            // that are still sitting in the write chunk buffer
+            if (m_pChunkBuffer
+                && lastSampleId >= m_writeSampleId - m_chunkSamples)
+            {
+                WriteChunkBuffer();
+            }
+
+            uint64_t totalSize = 0;
+            for (MP4SampleId sid = sampleId; sid <= lastSampleId; sid++)
+            {
+                totalSize += GetSampleSize(sid);
+            }
+            if (totalSize > *pNumBytes)
+            {
+                throw new Exception("sample buffer is too small", __FILE__,
+                                    __LINE__, __FUNCTION__);
+            }
+
+            log.verbose3f("\"%s\": ReadSampleRange: track %u id %u count %u"
+                          " size %" PRIu64,
+                          GetFile().GetFilename().c_str(), m_trackId, sampleId,
+                          numSamples, totalSize);
+
+            uint64_t oldPos = m_File.GetPosition(); // only used in mode == 'w'
+            try
+            {
+                vector<uint8_t> span;
+                uint32_t bufferOffset = 0;
+                MP4SampleId sid = sampleId;
+
+                while (sid <= lastSampleId)
+                {
+                    File* fin = GetSampleFile(sid);
+                    if (fin == (File*)-1)
+                        throw new Exception(
+                            "sample is located in an inaccessible file",
+                            __FILE__, __LINE__, __FUNCTION__);
+
+                    // grow the span over following samples while they are
+                    // in the same file and close enough behind it. The file
+                    // is told by the sample description, as GetSampleFile
+                    // would close fin when it switches to another one
+                    uint32_t stsdIndex =
+                        m_pStscSampleDescrIndexProperty->GetValue(
+                            GetSampleStscIndex(sid));
+                    uint64_t spanStart = GetSampleFileOffset(sid);
+                    uint64_t spanEnd = spanStart + GetSampleSize(sid);
+                    bool contiguous = true;
+
+                    MP4SampleId endSid = sid + 1;
+                    for (; endSid <= lastSampleId; endSid++)
+                    {
+                        if (m_pStscSampleDescrIndexProperty->GetValue(
+                                GetSampleStscIndex(endSid))
+                            != stsdIndex)
+                            break;
+
+                        uint64_t offset = GetSampleFileOffset(endSid);
+                        if (offset < spanEnd || offset - spanEnd > maxGap)
+                            break;
+
+                        uint64_t end = offset + GetSampleSize(endSid);
+                        if ((!contiguous || offset != spanEnd)
+                            && end - spanStart > maxGapSpan)
+                            break;
+
+                        contiguous = contiguous && offset == spanEnd;
+                        spanEnd = end;
+                    }
+
+                    uint32_t spanSize = (uint32_t)(spanEnd - spanStart);
+                    uint8_t* pSpan = pBytes + bufferOffset;
+                    if (!contiguous)
+                    {
+                        span.resize(spanSize);
+                        pSpan = &span[0];
+                    }
+
+                    m_File.SetPosition(spanStart, fin);
+                    m_File.ReadBytes(pSpan, spanSize, fin);
+
+                    for (; sid < endSid; sid++)
+                    {
+                        uint32_t sampleSize = GetSampleSize(sid);
+                        if (!contiguous)
+                        {
+                            uint64_t offset =
+                                GetSampleFileOffset(sid) - spanStart;
+                            memcpy(pBytes + bufferOffset, pSpan + offset,
+                                   sampleSize);
+                        }
+                        if (pSampleSizes)
+                        {
+                            pSampleSizes[sid - sampleId] = sampleSize;
+                        }
+                        bufferOffset += sampleSize;
+                    }
+                }
+
+                PrefetchChunks(lastSampleId);
+            }
+            catch (Exception* x)
+            {
+                if (m_File.IsWriteMode())
+                    m_File.SetPosition(oldPos);
+
+                throw x;
+            }
+
+            if (m_File.IsWriteMode())
+                m_File.SetPosition(oldPos);
+
+            *pNumBytes = (uint32_t)totalSize;
+        }
+
+        void MP4Track::GetSampleInfo(MP4SampleId sampleId,
+                                     MP4Timestamp* pStartTime,
+                                     MP4Duration* pDuration,
+                                     MP4Duration* pRenderingOffset,
+                                     bool* pIsSyncSample)
+        {
+            if (pStartTime || pDuration)
+            {
+                GetSampleTimes(sampleId, pStartTime, pDuration);
+
+                log.verbose3f("\"%s\": ReadSample:  start %" PRIu64
+                              " duration %" PRId64,
+                              GetFile().GetFilename().c_str(),
+                              (pStartTime ? *pStartTime : 0),
+                              (pDuration ? *pDuration : 0));
+            }
+            if (pRenderingOffset)
+            {
+                *pRenderingOffset = GetSampleRenderingOffset(sampleId);
+
+                log.verbose3f("\"%s\": ReadSample:  renderingOffset %" PRId64,
+                              GetFile().GetFilename().c_str(),
+                              *pRenderingOffset);
+            }
+            if (pIsSyncSample)
+            {
+                *pIsSyncSample = IsSyncSample(sampleId);
+
+                log.verbose3f("\"%s\": ReadSample:  isSyncSample %u",
+                              GetFile().GetFilename().c_str(), *pIsSyncSample);
+            }
+        }
+
+        const uint8_t* MP4Track::MapSample(MP4SampleId sampleId,
+                                           uint32_t* pNumBytes)
+        {
+            if (sampleId == MP4_INVALID_SAMPLE_ID)
+                throw new Exception("sample id can't be zero", __FILE__,
+                                    __LINE__, __FUNCTION__);
+
+            // sample data only stays put while the file is read-only
+            if (m_File.IsWriteMode())
+                return NULL;
+
+            File* fin = GetSampleFile(sampleId);
+            if (fin == (File*)-1)
+                throw new Exception("sample is located in an inaccessible file",
+                                    __FILE__, __LINE__, __FUNCTION__);
+
+            // an external data reference file is closed as soon as
+            // GetSampleFile switches to another one, which would unmap the
+            // views into it, so those samples are always copied
+            if (fin)
+                return NULL;
+
+            uint64_t fileOffset = GetSampleFileOffset(sampleId);
+            uint32_t sampleSize = GetSampleSize(sampleId);
+
+            const uint8_t* pBytes =
+                m_File.MapBytes(fileOffset, sampleSize, fin);
+            if (pBytes)
+            {
+                *pNumBytes = sampleSize;
+                PrefetchChunks(sampleId);
+            }
+
+            return pBytes;
+        }
+
         void MP4Track::ReadSampleFragment(MP4SampleId sampleId,
                                           uint32_t sampleOffset,
                                           uint16_t sampleLength, uint8_t* pDest)
@@ -407,6 +614,22 @@ namespace mp4v2
                                     __FUNCTION__);
             }
 
+            // serve fragments straight from a mapped sample when possible,
+            // rather than caching a private copy of it
+            uint32_t sampleSize = 0;
+            const uint8_t* pMapped = MapSample(sampleId, &sampleSize);
+            if (pMapped)
+            {
+                if (sampleOffset + sampleLength > sampleSize)
+                {
+                    throw new Exception("offset and/or length are too large",
+                                        __FILE__, __LINE__, __FUNCTION__);
+                }
+
+                memcpy(pDest, &pMapped[sampleOffset], sampleLength);
+                return;
+            }
+
             if (sampleId != m_cachedReadSampleId)
             {
                 MP4Free(m_pCachedReadSample);
@@ -704,6 +927,13 @@ namespace mp4v2
                     return fixedSampleSize * m_bytesPerSample;
                 }
             }
+            // skip the generic dispatch for plain 32 bit stsz entries
+            if (m_stszSampleSizes32)
+            {
+                return m_bytesPerSample
+                       * ((MP4Integer32Property*)m_pStszSampleSizeProperty)
+                             ->GetValue(sampleId - 1);
+            }
             // will have to check for 4 bit sample size here
             if (m_stsz_sample_bits == 4)
             {
@@ -736,6 +966,18 @@ namespace mp4v2
 
             uint32_t maxSampleSize = 0;
             uint32_t numSamples = m_pStszSampleSizeProperty->GetCount();
+            if (m_stszSampleSizes32)
+            {
+                const uint32_t* pSampleSizes =
+                    ((MP4Integer32Property*)m_pStszSampleSizeProperty)
+                        ->GetValues();
+                for (uint32_t i = 0; i < numSamples; i++)
+                {
+                    maxSampleSize = max(maxSampleSize, pSampleSizes[i]);
+                }
+                return maxSampleSize * m_bytesPerSample;
+            }
+
             for (MP4SampleId sid = 1; sid <= numSamples; sid++)
             {
                 uint32_t sampleSize =
@@ -770,6 +1012,18 @@ namespace mp4v2
             // else non-fixed sample size, sum them
             uint64_t totalSampleSizes = 0;
             uint32_t numSamples = m_pStszSampleSizeProperty->GetCount();
+            if (m_stszSampleSizes32)
+            {
+                const uint32_t* pSampleSizes =
+                    ((MP4Integer32Property*)m_pStszSampleSizeProperty)
+                        ->GetValues();
+                for (uint32_t i = 0; i < numSamples; i++)
+                {
+                    totalSampleSizes += pSampleSizes[i];
+                }
+                return totalSampleSizes * m_bytesPerSample;
+            }
+
             for (MP4SampleId sid = 1; sid <= numSamples; sid++)
             {
                 uint32_t sampleSize =
@@ -973,7 +1227,6 @@ namespace mp4v2
 
         uint32_t MP4Track::GetSampleStscIndex(MP4SampleId sampleId)
         {
-            uint32_t stscIndex;
             uint32_t numStscs = m_pStscCountProperty->GetValue();
 
             if (numStscs == 0)
@@ -982,22 +1235,27 @@ namespace mp4v2
                                     __FUNCTION__);
             }
 
-            for (stscIndex = 0; stscIndex < numStscs; stscIndex++)
+            // firstSample is ascending, so binary search for the last
+            // entry with firstSample <= sampleId
+            uint32_t stscLIndex = 0;
+            uint32_t stscRIndex = numStscs;
+
+            while (stscLIndex < stscRIndex)
             {
+                uint32_t stscIndex = (stscLIndex + stscRIndex) >> 1;
+
                 if (sampleId < m_pStscFirstSampleProperty->GetValue(stscIndex))
                 {
-                    ASSERT(stscIndex != 0);
-                    stscIndex -= 1;
-                    break;
+                    stscRIndex = stscIndex;
+                }
+                else
+                {
+                    stscLIndex = stscIndex + 1;
                 }
-            }
-            if (stscIndex == numStscs)
-            {
-                ASSERT(stscIndex != 0);
-                stscIndex -= 1;
             }
 
-            return stscIndex;
+            ASSERT(stscLIndex != 0);
+            return stscLIndex - 1;
         }
 
         File* MP4Track::GetSampleFile(MP4SampleId sampleId)
@@ -1068,8 +1326,9 @@ namespace mp4v2
 
                     if (fileName)
                     {
-                        file = new File(fileName, File::MODE_READ);
-                        if (!file->open())
+                        file = new File(fileName, File::MODE_READ,
+                                        &io::FileProvider::mapped());
+                        if (file->open())
                         {
                             delete file;
                             file = (File*)-1;
@@ -1078,8 +1337,7 @@ namespace mp4v2
                 }
             }
 
-            if (m_lastSampleFile)
-                m_lastSampleFile->close();
+            CloseSampleFile();
 
             // cache the answer
             m_lastStsdIndex = stsdIndex;
@@ -1088,8 +1346,31 @@ namespace mp4v2
             return file;
         }
 
+        void MP4Track::CloseSampleFile()
+        {
+            // NULL is the file itself and -1 a file which could not be opened
+            if (m_lastSampleFile && m_lastSampleFile != (File*)-1)
+            {
+                m_lastSampleFile->close();
+                delete m_lastSampleFile;
+            }
+
+            m_lastSampleFile = NULL;
+        }
+
         uint64_t MP4Track::GetSampleFileOffset(MP4SampleId sampleId)
         {
+            if (UseSampleIndex())
+            {
+                if (sampleId == MP4_INVALID_SAMPLE_ID
+                    || sampleId > m_sampleOffsetIndex.size())
+                {
+                    throw new Exception("sample id out of range", __FILE__,
+                                        __LINE__, __FUNCTION__);
+                }
+                return m_sampleOffsetIndex[sampleId - 1];
+            }
+
             uint32_t stscIndex = GetSampleStscIndex(sampleId);
 
             // firstChunk is the chunk index of the first chunk with
@@ -1127,6 +1408,242 @@ namespace mp4v2
             return chunkOffset + sampleOffset;
         }
 
+        bool MP4Track::UseSampleIndex()
+        {
+            // sample tables are still growing while writing
+            if (m_File.IsWriteMode())
+            {
+                return false;
+            }
+
+            if (!m_sampleIndexBuilt)
+            {
+                BuildSampleIndex();
+            }
+
+            return !m_sttsStartTimeIndex.empty();
+        }
+
+        void MP4Track::BuildSampleIndex()
+        {
+            m_sampleIndexBuilt = true;
+
+            uint32_t numSamples = GetNumberOfSamples();
+            uint32_t numStscs = m_pStscCountProperty->GetValue();
+            uint32_t numChunks = min(m_pChunkCountProperty->GetValue(),
+                                     m_pChunkOffsetProperty->GetCount());
+            uint32_t numStts = min(m_pSttsCountProperty->GetValue(),
+                                   m_pSttsSampleDeltaProperty->GetCount());
+
+            // resolve the column types once so the loops below index plain
+            // arrays instead of dispatching on every element
+            const uint32_t* pChunkOffsets32 = NULL;
+            const uint64_t* pChunkOffsets64 = NULL;
+            if (m_pChunkOffsetProperty->GetType() == Integer32Property)
+            {
+                pChunkOffsets32 =
+                    ((MP4Integer32Property*)m_pChunkOffsetProperty)
+                        ->GetValues();
+            }
+            else
+            {
+                pChunkOffsets64 =
+                    ((MP4Integer64Property*)m_pChunkOffsetProperty)
+                        ->GetValues();
+            }
+
+            const uint32_t* pSampleSizes = NULL;
+            if (m_stszSampleSizes32
+                && m_pStszFixedSampleSizeProperty->GetValue() == 0
+                && m_pStszSampleSizeProperty->GetCount() >= numSamples)
+            {
+                pSampleSizes =
+                    ((MP4Integer32Property*)m_pStszSampleSizeProperty)
+                        ->GetValues();
+            }
+
+            const uint32_t* pSttsSampleCounts =
+                m_pSttsSampleCountProperty->GetValues();
+            const uint32_t* pSttsSampleDeltas =
+                m_pSttsSampleDeltaProperty->GetValues();
+
+            // sample id -> file offset, walking stsc once instead of per call
+            m_sampleOffsetIndex.reserve(numSamples);
+
+            MP4SampleId sid = 1;
+            for (uint32_t stscIndex = 0;
+                 stscIndex < numStscs && sid <= numSamples; stscIndex++)
+            {
+                MP4ChunkId firstChunk =
+                    m_pStscFirstChunkProperty->GetValue(stscIndex);
+                MP4ChunkId lastChunk = numChunks;
+                if (stscIndex + 1 < numStscs)
+                {
+                    lastChunk =
+                        m_pStscFirstChunkProperty->GetValue(stscIndex + 1) - 1;
+                }
+                uint32_t samplesPerChunk =
+                    m_pStscSamplesPerChunkProperty->GetValue(stscIndex);
+
+                for (MP4ChunkId chunkId = firstChunk;
+                     chunkId <= lastChunk && chunkId <= numChunks
+                     && sid <= numSamples;
+                     chunkId++)
+                {
+                    uint64_t offset = pChunkOffsets32
+                                          ? pChunkOffsets32[chunkId - 1]
+                                          : pChunkOffsets64[chunkId - 1];
+
+                    for (uint32_t i = 0;
+                         i < samplesPerChunk && sid <= numSamples; i++, sid++)
+                    {
+                        m_sampleOffsetIndex.push_back(offset);
+                        offset += pSampleSizes
+                                      ? m_bytesPerSample * pSampleSizes[sid - 1]
+                                      : GetSampleSize(sid);
+                    }
+                }
+            }
+
+            // stts entry -> first sample id and start time, with a
+            // trailing sentinel so lookups can binary search
+            m_sttsFirstSampleIndex.reserve(numStts + 1);
+            m_sttsStartTimeIndex.reserve(numStts + 1);
+
+            MP4SampleId sttsSid = 1;
+            MP4Timestamp elapsed = 0;
+            for (uint32_t sttsIndex = 0; sttsIndex < numStts; sttsIndex++)
+            {
+                uint32_t sampleCount = pSttsSampleCounts[sttsIndex];
+                uint32_t sampleDelta = pSttsSampleDeltas[sttsIndex];
+
+                if (sampleDelta == 0 && sttsIndex < numStts - 1)
+                {
+                    log.warningf(
+                        "%s: \"%s\": Zero sample duration, stts entry %u",
+                        __FUNCTION__, GetFile().GetFilename().c_str(),
+                        sttsIndex);
+                }
+
+                m_sttsFirstSampleIndex.push_back(sttsSid);
+                m_sttsStartTimeIndex.push_back(elapsed);
+
+                sttsSid += sampleCount;
+                elapsed += (MP4Timestamp)sampleCount * sampleDelta;
+            }
+            m_sttsFirstSampleIndex.push_back(sttsSid);
+            m_sttsStartTimeIndex.push_back(elapsed);
+
+            // malformed tables are left to the unindexed code paths
+            if (m_sampleOffsetIndex.size() != numSamples)
+            {
+                log.verbose1f("\"%s\": track %u sample tables are inconsistent, "
+                              "sample index disabled",
+                              GetFile().GetFilename().c_str(), m_trackId);
+
+                vector<uint64_t>().swap(m_sampleOffsetIndex);
+                vector<MP4SampleId>().swap(m_sttsFirstSampleIndex);
+                vector<MP4Timestamp>().swap(m_sttsStartTimeIndex);
+            }
+        }
+
+        void MP4Track::SetPrefetch(uint32_t numChunks, uint32_t maxBytes)
+        {
+            m_prefetchChunks = numChunks;
+            m_prefetchMaxBytes = maxBytes;
+            m_prefetchChunkId = 0;
+            m_prefetchEndChunkId = 0;
+        }
+
+        void MP4Track::PrefetchChunks(MP4SampleId sampleId)
+        {
+            // chunks only have a final place on disk in read mode
+            if (m_prefetchChunks == 0 || m_File.IsWriteMode())
+            {
+                return;
+            }
+
+            // read-ahead is only a hint, it must never fail a read
+            try
+            {
+                uint32_t stscIndex = GetSampleStscIndex(sampleId);
+                uint32_t samplesPerChunk =
+                    m_pStscSamplesPerChunkProperty->GetValue(stscIndex);
+                if (samplesPerChunk == 0)
+                {
+                    return;
+                }
+
+                MP4SampleId firstSample =
+                    m_pStscFirstSampleProperty->GetValue(stscIndex);
+                MP4ChunkId chunkId =
+                    m_pStscFirstChunkProperty->GetValue(stscIndex)
+                    + (sampleId - firstSample) / samplesPerChunk;
+
+                if (chunkId == m_prefetchChunkId)
+                {
+                    return;
+                }
+
+                // landing outside the window is a seek, so forget what was
+                // requested for the old position and restart from here.
+                // pages the kernel is already reading can't be recalled, but
+                // nothing more is requested for the old window
+                if (chunkId < m_prefetchChunkId
+                    || chunkId > m_prefetchEndChunkId)
+                {
+                    m_prefetchEndChunkId = chunkId;
+                }
+                m_prefetchChunkId = chunkId;
+
+                uint32_t numChunks = GetNumberOfChunks();
+                MP4ChunkId lastChunkId = chunkId + m_prefetchChunks;
+                if (lastChunkId > numChunks)
+                {
+                    lastChunkId = numChunks;
+                }
+
+                File* file = GetSampleFile(sampleId);
+                if (file == (File*)-1)
+                {
+                    return;
+                }
+
+                // bytes already in flight ahead of the current chunk count
+                // against the budget
+                uint64_t pendingBytes = 0;
+                for (MP4ChunkId id = chunkId + 1; id <= m_prefetchEndChunkId;
+                     id++)
+                {
+                    pendingBytes += GetChunkSize(id);
+                }
+
+                while (m_prefetchEndChunkId < lastChunkId)
+                {
+                    MP4ChunkId id = m_prefetchEndChunkId + 1;
+                    uint32_t chunkSize = GetChunkSize(id);
+                    if (pendingBytes + chunkSize > m_prefetchMaxBytes)
+                    {
+                        break;
+                    }
+
+                    m_File.PrefetchBytes(
+                        m_pChunkOffsetProperty->GetValue(id - 1), chunkSize,
+                        file);
+
+                    pendingBytes += chunkSize;
+                    m_prefetchEndChunkId = id;
+                }
+            }
+            catch (Exception* x)
+            {
+                log.verbose1f("\"%s\": track %u read-ahead failed: %s",
+                              GetFile().GetFilename().c_str(), m_trackId,
+                              x->what.c_str());
+                delete x;
+            }
+        }
+
         void MP4Track::UpdateSampleToChunk(MP4SampleId sampleId,
                                            MP4ChunkId chunkId,
                                            uint32_t samplesPerChunk)
@@ -1201,6 +1718,38 @@ namespace mp4v2
                                       MP4Timestamp* pStartTime,
                                       MP4Duration* pDuration)
         {
+            if (UseSampleIndex())
+            {
+                // last stts entry whose first sample is <= sampleId
+                uint32_t sttsIndex =
+                    upper_bound(m_sttsFirstSampleIndex.begin(),
+                                m_sttsFirstSampleIndex.end(), sampleId)
+                    - m_sttsFirstSampleIndex.begin();
+
+                if (sampleId == MP4_INVALID_SAMPLE_ID || sttsIndex == 0
+                    || sttsIndex >= m_sttsFirstSampleIndex.size())
+                {
+                    throw new Exception("sample id out of range", __FILE__,
+                                        __LINE__, __FUNCTION__);
+                }
+                sttsIndex--;
+
+                uint32_t sampleDelta =
+                    m_pSttsSampleDeltaProperty->GetValue(sttsIndex);
+
+                if (pStartTime)
+                {
+                    *pStartTime = sampleId - m_sttsFirstSampleIndex[sttsIndex];
+                    *pStartTime *= sampleDelta;
+                    *pStartTime += m_sttsStartTimeIndex[sttsIndex];
+                }
+                if (pDuration)
+                {
+                    *pDuration = sampleDelta;
+                }
+                return;
+            }
+
             uint32_t numStts = m_pSttsCountProperty->GetValue();
             MP4SampleId sid;
             MP4Duration elapsed;
@@ -1256,6 +1805,37 @@ namespace mp4v2
         MP4SampleId MP4Track::GetSampleIdFromTime(MP4Timestamp when,
                                                   bool wantSyncSample)
         {
+            if (UseSampleIndex())
+            {
+                // first stts entry that ends at or after when
+                uint32_t sttsIndex =
+                    lower_bound(m_sttsStartTimeIndex.begin() + 1,
+                                m_sttsStartTimeIndex.end(), when)
+                    - (m_sttsStartTimeIndex.begin() + 1);
+
+                if (sttsIndex + 1 >= m_sttsStartTimeIndex.size())
+                {
+                    throw new Exception("time out of range", __FILE__,
+                                        __LINE__, __FUNCTION__);
+                }
+
+                uint32_t sampleDelta =
+                    m_pSttsSampleDeltaProperty->GetValue(sttsIndex);
+
+                MP4SampleId sampleId = m_sttsFirstSampleIndex[sttsIndex];
+                if (sampleDelta)
+                {
+                    sampleId +=
+                        (when - m_sttsStartTimeIndex[sttsIndex]) / sampleDelta;
+                }
+
+                if (wantSyncSample)
+                {
+                    return GetNextSyncSample(sampleId);
+                }
+                return sampleId;
+            }
+
             uint32_t numStts = m_pSttsCountProperty->GetValue();
             MP4SampleId sid = 1;
             MP4Duration elapsed = 0;
@@ -1556,32 +2136,10 @@ namespace mp4v2
                 return true;
             }
 
-            uint32_t numStss = m_pStssCountProperty->GetValue();
-            uint32_t stssLIndex = 0;
-            uint32_t stssRIndex = numStss - 1;
-
-            while (stssRIndex >= stssLIndex)
-            {
-                uint32_t stssIndex = (stssRIndex + stssLIndex) >> 1;
-                MP4SampleId syncSampleId =
-                    m_pStssSampleProperty->GetValue(stssIndex);
-
-                if (sampleId == syncSampleId)
-                {
-                    return true;
-                }
-
-                if (sampleId > syncSampleId)
-                {
-                    stssLIndex = stssIndex + 1;
-                }
-                else
-                {
-                    stssRIndex = stssIndex - 1;
-                }
-            }
+            uint32_t stssIndex = GetSyncSampleIndex(sampleId);
 
-            return false;
+            return stssIndex < m_pStssSampleProperty->GetCount()
+                   && m_pStssSampleProperty->GetValue(stssIndex) == sampleId;
         }
 
         // N.B. "next" is inclusive of this sample id
@@ -1592,23 +2150,45 @@ namespace mp4v2
                 return sampleId;
             }
 
-            uint32_t numStss = m_pStssCountProperty->GetValue();
+            uint32_t stssIndex = GetSyncSampleIndex(sampleId);
 
-            for (uint32_t stssIndex = 0; stssIndex < numStss; stssIndex++)
+            if (stssIndex < m_pStssSampleProperty->GetCount())
             {
-                MP4SampleId syncSampleId =
-                    m_pStssSampleProperty->GetValue(stssIndex);
+                return m_pStssSampleProperty->GetValue(stssIndex);
+            }
+
+            // LATER check stsh for alternate sample
+
+            return MP4_INVALID_SAMPLE_ID;
+        }
 
-                if (sampleId > syncSampleId)
+        uint32_t MP4Track::GetSyncSampleIndex(MP4SampleId sampleId)
+        {
+            // index of the first stss entry >= sampleId, or numStss if none
+            uint32_t numStss = min(m_pStssCountProperty->GetValue(),
+                                   m_pStssSampleProperty->GetCount());
+            const uint32_t* pSyncSamples = m_pStssSampleProperty->GetValues();
+
+            // sequential access lands on the entry found last time, or the
+            // one after it
+            uint32_t stssIndex = m_cachedStssIndex;
+            for (uint32_t i = 0; i < 2 && stssIndex < numStss; i++, stssIndex++)
+            {
+                if (sampleId <= pSyncSamples[stssIndex]
+                    && (stssIndex == 0 || pSyncSamples[stssIndex - 1] < sampleId))
                 {
-                    continue;
+                    m_cachedStssIndex = stssIndex;
+                    return stssIndex;
                 }
-                return syncSampleId;
             }
 
-            // LATER check stsh for alternate sample
+            // stss is sorted, so binary search
+            stssIndex = (uint32_t)(lower_bound(pSyncSamples,
+                                               pSyncSamples + numStss, sampleId)
+                                   - pSyncSamples);
 
-            return MP4_INVALID_SAMPLE_ID;
+            m_cachedStssIndex = stssIndex;
+            return stssIndex;
         }
 
         void MP4Track::UpdateSyncSamples(MP4SampleId sampleId,
@@ -1958,137 +2538,183 @@ namespace mp4v2
                 return MP4_INVALID_DURATION;
             }
 
-            MP4Duration totalDuration = 0;
+            UpdateEditIndex();
 
-            for (MP4EditId eid = 1; eid <= editId; eid++)
+            // the index only covers the edits which have a duration, so a
+            // count larger than the duration table still throws like reading
+            // the missing duration did
+            if (editId > m_editEndTimeIndex.size())
             {
-                totalDuration += m_pElstDurationProperty->GetValue(eid - 1);
+                ostringstream msg;
+                msg << "illegal array index: " << editId - 1 << " of "
+                    << m_editEndTimeIndex.size();
+                throw new PlatformException(msg.str().c_str(), ERANGE,
+                                            __FILE__, __LINE__, __FUNCTION__);
             }
 
-            return totalDuration;
+            return m_editEndTimeIndex[editId - 1];
         }
 
-        MP4SampleId MP4Track::GetSampleIdFromEditTime(MP4Timestamp editWhen,
-                                                      MP4Timestamp* pStartTime,
-                                                      MP4Duration* pDuration)
+        void MP4Track::UpdateEditIndex()
         {
-            MP4SampleId sampleId = MP4_INVALID_SAMPLE_ID;
-            uint32_t numEdits = 0;
+            // edits can change while writing, so only keep the index around
+            // in read mode
+            if (m_editIndexBuilt && !m_File.IsWriteMode())
+            {
+                return;
+            }
+            m_editIndexBuilt = true;
 
+            uint32_t numEdits = 0;
             if (m_pElstCountProperty)
             {
-                numEdits = m_pElstCountProperty->GetValue();
+                numEdits = min(m_pElstCountProperty->GetValue(),
+                               m_pElstDurationProperty->GetCount());
             }
 
-            if (numEdits)
+            // end of each edit segment in the edit timeline
+            m_editEndTimeIndex.resize(numEdits);
+
+            MP4Timestamp editEndTime = 0;
+            for (uint32_t editIndex = 0; editIndex < numEdits; editIndex++)
             {
-                MP4Duration editElapsedDuration = 0;
+                editEndTime += m_pElstDurationProperty->GetValue(editIndex);
+                m_editEndTimeIndex[editIndex] = editEndTime;
+            }
+        }
 
-                for (MP4EditId editId = 1; editId <= numEdits; editId++)
-                {
-                    // remember edit segment's start time (in edit timeline)
-                    MP4Timestamp editStartTime =
-                        (MP4Timestamp)editElapsedDuration;
+        uint32_t MP4Track::GetEditIndex(MP4Timestamp editWhen)
+        {
+            // index of the edit segment containing editWhen, or numEdits if
+            // it is past the end of the edit list
+            uint32_t numEdits = m_editEndTimeIndex.size();
 
-                    // accumulate edit segment's duration
-                    editElapsedDuration +=
-                        m_pElstDurationProperty->GetValue(editId - 1);
+            // sequential access stays in the same segment most of the time
+            uint32_t editIndex = m_cachedEditIndex;
+            if (editIndex < numEdits && editWhen < m_editEndTimeIndex[editIndex]
+                && (editIndex == 0
+                    || m_editEndTimeIndex[editIndex - 1] <= editWhen))
+            {
+                return editIndex;
+            }
 
-                    // calculate difference between the specified edit time
-                    // and the end of this edit segment
-                    if (editElapsedDuration - editWhen <= 0)
-                    {
-                        // the specified time has not yet been reached
-                        continue;
-                    }
+            editIndex =
+                (uint32_t)(upper_bound(m_editEndTimeIndex.begin(),
+                                       m_editEndTimeIndex.end(), editWhen)
+                           - m_editEndTimeIndex.begin());
 
-                    // 'editWhen' is within this edit segment
+            if (editIndex < numEdits)
+            {
+                m_cachedEditIndex = editIndex;
+            }
+            return editIndex;
+        }
 
-                    // calculate the specified edit time
-                    // relative to just this edit segment
-                    MP4Duration editOffset = editWhen - editStartTime;
+        MP4SampleId MP4Track::GetSampleIdFromEditTime(MP4Timestamp editWhen,
+                                                      MP4Timestamp* pStartTime,
+                                                      MP4Duration* pDuration)
+        {
+            MP4SampleId sampleId = MP4_INVALID_SAMPLE_ID;
 
-                    // calculate the media (track) time that corresponds
-                    // to the specified edit time based on the edit list
-                    MP4Timestamp mediaWhen =
-                        m_pElstMediaTimeProperty->GetValue(editId - 1)
-                        + editOffset;
+            UpdateEditIndex();
+            uint32_t numEdits = m_editEndTimeIndex.size();
 
-                    // lookup the sample id for the media time
-                    sampleId = GetSampleIdFromTime(mediaWhen, false);
+            if (numEdits)
+            {
+                uint32_t editIndex = GetEditIndex(editWhen);
+                if (editIndex == numEdits)
+                {
+                    throw new Exception("time out of range", __FILE__,
+                                        __LINE__, __FUNCTION__);
+                }
 
-                    // lookup the sample's media start time and duration
-                    MP4Timestamp sampleStartTime;
-                    MP4Duration sampleDuration;
+                // 'editWhen' is within this edit segment
+                MP4EditId editId = editIndex + 1;
 
-                    GetSampleTimes(sampleId, &sampleStartTime, &sampleDuration);
+                // edit segment's start and end time (in edit timeline)
+                MP4Timestamp editStartTime =
+                    editIndex ? m_editEndTimeIndex[editIndex - 1] : 0;
+                MP4Duration editElapsedDuration = m_editEndTimeIndex[editIndex];
 
-                    // calculate the difference if any between when the sample
-                    // would naturally start and when it starts in the edit
-                    // timeline
-                    MP4Duration sampleStartOffset = mediaWhen - sampleStartTime;
+                // calculate the specified edit time
+                // relative to just this edit segment
+                MP4Duration editOffset = editWhen - editStartTime;
 
-                    // calculate the start time for the sample in the edit time
-                    // line
-                    MP4Timestamp editSampleStartTime =
-                        editWhen - min(editOffset, sampleStartOffset);
+                // calculate the media (track) time that corresponds
+                // to the specified edit time based on the edit list
+                MP4Timestamp mediaWhen =
+                    m_pElstMediaTimeProperty->GetValue(editId - 1) + editOffset;
 
-                    MP4Duration editSampleDuration = 0;
+                // lookup the sample id for the media time
+                sampleId = GetSampleIdFromTime(mediaWhen, false);
 
-                    // calculate how long this sample lasts in the edit list
-                    // timeline
-                    if (m_pElstRateProperty->GetValue(editId - 1) == 0)
-                    {
-                        // edit segment is a "dwell"
-                        // so sample duration is that of the edit segment
-                        editSampleDuration =
-                            m_pElstDurationProperty->GetValue(editId - 1);
-                    }
-                    else
-                    {
-                        // begin with the natural sample duration
-                        editSampleDuration = sampleDuration;
+                // lookup the sample's media start time and duration
+                MP4Timestamp sampleStartTime;
+                MP4Duration sampleDuration;
 
-                        // now shorten that if the edit segment starts
-                        // after the sample would naturally start
-                        if (editOffset < sampleStartOffset)
-                        {
-                            editSampleDuration -=
-                                sampleStartOffset - editOffset;
-                        }
+                GetSampleTimes(sampleId, &sampleStartTime, &sampleDuration);
 
-                        // now shorten that if the edit segment ends
-                        // before the sample would naturally end
-                        if (editElapsedDuration
-                            < editSampleStartTime + sampleDuration)
-                        {
-                            editSampleDuration -=
-                                (editSampleStartTime + sampleDuration)
-                                - editElapsedDuration;
-                        }
-                    }
+                // calculate the difference if any between when the sample
+                // would naturally start and when it starts in the edit
+                // timeline
+                MP4Duration sampleStartOffset = mediaWhen - sampleStartTime;
 
-                    if (pStartTime)
+                // calculate the start time for the sample in the edit time
+                // line
+                MP4Timestamp editSampleStartTime =
+                    editWhen - min(editOffset, sampleStartOffset);
+
+                MP4Duration editSampleDuration = 0;
+
+                // calculate how long this sample lasts in the edit list
+                // timeline
+                if (m_pElstRateProperty->GetValue(editId - 1) == 0)
+                {
+                    // edit segment is a "dwell"
+                    // so sample duration is that of the edit segment
+                    editSampleDuration =
+                        m_pElstDurationProperty->GetValue(editId - 1);
+                }
+                else
+                {
+                    // begin with the natural sample duration
+                    editSampleDuration = sampleDuration;
+
+                    // now shorten that if the edit segment starts
+                    // after the sample would naturally start
+                    if (editOffset < sampleStartOffset)
                     {
-                        *pStartTime = editSampleStartTime;
+                        editSampleDuration -= sampleStartOffset - editOffset;
                     }
 
-                    if (pDuration)
+                    // now shorten that if the edit segment ends
+                    // before the sample would naturally end
+                    if (editElapsedDuration
+                        < editSampleStartTime + sampleDuration)
                     {
-                        *pDuration = editSampleDuration;
+                        editSampleDuration -=
+                            (editSampleStartTime + sampleDuration)
+                            - editElapsedDuration;
                     }
+                }
 
-                    log.verbose2f(
-                        "\"%s\": GetSampleIdFromEditTime: when %" PRIu64 " "
-                        "sampleId %u start %" PRIu64 " duration %" PRId64,
-                        GetFile().GetFilename().c_str(), editWhen, sampleId,
-                        editSampleStartTime, editSampleDuration);
+                if (pStartTime)
+                {
+                    *pStartTime = editSampleStartTime;
+                }
 
-                    return sampleId;
+                if (pDuration)
+                {
+                    *pDuration = editSampleDuration;
                 }
 
-                throw new Exception("time out of range", __FILE__, __LINE__,
-                                    __FUNCTION__);
+                log.verbose2f("\"%s\": GetSampleIdFromEditTime: when %" PRIu64
+                              " "
+                              "sampleId %u start %" PRIu64
+                              " duration %" PRId64,
+                              GetFile().GetFilename().c_str(), editWhen,
+                              sampleId, editSampleStartTime,
+                              editSampleDuration);
             }
             else
             { // no edit list
@@ -76,6 +76,14 @@ namespace mp4v2
                 bool* pIsSyncSample = NULL, bool* hasDependencyFlags = NULL,
                 uint32_t* dependencyFlags = NULL);
 
+            void ReadSampleRange(
+                // input parameters
+                MP4SampleId sampleId, uint32_t numSamples,
+                // input/output parameters
+                uint8_t* pBytes, uint32_t* pNumBytes,
+                // output parameters
+                uint32_t* pSampleSizes = NULL);
+
             void WriteSample(const uint8_t* pBytes, uint32_t numBytes,
                              MP4Duration duration = 0,
                              MP4Duration renderingOffset = 0,
@@ -125,6 +133,15 @@ namespace mp4v2
                                                 MP4Timestamp* pStartTime = NULL,
                                                 MP4Duration* pDuration = NULL);
 
+            // pointer to the sample in a read-only mapping of its file,
+            // or NULL if the sample isn't mapped
+            const uint8_t* MapSample(MP4SampleId sampleId, uint32_t* pNumBytes);
+
+            void GetSampleInfo(MP4SampleId sampleId, MP4Timestamp* pStartTime,
+                               MP4Duration* pDuration,
+                               MP4Duration* pRenderingOffset,
+                               bool* pIsSyncSample);
+
             // special operation for use during hint track packet assembly
             void ReadSampleFragment(MP4SampleId sampleId, uint32_t sampleOffset,
                                     uint16_t sampleLength, uint8_t* pDest);
@@ -144,10 +161,13 @@ namespace mp4v2
             MP4Duration GetDurationPerChunk();
             void SetDurationPerChunk(MP4Duration);
 
+            void SetPrefetch(uint32_t numChunks, uint32_t maxBytes);
+
         protected:
             bool InitEditListProperties();
 
             File* GetSampleFile(MP4SampleId sampleId);
+            void CloseSampleFile();
             uint64_t GetSampleFileOffset(MP4SampleId sampleId);
             uint32_t GetSampleStscIndex(MP4SampleId sampleId);
             uint32_t GetChunkStscIndex(MP4ChunkId chunkId);
@@ -155,6 +175,15 @@ namespace mp4v2
             uint32_t GetSampleCttsIndex(MP4SampleId sampleId,
                                         MP4SampleId* pFirstSampleId = NULL);
             MP4SampleId GetNextSyncSample(MP4SampleId sampleId);
+            uint32_t GetSyncSampleIndex(MP4SampleId sampleId);
+
+            void UpdateEditIndex();
+            uint32_t GetEditIndex(MP4Timestamp editWhen);
+
+            bool UseSampleIndex();
+            void BuildSampleIndex();
+
+            void PrefetchChunks(MP4SampleId sampleId);
 
             void UpdateSampleSizes(MP4SampleId sampleId, uint32_t numBytes);
             bool IsChunkFull(MP4SampleId sampleId);
@@ -225,6 +254,7 @@ namespace mp4v2
 
             void SampleSizePropertyAddValue(uint32_t bytes);
             uint8_t m_stsz_sample_bits;
+            bool m_stszSampleSizes32; // entries are MP4Integer32Property
             bool m_have_stz2_4bit_sample;
             uint8_t m_stz2_4bit_sample_value;
             MP4IntegerProperty* m_pStszSampleSizeProperty;
@@ -250,12 +280,27 @@ namespace mp4v2
             uint32_t m_cachedCttsIndex;
             MP4SampleId m_cachedCttsSid;
 
+            // flattened sample index for random access in read mode,
+            // built on first use since the sample tables can't change
+            bool m_sampleIndexBuilt;
+            vector<uint64_t> m_sampleOffsetIndex; // [sampleId - 1]
+            vector<MP4SampleId> m_sttsFirstSampleIndex; // [sttsIndex], +1
+            vector<MP4Timestamp> m_sttsStartTimeIndex;  // [sttsIndex], +1
+
+            // read-ahead window, chunks after m_prefetchChunkId up to
+            // m_prefetchEndChunkId have already been requested
+            uint32_t m_prefetchChunks;
+            uint32_t m_prefetchMaxBytes;
+            MP4ChunkId m_prefetchChunkId;
+            MP4ChunkId m_prefetchEndChunkId;
+
             MP4Integer32Property* m_pCttsCountProperty;
             MP4Integer32Property* m_pCttsSampleCountProperty;
             MP4Integer32Property* m_pCttsSampleOffsetProperty;
 
             MP4Integer32Property* m_pStssCountProperty;
             MP4Integer32Property* m_pStssSampleProperty;
+            uint32_t m_cachedStssIndex; // for sequential sync sample lookups
 
             MP4Integer32Property* m_pElstCountProperty;
             MP4IntegerProperty* m_pElstMediaTimeProperty; // 32 or 64 bits
@@ -263,6 +308,12 @@ namespace mp4v2
             MP4Integer16Property* m_pElstRateProperty;
             MP4Integer16Property* m_pElstReservedProperty;
 
+            // end of each edit segment in the edit timeline, kept between
+            // calls in read mode only since edits can change while writing
+            bool m_editIndexBuilt;
+            vector<MP4Timestamp> m_editEndTimeIndex;
+            uint32_t m_cachedEditIndex;
+
             string m_sdtpLog; // records frame types for H264 samples
         };
 
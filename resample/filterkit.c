@@ -25,6 +25,12 @@
 #include <stdio.h>
 #include <math.h>
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#define LRS_SIMD_X86 1
+#include <emmintrin.h>
+#endif
+
 /* LpFilter()
  *
  * reference: "Digital Filters, 2nd edition"
@@ -116,15 +122,32 @@ void lrsLpFilter(double c[], int N, double frq, double Beta, int Num)
     }
 }
 
-float lrsFilterUp(float Imp[],  /* impulse response */
-                  float ImpD[], /* impulse response deltas */
+/* The coeff c[x] of lrsLpFilter() at a fractional index x, 0 <= x < N */
+double lrsLpFilterValue(double x, int N, double frq, double Beta, int Num)
+{
+    double c, temp, temp1;
+
+    if (x == 0)
+        return 2.0 * frq;
+
+    temp = PI * x / (double)Num;
+    c = sin(2.0 * temp * frq) / temp;
+
+    temp = x / ((double)(N - 1));
+    temp1 = 1.0 - temp * temp;
+    temp1 = (temp1 < 0 ? 0 : temp1);
+    return c * Izero(Beta * sqrt(temp1)) / Izero(Beta);
+}
+
+float lrsFilterUp(const float Imp[],  /* impulse response */
+                  const float ImpD[], /* impulse response deltas */
                   UWORD Nwing,  /* len of one wing of filter */
                   BOOL Interp,  /* Interpolate coefs using deltas? */
                   float* Xp,    /* Current sample */
                   double Ph,    /* Phase */
                   int Inc) /* increment (1 for right wing or -1 for left) */
 {
-    float *Hp, *Hdp = NULL, *End;
+    const float *Hp, *Hdp = NULL, *End;
     double a = 0;
     float v, t;
 
@@ -173,8 +196,8 @@ float lrsFilterUp(float Imp[],  /* impulse response */
     return v;
 }
 
-float lrsFilterUD(float Imp[],  /* impulse response */
-                  float ImpD[], /* impulse response deltas */
+float lrsFilterUD(const float Imp[],  /* impulse response */
+                  const float ImpD[], /* impulse response deltas */
                   UWORD Nwing,  /* len of one wing of filter */
                   BOOL Interp,  /* Interpolate coefs using deltas? */
                   float* Xp,    /* Current sample */
@@ -183,7 +206,7 @@ float lrsFilterUD(float Imp[],  /* impulse response */
                   double dhb) /* filter sampling period */
 {
     float a;
-    float *Hp, *Hdp, *End;
+    const float *Hp, *Hdp, *End;
     float v, t;
     double Ho;
 
@@ -222,3 +245,338 @@ float lrsFilterUD(float Imp[],  /* impulse response */
 
     return v;
 }
+
+/*
+ * Dot products of the filter coefficients h[] with the input samples
+ * x[0], x[Inc], ..., x[(n-1)*Inc]. The SSE version keeps several partial
+ * sums, so the result differs from the sequential sum in the last bits.
+ * The wings are too short for the wider AVX vectors to pay off.
+ */
+
+#ifdef LRS_SIMD_X86
+
+/* reverses the order of the 4 floats */
+#define LRS_REVERSE_PS(v) _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3))
+
+/* the 4 input samples starting with x[k*Inc] */
+#define LRS_LOAD_X(x, k, Inc)                  \
+    ((Inc) == 1 ? _mm_loadu_ps((x) + (k))      \
+                : LRS_REVERSE_PS(_mm_loadu_ps((x) - (k)-3)))
+
+static INLINE float lrsHorizontalSum(__m128 s)
+{
+    float sum[4];
+    _mm_storeu_ps(sum, s);
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+static INLINE float lrsDotProduct(const float* h, const float* x, int n,
+                                  int Inc)
+{
+    __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+    float v;
+    int k = 0;
+
+    for (; k <= n - 8; k += 8)
+    {
+        s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(h + k),
+                                       LRS_LOAD_X(x, k, Inc)));
+        s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(h + k + 4),
+                                       LRS_LOAD_X(x, k + 4, Inc)));
+    }
+    if (k <= n - 4)
+    {
+        s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(h + k),
+                                       LRS_LOAD_X(x, k, Inc)));
+        k += 4;
+    }
+
+    v = lrsHorizontalSum(_mm_add_ps(s0, s1));
+    for (; k < n; k++)
+        v += h[k] * x[k * Inc];
+
+    return v;
+}
+
+#else
+
+static INLINE float lrsDotProduct(const float* h, const float* x, int n,
+                                  int Inc)
+{
+    float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int k = 0;
+
+    for (; k <= n - 4; k += 4, x += 4 * Inc)
+    {
+        s0 += h[k] * x[0];
+        s1 += h[k + 1] * x[Inc];
+        s2 += h[k + 2] * x[2 * Inc];
+        s3 += h[k + 3] * x[3 * Inc];
+    }
+
+    for (; k < n; k++, x += Inc)
+        s0 += h[k] * x[0];
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+#endif /* LRS_SIMD_X86 */
+
+/*
+ * Polyphase layout of the filter wing: the coefficients used with the
+ * phase p, Imp[p], Imp[p + Npc], Imp[p + 2*Npc], ..., are stored
+ * contiguously in Poly[p*Nstride], padded with zeros to Nstride, so
+ * that lrsFilterUp() becomes a single dot product.
+ */
+
+UWORD lrsPolyphaseStride(UWORD Nwing)
+{
+    /* the number of taps, rounded up to a multiple of 4 */
+    return ((Nwing + Npc - 1) / Npc + 3) & ~3;
+}
+
+void lrsPolyphase(float Poly[], const float Imp[], UWORD Nwing)
+{
+    UWORD Nstride = lrsPolyphaseStride(Nwing);
+    UWORD p, k;
+
+    for (p = 0; p < Npc; p++)
+        for (k = 0; k < Nstride; k++)
+        {
+            UWORD i = p + k * Npc;
+            Poly[p * Nstride + k] = i < Nwing ? Imp[i] : 0;
+        }
+}
+
+/* The coeffs of the wing at the phase Ph in the polyphase layout; returns
+   the number of taps and the first coeff in *Hp */
+static INLINE int lrsPolyphaseTaps(const float Poly[], UWORD Nwing, double Ph,
+                                   int Inc, const float** Hp)
+{
+    int End = Nwing, p, k0 = 0, n;
+
+    Ph *= Npc;
+    p = (int)Ph;
+
+    if (Inc == 1) /* drop the extra coeff and skip the first sample */
+    {             /* at the zero phase, like lrsFilterUp() does */
+        End--;
+        if (Ph == 0)
+            k0 = 1;
+    }
+
+    /* the phase of 1.0 is the phase 0 starting with the next coeff */
+    k0 += p / Npc;
+    p %= Npc;
+
+    n = (End - p + Npc - 1) / Npc; /* the coeffs with p + k*Npc < End */
+    *Hp = Poly + p * lrsPolyphaseStride(Nwing) + k0;
+    return n - k0;
+}
+
+/* The same as lrsFilterUp() without the coefficient interpolation */
+float lrsFilterUpPoly(const float Poly[], /* polyphase impulse response */
+                      UWORD Nwing,        /* len of one wing of filter */
+                      const float* Xp,    /* Current sample */
+                      double Ph,          /* Phase */
+                      int Inc) /* increment (1 for right wing or -1 for left) */
+{
+    const float* Hp;
+    int n = lrsPolyphaseTaps(Poly, Nwing, Ph, Inc, &Hp);
+
+    return n > 0 ? lrsDotProduct(Hp, Xp, n, Inc) : 0;
+}
+
+/*
+ * Multichannel versions of the filters. Xp points to the current frame of
+ * Nchan interleaved channels and the wing of every channel is added to
+ * v[0..Nchan-1], so the coefficients are computed once for all of them.
+ */
+
+/* v[c] += sum of h[k] * x[k*Inc*Nchan + c] */
+static void lrsDotProductN(const float* h, const float* x, int n, int Inc,
+                           int Nchan, float v[])
+{
+    int step = Inc * Nchan, c = 0, k;
+
+#ifdef LRS_SIMD_X86
+    if (Nchan == 2)
+    {
+        /* two stereo frames per vector, [h[k] h[k] h[k+1] h[k+1]] */
+        __m128 s = _mm_setzero_ps();
+        float sum[4];
+
+        for (k = 0; k <= n - 2; k += 2)
+        {
+            __m128 h2 = _mm_castpd_ps(_mm_load1_pd((const double*)(h + k)));
+            h2 = _mm_unpacklo_ps(h2, h2);
+            if (Inc == 1)
+                s = _mm_add_ps(s, _mm_mul_ps(h2, _mm_loadu_ps(x + k * 2)));
+            else
+            {
+                h2 = _mm_shuffle_ps(h2, h2, _MM_SHUFFLE(1, 0, 3, 2));
+                s = _mm_add_ps(s, _mm_mul_ps(h2, _mm_loadu_ps(x - k * 2 - 2)));
+            }
+        }
+        _mm_storeu_ps(sum, s);
+        v[0] += sum[0] + sum[2];
+        v[1] += sum[1] + sum[3];
+        if (k < n)
+        {
+            v[0] += h[k] * x[k * step];
+            v[1] += h[k] * x[k * step + 1];
+        }
+        return;
+    }
+
+    for (; c <= Nchan - 4; c += 4)
+    {
+        __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+        const float* xc = x + c;
+
+        for (k = 0; k <= n - 2; k += 2)
+        {
+            s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_set1_ps(h[k]),
+                                           _mm_loadu_ps(xc + k * step)));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_set1_ps(h[k + 1]),
+                                           _mm_loadu_ps(xc + (k + 1) * step)));
+        }
+        if (k < n)
+            s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_set1_ps(h[k]),
+                                           _mm_loadu_ps(xc + k * step)));
+        _mm_storeu_ps(v + c, _mm_add_ps(_mm_loadu_ps(v + c),
+                                        _mm_add_ps(s0, s1)));
+    }
+#endif
+
+    for (; c < Nchan; c += 4)
+    {
+        /* up to 4 channels, in registers rather than in v[] */
+        float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        const float* xc = x + c;
+        int r = MIN(Nchan - c, 4);
+
+        for (k = 0; k < n; k++, xc += step)
+        {
+            float t = h[k];
+            s0 += t * xc[0];
+            if (r > 1)
+                s1 += t * xc[1];
+            if (r > 2)
+                s2 += t * xc[2];
+            if (r > 3)
+                s3 += t * xc[3];
+        }
+
+        v[c] += s0;
+        if (r > 1)
+            v[c + 1] += s1;
+        if (r > 2)
+            v[c + 2] += s2;
+        if (r > 3)
+            v[c + 3] += s3;
+    }
+}
+
+void lrsFilterUpPolyN(const float Poly[], UWORD Nwing, const float* Xp,
+                      double Ph, int Inc, int Nchan, float v[])
+{
+    const float* Hp;
+    int n = lrsPolyphaseTaps(Poly, Nwing, Ph, Inc, &Hp);
+
+    if (n > 0)
+        lrsDotProductN(Hp, Xp, n, Inc, Nchan, v);
+}
+
+/* The coeffs at the non-integer stride dhb are gathered into a small
+   buffer first, which also makes the up-conversion with interpolated
+   coeffs (dhb = Npc) go through here */
+void lrsFilterUDN(const float Imp[], const float ImpD[], UWORD Nwing,
+                  BOOL Interp, const float* Xp, double Ph, int Inc,
+                  double dhb, int Nchan, float v[])
+{
+    float h[256];
+    double Ho;
+    int End = Nwing, n;
+
+    Ho = Ph * dhb;
+    if (Inc == 1) /* drop the extra coeff and skip the first sample */
+    {             /* at the zero phase, like lrsFilterUD() does */
+        End--;
+        if (Ph == 0)
+            Ho += dhb;
+    }
+
+    for (;;)
+    {
+        for (n = 0; n < 256 && (int)Ho < End; n++, Ho += dhb)
+        {
+            int i = (int)Ho;
+            h[n] = Interp ? Imp[i] + ImpD[i] * (float)(Ho - floor(Ho))
+                          : Imp[i];
+        }
+        if (n == 0)
+            break;
+        lrsDotProductN(h, Xp, n, Inc, Nchan, v);
+        Xp += n * Inc * Nchan;
+    }
+}
+
+/*
+ * Phase filters of the rational ratio L/M. The output samples are at the
+ * input times j*M/L, so they only use the L phases i/L. The row of the
+ * phase i holds both wings for the input samples Xp[-(Nleft-1)] ...
+ * Xp[Ntaps-Nleft], Xp being the sample at the integer part of the time,
+ * with the coeffs evaluated exactly at their positions and scaled by
+ * Scale, so each output is one dot product.
+ */
+
+/* the filter sampling period, as in lrsSrcUD() */
+static double lrsRationalPeriod(int L, int M)
+{
+    return L < M ? (double)Npc * L / M : (double)Npc;
+}
+
+void lrsRationalTaps(int L, int M, UWORD Nwing, int* Nleft, int* Ntaps)
+{
+    double dh = lrsRationalPeriod(L, M);
+
+    *Nleft = (int)ceil(Nwing / dh); /* the taps k*dh < Nwing at phase 0 */
+    *Ntaps = *Nleft + (int)ceil((Nwing - 1) / dh);
+}
+
+void lrsRationalPhases(float H[], int L, int M, UWORD Nwing, double frq,
+                       double Beta, float Scale)
+{
+    double dh = lrsRationalPeriod(L, M);
+    int Nleft, Ntaps, i, k;
+
+    lrsRationalTaps(L, M, Nwing, &Nleft, &Ntaps);
+    memset(H, 0, (size_t)L * Ntaps * sizeof(float));
+
+    for (i = 0; i < L; i++)
+    {
+        float* h = H + (size_t)i * Ntaps;
+        double Ph = (double)i / L, Ho;
+
+        /* left wing, Xp[-k] */
+        for (k = 0, Ho = Ph * dh; Ho < Nwing; k++, Ho = (Ph + k) * dh)
+            h[Nleft - 1 - k] =
+                Scale * lrsLpFilterValue(Ho, Nwing, frq, Beta, Npc);
+
+        /* right wing, Xp[1+k], without the extra coeff */
+        for (k = 0, Ho = (1 - Ph) * dh; Ho < Nwing - 1;
+             k++, Ho = (1 - Ph + k) * dh)
+            h[Nleft + k] = Scale * lrsLpFilterValue(Ho, Nwing, frq, Beta, Npc);
+    }
+}
+
+void lrsFilterRational(const float H[], int Ntaps, int Nleft,
+                       const float* Xp, int Nchan, float v[])
+{
+    Xp -= (Nleft - 1) * Nchan;
+    if (Nchan == 1)
+        v[0] += lrsDotProduct(H, Xp, Ntaps, 1);
+    else
+        lrsDotProductN(H, Xp, Ntaps, 1, Nchan, v);
+}
@@ -17,15 +17,61 @@
 /*
  * FilterUp() - Applies a filter to a given sample when up-converting.
  * FilterUD() - Applies a filter to a given sample when up- or down-
+ * FilterUpPoly() - FilterUp() on the polyphase filter, not interpolated.
+ * FilterUpPolyN(), FilterUDN() - Add the wing of each of Nchan interleaved
+ *    channels to v[].
  */
 
-LIBRESAMPLE_EXPORT float lrsFilterUp(float Imp[], float ImpD[], UWORD Nwing,
-                                     BOOL Interp, float* Xp, double Ph,
-                                     int Inc);
+LIBRESAMPLE_EXPORT float lrsFilterUp(const float Imp[], const float ImpD[],
+                                     UWORD Nwing, BOOL Interp, float* Xp,
+                                     double Ph, int Inc);
 
-LIBRESAMPLE_EXPORT float lrsFilterUD(float Imp[], float ImpD[], UWORD Nwing,
-                                     BOOL Interp, float* Xp, double Ph, int Inc,
-                                     double dhb);
+LIBRESAMPLE_EXPORT float lrsFilterUD(const float Imp[], const float ImpD[],
+                                     UWORD Nwing, BOOL Interp, float* Xp,
+                                     double Ph, int Inc, double dhb);
 
 LIBRESAMPLE_EXPORT void lrsLpFilter(double c[], int N, double frq, double Beta,
                                     int Num);
+
+LIBRESAMPLE_EXPORT double lrsLpFilterValue(double x, int N, double frq,
+                                           double Beta, int Num);
+
+LIBRESAMPLE_EXPORT float lrsFilterUpPoly(const float Poly[], UWORD Nwing,
+                                         const float* Xp, double Ph, int Inc);
+
+LIBRESAMPLE_EXPORT void lrsFilterUpPolyN(const float Poly[], UWORD Nwing,
+                                         const float* Xp, double Ph, int Inc,
+                                         int Nchan, float v[]);
+
+LIBRESAMPLE_EXPORT void lrsFilterUDN(const float Imp[], const float ImpD[],
+                                     UWORD Nwing, BOOL Interp, const float* Xp,
+                                     double Ph, int Inc, double dhb, int Nchan,
+                                     float v[]);
+
+/*
+ * Polyphase() - Stores the filter wing in the polyphase layout, in
+ *    Npc rows of PolyphaseStride(Nwing) coeffs.
+ */
+
+LIBRESAMPLE_EXPORT UWORD lrsPolyphaseStride(UWORD Nwing);
+
+LIBRESAMPLE_EXPORT void lrsPolyphase(float Poly[], const float Imp[],
+                                     UWORD Nwing);
+
+/*
+ * RationalTaps() - The number of taps of the phase filters of L/M, Nleft
+ *    of them on the left wing.
+ * RationalPhases() - Computes the L phase filters of L/M into H[], L rows
+ *    of Ntaps coeffs.
+ * FilterRational() - Adds the output of a phase filter to v[].
+ */
+
+LIBRESAMPLE_EXPORT void lrsRationalTaps(int L, int M, UWORD Nwing, int* Nleft,
+                                        int* Ntaps);
+
+LIBRESAMPLE_EXPORT void lrsRationalPhases(float H[], int L, int M, UWORD Nwing,
+                                          double frq, double Beta, float Scale);
+
+LIBRESAMPLE_EXPORT void lrsFilterRational(const float H[], int Ntaps,
+                                          int Nleft, const float* Xp,
+                                          int Nchan, float v[]);
@@ -32,6 +32,21 @@ extern "C"
     LIBRESAMPLE_EXPORT void* resample_open(int highQuality, double minFactor,
                                            double maxFactor);
 
+    /* A handle for nChannels interleaved channels. resample_process() then
+       takes and returns interleaved frames, and inBufferLen, inBufferUsed,
+       outBufferLen and its result count frames rather than samples. */
+    LIBRESAMPLE_EXPORT void* resample_open_channels(int highQuality,
+                                                    double minFactor,
+                                                    double maxFactor,
+                                                    int nChannels);
+
+    /* A handle for the fixed ratio L/M (output/input rate), e.g. 160/147
+       for 44.1 kHz to 48 kHz, with nChannels interleaved channels. It
+       precomputes the exact filters of the L output phases; the factor
+       passed to resample_process() must be (double)L/M. */
+    LIBRESAMPLE_EXPORT void* resample_open_rational(int highQuality, int L,
+                                                    int M, int nChannels);
+
     LIBRESAMPLE_EXPORT void* resample_dup(const void* handle);
 
     LIBRESAMPLE_EXPORT void resample_reset(void* handle);
@@ -45,6 +60,23 @@ extern "C"
 
     LIBRESAMPLE_EXPORT void resample_close(void* handle);
 
+    /* The same as resample_open_channels(), resample_open_rational() and
+       resample_close(), reusing the handles closed by the calling thread:
+       resample_pool_close() keeps up to a few idle handles per thread, and
+       the opens take a matching one, reset, before allocating a new one.
+       All the handles share the read-only filter tables, and the handles
+       can be opened from any thread. */
+    LIBRESAMPLE_EXPORT void* resample_pool_open(int highQuality,
+                                                double minFactor,
+                                                double maxFactor,
+                                                int nChannels);
+
+    LIBRESAMPLE_EXPORT void* resample_pool_open_rational(int highQuality,
+                                                         int L, int M,
+                                                         int nChannels);
+
+    LIBRESAMPLE_EXPORT void resample_pool_close(void* handle);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
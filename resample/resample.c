@@ -26,17 +26,49 @@
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
+#include <pthread.h>
 
+/* The Kaiser-windowed lowpass filter of all the handles */
+#define RS_ROLLOFF 0.90
+#define RS_BETA 6
+
+/* The largest phase filter table of the rational handles, in coeffs */
+#define RS_MAX_RATIONAL (1 << 22)
+
+/* The most idle handles kept by the pool of a thread */
+#define RS_POOL_SIZE 16
+
+/* The filter of a quality, computed once and shared read-only by all the
+   handles */
 typedef struct
 {
+    UWORD Nmult;
+    UWORD Nwing;
     float* Imp;
     float* ImpD;
+    float* Poly; /* Imp in the polyphase layout */
+} rsfilter;
+
+static rsfilter rsFilters[2]; /* low and high quality */
+static pthread_once_t rsFilterOnce[2] = {PTHREAD_ONCE_INIT, PTHREAD_ONCE_INIT};
+
+typedef struct
+{
+    const float* Imp; /* the shared filter */
+    const float* ImpD;
+    const float* Poly;
+    int L, M;    /* the ratio L/M of the rational handles */
+    float* Rat;  /* their L phase filters of Ntaps coeffs, or NULL */
+    int Nleft;
+    int Ntaps;
+    int Phase; /* the fraction of Time, in 1/L */
     float LpScl;
     UWORD Nmult;
     UWORD Nwing;
     double minFactor;
     double maxFactor;
-    UWORD XSize;
+    int Nchan;   /* X and Y hold frames of Nchan interleaved samples */
+    UWORD XSize; /* the sizes and positions of X and Y count frames */
     float* X;
     UWORD Xp;    /* Current "now"-sample pointer for input */
     UWORD Xread; /* Position to put new samples */
@@ -47,6 +79,58 @@ typedef struct
     double Time;
 } rsdata;
 
+static void rsInitFilter(rsfilter* filter, UWORD Nmult)
+{
+    double* Imp64;
+    UWORD Nwing = Npc * (Nmult - 1) / 2; /* # of filter coeffs in right wing */
+    int i;
+
+    filter->Nmult = Nmult;
+    filter->Nwing = Nwing;
+
+    Imp64 = (double*)malloc(Nwing * sizeof(double));
+    memset(Imp64, 0, sizeof(double) * Nwing);
+    lrsLpFilter(Imp64, Nwing, 0.5 * RS_ROLLOFF, RS_BETA, Npc);
+
+    filter->Imp = (float*)malloc(Nwing * sizeof(float));
+    filter->ImpD = (float*)malloc(Nwing * sizeof(float));
+    for (i = 0; i < Nwing; i++)
+        filter->Imp[i] = Imp64[i];
+    free(Imp64);
+
+    /* Storing deltas in ImpD makes linear interpolation
+       of the filter coefficients faster */
+    for (i = 0; i < Nwing - 1; i++)
+        filter->ImpD[i] = filter->Imp[i + 1] - filter->Imp[i];
+
+    /* Last coeff. not interpolated */
+    filter->ImpD[Nwing - 1] = -filter->Imp[Nwing - 1];
+
+    /* The coeffs of each phase stored contiguously make the up-conversion
+       filter loops dot products */
+    filter->Poly =
+        (float*)malloc(Npc * lrsPolyphaseStride(Nwing) * sizeof(float));
+    lrsPolyphase(filter->Poly, filter->Imp, Nwing);
+}
+
+static void rsInitLowQuality(void) { rsInitFilter(&rsFilters[0], 11); }
+
+static void rsInitHighQuality(void) { rsInitFilter(&rsFilters[1], 35); }
+
+/* The filter is computed by the first handle of the quality; the handles
+   opened concurrently wait for it */
+static const rsfilter* rsGetFilter(int highQuality)
+{
+    if (highQuality)
+    {
+        pthread_once(&rsFilterOnce[1], rsInitHighQuality);
+        return &rsFilters[1];
+    }
+
+    pthread_once(&rsFilterOnce[0], rsInitLowQuality);
+    return &rsFilters[0];
+}
+
 void* resample_dup(const void* handle)
 {
     const rsdata* cpy = (const rsdata*)handle;
@@ -54,24 +138,36 @@ void* resample_dup(const void* handle)
 
     hp->minFactor = cpy->minFactor;
     hp->maxFactor = cpy->maxFactor;
+    hp->Nchan = cpy->Nchan;
     hp->Nmult = cpy->Nmult;
     hp->LpScl = cpy->LpScl;
     hp->Nwing = cpy->Nwing;
 
-    hp->Imp = (float*)malloc(hp->Nwing * sizeof(float));
-    memcpy(hp->Imp, cpy->Imp, hp->Nwing * sizeof(float));
-    hp->ImpD = (float*)malloc(hp->Nwing * sizeof(float));
-    memcpy(hp->ImpD, cpy->ImpD, hp->Nwing * sizeof(float));
+    hp->Imp = cpy->Imp;
+    hp->ImpD = cpy->ImpD;
+    hp->Poly = cpy->Poly;
+
+    hp->L = cpy->L;
+    hp->M = cpy->M;
+    hp->Nleft = cpy->Nleft;
+    hp->Ntaps = cpy->Ntaps;
+    hp->Phase = cpy->Phase;
+    hp->Rat = NULL;
+    if (cpy->Rat)
+    {
+        hp->Rat = (float*)malloc((size_t)hp->L * hp->Ntaps * sizeof(float));
+        memcpy(hp->Rat, cpy->Rat, (size_t)hp->L * hp->Ntaps * sizeof(float));
+    }
 
     hp->Xoff = cpy->Xoff;
     hp->XSize = cpy->XSize;
-    hp->X = (float*)malloc((hp->XSize + hp->Xoff) * sizeof(float));
-    memcpy(hp->X, cpy->X, (hp->XSize + hp->Xoff) * sizeof(float));
+    hp->X = (float*)malloc((hp->XSize + hp->Xoff) * hp->Nchan * sizeof(float));
+    memcpy(hp->X, cpy->X, (hp->XSize + hp->Xoff) * hp->Nchan * sizeof(float));
     hp->Xp = cpy->Xp;
     hp->Xread = cpy->Xread;
     hp->YSize = cpy->YSize;
-    hp->Y = (float*)malloc(hp->YSize * sizeof(float));
-    memcpy(hp->Y, cpy->Y, hp->YSize * sizeof(float));
+    hp->Y = (float*)malloc(hp->YSize * hp->Nchan * sizeof(float));
+    memcpy(hp->Y, cpy->Y, hp->YSize * hp->Nchan * sizeof(float));
     hp->Yp = cpy->Yp;
     hp->Time = cpy->Time;
 
@@ -90,41 +186,36 @@ void resample_reset(void* handle)
         int i;
         rsdata* hp = (rsdata*)handle;
 
-        memset(hp->X, 0, (hp->XSize + hp->Xoff) * sizeof(float));
+        memset(hp->X, 0, (hp->XSize + hp->Xoff) * hp->Nchan * sizeof(float));
 
         /* Need Xoff zeros at begining of X buffer */
-        for (i = 0; i < hp->Xoff; i++)
+        for (i = 0; i < hp->Xoff * hp->Nchan; i++)
             hp->X[i] = 0;
 
         hp->Time = (double)hp->Xoff; /* Current-time pointer for converter */
         hp->Xp = hp->Xoff;
         hp->Xread = hp->Xoff;
-        for (i = 0; i < hp->Xoff; i++)
+        hp->Phase = 0;
+        for (i = 0; i < hp->Xoff * hp->Nchan; i++)
             hp->X[i] = 0;
-        memset(hp->Y, 0, hp->YSize * sizeof(float));
+        memset(hp->Y, 0, hp->YSize * hp->Nchan * sizeof(float));
         hp->Yp = 0;
     }
 }
 
 void* resample_open(int highQuality, double minFactor, double maxFactor)
 {
-    //
-    //  We only ever use highQuality and other params are fixed at compile time,
-    //  so Imp64 can be static, hence calculated only once.
-    //
-    static double* staticImp64 = 0;
-    double* Imp64;
-    double Rolloff, Beta;
+    return resample_open_channels(highQuality, minFactor, maxFactor, 1);
+}
+
+void* resample_open_channels(int highQuality, double minFactor,
+                             double maxFactor, int nChannels)
+{
+    const rsfilter* filter;
     rsdata* hp;
     UWORD Xoff_min, Xoff_max;
     int i;
 
-    if (!highQuality)
-    {
-        fprintf(stderr,
-                "WARNING: audio resampler only supports high quality.\n");
-    }
-
     /* Just exit if we get invalid factors */
     if (minFactor <= 0.0 || maxFactor <= 0.0 || maxFactor < minFactor)
     {
@@ -137,44 +228,32 @@ void* resample_open(int highQuality, double minFactor, double maxFactor)
         return 0;
     }
 
+    if (nChannels < 1)
+    {
+#if DEBUG
+        fprintf(stderr, "libresample: nChannels must be at least 1.\n");
+#endif
+        return 0;
+    }
+
     hp = (rsdata*)malloc(sizeof(rsdata));
 
     hp->minFactor = minFactor;
     hp->maxFactor = maxFactor;
-
-    if (highQuality)
-        hp->Nmult = 35;
-    else
-        hp->Nmult = 11;
-
+    hp->Nchan = nChannels;
+
+    filter = rsGetFilter(highQuality);
+    hp->Nmult = filter->Nmult;
+    hp->Nwing = filter->Nwing;
+    hp->Imp = filter->Imp;
+    hp->ImpD = filter->ImpD;
+    hp->Poly = filter->Poly;
     hp->LpScl = 1.0;
-    hp->Nwing =
-        Npc * (hp->Nmult - 1) / 2; /* # of filter coeffs in right wing */
-
-    Rolloff = 0.90;
-    Beta = 6;
-
-    if (0 == staticImp64)
-    {
-        staticImp64 = (double*)malloc(hp->Nwing * sizeof(double));
-        memset(staticImp64, 0, sizeof(double) * hp->Nwing);
-
-        lrsLpFilter(staticImp64, hp->Nwing, 0.5 * Rolloff, Beta, Npc);
-    }
-    Imp64 = staticImp64;
 
-    hp->Imp = (float*)malloc(hp->Nwing * sizeof(float));
-    hp->ImpD = (float*)malloc(hp->Nwing * sizeof(float));
-    for (i = 0; i < hp->Nwing; i++)
-        hp->Imp[i] = Imp64[i];
-
-    /* Storing deltas in ImpD makes linear interpolation
-       of the filter coefficients faster */
-    for (i = 0; i < hp->Nwing - 1; i++)
-        hp->ImpD[i] = hp->Imp[i + 1] - hp->Imp[i];
-
-    /* Last coeff. not interpolated */
-    hp->ImpD[hp->Nwing - 1] = -hp->Imp[hp->Nwing - 1];
+    hp->L = hp->M = 1;
+    hp->Rat = NULL;
+    hp->Nleft = hp->Ntaps = 0;
+    hp->Phase = 0;
 
     /* Calc reach of LP filter wing (plus some creeping room) */
     Xoff_min = ((hp->Nmult + 1) / 2.0) * MAX(1.0, 1.0 / minFactor) + 10;
@@ -187,20 +266,20 @@ void* resample_open(int highQuality, double minFactor, double maxFactor)
        we can zero-pad up to Xoff zeros at the end when we reach the
        end of the input samples. */
     hp->XSize = MAX(2 * hp->Xoff + 10, 4096);
-    hp->X = (float*)malloc((hp->XSize + hp->Xoff) * sizeof(float));
-    memset(hp->X, 0, (hp->XSize + hp->Xoff) * sizeof(float));
+    hp->X = (float*)malloc((hp->XSize + hp->Xoff) * hp->Nchan * sizeof(float));
+    memset(hp->X, 0, (hp->XSize + hp->Xoff) * hp->Nchan * sizeof(float));
     hp->Xp = hp->Xoff;
     hp->Xread = hp->Xoff;
 
     /* Need Xoff zeros at begining of X buffer */
-    for (i = 0; i < hp->Xoff; i++)
+    for (i = 0; i < hp->Xoff * hp->Nchan; i++)
         hp->X[i] = 0;
 
     /* Make the outBuffer long enough to hold the entire processed
        output of one inBuffer */
     hp->YSize = (int)(((double)hp->XSize) * maxFactor + 2.0);
-    hp->Y = (float*)malloc(hp->YSize * sizeof(float));
-    memset(hp->Y, 0, hp->YSize * sizeof(float));
+    hp->Y = (float*)malloc(hp->YSize * hp->Nchan * sizeof(float));
+    memset(hp->Y, 0, hp->YSize * hp->Nchan * sizeof(float));
     hp->Yp = 0;
 
     hp->Time = (double)hp->Xoff; /* Current-time pointer for converter */
@@ -208,6 +287,63 @@ void* resample_open(int highQuality, double minFactor, double maxFactor)
     return (void*)hp;
 }
 
+static void rsReduce(int* L, int* M)
+{
+    int a = *L, b = *M;
+
+    while (b)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    *L /= a;
+    *M /= a;
+}
+
+void* resample_open_rational(int highQuality, int L, int M, int nChannels)
+{
+    rsdata* hp;
+    double factor;
+
+    if (L <= 0 || M <= 0)
+    {
+#if DEBUG
+        fprintf(stderr, "libresample: L and M must be positive integers.\n");
+#endif
+        return 0;
+    }
+
+    /* Reduce L/M, the phase filters take L rows */
+    rsReduce(&L, &M);
+
+    factor = (double)L / M;
+    hp = (rsdata*)resample_open_channels(highQuality, factor, factor,
+                                         nChannels);
+    if (!hp)
+        return 0;
+
+    lrsRationalTaps(L, M, hp->Nwing, &hp->Nleft, &hp->Ntaps);
+    if ((double)L * hp->Ntaps > RS_MAX_RATIONAL)
+    {
+#if DEBUG
+        fprintf(stderr, "libresample: %d/%d needs too many phases.\n", L, M);
+#endif
+        resample_close(hp);
+        return 0;
+    }
+
+    /* Include the filter gain of factors less than 1, as resample_process()
+       does with LpScl */
+    hp->L = L;
+    hp->M = M;
+    hp->Rat = (float*)malloc((size_t)L * hp->Ntaps * sizeof(float));
+    lrsRationalPhases(hp->Rat, L, M, hp->Nwing, 0.5 * RS_ROLLOFF, RS_BETA,
+                      hp->LpScl * MIN(factor, 1.0));
+
+    return (void*)hp;
+}
+
 int resample_get_filter_width(const void* handle)
 {
     const rsdata* hp = (const rsdata*)handle;
@@ -220,10 +356,11 @@ int resample_process(void* handle, double factor, float* inBuffer,
                      float* outBuffer, int outBufferLen)
 {
     rsdata* hp = (rsdata*)handle;
-    float* Imp = hp->Imp;
-    float* ImpD = hp->ImpD;
+    const float* Imp = hp->Imp;
+    const float* ImpD = hp->ImpD;
     float LpScl = hp->LpScl;
     UWORD Nwing = hp->Nwing;
+    int Nchan = hp->Nchan;
     BOOL interpFilt = FALSE; /* TRUE means interpolate filter coeffs */
     int outSampleCount;
     UWORD Nout, Ncreep, Nreuse;
@@ -255,11 +392,11 @@ int resample_process(void* handle, double factor, float* inBuffer,
     if (hp->Yp && (outBufferLen - outSampleCount) > 0)
     {
         len = MIN(outBufferLen - outSampleCount, hp->Yp);
-        for (i = 0; i < len; i++)
-            outBuffer[outSampleCount + i] = hp->Y[i];
+        for (i = 0; i < len * Nchan; i++)
+            outBuffer[outSampleCount * Nchan + i] = hp->Y[i];
         outSampleCount += len;
-        for (i = 0; i < hp->Yp - len; i++)
-            hp->Y[i] = hp->Y[i + len];
+        for (i = 0; i < (hp->Yp - len) * Nchan; i++)
+            hp->Y[i] = hp->Y[i + len * Nchan];
         hp->Yp -= len;
     }
 
@@ -289,8 +426,9 @@ int resample_process(void* handle, double factor, float* inBuffer,
         if (len >= (inBufferLen - (*inBufferUsed)))
             len = (inBufferLen - (*inBufferUsed));
 
-        for (i = 0; i < len; i++)
-            hp->X[hp->Xread + i] = inBuffer[(*inBufferUsed) + i];
+        for (i = 0; i < len * Nchan; i++)
+            hp->X[hp->Xread * Nchan + i] =
+                inBuffer[(*inBufferUsed) * Nchan + i];
 
         *inBufferUsed += len;
         hp->Xread += len;
@@ -301,8 +439,8 @@ int resample_process(void* handle, double factor, float* inBuffer,
                end of the input buffer and make sure we process
                all the way to the end */
             Nx = hp->Xread - hp->Xoff;
-            for (i = 0; i < hp->Xoff; i++)
-                hp->X[hp->Xread + i] = 0;
+            for (i = 0; i < hp->Xoff * Nchan; i++)
+                hp->X[hp->Xread * Nchan + i] = 0;
         }
         else
             Nx = hp->Xread - 2 * hp->Xoff;
@@ -315,10 +453,25 @@ int resample_process(void* handle, double factor, float* inBuffer,
             break;
 
         /* Resample stuff in input buffer */
-        if (factor >= 1)
+        if (hp->Rat)
+        { /* the exact phase filters of the fixed ratio */
+            Nout = lrsSrcRational(hp->X, hp->Y, hp->L, hp->M, &hp->Time,
+                                  &hp->Phase, Nx, hp->Rat, hp->Nleft,
+                                  hp->Ntaps, Nchan);
+        }
+        else if (Nchan > 1)
+        { /* all the channels of a frame share the filter phase */
+            if (factor >= 1)
+                Nout = lrsSrcUpN(hp->X, hp->Y, factor, &hp->Time, Nx, Nwing,
+                                 LpScl, Imp, ImpD, interpFilt, hp->Poly, Nchan);
+            else
+                Nout = lrsSrcUDN(hp->X, hp->Y, factor, &hp->Time, Nx, Nwing,
+                                 LpScl, Imp, ImpD, interpFilt, Nchan);
+        }
+        else if (factor >= 1)
         { /* SrcUp() is faster if we can use it */
             Nout = lrsSrcUp(hp->X, hp->Y, factor, &hp->Time, Nx, Nwing, LpScl,
-                            Imp, ImpD, interpFilt);
+                            Imp, ImpD, interpFilt, hp->Poly);
         }
         else
         {
@@ -344,8 +497,8 @@ int resample_process(void* handle, double factor, float* inBuffer,
         /* Copy part of input signal that must be re-used */
         Nreuse = hp->Xread - (hp->Xp - hp->Xoff);
 
-        for (i = 0; i < Nreuse; i++)
-            hp->X[i] = hp->X[i + (hp->Xp - hp->Xoff)];
+        for (i = 0; i < Nreuse * Nchan; i++)
+            hp->X[i] = hp->X[i + (hp->Xp - hp->Xoff) * Nchan];
 
 #ifdef DEBUG
         printf("New Xread=%d\n", Nreuse);
@@ -370,11 +523,11 @@ int resample_process(void* handle, double factor, float* inBuffer,
         if (hp->Yp && (outBufferLen - outSampleCount) > 0)
         {
             len = MIN(outBufferLen - outSampleCount, hp->Yp);
-            for (i = 0; i < len; i++)
-                outBuffer[outSampleCount + i] = hp->Y[i];
+            for (i = 0; i < len * Nchan; i++)
+                outBuffer[outSampleCount * Nchan + i] = hp->Y[i];
             outSampleCount += len;
-            for (i = 0; i < hp->Yp - len; i++)
-                hp->Y[i] = hp->Y[i + len];
+            for (i = 0; i < (hp->Yp - len) * Nchan; i++)
+                hp->Y[i] = hp->Y[i + len * Nchan];
             hp->Yp -= len;
         }
 
@@ -392,7 +545,125 @@ void resample_close(void* handle)
     rsdata* hp = (rsdata*)handle;
     free(hp->X);
     free(hp->Y);
-    free(hp->Imp);
-    free(hp->ImpD);
+    free(hp->Rat);
     free(hp);
 }
+
+/*
+ * The pool of idle handles of each thread. resample_pool_close() keeps the
+ * handle for the next resample_pool_open() of the same parameters on the
+ * thread, which gets it reset, so reopening a resampler (e.g. on a seek)
+ * neither allocates nor computes filters. The handles left in the pool
+ * are closed when the thread exits.
+ */
+
+typedef struct
+{
+    int count;
+    rsdata* handles[RS_POOL_SIZE];
+} rspool;
+
+static pthread_key_t rsPoolKey;
+static pthread_once_t rsPoolKeyOnce = PTHREAD_ONCE_INIT;
+
+static void rsDestroyPool(void* ptr)
+{
+    rspool* pool = (rspool*)ptr;
+    int i;
+
+    for (i = 0; i < pool->count; i++)
+        resample_close(pool->handles[i]);
+    free(pool);
+}
+
+static void rsCreatePoolKey(void)
+{
+    pthread_key_create(&rsPoolKey, rsDestroyPool);
+}
+
+static rspool* rsGetPool(int create)
+{
+    rspool* pool;
+
+    pthread_once(&rsPoolKeyOnce, rsCreatePoolKey);
+    pool = (rspool*)pthread_getspecific(rsPoolKey);
+    if (!pool && create)
+    {
+        pool = (rspool*)calloc(1, sizeof(rspool));
+        if (pool)
+            pthread_setspecific(rsPoolKey, pool);
+    }
+
+    return pool;
+}
+
+/* Takes the idle handle of these parameters out of the pool, if any */
+static rsdata* rsPoolTake(int highQuality, double minFactor,
+                          double maxFactor, int nChannels, int L, int M,
+                          int rational)
+{
+    rspool* pool = rsGetPool(0);
+    UWORD Nmult = rsGetFilter(highQuality)->Nmult;
+    int i;
+
+    if (!pool)
+        return 0;
+
+    for (i = pool->count - 1; i >= 0; i--)
+    {
+        rsdata* hp = pool->handles[i];
+
+        if (hp->Nmult == Nmult && hp->minFactor == minFactor
+            && hp->maxFactor == maxFactor && hp->Nchan == nChannels
+            && (hp->Rat != NULL) == rational && hp->L == L && hp->M == M)
+        {
+            pool->handles[i] = pool->handles[--pool->count];
+            resample_reset(hp);
+            return hp;
+        }
+    }
+
+    return 0;
+}
+
+void* resample_pool_open(int highQuality, double minFactor, double maxFactor,
+                         int nChannels)
+{
+    rsdata* hp = rsPoolTake(highQuality, minFactor, maxFactor, nChannels, 1,
+                            1, 0);
+
+    return hp ? (void*)hp
+              : resample_open_channels(highQuality, minFactor, maxFactor,
+                                       nChannels);
+}
+
+void* resample_pool_open_rational(int highQuality, int L, int M,
+                                  int nChannels)
+{
+    rsdata* hp;
+    double factor;
+
+    if (L <= 0 || M <= 0)
+        return 0;
+
+    rsReduce(&L, &M);
+    factor = (double)L / M;
+    hp = rsPoolTake(highQuality, factor, factor, nChannels, L, M, 1);
+
+    return hp ? (void*)hp
+              : resample_open_rational(highQuality, L, M, nChannels);
+}
+
+void resample_pool_close(void* handle)
+{
+    rspool* pool;
+
+    if (!handle)
+        return;
+
+    pool = rsGetPool(1);
+    if (pool && pool->count < RS_POOL_SIZE)
+        pool->handles[pool->count++] = (rsdata*)handle;
+    else
+        resample_close(handle);
+}
@@ -85,14 +85,35 @@ typedef unsigned int UWORD;
 
 /* Function prototypes */
 
+/* Poly is the polyphase layout of Imp (see lrsPolyphase()), used when the
+   coeffs are not interpolated; it can be NULL */
 LIBRESAMPLE_EXPORT int lrsSrcUp(float X[], float Y[], double factor,
                                 double* Time, UWORD Nx, UWORD Nwing,
-                                float LpScl, float Imp[], float ImpD[],
-                                BOOL Interp);
+                                float LpScl, const float Imp[],
+                                const float ImpD[], BOOL Interp,
+                                const float Poly[]);
 
 LIBRESAMPLE_EXPORT int lrsSrcUD(float X[], float Y[], double factor,
                                 double* Time, UWORD Nx, UWORD Nwing,
-                                float LpScl, float Imp[], float ImpD[],
-                                BOOL Interp);
+                                float LpScl, const float Imp[],
+                                const float ImpD[], BOOL Interp);
+
+/* The same for Nchan interleaved channels; Nx and the result are frames */
+LIBRESAMPLE_EXPORT int lrsSrcUpN(float X[], float Y[], double factor,
+                                 double* Time, UWORD Nx, UWORD Nwing,
+                                 float LpScl, const float Imp[],
+                                 const float ImpD[], BOOL Interp,
+                                 const float Poly[], int Nchan);
+
+LIBRESAMPLE_EXPORT int lrsSrcUDN(float X[], float Y[], double factor,
+                                 double* Time, UWORD Nx, UWORD Nwing,
+                                 float LpScl, const float Imp[],
+                                 const float ImpD[], BOOL Interp, int Nchan);
+
+/* Conversion by L/M on the phase filters H; the time is *Time + *Phase/L */
+LIBRESAMPLE_EXPORT int lrsSrcRational(float X[], float Y[], int L, int M,
+                                      double* Time, int* Phase, UWORD Nx,
+                                      const float H[], int Nleft, int Ntaps,
+                                      int Nchan);
 
 #endif
@@ -28,7 +28,8 @@
  * Slightly faster than down-conversion;
  */
 int lrsSrcUp(float X[], float Y[], double factor, double* TimePtr, UWORD Nx,
-             UWORD Nwing, float LpScl, float Imp[], float ImpD[], BOOL Interp)
+             UWORD Nwing, float LpScl, const float Imp[], const float ImpD[],
+             BOOL Interp, const float Poly[])
 {
     float *Xp, *Ystart;
     float v;
@@ -47,10 +48,19 @@ int lrsSrcUp(float X[], float Y[], double factor, double* TimePtr, UWORD Nx,
         double RightPhase = 1.0 - LeftPhase;
 
         Xp = &X[(int)CurrentTime]; /* Ptr to current input sample */
-        /* Perform left-wing inner product */
-        v = lrsFilterUp(Imp, ImpD, Nwing, Interp, Xp, LeftPhase, -1);
-        /* Perform right-wing inner product */
-        v += lrsFilterUp(Imp, ImpD, Nwing, Interp, Xp + 1, RightPhase, 1);
+        if (Poly && !Interp)
+        {
+            /* Perform left-wing and right-wing inner products */
+            v = lrsFilterUpPoly(Poly, Nwing, Xp, LeftPhase, -1);
+            v += lrsFilterUpPoly(Poly, Nwing, Xp + 1, RightPhase, 1);
+        }
+        else
+        {
+            /* Perform left-wing inner product */
+            v = lrsFilterUp(Imp, ImpD, Nwing, Interp, Xp, LeftPhase, -1);
+            /* Perform right-wing inner product */
+            v += lrsFilterUp(Imp, ImpD, Nwing, Interp, Xp + 1, RightPhase, 1);
+        }
 
         v *= LpScl; /* Normalize for unity filter gain */
 
@@ -65,7 +75,8 @@ int lrsSrcUp(float X[], float Y[], double factor, double* TimePtr, UWORD Nx,
 /* Sampling rate conversion subroutine */
 
 int lrsSrcUD(float X[], float Y[], double factor, double* TimePtr, UWORD Nx,
-             UWORD Nwing, float LpScl, float Imp[], float ImpD[], BOOL Interp)
+             UWORD Nwing, float LpScl, const float Imp[], const float ImpD[],
+             BOOL Interp)
 {
     float *Xp, *Ystart;
     float v;
@@ -101,3 +112,135 @@ int lrsSrcUD(float X[], float Y[], double factor, double* TimePtr, UWORD Nx,
     *TimePtr = CurrentTime;
     return (Y - Ystart); /* Return the number of output samples */
 }
+
+/* Interleaved multichannel versions of lrsSrcUp() and lrsSrcUD(); X and Y
+ * hold frames of Nchan samples, Nx and the result count frames.
+ */
+
+int lrsSrcUpN(float X[], float Y[], double factor, double* TimePtr, UWORD Nx,
+              UWORD Nwing, float LpScl, const float Imp[],
+              const float ImpD[], BOOL Interp, const float Poly[], int Nchan)
+{
+    float *Xp, *Ystart;
+    int c;
+
+    double CurrentTime = *TimePtr;
+    double dt;      /* Step through input signal */
+    double endTime; /* When Time reaches EndTime, return to user */
+
+    dt = 1.0 / factor; /* Output sampling period */
+
+    Ystart = Y;
+    endTime = CurrentTime + Nx;
+    while (CurrentTime < endTime)
+    {
+        double LeftPhase = CurrentTime - floor(CurrentTime);
+        double RightPhase = 1.0 - LeftPhase;
+
+        Xp = &X[(int)CurrentTime * Nchan]; /* Ptr to current input frame */
+        for (c = 0; c < Nchan; c++)
+            Y[c] = 0;
+
+        /* Perform left-wing and right-wing inner products */
+        if (Poly && !Interp)
+        {
+            lrsFilterUpPolyN(Poly, Nwing, Xp, LeftPhase, -1, Nchan, Y);
+            lrsFilterUpPolyN(Poly, Nwing, Xp + Nchan, RightPhase, 1, Nchan, Y);
+        }
+        else
+        {
+            lrsFilterUDN(Imp, ImpD, Nwing, Interp, Xp, LeftPhase, -1, Npc,
+                         Nchan, Y);
+            lrsFilterUDN(Imp, ImpD, Nwing, Interp, Xp + Nchan, RightPhase, 1,
+                         Npc, Nchan, Y);
+        }
+
+        for (c = 0; c < Nchan; c++)
+            Y[c] *= LpScl; /* Normalize for unity filter gain */
+
+        Y += Nchan;        /* Deposit output */
+        CurrentTime += dt; /* Move to next sample by time increment */
+    }
+
+    *TimePtr = CurrentTime;
+    return (Y - Ystart) / Nchan; /* Return the number of output frames */
+}
+
+int lrsSrcUDN(float X[], float Y[], double factor, double* TimePtr, UWORD Nx,
+              UWORD Nwing, float LpScl, const float Imp[],
+              const float ImpD[], BOOL Interp, int Nchan)
+{
+    float *Xp, *Ystart;
+    int c;
+
+    double CurrentTime = (*TimePtr);
+    double dh;      /* Step through filter impulse response */
+    double dt;      /* Step through input signal */
+    double endTime; /* When Time reaches EndTime, return to user */
+
+    dt = 1.0 / factor; /* Output sampling period */
+
+    dh = MIN(Npc, factor * Npc); /* Filter sampling period */
+
+    Ystart = Y;
+    endTime = CurrentTime + Nx;
+    while (CurrentTime < endTime)
+    {
+        double LeftPhase = CurrentTime - floor(CurrentTime);
+        double RightPhase = 1.0 - LeftPhase;
+
+        Xp = &X[(int)CurrentTime * Nchan]; /* Ptr to current input frame */
+        for (c = 0; c < Nchan; c++)
+            Y[c] = 0;
+
+        /* Perform left-wing and right-wing inner products */
+        lrsFilterUDN(Imp, ImpD, Nwing, Interp, Xp, LeftPhase, -1, dh, Nchan, Y);
+        lrsFilterUDN(Imp, ImpD, Nwing, Interp, Xp + Nchan, RightPhase, 1, dh,
+                     Nchan, Y);
+
+        for (c = 0; c < Nchan; c++)
+            Y[c] *= LpScl; /* Normalize for unity filter gain */
+
+        Y += Nchan;        /* Deposit output */
+        CurrentTime += dt; /* Move to next sample by time increment */
+    }
+
+    *TimePtr = CurrentTime;
+    return (Y - Ystart) / Nchan; /* Return the number of output frames */
+}
+
+/* Rational L/M conversion on the phase filters of lrsRationalPhases(); the
+ * time is *TimePtr + *PhasePtr/L, kept exact in integers.
+ */
+
+int lrsSrcRational(float X[], float Y[], int L, int M, double* TimePtr,
+                   int* PhasePtr, UWORD Nx, const float H[], int Nleft,
+                   int Ntaps, int Nchan)
+{
+    float* Ystart;
+    int c;
+
+    int CurrentTime = (int)*TimePtr; /* Integer part of the time */
+    int Phase = *PhasePtr;           /* and its fraction, in 1/L */
+    int endTime = CurrentTime + Nx;  /* When Time reaches EndTime, return */
+
+    Ystart = Y;
+    while (CurrentTime < endTime)
+    {
+        for (c = 0; c < Nchan; c++)
+            Y[c] = 0;
+
+        lrsFilterRational(H + (size_t)Phase * Ntaps, Ntaps, Nleft,
+                          &X[CurrentTime * Nchan], Nchan, Y);
+
+        Y += Nchan; /* Deposit output */
+
+        Phase += M; /* Move to next sample by M/L */
+        CurrentTime += Phase / L;
+        Phase %= L;
+    }
+
+    *TimePtr = CurrentTime;
+    *PhasePtr = Phase;
+    return (Y - Ystart) / Nchan; /* Return the number of output frames */
+}